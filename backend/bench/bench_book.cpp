@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "md/book.hpp"
+#include "md/flat_book.hpp"
+#include "venues/coinbase/parser.hpp"
+#include "venues/kraken/parser.hpp"
+
+// Microbenchmark: std::map Book vs contiguous FlatBook.
+// Each engine runs twice: one apply() per event, and apply_many() over runs of
+// kDrainEvents events (VenueFeed coalescing frames that queued up back to back).
+// Replays recorded venue frames (one raw WS JSON frame per line, e.g. the output of
+// test_ws_coinbase / test_ws_kraken redirected to a file) or a synthetic random walk.
+//
+// Usage:
+//   bench_book coinbase frames_coinbase.txt
+//   bench_book kraken   frames_kraken.txt
+//   bench_book synthetic [events]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr std::size_t kPublishEvery = 32; // mirrors PublishPolicy::max_updates_per_publish
+constexpr std::size_t kDrainEvents = 8;   // events per coalesced apply_many()
+
+struct Workload {
+    std::string venue;
+    std::string symbol;
+    BookEventBatch batch; // every parsed event, in arrival order
+    std::size_t deltas{0};
+};
+
+template <class ParserT>
+bool load_frames(const std::string& path, Workload& wl) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open " << path << "\n";
+        return false;
+    }
+    ParserT parser;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty()) continue;
+        parser.parse(line, wl.batch); // parsers append; the batch is never cleared here
+    }
+    if (wl.batch.empty()) return false;
+    const auto& first = wl.batch.events().front();
+    wl.venue = std::string(md::venue_ids().name(first.venue));
+    wl.symbol = std::string(md::symbol_ids().name(first.symbol));
+    wl.deltas = wl.batch.level_count();
+    return true;
+}
+
+// Random walk around a mid price with most activity near the touch.
+Workload synthetic_workload(std::size_t n_events) {
+    Workload wl;
+    wl.venue = "Synthetic";
+    wl.symbol = "BTC-USD";
+    const md::VenueId venue = md::venue_ids().intern(wl.venue);
+    const md::SymbolId symbol = md::symbol_ids().intern(wl.symbol);
+
+    std::mt19937_64 rng(42);
+    std::geometric_distribution<int> depth_dist(0.08);
+    std::uniform_int_distribution<md::SizeLots> size_dist(md::kSizeScale / 1000, 2 * md::kSizeScale);
+    std::bernoulli_distribution delete_dist(0.35);
+    const md::PriceTicks tick = md::kPriceScale / 100; // 0.01
+    md::PriceTicks mid = 60000 * md::kPriceScale;
+
+    wl.batch.begin(BookEventKind::Snapshot, venue, symbol, 0);
+    for (int i = 1; i <= 1000; ++i) {
+        wl.batch.add_level(BookSide::Bid, mid - i * tick, size_dist(rng));
+        wl.batch.add_level(BookSide::Ask, mid + i * tick, size_dist(rng));
+    }
+    wl.batch.commit();
+
+    for (std::size_t i = 0; i < n_events; ++i) {
+        if ((i & 0xff) == 0) mid += (rng() & 1 ? tick : -tick);
+        const bool bid = rng() & 1;
+        const int k = 1 + std::min(depth_dist(rng), 999);
+        const md::SizeLots qty = delete_dist(rng) ? 0 : size_dist(rng);
+        wl.batch.begin(BookEventKind::Delta, venue, symbol, 0);
+        wl.batch.add_level(bid ? BookSide::Bid : BookSide::Ask,
+                           bid ? mid - k * tick : mid + k * tick, qty);
+        wl.batch.commit();
+    }
+    wl.deltas = wl.batch.level_count();
+    return wl;
+}
+
+struct Result {
+    double apply_ns{0.0};
+    double publish_ns{0.0};
+    std::size_t publishes{0};
+    double checksum{0.0};
+};
+
+template <class BookT>
+Result run(const Workload& wl, int rounds) {
+    Result best;
+    best.apply_ns = 1e300;
+    SnapshotLevels bids, asks;
+
+    for (int r = 0; r < rounds; ++r) {
+        BookT book(wl.venue, wl.symbol);
+        Result cur;
+        Clock::duration apply_time{};
+        Clock::duration publish_time{};
+        std::size_t since_publish = 0;
+
+        for (const auto& ev : wl.batch.events()) {
+            const auto t0 = Clock::now();
+            book.apply(wl.batch, ev);
+            const auto t1 = Clock::now();
+            apply_time += (t1 - t0);
+
+            if (++since_publish >= kPublishEvery) {
+                since_publish = 0;
+                const auto p0 = Clock::now();
+                book.copy_snapshot_levels(bids, asks);
+                publish_time += (Clock::now() - p0);
+                ++cur.publishes;
+            }
+        }
+
+        book.copy_snapshot_levels(bids, asks);
+        for (const auto& l : bids) cur.checksum += l.price * l.size;
+        for (const auto& l : asks) cur.checksum += l.price * l.size;
+
+        cur.apply_ns = std::chrono::duration<double, std::nano>(apply_time).count();
+        cur.publish_ns = std::chrono::duration<double, std::nano>(publish_time).count();
+        if (cur.apply_ns + cur.publish_ns < best.apply_ns + best.publish_ns) best = cur;
+    }
+    return best;
+}
+
+// Same workload cut into runs of kDrainEvents events, each applied with one
+// apply_many() call; a publish follows every kPublishEvery events as above.
+std::vector<BookEventBatch> drain_runs(const Workload& wl) {
+    std::vector<BookEventBatch> runs;
+    BookEventBatch one;
+    for (const auto& ev : wl.batch.events()) {
+        if (runs.empty() || runs.back().events().size() == kDrainEvents) runs.emplace_back();
+        one.clear();
+        one.begin(ev.kind, ev.venue, ev.symbol, ev.ts_ns, ev.seq);
+        for (const auto& lvl : wl.batch.levels(ev)) one.add_level(lvl.side, lvl.px, lvl.qty);
+        one.commit();
+        runs.back().append(one);
+    }
+    return runs;
+}
+
+template <class BookT>
+Result run_coalesced(const Workload& wl, const std::vector<BookEventBatch>& runs, int rounds) {
+    Result best;
+    best.apply_ns = 1e300;
+    SnapshotLevels bids, asks;
+    static_assert(kPublishEvery % kDrainEvents == 0);
+
+    for (int r = 0; r < rounds; ++r) {
+        BookT book(wl.venue, wl.symbol);
+        Result cur;
+        Clock::duration apply_time{};
+        Clock::duration publish_time{};
+        std::size_t since_publish = 0;
+
+        for (const auto& run : runs) {
+            const auto t0 = Clock::now();
+            book.apply_many(run);
+            apply_time += (Clock::now() - t0);
+
+            since_publish += run.events().size();
+            if (since_publish >= kPublishEvery) {
+                since_publish = 0;
+                const auto p0 = Clock::now();
+                book.copy_snapshot_levels(bids, asks);
+                publish_time += (Clock::now() - p0);
+                ++cur.publishes;
+            }
+        }
+
+        book.copy_snapshot_levels(bids, asks);
+        for (const auto& l : bids) cur.checksum += l.price * l.size;
+        for (const auto& l : asks) cur.checksum += l.price * l.size;
+
+        cur.apply_ns = std::chrono::duration<double, std::nano>(apply_time).count();
+        cur.publish_ns = std::chrono::duration<double, std::nano>(publish_time).count();
+        if (cur.apply_ns + cur.publish_ns < best.apply_ns + best.publish_ns) best = cur;
+    }
+    return best;
+}
+
+void report(const char* name, const Workload& wl, const Result& r) {
+    std::cout << std::left << std::setw(12) << name
+              << " apply " << std::setw(8) << std::fixed << std::setprecision(1)
+              << (r.apply_ns / static_cast<double>(wl.batch.events().size())) << " ns/event"
+              << "  publish " << std::setw(10)
+              << (r.publishes ? r.publish_ns / static_cast<double>(r.publishes) : 0.0) << " ns/copy"
+              << "  total " << std::setprecision(2) << (r.apply_ns + r.publish_ns) / 1e6 << " ms"
+              << "  checksum " << std::setprecision(4) << r.checksum
+              << std::defaultfloat << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::string mode = argc >= 2 ? argv[1] : "synthetic";
+    Workload wl;
+
+    if (mode == "coinbase" || mode == "kraken") {
+        if (argc < 3) {
+            std::cerr << "usage: bench_book " << mode << " <frames.txt>\n";
+            return 1;
+        }
+        const bool ok = mode == "coinbase"
+            ? load_frames<CoinbaseBookParser>(argv[2], wl)
+            : load_frames<KrakenBookParser>(argv[2], wl);
+        if (!ok) {
+            std::cerr << "no book events parsed from " << argv[2] << "\n";
+            return 1;
+        }
+    } else {
+        const std::size_t n = argc >= 3 ? std::stoul(argv[2]) : 2'000'000;
+        wl = synthetic_workload(n);
+    }
+
+    std::cout << "workload=" << mode << " venue=" << wl.venue << " symbol=" << wl.symbol
+              << " events=" << wl.batch.events().size() << " levels=" << wl.deltas
+              << " publish_every=" << kPublishEvery << "\n";
+
+    constexpr int kRounds = 5;
+    const auto map_res = run<Book>(wl, kRounds);
+    const auto flat_res = run<FlatBook>(wl, kRounds);
+
+    const auto runs = drain_runs(wl);
+    const auto map_co = run_coalesced<Book>(wl, runs, kRounds);
+    const auto flat_co = run_coalesced<FlatBook>(wl, runs, kRounds);
+
+    report("Book", wl, map_res);
+    report("FlatBook", wl, flat_res);
+    report("Book x8", wl, map_co);
+    report("FlatBook x8", wl, flat_co);
+
+    if (map_res.checksum != flat_res.checksum ||
+        map_co.checksum != map_res.checksum || flat_co.checksum != flat_res.checksum) {
+        std::cerr << "WARNING: final book state differs between engines\n";
+        return 2;
+    }
+    return 0;
+}
+
+/*
+Build:
+
+cd backend
+BOOST_PREFIX=$(brew --prefix boost)
+SIMDJSON_PREFIX=$(brew --prefix simdjson)
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  src/md/symbol_codec.cpp \
+  bench/bench_book.cpp \
+  -I src -I"$SIMDJSON_PREFIX/include" \
+  -L"$SIMDJSON_PREFIX/lib" -lsimdjson \
+  -Wl,-rpath,"$SIMDJSON_PREFIX/lib" \
+  -o build/bench_book
+
+# Record frames first (Ctrl-C after a while), then replay:
+./build/test_ws_coinbase > frames_coinbase.txt
+./build/bench_book coinbase frames_coinbase.txt
+./build/bench_book synthetic 2000000
+*/
@@ -0,0 +1,242 @@
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "md/book.hpp"
+#include "md/book_checksum.hpp"
+#include "md/flat_book.hpp"
+#include "util/crc32.hpp"
+#include "venues/kraken/parser.hpp"
+#include "venues/okx/parser.hpp"
+
+// Microbenchmark: per-message cost of venue book checksum verification.
+// Applies a synthetic top-of-book delta stream and, after every message,
+// recomputes the Kraken (top 10, fixed precision) and OKX (top 25, shortest
+// decimals) checksums the way VenueFeed does. Also times CRC-32 alone on the
+// table path vs the hardware path for the same input sizes.
+// With recorded frames (raw WS JSON, one per line) it replays them through the
+// parser and book and reports how many venue checksums matched. Kraken also
+// needs the pair's instrument metadata (REST AssetPairs body) for its precision.
+//
+// Usage:
+//   bench_checksum [messages]
+//   bench_checksum kraken frames_kraken.txt asset_pairs.json
+//   bench_checksum okx    frames_okx.txt
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Random walk near the touch, like bench_book's synthetic workload.
+BookEventBatch synthetic_stream(std::size_t n_events) {
+    BookEventBatch batch;
+    const md::VenueId venue = md::venue_ids().intern("Synthetic");
+    const md::SymbolId symbol = md::symbol_ids().intern("BTC-USD");
+    std::mt19937_64 rng(7);
+    std::geometric_distribution<int> depth_dist(0.15);
+    std::uniform_int_distribution<md::SizeLots> size_dist(1, 20 * md::kSizeScale);
+    std::bernoulli_distribution delete_dist(0.3);
+    const md::PriceTicks tick = md::kPriceScale / 10; // 0.1, Kraken BTC/USD precision
+    md::PriceTicks mid = 60000 * md::kPriceScale;
+
+    batch.begin(BookEventKind::Snapshot, venue, symbol, 0);
+    for (int i = 1; i <= 1000; ++i) {
+        batch.add_level(BookSide::Bid, mid - i * tick, size_dist(rng));
+        batch.add_level(BookSide::Ask, mid + i * tick, size_dist(rng));
+    }
+    batch.commit();
+    for (std::size_t i = 0; i < n_events; ++i) {
+        if ((i & 0xff) == 0) mid += (rng() & 1 ? tick : -tick);
+        const bool bid = rng() & 1;
+        const int k = 1 + std::min(depth_dist(rng), 999);
+        batch.begin(BookEventKind::Delta, venue, symbol, 0);
+        batch.add_level(bid ? BookSide::Bid : BookSide::Ask,
+                        bid ? mid - k * tick : mid + k * tick,
+                        delete_dist(rng) ? 0 : size_dist(rng));
+        batch.commit();
+    }
+    return batch;
+}
+
+struct CheckCost {
+    double apply_ns{0.0};
+    double verify_ns{0.0};
+    double bytes{0.0};
+    std::uint32_t fold{0}; // keeps the checksums observable
+};
+
+template <class BookT>
+CheckCost run_verify(const BookEventBatch& batch, const md::ChecksumRule& rule) {
+    BookT book("Synthetic", "BTC-USD");
+    CheckCost c;
+    Clock::duration apply{}, verify{};
+    char buf[md::kChecksumBufferSize];
+    std::size_t bytes = 0;
+    for (const auto& ev : batch.events()) {
+        const auto t0 = Clock::now();
+        book.apply(batch, ev);
+        const auto t1 = Clock::now();
+        c.fold ^= md::book_checksum(book, rule);
+        verify += Clock::now() - t1;
+        apply += t1 - t0;
+        bytes += md::format_checksum_input(book, rule, buf);
+    }
+    const auto n = static_cast<double>(batch.events().size());
+    c.apply_ns = std::chrono::duration<double, std::nano>(apply).count() / n;
+    c.verify_ns = std::chrono::duration<double, std::nano>(verify).count() / n;
+    c.bytes = static_cast<double>(bytes) / n;
+    return c;
+}
+
+template <class F>
+double time_crc(const std::string& input, std::size_t iters, F&& crc) {
+    std::uint32_t fold = 0;
+    const auto t0 = Clock::now();
+    for (std::size_t i = 0; i < iters; ++i) fold ^= crc(input.data(), input.size(), fold);
+    const auto ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+    if (fold == 0x12345678u) std::cout << ""; // defeat dead-code elimination
+    return ns / static_cast<double>(iters);
+}
+
+bool self_check() {
+    if (util::crc32("123456789", 9) != 0xCBF43926u) {
+        std::cerr << "crc32 check value mismatch\n";
+        return false;
+    }
+    std::mt19937 rng(1);
+    std::string buf;
+    for (std::size_t n = 0; n < 4096; ++n) {
+        buf.push_back(static_cast<char>(rng()));
+        if (util::crc32(buf.data(), n) != util::crc32_portable(buf.data(), n)) {
+            std::cerr << "crc32 hardware/table mismatch at length " << n << "\n";
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class ParserT>
+int replay(const std::string& path, const std::string& instrument_path) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open " << path << "\n";
+        return 1;
+    }
+    ParserT parser;
+    if (!instrument_path.empty()) {
+        std::ifstream info_in(instrument_path);
+        const std::string info((std::istreambuf_iterator<char>(info_in)), std::istreambuf_iterator<char>());
+        if (!parser.parse_instrument_info(info)) {
+            std::cerr << "cannot read instrument metadata from " << instrument_path << "\n";
+            return 1;
+        }
+    }
+    BookEventBatch evs;
+    std::unique_ptr<Book> book;
+    std::size_t checked = 0, matched = 0;
+    Clock::duration verify{};
+    std::string line;
+    while (std::getline(in, line)) {
+        evs.clear();
+        if (!parser.parse(line, evs) || evs.empty()) continue;
+        const auto& last = evs.events().back();
+        if (!book) {
+            book = std::make_unique<Book>(std::string(md::venue_ids().name(last.venue)),
+                                          std::string(md::symbol_ids().name(last.symbol)));
+        }
+        book->apply_many(evs);
+        const md::ChecksumRule* rule = parser.checksum_rule();
+        if (!last.has_checksum || !rule) continue;
+        const auto t0 = Clock::now();
+        const bool ok = md::book_checksum(*book, *rule) == last.checksum;
+        verify += Clock::now() - t0;
+        ++checked;
+        matched += ok;
+    }
+    std::cout << "frames checked=" << checked << " matched=" << matched << " verify "
+              << std::fixed << std::setprecision(1)
+              << (checked ? std::chrono::duration<double, std::nano>(verify).count() / checked : 0.0)
+              << " ns/msg" << std::defaultfloat << "\n";
+    return checked == matched ? 0 : 2;
+}
+
+void report(const char* name, const CheckCost& c) {
+    std::cout << std::left << std::setw(18) << name << std::fixed << std::setprecision(1)
+              << " apply " << std::setw(7) << c.apply_ns << " ns/msg"
+              << "  verify " << std::setw(7) << c.verify_ns << " ns/msg"
+              << "  input " << std::setprecision(0) << c.bytes << " B"
+              << std::defaultfloat << "\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!self_check()) return 2;
+
+    const std::string mode = argc >= 2 ? argv[1] : "";
+    if (mode == "kraken" || mode == "okx") {
+        if (argc < (mode == "kraken" ? 4 : 3)) {
+            std::cerr << "usage: bench_checksum " << mode << " <frames.txt>"
+                      << (mode == "kraken" ? " <asset_pairs.json>" : "") << "\n";
+            return 1;
+        }
+        return mode == "kraken" ? replay<KrakenBookParser>(argv[2], argv[3]) : replay<OkxBookParser>(argv[2], "");
+    }
+
+    const std::size_t n = argc >= 2 ? std::stoul(argv[1]) : 1'000'000;
+    const auto batch = synthetic_stream(n);
+    const md::ChecksumRule kraken{md::ChecksumStyle::Kraken, 10, 1, 8};
+    const md::ChecksumRule okx{md::ChecksumStyle::Okx, 25, 0, 0};
+
+    std::cout << "messages=" << batch.events().size()
+              << " crc32 path=" << (util::crc32_hardware() ? "hardware" : "table") << "\n";
+    report("kraken Book", run_verify<Book>(batch, kraken));
+    report("kraken FlatBook", run_verify<FlatBook>(batch, kraken));
+    report("okx Book", run_verify<Book>(batch, okx));
+    report("okx FlatBook", run_verify<FlatBook>(batch, okx));
+
+    // CRC alone over inputs of the two venues' typical sizes.
+    std::cout << "\ncrc32 only\n";
+    for (std::size_t len : {64, 256, 512, 1024, 2048}) {
+        std::string input(len, '7');
+        const std::size_t iters = 20'000'000 / len;
+        const double table_ns = time_crc(input, iters, [](const void* p, std::size_t k, std::uint32_t s) {
+            return util::crc32_portable(p, k, s);
+        });
+        const double fast_ns = time_crc(input, iters, [](const void* p, std::size_t k, std::uint32_t s) {
+            return util::crc32(p, k, s);
+        });
+        std::cout << std::setw(6) << len << " B  table " << std::fixed << std::setprecision(1)
+                  << std::setw(7) << table_ns << " ns  crc32() " << std::setw(7) << fast_ns << " ns"
+                  << std::defaultfloat << "\n";
+    }
+    return 0;
+}
+
+/*
+Build:
+
+cd backend
+SIMDJSON_PREFIX=$(brew --prefix simdjson)
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  src/md/symbol_codec.cpp \
+  bench/bench_checksum.cpp \
+  -I src -I"$SIMDJSON_PREFIX/include" \
+  -L"$SIMDJSON_PREFIX/lib" -lsimdjson \
+  -Wl,-rpath,"$SIMDJSON_PREFIX/lib" \
+  -o build/bench_checksum
+
+./build/bench_checksum 1000000
+# Recorded frames (e.g. test_ws_kraken output) must include the snapshot:
+curl -s 'https://api.kraken.com/0/public/AssetPairs?pair=XBTUSD' > asset_pairs.json
+./build/bench_checksum kraken frames_kraken.txt asset_pairs.json
+*/
@@ -0,0 +1,199 @@
+#include <boost/asio/connect.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/http.hpp>
+#include <boost/beast/ssl.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Load test for the HTTPS server: closed-loop clients, each on one keep-alive
+// TLS connection, issue requests back to back at increasing concurrency and
+// report throughput and p50/p99 latency per endpoint.
+// - book:   GET /api/book?symbol=<symbol>            (in-memory, I/O thread)
+// - orders: GET /api/orders?user_id=<user_id>         (database, worker pool)
+// - mixed:  half the clients on /api/book, half keep /api/orders busy until
+//           they finish; reports /api/book only, i.e. whether heavy requests
+//           stall cheap ones.
+// Certificates are not verified (point it at your own server).
+//
+// Usage:
+//   bench_http_load [host] [port] [requests_per_client] [symbol] [user_id]
+
+namespace {
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace net = boost::asio;
+namespace ssl = net::ssl;
+using tcp = net::ip::tcp;
+using Clock = std::chrono::steady_clock;
+
+struct Target {
+    std::string host;
+    std::string port;
+    std::string book_path;
+    std::string orders_path;
+};
+
+struct Samples {
+    std::vector<std::int64_t> book_ns;
+    std::vector<std::int64_t> orders_ns;
+    std::uint64_t non_ok{0};
+    std::uint64_t failed_clients{0};
+};
+
+// One client: a connection reused for every request. With `until`, keeps
+// going until it is set instead of stopping after `requests`.
+void run_client(const Target& t, const std::string& path, std::size_t requests,
+                const std::atomic<bool>* until, std::vector<std::int64_t>& out, std::uint64_t& non_ok) {
+    net::io_context ioc;
+    ssl::context ctx{ssl::context::tls_client};
+    ctx.set_verify_mode(ssl::verify_none);
+    beast::ssl_stream<beast::tcp_stream> stream(ioc, ctx);
+    SSL_set_tlsext_host_name(stream.native_handle(), t.host.c_str());
+
+    tcp::resolver resolver(ioc);
+    beast::get_lowest_layer(stream).connect(resolver.resolve(t.host, t.port));
+    stream.handshake(ssl::stream_base::client);
+
+    http::request<http::empty_body> req{http::verb::get, path, 11};
+    req.set(http::field::host, t.host);
+    req.keep_alive(true);
+
+    beast::flat_buffer buffer;
+    for (std::size_t i = 0; until ? !until->load(std::memory_order_relaxed) : i < requests; ++i) {
+        const auto t0 = Clock::now();
+        http::write(stream, req);
+        http::response<http::string_body> res;
+        http::read(stream, buffer, res);
+        out.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+        if (res.result() != http::status::ok) ++non_ok;
+        if (!res.keep_alive()) break;
+    }
+
+    beast::error_code ec;
+    stream.shutdown(ec); // peers often skip close_notify; ignore
+}
+
+// Runs `book_clients` + `orders_clients` concurrently and merges their samples.
+// `background_orders`: orders clients run until the book clients are done.
+Samples run_level(const Target& t, std::size_t book_clients, std::size_t orders_clients, std::size_t requests,
+                  bool background_orders = false) {
+    Samples all;
+    std::mutex mu;
+    std::atomic<bool> book_done{false};
+    std::vector<std::thread> threads;
+    std::vector<std::thread> background;
+    for (std::size_t i = 0; i < book_clients + orders_clients; ++i) {
+        const bool book = i < book_clients;
+        auto& group = (!book && background_orders) ? background : threads;
+        group.emplace_back([&, book] {
+            std::vector<std::int64_t> lat;
+            lat.reserve(requests);
+            std::uint64_t non_ok = 0;
+            bool failed = false;
+            try {
+                run_client(t, book ? t.book_path : t.orders_path, requests,
+                           (!book && background_orders) ? &book_done : nullptr, lat, non_ok);
+            } catch (const std::exception& e) {
+                failed = true;
+                std::lock_guard<std::mutex> lk(mu);
+                if (all.failed_clients == 0) std::cerr << "  client error: " << e.what() << "\n";
+            }
+            std::lock_guard<std::mutex> lk(mu);
+            auto& dst = book ? all.book_ns : all.orders_ns;
+            dst.insert(dst.end(), lat.begin(), lat.end());
+            all.non_ok += non_ok;
+            if (failed) ++all.failed_clients;
+        });
+    }
+    for (auto& th : threads) th.join();
+    book_done.store(true, std::memory_order_relaxed);
+    for (auto& th : background) th.join();
+    return all;
+}
+
+void print_row(const std::string& name, std::size_t concurrency, std::vector<std::int64_t>& lat, double secs,
+               const Samples& s) {
+    std::cout << std::left << std::setw(8) << name << std::right << std::setw(6) << concurrency;
+    if (lat.empty()) {
+        std::cout << "  (no responses)\n";
+        return;
+    }
+    std::sort(lat.begin(), lat.end());
+    auto pct_us = [&](double p) {
+        return static_cast<double>(lat[static_cast<std::size_t>(p * static_cast<double>(lat.size() - 1))]) / 1e3;
+    };
+    std::cout << std::fixed << std::setprecision(0)
+              << std::setw(10) << static_cast<double>(lat.size()) / secs << " req/s"
+              << std::setprecision(1)
+              << "  p50=" << std::setw(8) << pct_us(0.50) << "us"
+              << "  p99=" << std::setw(8) << pct_us(0.99) << "us";
+    if (s.non_ok > 0) std::cout << "  non-200=" << s.non_ok;
+    if (s.failed_clients > 0) std::cout << "  failed_clients=" << s.failed_clients;
+    std::cout << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Target t;
+    t.host = argc > 1 ? argv[1] : "127.0.0.1";
+    t.port = argc > 2 ? argv[2] : "8443";
+    const std::size_t requests = argc > 3 ? std::stoull(argv[3]) : 200;
+    const std::string symbol = argc > 4 ? argv[4] : "BTC-USD";
+    const std::string user_id = argc > 5 ? argv[5] : "00000000-0000-0000-0000-000000000000";
+    t.book_path = "/api/book?symbol=" + symbol;
+    t.orders_path = "/api/orders?user_id=" + user_id;
+
+    const std::size_t levels[] = {1, 2, 4, 8, 16, 32, 64};
+
+    std::cout << "https://" << t.host << ":" << t.port << ", " << requests << " requests per client\n";
+    std::cout << "endpoint  conc    throughput        latency\n";
+    for (std::size_t c : levels) {
+        const auto t0 = Clock::now();
+        Samples s = run_level(t, c, 0, requests);
+        print_row("book", c, s.book_ns, std::chrono::duration<double>(Clock::now() - t0).count(), s);
+    }
+    for (std::size_t c : levels) {
+        const auto t0 = Clock::now();
+        Samples s = run_level(t, 0, c, requests);
+        print_row("orders", c, s.orders_ns, std::chrono::duration<double>(Clock::now() - t0).count(), s);
+    }
+    // book latency with as many orders clients hammering the workers
+    for (std::size_t c : levels) {
+        if (c < 2) continue;
+        const auto t0 = Clock::now();
+        Samples s = run_level(t, c / 2, c / 2, requests, true);
+        print_row("mixed", c, s.book_ns, std::chrono::duration<double>(Clock::now() - t0).count(), s);
+    }
+    return 0;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+BOOST_PREFIX=$(brew --prefix boost)
+OPENSSL_PREFIX=$(brew --prefix openssl@3)
+
+clang++ -std=c++20 -O3 -Wall -Wextra -pthread \
+  bench/bench_http_load.cpp \
+  -I"$BOOST_PREFIX/include" -I"$OPENSSL_PREFIX/include" \
+  -L"$OPENSSL_PREFIX/lib" -lssl -lcrypto \
+  -o build/bench_http_load
+
+# against a running server (HTTPS_IO_THREADS / HTTPS_WORKERS to compare modes)
+./build/bench_http_load 127.0.0.1 8443 200 BTC-USD <user-uuid>
+*/
@@ -0,0 +1,187 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "md/fixed_point.hpp"
+#include "util/json_writer.hpp"
+
+// Microbenchmark: encoding a consolidated /api/book body.
+// - ostringstream: the previous encoder (json_escape + operator<< with
+//   setprecision(15) per double).
+// - JsonWriter:    util/json_writer.hpp into a reused std::string, doubles
+//   via to_chars, ladder prices/sizes via decimal() from PriceTicks/SizeLots.
+// Both bodies are checked to carry the same numbers. Reports ns per body and
+// MB/s of JSON produced.
+//
+// Usage:
+//   bench_json [depth] [iterations]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Level {
+    std::string venue;
+    double price;
+    double size;
+    md::PriceTicks px;
+    md::SizeLots qty;
+};
+
+std::vector<Level> make_side(std::mt19937_64& rng, bool bids, std::size_t depth) {
+    static const char* const kVenues[] = {"Coinbase", "Kraken", "OKX", "Binance"};
+    constexpr md::PriceTicks kTick = md::kPriceScale / 100;
+    md::PriceTicks px = 60'000 * md::kPriceScale;
+    std::vector<Level> out;
+    for (std::size_t i = 0; i < depth; ++i) {
+        px += (bids ? -kTick : kTick) * static_cast<md::PriceTicks>(1 + rng() % 3);
+        const md::SizeLots qty = static_cast<md::SizeLots>(1 + rng() % (5 * md::kSizeScale));
+        out.push_back(Level{kVenues[rng() % 4], md::price_to_double(px), md::size_to_double(qty), px, qty});
+    }
+    return out;
+}
+
+std::string old_escape(std::string_view s) {
+    std::string out;
+    out.reserve(s.size() + 8);
+    for (char c : s) {
+        switch (c) {
+            case '\\': out += "\\\\"; break;
+            case '"':  out += "\\\""; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            default:   out += c;      break;
+        }
+    }
+    return out;
+}
+
+void old_ladder(std::ostringstream& os, const std::vector<Level>& rows) {
+    os << "[";
+    bool first = true;
+    for (const auto& lvl : rows) {
+        if (!first) os << ",";
+        first = false;
+        os << "{"
+           << "\"price\":" << std::setprecision(15) << lvl.price << ","
+           << "\"size\":" << std::setprecision(15) << lvl.size << ","
+           << "\"venue\":\"" << old_escape(lvl.venue) << "\""
+           << "}";
+    }
+    os << "]";
+}
+
+std::string encode_stream(const std::vector<Level>& bids, const std::vector<Level>& asks) {
+    std::ostringstream os;
+    os << "{\"status\":{\"code\":200,\"message\":\"OK\"},";
+    os << "\"last_updated_ms\":" << 1'760'000'000'000LL << ",";
+    os << "\"symbol\":\"" << old_escape("BTC-USD") << "\",";
+    os << "\"venues\":[\"Coinbase\",\"Kraken\",\"OKX\",\"Binance\"],";
+    os << "\"bids\":"; old_ladder(os, bids); os << ",";
+    os << "\"asks\":"; old_ladder(os, asks);
+    os << "}";
+    return os.str();
+}
+
+void write_ladder(JsonWriter& w, const std::vector<Level>& rows) {
+    w.begin_array();
+    for (const auto& lvl : rows) {
+        w.begin_object()
+            .key("price").decimal(lvl.px, md::kPriceDecimals)
+            .key("size").decimal(lvl.qty, md::kSizeDecimals)
+            .field("venue", lvl.venue)
+            .end_object();
+    }
+    w.end_array();
+}
+
+void encode_writer(const std::vector<Level>& bids, const std::vector<Level>& asks, std::string& out) {
+    out.clear();
+    JsonWriter w(out);
+    w.begin_object();
+    w.key("status").begin_object().field("code", 200).field("message", "OK").end_object();
+    w.field("last_updated_ms", std::int64_t{1'760'000'000'000});
+    w.field("symbol", "BTC-USD");
+    w.key("venues").begin_array().value("Coinbase").value("Kraken").value("OKX").value("Binance").end_array();
+    w.key("bids"); write_ladder(w, bids);
+    w.key("asks"); write_ladder(w, asks);
+    w.end_object();
+}
+
+// Every number in both bodies, parsed back.
+std::vector<double> numbers(const std::string& json) {
+    std::vector<double> out;
+    for (std::size_t i = 0; i < json.size();) {
+        if (json[i] == ':' && i + 1 < json.size() && (json[i + 1] == '-' || (json[i + 1] >= '0' && json[i + 1] <= '9'))) {
+            std::size_t used = 0;
+            out.push_back(std::stod(json.substr(i + 1, 32), &used));
+            i += 1 + used;
+        } else {
+            ++i;
+        }
+    }
+    return out;
+}
+
+template <class Fn>
+double time_ns(std::size_t iterations, Fn&& fn) {
+    const auto t0 = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(iterations);
+}
+
+void report(const std::string& name, double ns, std::size_t bytes, const std::string& note = {}) {
+    std::cout << "  " << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << ns << " ns/body" << std::setprecision(1) << std::setw(9)
+              << static_cast<double>(bytes) * 1e3 / ns << " MB/s" << note << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t max_depth = argc > 1 ? std::stoull(argv[1]) : 1000;
+    const std::size_t base_iterations = argc > 2 ? std::stoull(argv[2]) : 200'000;
+
+    std::mt19937_64 rng(42);
+    std::string out;
+
+    for (std::size_t depth : {std::size_t{10}, std::size_t{100}, max_depth}) {
+        const auto bids = make_side(rng, true, depth);
+        const auto asks = make_side(rng, false, depth);
+        const std::size_t iterations = std::max<std::size_t>(base_iterations / depth, 100);
+
+        const std::string ref = encode_stream(bids, asks);
+        encode_writer(bids, asks, out);
+        const bool ok = numbers(ref) == numbers(out);
+
+        std::cout << "depth " << depth << " (" << ref.size() << " / " << out.size() << " bytes)\n";
+        std::string body;
+        report("ostringstream", time_ns(iterations, [&] { body = encode_stream(bids, asks); }), ref.size());
+        report("JsonWriter", time_ns(iterations, [&] { encode_writer(bids, asks, out); }), out.size(),
+               ok ? "" : "  MISMATCH");
+    }
+    return 0;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  bench/bench_json.cpp \
+  -I src \
+  -o build/bench_json
+
+./build/bench_json
+./build/bench_json 5000
+*/
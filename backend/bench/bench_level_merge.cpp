@@ -0,0 +1,170 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <queue>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "md/level_merge.hpp"
+#include "synthetic_books.hpp"
+
+// Microbenchmark: consolidating K venues' best-first book sides into one ladder.
+// - sort:       flatten every venue's top `depth` levels, then std::sort (the
+//               previous UIMasterFeed::snapshot_consolidated).
+// - heap:       std::priority_queue over the venue heads (the router sweep).
+// - tournament: md::LevelMerger (loser tree), plain and with same-price
+//               aggregation.
+// Inputs are SnapshotLevels as published by VenueFeed, venues quoting on a
+// shared tick grid so equal prices across venues are common. Reports ns per
+// merge and per output row; outputs of sort/heap/tournament are cross-checked.
+//
+// Usage:
+//   bench_level_merge [venues] [iterations]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using Iter = SnapshotLevels::const_iterator;
+
+struct Row {
+    md::PriceTicks px;
+    md::SizeLots qty;
+    std::uint32_t venue;
+};
+
+bool better(BookSide side, const Row& a, const Row& b) {
+    if (a.px != b.px) return side == BookSide::Bid ? a.px > b.px : a.px < b.px;
+    if (a.qty != b.qty) return a.qty > b.qty;
+    return a.venue < b.venue;
+}
+
+void merge_sort(BookSide side, const std::vector<SnapshotLevels>& books, std::size_t depth, std::vector<Row>& out) {
+    out.clear();
+    for (std::uint32_t v = 0; v < books.size(); ++v) {
+        std::size_t taken = 0;
+        for (const auto& lvl : books[v]) {
+            if (taken++ >= depth) break;
+            out.push_back(Row{lvl.px, lvl.qty, v});
+        }
+    }
+    std::sort(out.begin(), out.end(), [side](const Row& a, const Row& b) { return better(side, a, b); });
+}
+
+void merge_heap(BookSide side, const std::vector<SnapshotLevels>& books, std::size_t depth, std::vector<Row>& out) {
+    out.clear();
+    struct Cursor {
+        Iter it, end;
+        std::size_t left;
+    };
+    std::vector<Cursor> cursors;
+    auto worse = [side](const Row& a, const Row& b) { return better(side, b, a); };
+    std::priority_queue<Row, std::vector<Row>, decltype(worse)> heap(worse);
+    for (std::uint32_t v = 0; v < books.size(); ++v) {
+        cursors.push_back(Cursor{books[v].begin(), books[v].end(), depth});
+        auto& c = cursors.back();
+        if (c.it != c.end && c.left > 0) {
+            const auto lvl = *c.it;
+            heap.push(Row{lvl.px, lvl.qty, v});
+        }
+    }
+    while (!heap.empty()) {
+        const Row top = heap.top();
+        heap.pop();
+        out.push_back(top);
+        auto& c = cursors[top.venue];
+        ++c.it;
+        if (--c.left > 0 && c.it != c.end) {
+            const auto lvl = *c.it;
+            heap.push(Row{lvl.px, lvl.qty, top.venue});
+        }
+    }
+}
+
+void merge_tournament(md::LevelMerger<Iter>& merger, BookSide side, const std::vector<SnapshotLevels>& books,
+                      std::size_t depth, bool aggregate, std::vector<Row>& out) {
+    out.clear();
+    merger.reset(side);
+    for (const auto& b : books) merger.add(b.begin(), b.end());
+    md::LevelMergeOptions opts;
+    opts.per_source_depth = depth;
+    opts.aggregate = aggregate;
+    merger.run(opts, [&](const md::MergedLevel& m) { out.push_back(Row{m.level.px, m.level.qty, m.source}); });
+}
+
+bool same(const std::vector<Row>& a, const std::vector<Row>& b) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Row& x, const Row& y) {
+        return x.px == y.px && x.qty == y.qty && x.venue == y.venue;
+    });
+}
+
+template <class Fn>
+double time_ns(std::size_t iterations, Fn&& fn) {
+    const auto t0 = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(iterations);
+}
+
+void report(const std::string& name, double ns, std::size_t rows, const std::string& note = {}) {
+    std::cout << "  " << std::left << std::setw(20) << name << std::right << std::fixed << std::setprecision(0)
+              << std::setw(10) << ns << " ns/merge" << std::setprecision(2) << std::setw(8)
+              << ns / static_cast<double>(std::max<std::size_t>(rows, 1)) << " ns/row" << note << "\n";
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t venues = argc > 1 ? std::stoull(argv[1]) : 4;
+    const std::size_t base_iterations = argc > 2 ? std::stoull(argv[2]) : 200'000;
+
+    std::mt19937_64 rng(42);
+    md::LevelMerger<Iter> merger;
+    std::vector<Row> ref, got;
+
+    std::cout << venues << " venues, bids\n";
+    for (std::size_t depth : {std::size_t{10}, std::size_t{100}, std::size_t{1000}}) {
+        std::vector<SnapshotLevels> books;
+        for (std::size_t v = 0; v < venues; ++v) books.push_back(bench::make_side(rng, BookSide::Bid, depth, 5 * md::kSizeScale));
+        const std::size_t iterations = std::max<std::size_t>(base_iterations / depth, 100);
+
+        merge_sort(BookSide::Bid, books, depth, ref);
+        merge_heap(BookSide::Bid, books, depth, got);
+        const bool heap_ok = same(ref, got);
+        merge_tournament(merger, BookSide::Bid, books, depth, false, got);
+        const bool tour_ok = same(ref, got);
+        merge_tournament(merger, BookSide::Bid, books, depth, true, got);
+        const std::size_t agg_rows = got.size();
+
+        std::cout << "depth " << depth << " (" << ref.size() << " rows, " << agg_rows << " prices)\n";
+        report("sort", time_ns(iterations, [&] { merge_sort(BookSide::Bid, books, depth, ref); }), ref.size());
+        report("heap", time_ns(iterations, [&] { merge_heap(BookSide::Bid, books, depth, got); }), ref.size(),
+               heap_ok ? "" : "  MISMATCH");
+        report("tournament",
+               time_ns(iterations, [&] { merge_tournament(merger, BookSide::Bid, books, depth, false, got); }),
+               ref.size(), tour_ok ? "" : "  MISMATCH");
+        report("tournament+aggregate",
+               time_ns(iterations, [&] { merge_tournament(merger, BookSide::Bid, books, depth, true, got); }),
+               agg_rows);
+    }
+    return 0;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  bench/bench_level_merge.cpp \
+  -I src \
+  -o build/bench_level_merge
+
+./build/bench_level_merge
+./build/bench_level_merge 8
+*/
@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "md/capture_log.hpp"
+#include "md/symbol_codec.hpp"
+#include "md/venue_feed.hpp"
+#include "router/router_framework.hpp"
+#include "venues/binance/parser.hpp"
+#include "venues/coinbase/parser.hpp"
+#include "venues/kraken/parser.hpp"
+#include "venues/okx/parser.hpp"
+#include "venues/replay_ws.hpp"
+#include "synthetic_books.hpp"
+
+// Router benchmark and regression harness: every RouterVersionId over a grid
+// of side x order size x market/limit, on one frozen set of BookSnapshots.
+// - Books: synthetic (--venues, --depth, --spread-bps, --seed), or the final
+//   books of a capture log (--capture, FEED_CAPTURE_PATH on the server)
+//   replayed through VenueFeed<ReplayWs, Parser>.
+// - Per route: ns, heap allocations (global operator new) and a checksum of
+//   the decision (venues, quantities, prices rounded to 1e-8 / 1e-6). Routes
+//   reuse one RoutingContext and RoutingDecision, as a steady-state caller would.
+// - `same` names the first version that made the same decision for a row,
+//   so strategy differences between versions are visible at a glance.
+// - --out writes the rows as TSV; --baseline compares against such a file
+//   from an earlier commit and flags changed decisions and slowdowns; the
+//   exit status is 2 when any decision changed.
+//
+// Usage:
+//   bench_router [--venues N] [--depth N] [--spread-bps X] [--seed N]
+//                [--capture file [--symbol BTC-USD]]
+//                [--iterations N] [--out file.tsv] [--baseline file.tsv]
+//                [--slower 1.25]
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocs{0};
+
+} // namespace
+
+// Out of line so the compiler never pairs an inlined malloc with a delete.
+[[gnu::noinline]] void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+constexpr int kRepeats = 5;
+
+struct Options {
+    std::size_t venues{4};
+    std::size_t depth{1000};
+    double spread_bps{1.0};
+    std::uint64_t seed{1};
+    std::string capture;
+    std::string symbol;
+    std::size_t iterations{0}; // 0 = scaled by book size
+    std::string out;
+    std::string baseline;
+    double slower{1.25};
+};
+
+// -------- books --------
+
+// Venues quote around a common mid on a 0.01 grid; each venue's touch sits
+// a random 0..spread_bps away from the mid.
+std::vector<std::shared_ptr<const BookSnapshot>> synthetic_books(const Options& o) {
+    static const char* const kNames[] = {"Coinbase", "Kraken", "OKX", "Binance"};
+    constexpr md::PriceTicks kTick = md::kPriceScale / 100;
+    constexpr md::PriceTicks kMid = 60'000 * md::kPriceScale;
+    std::mt19937_64 rng(o.seed);
+    std::vector<std::shared_ptr<const BookSnapshot>> books;
+    for (std::size_t v = 0; v < o.venues; ++v) {
+        auto snap = std::make_shared<BookSnapshot>();
+        snap->venue = v < 4 ? kNames[v] : "Venue" + std::to_string(v);
+        snap->symbol = "BTC-USD";
+        snap->seq = v + 1;
+        const double half = o.spread_bps * 1e-4 * 60'000.0 * std::uniform_real_distribution<>(0.0, 1.0)(rng);
+        const md::PriceTicks offset = std::max<md::PriceTicks>(1, static_cast<md::PriceTicks>(half * 100.0)) * kTick;
+        for (BookSide side : {BookSide::Bid, BookSide::Ask}) {
+            std::vector<std::pair<md::PriceTicks, md::SizeLots>> rows;
+            md::PriceTicks px = side == BookSide::Bid ? kMid - offset : kMid + offset;
+            for (std::size_t i = 0; i < o.depth; ++i) {
+                rows.emplace_back(px, static_cast<md::SizeLots>(1 + rng() % (2 * md::kSizeScale)));
+                const md::PriceTicks step = kTick * static_cast<md::PriceTicks>(1 + rng() % 3);
+                px += side == BookSide::Bid ? -step : step;
+            }
+            (side == BookSide::Bid ? snap->bids : snap->asks) = bench::build_side(side, rows);
+        }
+        books.push_back(std::move(snap));
+    }
+    return books;
+}
+
+template <typename ParserT>
+std::shared_ptr<IVenueFeed> make_feed(const std::string& venue, const std::string& canonical) {
+    return std::make_shared<VenueFeed<ReplayWs, ParserT>>(venue, canonical, Backpressure::Block);
+}
+
+std::shared_ptr<IVenueFeed> make_replay_feed(const std::string& venue, const std::string& canonical) {
+    if (venue == "Binance")  return make_feed<BinanceBookParser>(venue, canonical);
+    if (venue == "Coinbase") return make_feed<CoinbaseBookParser>(venue, canonical);
+    if (venue == "Kraken")   return make_feed<KrakenBookParser>(venue, canonical);
+    if (venue == "OKX")      return make_feed<OkxBookParser>(venue, canonical);
+    return nullptr;
+}
+
+// Final books of every stream of `symbol` (default: the symbol with the most venues).
+std::vector<std::shared_ptr<const BookSnapshot>> capture_books(const Options& o) {
+    auto log = std::make_shared<const md::CaptureLog>(o.capture);
+    std::map<std::pair<std::string, std::string>, std::uint64_t> streams;
+    md::CapturedFrame rec;
+    for (std::size_t off = log->first(); log->read(off, rec); off = log->next(off)) {
+        ++streams[{std::string(rec.venue), std::string(rec.symbol)}];
+    }
+    ReplayWs::load(log, ReplayOptions{0.0});
+
+    std::vector<std::shared_ptr<IVenueFeed>> feeds;
+    std::uint64_t expected = 0;
+    for (const auto& [stream, frames] : streams) {
+        const auto& [venue, venue_symbol] = stream;
+        auto feed = make_replay_feed(venue, SymbolCodec::to_canonical(venue, venue_symbol));
+        if (!feed) continue;
+        feed->start_ws(venue_symbol);
+        feeds.push_back(std::move(feed));
+        expected += frames;
+    }
+    while (ReplayWs::frames_replayed() < expected) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    for (std::int64_t last = -1;;) {
+        std::int64_t now = 0;
+        for (const auto& f : feeds) now = std::max(now, f->last_book_update_ns());
+        if (now == last) break;
+        last = now;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    }
+
+    std::map<std::string, std::vector<std::shared_ptr<const BookSnapshot>>> by_symbol;
+    for (const auto& f : feeds) {
+        auto snap = f->load_snapshot();
+        if (snap && !snap->bids.empty() && !snap->asks.empty()) by_symbol[f->canonical()].push_back(std::move(snap));
+        f->stop();
+    }
+    if (!o.symbol.empty()) return by_symbol[o.symbol];
+    std::vector<std::shared_ptr<const BookSnapshot>> best;
+    for (auto& [symbol, books] : by_symbol) {
+        if (books.size() > best.size()) best = std::move(books);
+    }
+    return best;
+}
+
+// -------- routing grid --------
+
+struct Scenario {
+    std::string side;
+    double qty_frac{0.0};             // of the smaller side's total size
+    std::optional<double> limit_bps;  // limit this far through the best touch
+    double qty{0.0};
+    std::optional<double> limit_price;
+
+    std::string name() const {
+        std::ostringstream os;
+        os << side << " " << qty_frac * 100 << "% ";
+        if (limit_bps) os << "limit+" << *limit_bps << "bp";
+        else os << "market";
+        return os.str();
+    }
+};
+
+std::vector<Scenario> make_grid(const std::vector<std::shared_ptr<const BookSnapshot>>& books) {
+    double bid_qty = 0.0, ask_qty = 0.0;
+    double best_bid = 0.0, best_ask = std::numeric_limits<double>::infinity();
+    for (const auto& b : books) {
+        if (!b->bids.empty()) {
+            bid_qty += b->bids.back().cum_qty;
+            best_bid = std::max(best_bid, b->bids.front().price);
+        }
+        if (!b->asks.empty()) {
+            ask_qty += b->asks.back().cum_qty;
+            best_ask = std::min(best_ask, b->asks.front().price);
+        }
+    }
+    const double side_qty = std::min(bid_qty, ask_qty);
+
+    std::vector<Scenario> grid;
+    for (const char* side : {"buy", "sell"}) {
+        for (double frac : {0.0001, 0.001, 0.01, 0.1, 0.5}) {
+            for (std::optional<double> bps : {std::optional<double>{}, std::optional<double>{5.0}}) {
+                Scenario s{side, frac, bps, 0.0, std::nullopt};
+                s.qty = side_qty * frac;
+                if (bps) {
+                    const bool buy = s.side == "buy";
+                    s.limit_price = buy ? best_ask * (1.0 + *bps * 1e-4) : best_bid * (1.0 - *bps * 1e-4);
+                }
+                grid.push_back(std::move(s));
+            }
+        }
+    }
+    return grid;
+}
+
+std::uint64_t decision_checksum(const RoutingDecision& d) {
+    std::uint64_t h = 1469598103934665603ull; // FNV-1a
+    auto mix = [&](const void* p, std::size_t n) {
+        const auto* b = static_cast<const unsigned char*>(p);
+        for (std::size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 1099511628211ull;
+    };
+    auto mix_num = [&](double v, double unit) {
+        const std::int64_t q = std::llround(v / unit);
+        mix(&q, sizeof(q));
+    };
+    mix(&d.fully_routable, 1);
+    mix_num(d.routable_qty, 1e-8);
+    for (const auto& s : d.slices) {
+        const std::string_view venue = s.venue();
+        mix(venue.data(), venue.size());
+        const int type = s.execution_type;
+        mix(&type, sizeof(type));
+        mix_num(s.quantity, 1e-8);
+        mix_num(s.price, 1e-6);
+    }
+    return h;
+}
+
+struct Row {
+    std::string version;
+    std::string scenario;
+    double ns{0.0};
+    double allocs{0.0};
+    std::uint64_t checksum{0};
+};
+
+std::string key(const std::string& version, const std::string& scenario) { return version + "\t" + scenario; }
+
+std::map<std::string, Row> read_baseline(const std::string& path) {
+    std::map<std::string, Row> rows;
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream ls(line);
+        Row r;
+        std::string checksum;
+        std::getline(ls, r.version, '\t');
+        std::getline(ls, r.scenario, '\t');
+        ls >> r.ns >> r.allocs >> checksum;
+        r.checksum = std::stoull(checksum, nullptr, 16);
+        rows[key(r.version, r.scenario)] = r;
+    }
+    return rows;
+}
+
+Options parse(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const std::string val = argv[i + 1];
+        if (flag == "--venues") o.venues = std::stoull(val);
+        else if (flag == "--depth") o.depth = std::stoull(val);
+        else if (flag == "--spread-bps") o.spread_bps = std::stod(val);
+        else if (flag == "--seed") o.seed = std::stoull(val);
+        else if (flag == "--capture") o.capture = val;
+        else if (flag == "--symbol") o.symbol = val;
+        else if (flag == "--iterations") o.iterations = std::stoull(val);
+        else if (flag == "--out") o.out = val;
+        else if (flag == "--baseline") o.baseline = val;
+        else if (flag == "--slower") o.slower = std::stod(val);
+        else std::cerr << "ignoring unknown option " << flag << "\n";
+    }
+    return o;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Options o = parse(argc, argv);
+    const auto books = o.capture.empty() ? synthetic_books(o) : capture_books(o);
+    if (books.empty()) {
+        std::cerr << "no books to route on\n";
+        return 1;
+    }
+
+    // Frozen books carry no live timestamps, so routing runs without an age bound.
+    md::SnapshotSet set;
+    std::size_t levels = 0;
+    std::cout << "books:";
+    for (const auto& b : books) {
+        set.venues.push_back(md::SnapshotSet::Venue{snapshot_venue_id(*b), b});
+        levels += b->bids.size() + b->asks.size();
+        std::cout << " " << b->venue << " " << b->symbol << " " << b->bids.size() << "/" << b->asks.size();
+    }
+    std::cout << "\n";
+
+    // Fixed base-tier fees so results do not depend on REST lookups.
+    std::unordered_map<std::string, VenueStaticInfo> static_info;
+    std::unordered_map<std::string, VenueRuntimeInfo> runtime_info;
+    const std::map<std::string, std::pair<double, double>> kFees = {
+        {"Coinbase", {0.004, 0.006}}, {"Kraken", {0.0025, 0.004}}, {"OKX", {0.0008, 0.001}}, {"Binance", {0.001, 0.001}}};
+    for (const auto& b : books) {
+        auto it = kFees.find(b->venue);
+        const auto [maker, taker] = it != kFees.end() ? it->second : std::pair{0.002, 0.003};
+        static_info[b->venue].fees.tiers = {FeeTier{0.0, maker, taker}};
+        runtime_info[b->venue] = VenueRuntimeInfo{0.0, 50.0, 0.0005};
+    }
+
+    const auto grid = make_grid(books);
+    const std::size_t iterations = o.iterations ? o.iterations : std::max<std::size_t>(20, 4'000'000 / (levels + 1000));
+    const auto baseline = o.baseline.empty() ? std::map<std::string, Row>{} : read_baseline(o.baseline);
+
+    RoutingContext ctx;
+    RoutingDecision decision;
+    std::vector<Row> rows;
+    std::size_t changed = 0, slower = 0;
+    std::cout << std::left << std::setw(22) << "version" << std::setw(26) << "order" << std::right << std::setw(12)
+              << "ns/route" << std::setw(10) << "allocs" << std::setw(18) << "checksum" << "  same as\n";
+    for (const auto& s : grid) {
+        std::map<std::uint64_t, std::string> first_with;
+        for (std::uint8_t id = 1; id <= router::kRouterVersionCount; ++id) {
+            const auto version = static_cast<router::RouterVersionId>(id);
+            auto route = [&] {
+                router::route_order(ctx, version, set, 0, s.side, s.qty, s.limit_price, static_info, runtime_info, decision);
+            };
+
+            Row r{std::string(router::router_version_name(version)), s.name()};
+            route();
+            r.checksum = decision_checksum(decision);
+
+            // Best of kRepeats keeps run-to-run noise below the --slower threshold.
+            r.ns = std::numeric_limits<double>::infinity();
+            for (int rep = 0; rep < kRepeats; ++rep) {
+                const std::uint64_t a0 = g_allocs.load(std::memory_order_relaxed);
+                const auto t0 = Clock::now();
+                for (std::size_t i = 0; i < iterations; ++i) route();
+                const double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+                r.ns = std::min(r.ns, ns / static_cast<double>(iterations));
+                r.allocs = static_cast<double>(g_allocs.load(std::memory_order_relaxed) - a0) /
+                           static_cast<double>(iterations);
+            }
+
+            const auto [same, inserted] = first_with.emplace(r.checksum, r.version);
+            std::cout << std::left << std::setw(22) << r.version << std::setw(26) << r.scenario << std::right
+                      << std::fixed << std::setprecision(0) << std::setw(12) << r.ns << std::setprecision(1)
+                      << std::setw(10) << r.allocs << std::hex << std::setw(18) << r.checksum << std::dec << "  "
+                      << (inserted ? "-" : same->second);
+            if (auto b = baseline.find(key(r.version, r.scenario)); b != baseline.end()) {
+                if (b->second.checksum != r.checksum) {
+                    std::cout << "  DECISION CHANGED";
+                    ++changed;
+                }
+                if (r.ns > b->second.ns * o.slower) {
+                    std::cout << "  SLOWER x" << std::setprecision(2) << r.ns / b->second.ns;
+                    ++slower;
+                }
+            }
+            std::cout << std::defaultfloat << "\n";
+            rows.push_back(std::move(r));
+        }
+    }
+
+    if (!o.out.empty()) {
+        std::ofstream out(o.out);
+        out << "# version\tscenario\tns\tallocs\tchecksum\n";
+        for (const auto& r : rows) {
+            out << r.version << "\t" << r.scenario << "\t" << std::fixed << std::setprecision(1) << r.ns << "\t"
+                << r.allocs << "\t" << std::hex << r.checksum << std::dec << "\n";
+        }
+    }
+    if (!baseline.empty()) {
+        std::cout << std::defaultfloat << std::setprecision(3) << "vs baseline: " << changed << " changed decisions, " << slower << " slower than x" << o.slower
+                  << "\n";
+    }
+    return changed == 0 ? 0 : 2;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+
+SIMDJSON_PREFIX=$(brew --prefix simdjson)
+BOOST_PREFIX=$(brew --prefix boost)
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  src/venues/replay_ws.cpp src/venues/ws_io_pool.cpp \
+  src/md/symbol_codec.cpp \
+  bench/bench_router.cpp \
+  -I src -I"$SIMDJSON_PREFIX/include" -I"$BOOST_PREFIX/include" \
+  -L"$SIMDJSON_PREFIX/lib" -lsimdjson \
+  -Wl,-rpath,"$SIMDJSON_PREFIX/lib" \
+  -DBOOST_ERROR_CODE_HEADER_ONLY \
+  -o build/bench_router
+
+./build/bench_router --out before.tsv                      # synthetic 4 x 1000
+./build/bench_router --venues 8 --depth 10000 --spread-bps 3
+./build/bench_router --capture /tmp/feed.cap --symbol BTC-USD
+# after a change: flag changed decisions and >25% slowdowns
+./build/bench_router --baseline before.tsv
+*/
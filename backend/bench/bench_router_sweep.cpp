@@ -0,0 +1,132 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "router/router_framework.hpp"
+#include "synthetic_books.hpp"
+
+// Microbenchmark: taker sweeps across K venues, heap routers vs the
+// prefix-sum router.
+// - v1/v2/v3: pop one level at a time from a std::priority_queue (v3 market
+//   orders only; its limit path is a different model).
+// - v4: binary-searches the marginal fee-adjusted price on the snapshots'
+//   cum_qty/cum_notional and reads whole levels from the prefix sums.
+// Books are synthetic SnapshotLevels on a shared tick grid with per-venue taker
+// fees. Order sizes are fractions of one side's total depth; v4's slices are
+// cross-checked against v2 (same decision rule). Reports ns per route.
+//
+// Usage:
+//   bench_router_sweep [venues] [iterations]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+template <class Fn>
+double time_ns(std::size_t iterations, Fn&& fn) {
+    const auto t0 = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i) fn();
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / static_cast<double>(iterations);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const std::size_t venues = argc > 1 ? std::stoull(argv[1]) : 4;
+    const std::size_t base_iterations = argc > 2 ? std::stoull(argv[2]) : 2'000'000;
+
+    static const char* const kNames[] = {"Coinbase", "Kraken", "OKX", "Binance", "Bybit", "Bitstamp", "Gemini", "Bitfinex"};
+    static const double kTakerFees[] = {0.006, 0.0026, 0.001, 0.004, 0.0011, 0.003, 0.0035, 0.002};
+
+    std::unordered_map<std::string, VenueStaticInfo> static_info;
+    std::unordered_map<std::string, VenueRuntimeInfo> runtime_info;
+    for (std::size_t v = 0; v < venues; ++v) {
+        VenueStaticInfo info;
+        info.fees.tiers.push_back(FeeTier{0.0, kTakerFees[v % 8] / 2, kTakerFees[v % 8]});
+        static_info[kNames[v % 8]] = info;
+    }
+
+    std::mt19937_64 rng(7);
+    std::size_t mismatches = 0;
+
+    std::cout << venues << " venues\n";
+    for (std::size_t depth : {std::size_t{100}, std::size_t{1000}, std::size_t{10000}}) {
+        md::SnapshotSet set;
+        double side_qty = 0.0;
+        for (std::size_t v = 0; v < venues; ++v) {
+            auto snap = std::make_shared<BookSnapshot>();
+            snap->venue = kNames[v % 8];
+            snap->symbol = "BTC-USD";
+            snap->seq = v + 1;
+            snap->bids = bench::make_side(rng, BookSide::Bid, depth);
+            snap->asks = bench::make_side(rng, BookSide::Ask, depth);
+            side_qty += snap->asks.back().cum_qty;
+            const md::VenueId venue_id = snapshot_venue_id(*snap);
+            set.venues.push_back(md::SnapshotSet::Venue{venue_id, std::move(snap)});
+        }
+        const std::size_t iterations = std::max<std::size_t>(base_iterations / depth, 50);
+
+        std::cout << "depth " << depth << "\n";
+        std::cout << "  " << std::left << std::setw(22) << "order" << std::right
+                  << std::setw(12) << "v1" << std::setw(12) << "v2" << std::setw(12) << "v3"
+                  << std::setw(12) << "v4" << "   ns/route\n";
+        for (double frac : {0.001, 0.01, 0.1, 0.5, 1.0}) {
+            for (bool limit : {false, true}) {
+                const double qty = side_qty * frac;
+                // Limit halfway into the touched range keeps part of the order resting.
+                const std::optional<double> limit_px =
+                    limit ? std::optional<double>(60'000.0 + 0.01 * static_cast<double>(depth) * frac) : std::nullopt;
+
+                auto run = [&](router::RouterVersionId id) {
+                    return router::route_order(id, set, 0, "buy", qty, limit_px, static_info, runtime_info);
+                };
+                const bool ok = bench::same_decision(run(router::RouterVersionId::V2BestPriceFee),
+                                                     run(router::RouterVersionId::V4CumulativeSweep), 1e-9);
+                mismatches += ok ? 0 : 1;
+
+                auto ns = [&](router::RouterVersionId id) {
+                    return time_ns(iterations, [&] { run(id); });
+                };
+                std::ostringstream label;
+                label << std::setprecision(3) << frac * 100 << "% " << (limit ? "limit" : "market");
+                std::cout << "  " << std::left << std::setw(22) << label.str() << std::right << std::fixed
+                          << std::setprecision(0) << std::setw(12) << ns(router::RouterVersionId::V1BestPriceSweep)
+                          << std::setw(12) << ns(router::RouterVersionId::V2BestPriceFee);
+                if (limit) {
+                    std::cout << std::setw(12) << "-";
+                } else {
+                    std::cout << std::setw(12) << ns(router::RouterVersionId::V3LimitCurve);
+                }
+                std::cout << std::setw(12) << ns(router::RouterVersionId::V4CumulativeSweep)
+                          << (ok ? "" : "   MISMATCH vs v2") << "\n";
+                std::cout.unsetf(std::ios::fixed);
+            }
+        }
+    }
+    std::cout << (mismatches == 0 ? "v4 matches v2 on every order\n" : "v4 differs from v2\n");
+    return mismatches == 0 ? 0 : 1;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  bench/bench_router_sweep.cpp \
+  -I src \
+  -o build/bench_router_sweep
+
+./build/bench_router_sweep
+./build/bench_router_sweep 8
+*/
@@ -0,0 +1,230 @@
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "md/snapshot_set.hpp"
+#include "router/router_framework.hpp"
+#include "synthetic_books.hpp"
+
+// Contention benchmark: how routers read a symbol's books while every venue
+// keeps publishing.
+// - per-feed: each venue owns a shared_ptr<const BookSnapshot> (VenueFeed's
+//   snapshot_); a router takes K std::atomic_load()s, one per venue, and the
+//   books it gets may come from different instants.
+// - set: venues publish into one md::SnapshotSetPublisher; a router takes one
+//   load() and gets every venue's book as of the same publish. Readers also
+//   check that the set version never goes backwards.
+// - set+route: the set read followed by a v4 route with a 1s age bound, i.e.
+//   what RouterService does per order.
+// Publishers cycle through prebuilt books, stamping a fresh copy per publish
+// like VenueFeed (the ladders' chunks are shared, so no book work), flat out
+// unless --publish-us paces them. Reports reads and publishes per second.
+//
+// Usage:
+//   bench_snapshot_set [--venues N] [--routers N] [--depth N] [--ms N] [--publish-us N]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::size_t venues{4};
+    std::size_t routers{4};
+    std::size_t depth{200};
+    int ms{1000};
+    int publish_us{0};
+};
+
+Options parse(int argc, char** argv) {
+    Options o;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        const std::string flag = argv[i];
+        const long v = std::strtol(argv[i + 1], nullptr, 10);
+        if (flag == "--venues") o.venues = static_cast<std::size_t>(std::max(1L, v));
+        else if (flag == "--routers") o.routers = static_cast<std::size_t>(std::max(1L, v));
+        else if (flag == "--depth") o.depth = static_cast<std::size_t>(std::max(1L, v));
+        else if (flag == "--ms") o.ms = static_cast<int>(std::max(1L, v));
+        else if (flag == "--publish-us") o.publish_us = static_cast<int>(std::max(0L, v));
+        else std::cerr << "ignoring unknown flag " << flag << "\n";
+    }
+    return o;
+}
+
+std::int64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+}
+
+struct Result {
+    std::uint64_t reads{0};
+    std::uint64_t publishes{0};
+    std::uint64_t regressions{0};
+    double seconds{0.0};
+};
+
+// Runs one publisher thread per venue and `routers` reader threads for o.ms.
+// publish(v, book) publishes a venue's next book; read(regressions) is one
+// router read.
+template <class Publish, class Read>
+Result run(const Options& o,
+           const std::vector<std::vector<std::shared_ptr<const BookSnapshot>>>& pool,
+           Publish&& publish,
+           Read&& read) {
+    std::atomic<bool> stop{false};
+    std::atomic<std::uint64_t> reads{0}, publishes{0}, regressions{0};
+    std::vector<std::thread> threads;
+
+    for (std::size_t v = 0; v < o.venues; ++v) {
+        threads.emplace_back([&, v] {
+            std::uint64_t n = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                auto book = std::make_shared<BookSnapshot>(*pool[v][n % pool[v].size()]);
+                book->ts_ns = steady_ns();
+                publish(v, std::shared_ptr<const BookSnapshot>(std::move(book)));
+                ++n;
+                if (o.publish_us > 0) std::this_thread::sleep_for(std::chrono::microseconds(o.publish_us));
+            }
+            publishes.fetch_add(n, std::memory_order_relaxed);
+        });
+    }
+    const auto start = Clock::now();
+    for (std::size_t r = 0; r < o.routers; ++r) {
+        threads.emplace_back([&] {
+            std::uint64_t n = 0;
+            std::uint64_t back = 0;
+            while (!stop.load(std::memory_order_relaxed)) {
+                read(back);
+                ++n;
+            }
+            reads.fetch_add(n, std::memory_order_relaxed);
+            regressions.fetch_add(back, std::memory_order_relaxed);
+        });
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(o.ms));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto& t : threads) t.join();
+
+    Result out;
+    out.seconds = std::chrono::duration<double>(Clock::now() - start).count();
+    out.reads = reads.load();
+    out.publishes = publishes.load();
+    out.regressions = regressions.load();
+    return out;
+}
+
+void print(const std::string& name, const Result& r) {
+    std::cout << "  " << std::left << std::setw(12) << name << std::right << std::fixed << std::setprecision(2)
+              << std::setw(12) << static_cast<double>(r.reads) / r.seconds / 1e6 << std::setw(14)
+              << static_cast<double>(r.publishes) / r.seconds / 1e6 << std::setw(14) << r.regressions << "\n"
+              << std::defaultfloat;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    const Options o = parse(argc, argv);
+    static const char* const kNames[] = {"Coinbase", "Kraken", "OKX", "Binance"};
+
+    // A few distinct books per venue so publishers do not republish one pointer.
+    constexpr std::size_t kPoolPerVenue = 8;
+    std::mt19937_64 rng(5);
+    std::vector<std::vector<std::shared_ptr<const BookSnapshot>>> pool(o.venues);
+    std::unordered_map<std::string, VenueStaticInfo> static_info;
+    const std::unordered_map<std::string, VenueRuntimeInfo> runtime_info;
+    for (std::size_t v = 0; v < o.venues; ++v) {
+        const std::string name = std::string(kNames[v % 4]) + (v < 4 ? "" : std::to_string(v));
+        for (std::size_t i = 0; i < kPoolPerVenue; ++i) {
+            auto snap = std::make_shared<BookSnapshot>();
+            snap->venue = name;
+            snap->symbol = "BTC-USD";
+            snap->venue_id = md::venue_ids().intern(name);
+            snap->seq = i + 1;
+            snap->bids = bench::make_side(rng, BookSide::Bid, o.depth);
+            snap->asks = bench::make_side(rng, BookSide::Ask, o.depth);
+            pool[v].push_back(std::move(snap));
+        }
+        static_info[name].fees.tiers = {FeeTier{0.0, 0.001, 0.002}};
+    }
+    std::cout << o.venues << " venues (one publisher each), " << o.routers << " routers, depth " << o.depth
+              << ", " << o.ms << "ms per mode\n";
+    std::cout << "  " << std::left << std::setw(12) << "mode" << std::right << std::setw(12) << "Mreads/s"
+              << std::setw(14) << "Mpublishes/s" << std::setw(14) << "regressions" << "\n";
+
+    {
+        std::vector<std::shared_ptr<const BookSnapshot>> slots(o.venues);
+        const auto r = run(
+            o, pool,
+            [&](std::size_t v, std::shared_ptr<const BookSnapshot> book) {
+                std::atomic_store_explicit(&slots[v], std::move(book), std::memory_order_release);
+            },
+            [&](std::uint64_t&) {
+                std::size_t live = 0;
+                for (const auto& slot : slots) {
+                    live += std::atomic_load_explicit(&slot, std::memory_order_acquire) ? 1 : 0;
+                }
+                if (live > o.venues) std::abort(); // keep the loads observable
+            });
+        print("per-feed", r);
+    }
+
+    auto run_set = [&](const std::string& name, auto&& per_set) {
+        md::SnapshotSetPublisher publisher;
+        std::vector<std::size_t> slot_of(o.venues);
+        for (std::size_t v = 0; v < o.venues; ++v) slot_of[v] = publisher.add_venue(pool[v][0]->venue_id);
+        const auto r = run(
+            o, pool,
+            [&](std::size_t v, std::shared_ptr<const BookSnapshot> book) {
+                const std::int64_t transport_ns = book->ts_ns;
+                publisher.publish(slot_of[v], std::move(book), transport_ns);
+            },
+            [&](std::uint64_t& regressions) {
+                thread_local std::uint64_t last_version = 0;
+                const auto set = publisher.load();
+                if (set->version < last_version) ++regressions;
+                last_version = set->version;
+                per_set(*set);
+            });
+        print(name, r);
+        return r.regressions;
+    };
+
+    std::uint64_t regressions = 0;
+    regressions += run_set("set", [&](const md::SnapshotSet& set) {
+        if (set.venues.size() != o.venues) std::abort();
+    });
+    constexpr std::int64_t kMaxAgeNs = 1'000'000'000;
+    regressions += run_set("set+route", [&](const md::SnapshotSet& set) {
+        thread_local RoutingDecision decision;
+        router::route_order(RoutingContext::for_this_thread(), router::RouterVersionId::V4CumulativeSweep, set,
+                            kMaxAgeNs, "buy", 1.0, std::nullopt, static_info, runtime_info, decision);
+    });
+
+    std::cout << (regressions == 0 ? "set versions never went backwards\n" : "set version went backwards\n");
+    return regressions == 0 ? 0 : 1;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra -pthread \
+  bench/bench_snapshot_set.cpp \
+  -I src \
+  -o build/bench_snapshot_set
+
+./build/bench_snapshot_set
+./build/bench_snapshot_set --venues 8 --routers 8 --publish-us 100
+*/
@@ -0,0 +1,177 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "md/feed_wait.hpp"
+#include "util/spsc_queue.hpp"
+
+// Microbenchmark: VenueFeed consumer wakeup strategies.
+// - wake latency: producer pushes a timestamp after an idle gap; the consumer
+//   records push->pop latency (p50/p99/max).
+// - idle CPU: N consumers wait on empty queues for a fixed wall time; reports CPU
+//   time burned per idle feed.
+// "sleep-poll" is the previous consume_loop behaviour (sleep 100us when empty).
+//
+// Usage:
+//   bench_wait_strategy [samples] [idle_feeds]
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+constexpr auto kIdleGap = std::chrono::microseconds(500);
+constexpr auto kIdleWindow = std::chrono::seconds(1);
+
+struct Mode {
+    std::string name;
+    bool sleep_poll{false};
+    WaitPolicy policy{};
+};
+
+std::vector<Mode> modes() {
+    Mode busy{"busy-spin", false, {}};
+    busy.policy.strategy = WaitStrategy::BusySpin;
+    Mode spin_park{"spin-park", false, {}};
+    spin_park.policy.strategy = WaitStrategy::SpinThenPark;
+    Mode blocking{"blocking", false, {}};
+    blocking.policy.strategy = WaitStrategy::Blocking;
+    return {Mode{"sleep-poll", true, {}}, busy, spin_park, blocking};
+}
+
+std::int64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now().time_since_epoch()).count();
+}
+
+double process_cpu_ms() {
+    timespec ts{};
+    ::clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) * 1e3 + static_cast<double>(ts.tv_nsec) / 1e6;
+}
+
+// One consumer loop shaped like VenueFeed::consume_loop.
+struct Channel {
+    explicit Channel(const Mode& m) : mode(m), waiter(m.policy) {}
+
+    void consume(std::vector<std::int64_t>* latencies) {
+        std::int64_t stamp = 0;
+        while (true) {
+            if (!queue.try_pop(stamp)) {
+                if (!running.load(std::memory_order_relaxed)) return;
+                if (mode.sleep_poll) {
+                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                } else {
+                    waiter.wait([this] {
+                        return !queue.empty() || !running.load(std::memory_order_relaxed);
+                    });
+                }
+                continue;
+            }
+            if (latencies) latencies->push_back(now_ns() - stamp);
+        }
+    }
+
+    void push(std::int64_t stamp) {
+        (void)queue.try_push(std::move(stamp));
+        if (!mode.sleep_poll) waiter.notify();
+    }
+
+    void stop() {
+        running.store(false, std::memory_order_relaxed);
+        waiter.wake();
+    }
+
+    Mode mode;
+    SpscQueue<std::int64_t, 1024> queue;
+    md::FeedWaiter waiter;
+    std::atomic<bool> running{true};
+};
+
+void bench_latency(const Mode& mode, std::size_t samples) {
+    Channel ch(mode);
+    std::vector<std::int64_t> lat;
+    lat.reserve(samples);
+    std::thread consumer([&] { ch.consume(&lat); });
+
+    for (std::size_t i = 0; i < samples; ++i) {
+        std::this_thread::sleep_for(kIdleGap);
+        ch.push(now_ns());
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    ch.stop();
+    consumer.join();
+
+    if (lat.empty()) return;
+    std::sort(lat.begin(), lat.end());
+    auto pct = [&](double p) {
+        return static_cast<double>(lat[static_cast<std::size_t>(p * (lat.size() - 1))]) / 1e3;
+    };
+    std::cout << std::left << std::setw(12) << mode.name
+              << std::fixed << std::setprecision(2)
+              << " wake p50=" << pct(0.50) << "us"
+              << " p99=" << pct(0.99) << "us"
+              << " max=" << static_cast<double>(lat.back()) / 1e3 << "us\n";
+}
+
+void bench_idle_cpu(const Mode& mode, std::size_t feeds) {
+    std::vector<std::unique_ptr<Channel>> chans;
+    std::vector<std::thread> threads;
+    chans.reserve(feeds);
+    for (std::size_t i = 0; i < feeds; ++i) {
+        chans.push_back(std::make_unique<Channel>(mode));
+    }
+
+    const double cpu0 = process_cpu_ms();
+    for (auto& ch : chans) {
+        threads.emplace_back([c = ch.get()] { c->consume(nullptr); });
+    }
+    std::this_thread::sleep_for(kIdleWindow);
+    for (auto& ch : chans) ch->stop();
+    for (auto& t : threads) t.join();
+    const double cpu_ms = process_cpu_ms() - cpu0;
+
+    const double wall_ms =
+        std::chrono::duration<double, std::milli>(kIdleWindow).count();
+    std::cout << std::left << std::setw(12) << mode.name
+              << std::fixed << std::setprecision(2)
+              << " idle cpu/feed=" << (cpu_ms / feeds) << "ms"
+              << " (" << (100.0 * cpu_ms / feeds / wall_ms) << "% of a core)\n";
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const std::size_t samples = argc >= 2 ? std::stoul(argv[1]) : 2000;
+    const std::size_t feeds = argc >= 3 ? std::stoul(argv[2]) : 8;
+
+    std::cout << "wake latency after " << kIdleGap.count() << "us idle gaps, samples="
+              << samples << "\n";
+    for (const auto& m : modes()) bench_latency(m, samples);
+
+    std::cout << "\nidle cpu over " << kIdleWindow.count() << "s, feeds=" << feeds << "\n";
+    for (const auto& m : modes()) bench_idle_cpu(m, feeds);
+    return 0;
+}
+
+/*
+Build:
+
+cd backend
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra -pthread \
+  bench/bench_wait_strategy.cpp \
+  -I src \
+  -o build/bench_wait_strategy
+
+./build/bench_wait_strategy
+./build/bench_wait_strategy 5000 32
+*/
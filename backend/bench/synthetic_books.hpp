@@ -0,0 +1,76 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "md/book_events.hpp"
+#include "md/snapshot_levels.hpp"
+#include "router/router_common.hpp"
+
+// Synthetic book sides and decision checks shared by the router and book
+// benchmarks (and test/test_router_alloc).
+namespace bench {
+
+// Best-first (price, size) rows as the SnapshotLevels VenueFeed publishes.
+inline SnapshotLevels build_side(BookSide side, const std::vector<std::pair<md::PriceTicks, md::SizeLots>>& rows) {
+    DirtyPriceRange dirty;
+    dirty.mark_full();
+    auto range = [&](std::optional<md::PriceTicks>, std::optional<md::PriceTicks>) {
+        return std::make_pair(rows.cbegin(), rows.cend());
+    };
+    auto proj = [](const auto& r) { return r; };
+    if (side == BookSide::Bid) {
+        return SnapshotLevels::rebuild(SnapshotLevels{}, dirty, std::greater<>{}, range, proj);
+    }
+    return SnapshotLevels::rebuild(SnapshotLevels{}, dirty, std::less<>{}, range, proj);
+}
+
+// One side of `levels` levels walking away from a 60'000 mid in 1-3 ticks of
+// 0.01 (a grid every venue shares, so equal prices across venues are common),
+// each with a size in (0, max_qty] lots.
+inline SnapshotLevels make_side(std::mt19937_64& rng, BookSide side, std::size_t levels,
+                                md::SizeLots max_qty = 2 * md::kSizeScale) {
+    constexpr md::PriceTicks kMid = 60'000 * md::kPriceScale;
+    constexpr md::PriceTicks kTick = md::kPriceScale / 100;
+    std::vector<std::pair<md::PriceTicks, md::SizeLots>> rows;
+    md::PriceTicks px = side == BookSide::Bid ? kMid - kTick : kMid;
+    for (std::size_t i = 0; i < levels; ++i) {
+        const md::PriceTicks step = kTick * static_cast<md::PriceTicks>(1 + rng() % 3);
+        px += side == BookSide::Bid ? -step : step;
+        rows.emplace_back(px, static_cast<md::SizeLots>(1 + rng() % static_cast<std::uint64_t>(max_qty)));
+    }
+    return build_side(side, rows);
+}
+
+// Same slices (venue, execution type, quantity, price) and routable quantity
+// and average price. rel_tol > 0 lets quantities and prices differ by that
+// relative amount, for routers that reach the same plan through different
+// arithmetic; fully_routable and the message are then not compared, since an
+// order sized to the whole book lands on either side of the threshold.
+inline bool same_decision(const RoutingDecision& a, const RoutingDecision& b, double rel_tol = 0.0) {
+    auto close = [rel_tol](double x, double y) {
+        return x == y || std::abs(x - y) <= rel_tol * std::max({1.0, std::abs(x), std::abs(y)});
+    };
+    if (rel_tol == 0.0 && (a.fully_routable != b.fully_routable || a.message != b.message)) return false;
+    if (!close(a.routable_qty, b.routable_qty) || !close(a.indicative_average_price, b.indicative_average_price) ||
+        a.slices.size() != b.slices.size()) {
+        return false;
+    }
+    for (std::size_t i = 0; i < a.slices.size(); ++i) {
+        const auto& x = a.slices[i];
+        const auto& y = b.slices[i];
+        if (x.venue_id != y.venue_id || x.execution_type != y.execution_type || !close(x.quantity, y.quantity) ||
+            !close(x.price, y.price)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace bench
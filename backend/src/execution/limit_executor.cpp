@@ -310,8 +310,8 @@ void LimitExecutor::run(
     legs.reserve(routing.slices.size());
     for (const auto& slice : routing.slices) {
         LegState s;
-        s.venue         = slice.venue;
-        s.sim_id        = "LIM-" + order_id.substr(0, 8) + "-" + slice.venue;
+        s.venue         = slice.venue();
+        s.sim_id        = "LIM-" + order_id.substr(0, 8) + "-" + s.venue;
         s.exec_type     = slice.execution_type;
         s.planned_qty   = slice.quantity;
         s.limit_price   = limit_price;
@@ -56,27 +56,30 @@ MarketExecutionResult MarketExecutor::execute(
     if (!inputs)
         return {OrderFillResult{}, false, "could not acquire routing inputs for " + symbol};
 
-    // Index snapshots by venue name.
-    std::unordered_map<std::string, std::shared_ptr<const BookSnapshot>> snapshots;
-    for (const auto& feed : inputs->feeds) {
-        auto snap = feed->load_snapshot();
-        if (snap) snapshots[feed->venue()] = std::move(snap);
-    }
+    // Every venue's book from one snapshot-set load, looked up by venue id.
+    const auto books = inputs->books->load();
+    auto book_for = [&](md::VenueId venue_id) -> const BookSnapshot* {
+        for (const auto& v : books->venues) {
+            if (v.venue_id == venue_id) return v.book.get();
+        }
+        return nullptr;
+    };
 
     // Simulate fill per routing slice.
     std::vector<LegFillResult> leg_results;
     leg_results.reserve(routing.slices.size());
     for (const auto& slice : routing.slices) {
-        auto it = snapshots.find(slice.venue);
-        if (it == snapshots.end() || !it->second) {
+        const std::string venue(slice.venue());
+        const BookSnapshot* book = book_for(slice.venue_id);
+        if (!book) {
             LegFillResult empty;
-            empty.venue = slice.venue;
+            empty.venue = venue;
             leg_results.push_back(empty);
             continue;
         }
-        double taker_fee = resolve_taker_fee(slice.venue, venue_runtime_info);
+        double taker_fee = resolve_taker_fee(venue, venue_runtime_info);
         leg_results.push_back(
-            simulate_market_leg(*it->second, slice.venue, side, slice.quantity, taker_fee));
+            simulate_market_leg(*book, venue, side, slice.quantity, taker_fee));
     }
 
     auto fill = aggregate_fills(leg_results, routing.requested_qty);
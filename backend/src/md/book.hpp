@@ -1,50 +1,59 @@
 #pragma once
 
 #include <algorithm>
-#include <cmath>
 #include <cstddef>
 #include <cstdint>
 #include <map>
 #include <optional>
 #include <string>
 #include <utility>
-#include <variant>
+#include <span>
 #include <vector>
 
+#include "book_coalesce.hpp"
 #include "book_events.hpp"
 #include "book_snapshot.hpp"
 
 // Per-venue full-depth limit order book.
-// - BookEventSnapshot replaces both sides with absolute sizes (Upsert only).
-// - BookEventDelta is absolute size at price (0 or Delete => erase).
+// - Snapshot events replace both sides with absolute sizes (Upsert only).
+// - Delta events are absolute size at price (0 or Delete => erase).
 // - Single writer model: one consumer thread mutates this book.
+// - Keyed on fixed-point ticks (md::PriceTicks) so lookups are exact integer compares.
 // - Readers consume immutable snapshots published by VenueFeed.
 class Book {
 public:
-    using BidMap = std::map<double, double, std::greater<double>>; // best-first
-    using AskMap = std::map<double, double, std::less<double>>;    // best-first
+    using BidMap = std::map<md::PriceTicks, md::SizeLots, std::greater<md::PriceTicks>>; // best-first
+    using AskMap = std::map<md::PriceTicks, md::SizeLots, std::less<md::PriceTicks>>;    // best-first
 
     Book(std::string venue, std::string symbol)
-        : venue_(std::move(venue)), symbol_(std::move(symbol)) {}
+        : venue_(std::move(venue)), symbol_(std::move(symbol))
+        , venue_id_(md::venue_ids().intern(venue_))
+        , symbol_id_(md::symbol_ids().intern(symbol_)) {}
 
-    // Single-event apply.
-    void apply(const BookEventSnapshot& snap) {
-        if (!matches(snap.venue, snap.symbol)) return;
-        apply_unlocked(snap);
-    }
-    void apply(const BookEventDelta& d) {
-        if (!matches(d.venue, d.symbol)) return;
-        apply_unlocked(d);
-    }
-    void apply(const BookEvent& ev) {
-        std::visit([this](auto&& e){ apply_unlocked(e); }, ev);
+    // Single-event apply (ignored unless it targets this book).
+    void apply(const BookEventBatch& batch, const BookEventHeader& ev) {
+        if (!matches(ev.venue, ev.symbol)) return;
+        apply_unlocked(ev, batch.levels(ev));
     }
 
-    // Batch apply.
-    void apply_many(const std::vector<BookEvent>& evs) {
-        for (const auto& ev : evs) {
-            std::visit([this](auto&& e){ apply_unlocked(e); }, ev);
+    // Batch apply. Runs of several delta events are coalesced: the last write
+    // per price is merged into each side in one ordered pass (same end state
+    // as applying the events one by one). A lone delta event is applied as is.
+    void apply_many(const BookEventBatch& batch) {
+        const auto& events = batch.events();
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const auto& ev = events[i];
+            if (ev.kind == BookEventKind::Snapshot) {
+                flush_coalesced();
+                apply_snapshot(ev, batch.levels(ev));
+            } else if (bid_stage_.empty() && ask_stage_.empty() &&
+                       (i + 1 == events.size() || events[i + 1].kind == BookEventKind::Snapshot)) {
+                apply_deltas(ev, batch.levels(ev));
+            } else {
+                stage_deltas(ev, batch.levels(ev));
+            }
         }
+        flush_coalesced();
     }
 
     // Read API for publisher path.
@@ -56,24 +65,46 @@ public:
         ensure_ask_curve();
         return take_top_pairs(ask_curve_, n);
     }
-    // O(1) top-of-book access from canonical maps (used by publish gating).
+    // O(1) top-of-book access from canonical maps, on the fixed-point grid
+    // (used by publish gating).
+    std::optional<std::pair<md::PriceTicks, md::SizeLots>> best_level(BookSide side) const noexcept {
+        if (side == BookSide::Bid) {
+            if (bids_.empty()) return std::nullopt;
+            return *bids_.begin();
+        }
+        if (asks_.empty()) return std::nullopt;
+        return *asks_.begin();
+    }
     std::optional<std::pair<double,double>> best_bid() const noexcept {
         if (bids_.empty()) return std::nullopt;
         const auto& it = *bids_.begin();
-        return std::make_pair(it.first, it.second);
+        return std::make_pair(md::price_to_double(it.first), md::size_to_double(it.second));
     }
     std::optional<std::pair<double,double>> best_ask() const noexcept {
         if (asks_.empty()) return std::nullopt;
         const auto& it = *asks_.begin();
-        return std::make_pair(it.first, it.second);
+        return std::make_pair(md::price_to_double(it.first), md::size_to_double(it.second));
+    }
+
+    // Best-first walk over up to n levels of one side: f(px, qty) (checksums).
+    template <class F>
+    void visit_top(BookSide side, std::size_t n, F&& f) const {
+        auto walk = [n, &f](const auto& levels) {
+            auto it = levels.begin();
+            for (std::size_t i = 0; i < n && it != levels.end(); ++i, ++it) f(it->first, it->second);
+        };
+        if (side == BookSide::Bid) walk(bids_);
+        else                       walk(asks_);
     }
 
     std::size_t bid_levels() const noexcept { return bids_.size(); }
     std::size_t ask_levels() const noexcept { return asks_.size(); }
 
     // Copy precomputed full-depth levels for immutable snapshot publication.
-    void copy_snapshot_levels(std::vector<BookSnapshotLevel>& bids_out,
-                              std::vector<BookSnapshotLevel>& asks_out) const {
+    // Only chunks owning prices touched since the last call are rebuilt; the rest
+    // are shared with the previously published ladders.
+    void copy_snapshot_levels(SnapshotLevels& bids_out,
+                              SnapshotLevels& asks_out) const {
         ensure_bid_curve();
         ensure_ask_curve();
         bids_out = bid_curve_;
@@ -88,95 +119,137 @@ public:
         asks_.clear();
         bid_curve_.clear();
         ask_curve_.clear();
-        bid_curve_dirty_ = false;
-        ask_curve_dirty_ = false;
+        bid_dirty_.reset();
+        ask_dirty_.reset();
         last_seq_ = 0;
     }
 
 private:
-    static bool valid_price(double price) noexcept {
-        return std::isfinite(price) && price > 0.0;
-    }
+    static bool valid_price(md::PriceTicks px) noexcept { return px > 0; }
+    static bool valid_size(md::SizeLots qty) noexcept { return qty > 0; }
 
-    static bool valid_size(double size) noexcept {
-        return std::isfinite(size) && size > 0.0;
+    // -------- apply helpers --------
+    void apply_unlocked(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        if (ev.kind == BookEventKind::Snapshot) apply_snapshot(ev, levels);
+        else                                    apply_deltas(ev, levels);
     }
 
-    // -------- apply helpers --------
-    void apply_unlocked(const BookEventSnapshot& snap) {
+    void apply_snapshot(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        // Sequenced snapshot older than what was applied (REST vs stream race).
+        if (ev.seq && last_seq_ && ev.seq <= last_seq_) return;
         bids_.clear();
         asks_.clear();
-        std::uint64_t max_seq_in_snap = 0;
-        for (const auto& lvl : snap.levels) {
+        for (const auto& lvl : levels) {
             if (lvl.op == BookOp::Delete) continue;
-            if (!valid_price(lvl.price) || !valid_size(lvl.size)) continue;
-            if (lvl.side == BookSide::Bid) bids_[lvl.price] = lvl.size;
-            else                           asks_[lvl.price] = lvl.size;
-            if (lvl.seq > max_seq_in_snap) max_seq_in_snap = lvl.seq;
+            if (!valid_price(lvl.px) || !valid_size(lvl.qty)) continue;
+            if (lvl.side == BookSide::Bid) bids_[lvl.px] = lvl.qty;
+            else                           asks_[lvl.px] = lvl.qty;
         }
-        if (max_seq_in_snap) last_seq_ = max_seq_in_snap;
-        bid_curve_dirty_ = true;
-        ask_curve_dirty_ = true;
+        if (ev.seq) last_seq_ = ev.seq;
+        bid_dirty_.mark_full();
+        ask_dirty_.mark_full();
     }
 
-    void apply_unlocked(const BookEventDelta& d) {
-        if (d.seq && last_seq_ && d.seq <= last_seq_) return;
-        if (!valid_price(d.price)) return;
+    void apply_deltas(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        if (ev.seq && last_seq_ && ev.seq <= last_seq_) return;
 
-        if (d.side == BookSide::Bid) {
-            apply_one(bids_, d);
-            bid_curve_dirty_ = true;
-        } else {
-            apply_one(asks_, d);
-            ask_curve_dirty_ = true;
+        for (const auto& lvl : levels) {
+            if (!valid_price(lvl.px)) continue;
+            if (lvl.side == BookSide::Bid) {
+                apply_one(bids_, lvl);
+                bid_dirty_.add(lvl.px, bids_.key_comp());
+            } else {
+                apply_one(asks_, lvl);
+                ask_dirty_.add(lvl.px, asks_.key_comp());
+            }
         }
-        if (d.seq) last_seq_ = d.seq;
+        if (ev.seq) last_seq_ = ev.seq;
     }
 
-    static void apply_one(BidMap& side, const BookEventDelta& d) {
-        if (d.op == BookOp::Delete || !valid_size(d.size)) {
-            auto it = side.find(d.price);
-            if (it != side.end()) side.erase(it);
-        } else {
-            side[d.price] = d.size;
+    void stage_deltas(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        if (ev.seq && last_seq_ && ev.seq <= last_seq_) return;
+        for (const auto& lvl : levels) {
+            if (!valid_price(lvl.px)) continue;
+            if (lvl.side == BookSide::Bid) bid_stage_.add(lvl);
+            else                           ask_stage_.add(lvl);
+        }
+        if (ev.seq) last_seq_ = ev.seq;
+    }
+
+    void flush_coalesced() {
+        if (!bid_stage_.empty()) merge_side(bids_, bid_stage_, bid_dirty_);
+        if (!ask_stage_.empty()) merge_side(asks_, ask_stage_, ask_dirty_);
+    }
+
+    // Sorted updates against the best-first map: step the cursor a few nodes
+    // from the previous update (bursts cluster near the touch) before falling
+    // back to a tree search, and insert with the cursor as hint.
+    template <class OrderedMap, class Stage>
+    static void merge_side(OrderedMap& side, Stage& stage, DirtyPriceRange& dirty) {
+        constexpr int kMaxSteps = 2;
+        const auto updates = stage.drain();
+        const auto comp = side.key_comp();
+        auto it = side.begin();
+        for (const auto& u : updates) {
+            for (int steps = 0; it != side.end() && comp(it->first, u.px); ++steps) {
+                if (steps == kMaxSteps) {
+                    it = side.lower_bound(u.px);
+                    break;
+                }
+                ++it;
+            }
+            const bool found = it != side.end() && it->first == u.px;
+            if (u.qty == 0) {
+                if (found) it = side.erase(it);
+            } else if (found) {
+                (it++)->second = u.qty;
+            } else {
+                it = std::next(side.emplace_hint(it, u.px, u.qty));
+            }
         }
+        dirty.add(updates.front().px, comp);
+        dirty.add(updates.back().px, comp);
+        stage.clear();
     }
-    static void apply_one(AskMap& side, const BookEventDelta& d) {
-        if (d.op == BookOp::Delete || !valid_size(d.size)) {
-            auto it = side.find(d.price);
+
+    template <class OrderedMap>
+    static void apply_one(OrderedMap& side, const BookLevelUpdate& lvl) {
+        if (lvl.op == BookOp::Delete || !valid_size(lvl.qty)) {
+            auto it = side.find(lvl.px);
             if (it != side.end()) side.erase(it);
         } else {
-            side[d.price] = d.size;
+            side[lvl.px] = lvl.qty;
         }
     }
 
     void ensure_bid_curve() const {
-        if (!bid_curve_dirty_) return;
-        rebuild_curve(bids_, bid_curve_);
-        bid_curve_dirty_ = false;
+        if (!bid_dirty_.any) return;
+        bid_curve_ = rebuild_curve(bids_, bid_curve_, bid_dirty_);
+        bid_dirty_.reset();
     }
 
     void ensure_ask_curve() const {
-        if (!ask_curve_dirty_) return;
-        rebuild_curve(asks_, ask_curve_);
-        ask_curve_dirty_ = false;
+        if (!ask_dirty_.any) return;
+        ask_curve_ = rebuild_curve(asks_, ask_curve_, ask_dirty_);
+        ask_dirty_.reset();
     }
 
     template <class OrderedMap>
-    static void rebuild_curve(const OrderedMap& side, std::vector<BookSnapshotLevel>& out) {
-        out.clear();
-        out.reserve(side.size());
-        double cum_qty = 0.0;
-        double cum_notional = 0.0;
-        for (const auto& [px, sz] : side) {
-            cum_qty += sz;
-            cum_notional += (px * sz);
-            out.push_back(BookSnapshotLevel{px, sz, cum_qty, cum_notional});
-        }
+    static SnapshotLevels rebuild_curve(const OrderedMap& side,
+                                        const SnapshotLevels& prev,
+                                        const DirtyPriceRange& dirty) {
+        // Maps are best-first, so lower_bound gives both span ends directly.
+        auto range = [&side](const std::optional<md::PriceTicks>& lo,
+                             const std::optional<md::PriceTicks>& hi) {
+            return std::make_pair(lo ? side.lower_bound(*lo) : side.begin(),
+                                  hi ? side.lower_bound(*hi) : side.end());
+        };
+        auto proj = [](const auto& kv) { return std::make_pair(kv.first, kv.second); };
+        return SnapshotLevels::rebuild(prev, dirty, side.key_comp(), range, proj);
     }
 
     static std::vector<std::pair<double,double>> take_top_pairs(
-        const std::vector<BookSnapshotLevel>& levels,
+        const SnapshotLevels& levels,
         std::size_t n) {
         std::vector<std::pair<double,double>> out;
         out.reserve(std::min(n, levels.size()));
@@ -188,21 +261,27 @@ private:
         return out;
     }
 
-    bool matches(const std::string& v, const std::string& s) const noexcept {
-        return v == venue_ && s == symbol_;
+    bool matches(md::VenueId v, md::SymbolId s) const noexcept {
+        return v == venue_id_ && s == symbol_id_;
     }
 
     // -------- state --------
     std::string venue_;
     std::string symbol_;
+    md::VenueId venue_id_;
+    md::SymbolId symbol_id_;
 
     BidMap bids_;
     AskMap asks_;
     std::uint64_t last_seq_{0}; // 0 => unknown; otherwise last applied seq
 
-    // Cached cumulative curves for publisher snapshots.
-    mutable std::vector<BookSnapshotLevel> bid_curve_;
-    mutable std::vector<BookSnapshotLevel> ask_curve_;
-    mutable bool bid_curve_dirty_{true};
-    mutable bool ask_curve_dirty_{true};
+    // Last published chunked curves and the prices touched since.
+    mutable SnapshotLevels bid_curve_;
+    mutable SnapshotLevels ask_curve_;
+    mutable DirtyPriceRange bid_dirty_;
+    mutable DirtyPriceRange ask_dirty_;
+
+    // apply_many() staging, best-first like the maps.
+    md::SideCoalescer<std::greater<md::PriceTicks>> bid_stage_;
+    md::SideCoalescer<std::less<md::PriceTicks>> ask_stage_;
 };
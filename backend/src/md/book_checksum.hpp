@@ -0,0 +1,188 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <utility>
+
+#include "book_events.hpp"
+#include "fixed_point.hpp"
+#include "util/crc32.hpp"
+
+// Venue top-of-book checksums, recomputed from the local book and compared with
+// the value the venue sends alongside each update (Kraken v2 `book`, OKX `books`).
+// Both are CRC-32 over the top levels' decimal strings, so the book's fixed-point
+// keys are re-formatted with each venue's string rules:
+// - Kraken: top 10 asks (best first) then top 10 bids, each level as price then
+//   qty at the instrument's precision, with the '.' and leading zeros removed,
+//   concatenated without separators. Unsigned CRC.
+// - OKX: top 25 levels interleaved "bid px:bid sz:ask px:ask sz:..." (a missing
+//   side is skipped) in shortest decimal form, ':'-separated. Signed CRC on the
+//   wire; compared here as its uint32 bit pattern.
+// The string is built in a stack buffer and hashed in one pass, so a check costs
+// ~40-100 number formats plus one CRC over a few hundred bytes (bench/bench_checksum).
+namespace md {
+
+enum class ChecksumStyle : std::uint8_t {
+    Kraken,
+    Okx
+};
+
+struct ChecksumRule {
+    ChecksumStyle style{ChecksumStyle::Kraken};
+    std::uint32_t depth{10};
+    // Kraken: instrument price/qty precision (fractional digits); unused for OKX.
+    int price_decimals{0};
+    int qty_decimals{0};
+};
+
+inline constexpr std::uint32_t kMaxChecksumDepth = 32;
+
+namespace detail {
+
+// Eight ASCII digits of x < 1e8 (zero-padded), first digit in the lowest byte:
+// all four radix-100 pairs are split in parallel inside one 64-bit register, so
+// no digit goes through memory (little-endian layout).
+inline std::uint64_t digits8(std::uint32_t x) noexcept {
+    const std::uint64_t merged = (x / 10000) | (static_cast<std::uint64_t>(x % 10000) << 32);
+    const std::uint64_t top = ((merged * 10486) >> 20) & ((0x7FULL << 32) | 0x7FULL); // /100
+    const std::uint64_t bot = merged - 100 * top;
+    const std::uint64_t hundreds = (bot << 16) + top;
+    std::uint64_t tens = (hundreds * 103) >> 10; // /10
+    tens &= (0xFULL << 48) | (0xFULL << 32) | (0xFULL << 16) | 0xFULL;
+    tens += (hundreds - 10 * tens) << 8;
+    return tens | 0x3030303030303030ULL;
+}
+
+// Low `w` (1..8) digits of x as the leading bytes of an 8-byte store.
+inline void store_digits(char* out, std::uint32_t x, int w) noexcept {
+    const std::uint64_t d = digits8(x) >> (8 * (8 - w));
+    std::memcpy(out, &d, 8);
+}
+
+inline int decimal_width(std::uint64_t v) noexcept {
+    const int w = ((64 - std::countl_zero(v | 1)) * 1233) >> 12; // ~bits * log10(2)
+    if (w >= 19) return v >= 10'000'000'000'000'000'000ull ? 20 : 19;
+    return w + (v >= static_cast<std::uint64_t>(kPow10[w]) ? 1 : 0) + (v == 0 ? 1 : 0);
+}
+
+// v / 10^k with a constant divisor per case, so it compiles to multiplies.
+inline std::uint64_t div_pow10(std::uint64_t v, int k) noexcept {
+    switch (k) {
+        case 0: return v;
+        case 1: return v / 10;
+        case 2: return v / 100;
+        case 3: return v / 1'000;
+        case 4: return v / 10'000;
+        case 5: return v / 100'000;
+        case 6: return v / 1'000'000;
+        case 7: return v / 10'000'000;
+        case 8: return v / 100'000'000;
+        case 9: return v / 1'000'000'000;
+        case 10: return v / 10'000'000'000;
+        default: return v / static_cast<std::uint64_t>(kPow10[k]);
+    }
+}
+
+} // namespace detail
+
+// Exactly `w` digits of v < 10^w (zero-padded). Returns the end. Stores run in
+// 8-byte words, so the destination needs 8 bytes of room past the digits.
+inline char* write_digits(char* out, std::uint64_t v, int w) noexcept {
+    static_assert(std::endian::native == std::endian::little, "digits8 assumes little-endian");
+    if (w <= 8) {
+        detail::store_digits(out, static_cast<std::uint32_t>(v), w);
+    } else if (w <= 16) {
+        detail::store_digits(out, static_cast<std::uint32_t>(v / 100'000'000), w - 8);
+        detail::store_digits(out + w - 8, static_cast<std::uint32_t>(v % 100'000'000), 8);
+    } else {
+        const std::uint64_t rest = v % 10'000'000'000'000'000;
+        detail::store_digits(out, static_cast<std::uint32_t>(v / 10'000'000'000'000'000), w - 16);
+        detail::store_digits(out + w - 16, static_cast<std::uint32_t>(rest / 100'000'000), 8);
+        detail::store_digits(out + w - 8, static_cast<std::uint32_t>(rest % 100'000'000), 8);
+    }
+    return out + w;
+}
+
+// Decimal digits of v without leading zeros ("0" for 0); same room rule.
+inline char* write_uint(char* out, std::uint64_t v) noexcept {
+    return write_digits(out, v, detail::decimal_width(v));
+}
+
+// Grid value (`grid` fractional digits) as its digit string at `frac` fractional
+// digits with the decimal point and leading zeros dropped (Kraken): 0.05000 at
+// frac 5 -> "5000". Finer grid digits are truncated.
+inline char* write_scaled_digits(char* out, std::int64_t value, int grid, int frac) noexcept {
+    auto v = static_cast<std::uint64_t>(value < 0 ? 0 : value);
+    if (frac < grid)      v = detail::div_pow10(v, grid - frac);
+    else if (frac > grid) v *= static_cast<std::uint64_t>(detail::kPow10[frac - grid]);
+    return write_uint(out, v);
+}
+
+// Grid value in shortest decimal form: trailing fractional zeros and a bare
+// '.' dropped (OKX): 41006.80 -> "41006.8", 3366.0 -> "3366".
+template <int Grid>
+char* write_shortest_decimal(char* out, std::int64_t value) noexcept {
+    static_assert(Grid >= 1 && Grid <= 16);
+    constexpr auto kScale = static_cast<std::uint64_t>(detail::kPow10[Grid]);
+    const auto v = static_cast<std::uint64_t>(value < 0 ? 0 : value);
+    out = write_uint(out, v / kScale);
+    std::uint64_t frac = v % kScale;
+    if (frac == 0) return out;
+    // Strip trailing zeros in 8/4/2/1 steps (at most Grid - 1 of them).
+    int width = Grid;
+    if (frac % 100'000'000 == 0) { frac /= 100'000'000; width -= 8; }
+    if (frac % 10'000 == 0)      { frac /= 10'000;      width -= 4; }
+    if (frac % 100 == 0)         { frac /= 100;         width -= 2; }
+    if (frac % 10 == 0)          { frac /= 10;          width -= 1; }
+    *out++ = '.';
+    return write_digits(out, frac, width);
+}
+
+// Up to 2 * kMaxChecksumDepth levels of two <= 20-char numbers plus separators,
+// and the 8 bytes of room write_digits() stores past its end.
+inline constexpr std::size_t kChecksumBufferSize = kMaxChecksumDepth * 2 * 2 * 24 + 8;
+
+// Checksum input for `book` under `rule`, written to `buf` (kChecksumBufferSize
+// bytes); returns its length. BookT provides visit_top(side, n, f(px, qty)).
+template <class BookT>
+std::size_t format_checksum_input(const BookT& book, const ChecksumRule& rule, char* buf) {
+    const std::uint32_t depth = std::min(rule.depth, kMaxChecksumDepth);
+    char* p = buf;
+
+    if (rule.style == ChecksumStyle::Kraken) {
+        auto emit = [&](md::PriceTicks px, md::SizeLots qty) {
+            p = write_scaled_digits(p, px, kPriceDecimals, rule.price_decimals);
+            p = write_scaled_digits(p, qty, kSizeDecimals, rule.qty_decimals);
+        };
+        book.visit_top(BookSide::Ask, depth, emit);
+        book.visit_top(BookSide::Bid, depth, emit);
+        return static_cast<std::size_t>(p - buf);
+    }
+
+    // OKX interleaves sides by rank, so collect both first.
+    std::pair<md::PriceTicks, md::SizeLots> bids[kMaxChecksumDepth], asks[kMaxChecksumDepth];
+    std::uint32_t nb = 0, na = 0;
+    book.visit_top(BookSide::Bid, depth, [&](md::PriceTicks px, md::SizeLots qty) { bids[nb++] = {px, qty}; });
+    book.visit_top(BookSide::Ask, depth, [&](md::PriceTicks px, md::SizeLots qty) { asks[na++] = {px, qty}; });
+    auto emit = [&](const std::pair<md::PriceTicks, md::SizeLots>& l) {
+        if (p != buf) *p++ = ':';
+        p = write_shortest_decimal<kPriceDecimals>(p, l.first);
+        *p++ = ':';
+        p = write_shortest_decimal<kSizeDecimals>(p, l.second);
+    };
+    for (std::uint32_t i = 0; i < std::max(nb, na); ++i) {
+        if (i < nb) emit(bids[i]);
+        if (i < na) emit(asks[i]);
+    }
+    return static_cast<std::size_t>(p - buf);
+}
+
+template <class BookT>
+std::uint32_t book_checksum(const BookT& book, const ChecksumRule& rule) {
+    char buf[kChecksumBufferSize];
+    return util::crc32(buf, format_checksum_input(book, rule, buf));
+}
+
+} // namespace md
@@ -0,0 +1,81 @@
+#pragma once
+#include <algorithm>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "book_events.hpp"
+
+// Staging area for one book side while Book/FlatBook::apply_many coalesces a
+// run of delta events: every write is recorded, then drained once as a
+// price-sorted list holding only the last write per price, so the side is
+// updated in a single ordered pass and its dirty range is extended once.
+// Storage is reused across batches (no allocation once warmed up).
+namespace md {
+
+struct CoalescedLevel {
+    PriceTicks px{0};
+    SizeLots qty{0};        // 0 => erase
+    std::uint32_t order{0}; // arrival index; the last write per price wins
+};
+
+// Order: strict price ordering the drained levels follow (the side's walk order).
+template <class Order>
+class SideCoalescer {
+public:
+    void add(const BookLevelUpdate& lvl) {
+        const SizeLots qty = (lvl.op == BookOp::Delete || lvl.qty <= 0) ? 0 : lvl.qty;
+        const std::uint32_t order = next_order_++;
+        if (sorted_ && levels_.size() < kInsertMax) {
+            // Small stage: keep it sorted and deduplicated as it grows
+            // (insertion from the back; a repeated price is overwritten).
+            std::size_t i = levels_.size();
+            while (i > 0 && Order{}(lvl.px, levels_[i - 1].px)) --i;
+            if (i > 0 && levels_[i - 1].px == lvl.px) {
+                levels_[i - 1].qty = qty;
+            } else {
+                levels_.insert(levels_.begin() + static_cast<std::ptrdiff_t>(i), CoalescedLevel{lvl.px, qty, order});
+            }
+            return;
+        }
+        sorted_ = false;
+        levels_.push_back(CoalescedLevel{lvl.px, qty, order});
+    }
+
+    bool empty() const noexcept { return levels_.empty(); }
+
+    // Sorted by Order, one level per price. Valid until the next add()/clear().
+    std::span<const CoalescedLevel> drain() {
+        if (sorted_) return levels_;
+        // Large stage: sort once, then keep the last write of each price.
+        // Entries overwritten in the sorted prefix are older than anything
+        // appended after it, so arrival order still decides.
+        std::sort(levels_.begin(), levels_.end(), [](const CoalescedLevel& a, const CoalescedLevel& b) {
+            if (a.px != b.px) return Order{}(a.px, b.px);
+            return a.order < b.order;
+        });
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < levels_.size(); ++i) {
+            if (out > 0 && levels_[out - 1].px == levels_[i].px) levels_[out - 1] = levels_[i];
+            else                                                 levels_[out++] = levels_[i];
+        }
+        levels_.resize(out);
+        sorted_ = true;
+        return levels_;
+    }
+
+    void clear() noexcept {
+        levels_.clear();
+        sorted_ = true;
+        next_order_ = 0;
+    }
+
+private:
+    static constexpr std::size_t kInsertMax = 32;
+
+    std::vector<CoalescedLevel> levels_;
+    bool sorted_{true};
+    std::uint32_t next_order_{0};
+};
+
+} // namespace md
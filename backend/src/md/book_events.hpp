@@ -1,9 +1,12 @@
 #pragma once
-#include <string>
 #include <cstdint>
-#include <variant>
+#include <span>
+#include <type_traits>
 #include <vector>
 
+#include "fixed_point.hpp"
+#include "intern.hpp"
+
 enum class BookSide : uint8_t
 {
     Bid = 0,
@@ -14,26 +17,161 @@ enum class BookOp : uint8_t
     Upsert = 0,
     Delete = 1
 };
+enum class BookEventKind : uint8_t
+{
+    Snapshot = 0, // replaces both sides with absolute sizes
+    Delta = 1     // absolute size at price (0 or Delete => erase)
+};
 
-struct BookEventDelta
+// One price level of an event (plain data, stored in BookEventBatch's arena).
+struct BookLevelUpdate
 {
-    std::string venue;  // "Coinbase", "Kraken"
-    std::string symbol; // canonical "BTC-USD"
-    BookSide side;
-    double price{0};
-    double size{0}; // size==0 implies delete for some venues
+    md::PriceTicks px{0}; // price on the md::kPriceScale grid
+    md::SizeLots qty{0};  // size on the md::kSizeScale grid; 0 implies delete for some venues
+    BookSide side{BookSide::Bid};
     BookOp op{BookOp::Upsert};
-    std::uint64_t seq{0}; // venue sequence if available (0 if not)
-    std::int64_t ts_ns{0};
 };
 
-struct BookEventSnapshot
+// One parsed book event: a run of levels [first, first + count) in the batch arena.
+struct BookEventHeader
 {
-    std::string venue;  // venue id
-    std::string symbol; // canonical
-    // We encode snapshot as a vector of deltas (Upsert) you can apply in order.
-    std::vector<BookEventDelta> levels;
+    BookEventKind kind{BookEventKind::Delta};
+    md::VenueId venue{md::kNoVenue};    // md::venue_ids() ("Coinbase", "Kraken")
+    md::SymbolId symbol{md::kNoSymbol}; // md::symbol_ids() canonical ("BTC-USD")
+    std::uint32_t first{0};
+    std::uint32_t count{0};
+    std::uint64_t seq{0}; // venue sequence if available (0 if not)
     std::int64_t ts_ns{0};
+    std::uint32_t checksum{0}; // venue top-of-book CRC after this event (see md/book_checksum.hpp)
+    bool has_checksum{false};
+    std::int64_t venue_ts_ns{0}; // venue event time (ns since the Unix epoch) if available (0 if not)
 };
 
-using BookEvent = std::variant<BookEventSnapshot, BookEventDelta>;
+static_assert(std::is_trivially_copyable_v<BookLevelUpdate>);
+static_assert(std::is_trivially_copyable_v<BookEventHeader>);
+
+// Parser output: events plus one shared level arena. Owned by the caller and
+// reused frame after frame; clear() keeps capacity, so a warmed-up feed parses
+// snapshots and deltas without touching the heap.
+class BookEventBatch
+{
+public:
+    void clear() noexcept
+    {
+        events_.clear();
+        levels_.clear();
+        gap_ = false;
+        rejected_levels_ = 0;
+    }
+
+    // Open an event; add_level() appends to it until the next begin().
+    void begin(BookEventKind kind, md::VenueId venue, md::SymbolId symbol,
+               std::int64_t ts_ns, std::uint64_t seq = 0)
+    {
+        events_.push_back(BookEventHeader{kind, venue, symbol,
+                                          static_cast<std::uint32_t>(levels_.size()), 0,
+                                          seq, ts_ns});
+    }
+
+    // Append a level to the open event; qty == 0 marks a delete.
+    void add_level(BookSide side, md::PriceTicks px, md::SizeLots qty)
+    {
+        levels_.push_back(BookLevelUpdate{px, qty, side, qty == 0 ? BookOp::Delete : BookOp::Upsert});
+        ++events_.back().count;
+    }
+
+    // Sequence of the open event, for venues that send it after the levels.
+    void set_seq(std::uint64_t seq) noexcept { events_.back().seq = seq; }
+
+    // Venue event time of the open event, for matching deltas against a REST
+    // snapshot that carries no sequence.
+    void set_venue_ts(std::int64_t ts_ns) noexcept { events_.back().venue_ts_ns = ts_ns; }
+
+    // Attach the venue's book checksum to the open event.
+    void set_checksum(std::uint32_t crc) noexcept
+    {
+        events_.back().checksum = crc;
+        events_.back().has_checksum = true;
+    }
+
+    // Close the open event, dropping it if no level was added. Returns true if kept.
+    bool commit() noexcept
+    {
+        if (events_.empty()) return false;
+        if (events_.back().count != 0) return true;
+        events_.pop_back();
+        return false;
+    }
+
+    // Append every event of `other` (resync buffering).
+    void append(const BookEventBatch& other)
+    {
+        const auto base = static_cast<std::uint32_t>(levels_.size());
+        levels_.insert(levels_.end(), other.levels_.begin(), other.levels_.end());
+        for (BookEventHeader ev : other.events_) {
+            ev.first += base;
+            events_.push_back(ev);
+        }
+        gap_ = gap_ || other.gap_;
+        rejected_levels_ += other.rejected_levels_;
+    }
+
+    // Drop the events stamped before `venue_ts_ns` (unstamped ones are kept):
+    // deltas a REST snapshot taken at that venue time already covers. Their
+    // levels stay in the arena until clear().
+    void drop_before(std::int64_t venue_ts_ns)
+    {
+        std::erase_if(events_, [venue_ts_ns](const BookEventHeader& ev) {
+            return ev.venue_ts_ns != 0 && ev.venue_ts_ns < venue_ts_ns;
+        });
+    }
+
+    // Undo everything added since mark() (a scanner falling back to a full parse).
+    struct Mark
+    {
+        std::size_t events;
+        std::size_t levels;
+    };
+    Mark mark() const noexcept { return {events_.size(), levels_.size()}; }
+    void rewind(Mark m)
+    {
+        events_.resize(m.events);
+        levels_.resize(m.levels);
+    }
+
+    // Parser saw a venue sequence break: updates were lost and the book must be
+    // resnapshotted. May be set on frames that carry no events (e.g. heartbeats).
+    void mark_gap() noexcept { gap_ = true; }
+    bool gap() const noexcept { return gap_; }
+
+    // Parser dropped a level of the open event whose price or size does not
+    // parse onto the fixed-point grid (md/fixed_point.hpp). Sizes saturate, so
+    // this is a malformed value or a price past the grid; such a level is
+    // dropped from snapshots and deltas alike and never enters the book, so
+    // it is not a gap.
+    void reject_level() noexcept { ++rejected_levels_; }
+    std::uint32_t rejected_levels() const noexcept { return rejected_levels_; }
+
+    bool has_snapshot() const noexcept
+    {
+        for (const auto& ev : events_) {
+            if (ev.kind == BookEventKind::Snapshot) return true;
+        }
+        return false;
+    }
+
+    bool empty() const noexcept { return events_.empty(); }
+    std::size_t level_count() const noexcept { return levels_.size(); }
+    const std::vector<BookEventHeader>& events() const noexcept { return events_; }
+
+    std::span<const BookLevelUpdate> levels(const BookEventHeader& ev) const noexcept
+    {
+        return {levels_.data() + ev.first, ev.count};
+    }
+
+private:
+    std::vector<BookEventHeader> events_;
+    std::vector<BookLevelUpdate> levels_;
+    bool gap_{false};
+    std::uint32_t rejected_levels_{0};
+};
@@ -1,14 +1,38 @@
 #pragma once
+#include "book_checksum.hpp"
 #include "book_events.hpp"
 #include <memory>
 #include <string>
-#include <vector>
 
 // Uniform interface for any venue book parser (snapshot + incremental updates).
 struct IBookParser {
     virtual ~IBookParser() = default;
 
-    // Parse a raw JSON text frame into one or more BookEvent(s).
-    // Return true if the message is successfully parsed as a relevant book event.
-    virtual bool parse(const std::string& raw, std::vector<BookEvent>& out) = 0;
+    // Parse a raw JSON text frame, appending one or more events to `out`.
+    // `out` is caller-owned and reused across frames (the caller clears it).
+    // Return true if the message produced at least one relevant book event.
+    // A detected venue sequence break is reported with out.mark_gap().
+    virtual bool parse(const std::string& raw, BookEventBatch& out) = 0;
+
+    // Parse the venue's REST depth response (see the WS adapter's
+    // fetch_book_snapshot()) into one snapshot event. False if unsupported/invalid.
+    virtual bool parse_rest_snapshot(const std::string& /*body*/, BookEventBatch& /*out*/) {
+        return false;
+    }
+
+    // Parse the venue's instrument metadata (see the WS adapter's
+    // fetch_instrument_info()), e.g. the precision its checksum formats levels
+    // with. False if unsupported/invalid.
+    virtual bool parse_instrument_info(const std::string& /*body*/) { return false; }
+
+    // Forget sequence continuity (new connection, feed reset).
+    virtual void reset_sequence() {}
+
+    // How to recompute the checksum the venue attaches to events (has_checksum);
+    // null if the venue sends none or its format is not yet known.
+    virtual const md::ChecksumRule* checksum_rule() const { return nullptr; }
+
+    // The connection also carries other symbols' frames that this parser never
+    // sees (WsMux), so connection-wide sequence numbers cannot be checked.
+    virtual void set_shared_connection(bool /*shared*/) {}
 };
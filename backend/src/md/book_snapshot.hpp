@@ -4,14 +4,8 @@
 #include <string>
 #include <vector>
 
-// Precomputed per-level book features in best-to-worse order.
-// Shared by routing and UI consumers.
-struct BookSnapshotLevel {
-    double price{0.0};
-    double size{0.0};
-    double cum_qty{0.0};
-    double cum_notional{0.0};
-};
+#include "intern.hpp"
+#include "snapshot_levels.hpp"
 
 // Immutable full-depth per-venue book snapshot.
 // Shared by routing and UI readers.
@@ -19,10 +13,12 @@ struct BookSnapshotLevel {
 struct BookSnapshot {
     std::string venue;
     std::string symbol;
+    md::VenueId venue_id{md::kNoVenue}; // md::venue_ids() id of `venue`
     std::uint64_t seq{0}; // monotonic local publish sequence
-    std::int64_t ts_ns{0};
+    std::int64_t ts_ns{0}; // steady_clock time of publish
     std::int64_t ts_ms{0};
 
-    std::vector<BookSnapshotLevel> bids;
-    std::vector<BookSnapshotLevel> asks;
+    // Chunked best-first ladders; unchanged chunks are shared with prior versions.
+    SnapshotLevels bids;
+    SnapshotLevels asks;
 };
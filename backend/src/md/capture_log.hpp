@@ -0,0 +1,210 @@
+#pragma once
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Raw market-data capture: every WebSocket frame a VenueFeed receives, appended
+// to a binary log that is replayed by mapping it into memory (venues/replay_ws.hpp).
+// Layout (host byte order, little-endian on every supported target):
+//   file header   "CRCAPLOG" magic, uint32 version, uint32 reserved   (16 bytes)
+//   record        int64 recv_ns      wall clock (UTC ns) when the frame arrived
+//                 uint32 frame_len
+//                 uint8 venue_len, uint8 symbol_len, uint16 reserved
+//                 venue, venue symbol, frame bytes, zero-padded to 8 bytes
+// Records are 8-byte aligned, so the header fields are read in place from the
+// mapping. A record cut short by a crash ends the log at the last whole record.
+namespace md {
+
+namespace capture {
+
+inline constexpr char kMagic[8] = {'C', 'R', 'C', 'A', 'P', 'L', 'O', 'G'};
+inline constexpr std::uint32_t kVersion = 1;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t reserved;
+};
+
+struct RecordHeader {
+    std::int64_t recv_ns;
+    std::uint32_t frame_len;
+    std::uint8_t venue_len;
+    std::uint8_t symbol_len;
+    std::uint16_t reserved;
+};
+
+static_assert(sizeof(FileHeader) == 16);
+static_assert(sizeof(RecordHeader) == 16);
+
+inline constexpr std::size_t kAlign = 8;
+
+inline std::size_t padded(std::size_t n) noexcept { return (n + kAlign - 1) & ~(kAlign - 1); }
+
+inline std::int64_t wall_ns() noexcept {
+    using namespace std::chrono;
+    return duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace capture
+
+// One captured frame; views point into the mapped log.
+struct CapturedFrame {
+    std::int64_t recv_ns{0};
+    std::string_view venue;
+    std::string_view symbol;
+    std::string_view frame;
+};
+
+// Appends frames from any number of feed threads (io shards, supervisor
+// threads) to one log. Writes go through a large stdio buffer under a mutex, so
+// the io thread pays a memcpy per frame, not a syscall.
+class CaptureWriter {
+public:
+    // Opens `path` for appending, writing the file header if it is new.
+    // Throws std::runtime_error if the file cannot be opened or is not a capture log.
+    explicit CaptureWriter(const std::string& path, std::size_t buffer_bytes = 1u << 20)
+    : buffer_(new char[buffer_bytes]) {
+        file_ = std::fopen(path.c_str(), "ab+");
+        if (!file_) throw std::runtime_error("capture: cannot open " + path);
+        std::setvbuf(file_, buffer_.get(), _IOFBF, buffer_bytes);
+
+        std::fseek(file_, 0, SEEK_END);
+        if (std::ftell(file_) == 0) {
+            capture::FileHeader header{};
+            std::memcpy(header.magic, capture::kMagic, sizeof(header.magic));
+            header.version = capture::kVersion;
+            std::fwrite(&header, sizeof(header), 1, file_);
+        } else if (std::ftell(file_) % capture::kAlign != 0) {
+            std::fclose(file_);
+            throw std::runtime_error("capture: " + path + " is not a capture log");
+        }
+    }
+
+    ~CaptureWriter() {
+        if (file_) std::fclose(file_);
+    }
+
+    CaptureWriter(const CaptureWriter&) = delete;
+    CaptureWriter& operator=(const CaptureWriter&) = delete;
+
+    // Thread-safe. Venue and symbol are truncated to 255 bytes.
+    void append(std::int64_t recv_ns, std::string_view venue, std::string_view symbol,
+                std::string_view frame) {
+        capture::RecordHeader header{};
+        header.recv_ns = recv_ns;
+        header.frame_len = static_cast<std::uint32_t>(frame.size());
+        header.venue_len = static_cast<std::uint8_t>(venue.size() < 256 ? venue.size() : 255);
+        header.symbol_len = static_cast<std::uint8_t>(symbol.size() < 256 ? symbol.size() : 255);
+        const std::size_t body = std::size_t{header.venue_len} + header.symbol_len + frame.size();
+        static constexpr char kZeros[capture::kAlign] = {};
+
+        std::lock_guard<std::mutex> lk(mu_);
+        std::fwrite(&header, sizeof(header), 1, file_);
+        std::fwrite(venue.data(), 1, header.venue_len, file_);
+        std::fwrite(symbol.data(), 1, header.symbol_len, file_);
+        std::fwrite(frame.data(), 1, frame.size(), file_);
+        std::fwrite(kZeros, 1, capture::padded(body) - body, file_);
+        ++frames_;
+    }
+
+    void append(std::string_view venue, std::string_view symbol, std::string_view frame) {
+        append(capture::wall_ns(), venue, symbol, frame);
+    }
+
+    void flush() {
+        std::lock_guard<std::mutex> lk(mu_);
+        std::fflush(file_);
+    }
+
+    std::uint64_t frames() const {
+        std::lock_guard<std::mutex> lk(mu_);
+        return frames_;
+    }
+
+private:
+    mutable std::mutex mu_;
+    std::unique_ptr<char[]> buffer_; // stdio buffer; outlives file_
+    std::FILE* file_{nullptr};
+    std::uint64_t frames_{0};
+};
+
+// Read-only mapping of a capture log. Records are walked by byte offset:
+//   for (std::size_t off = log.first(); log.read(off, rec); off = log.next(off)) ...
+class CaptureLog {
+public:
+    // Throws std::runtime_error if the file cannot be mapped or is not a capture log.
+    explicit CaptureLog(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("capture: cannot open " + path);
+        struct stat st{};
+        if (::fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(capture::FileHeader))) {
+            ::close(fd);
+            throw std::runtime_error("capture: " + path + " is not a capture log");
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        void* p = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) throw std::runtime_error("capture: cannot map " + path);
+        data_ = static_cast<const char*>(p);
+        ::madvise(p, size_, MADV_SEQUENTIAL);
+
+        capture::FileHeader header;
+        std::memcpy(&header, data_, sizeof(header));
+        if (std::memcmp(header.magic, capture::kMagic, sizeof(header.magic)) != 0 ||
+            header.version != capture::kVersion) {
+            ::munmap(p, size_);
+            throw std::runtime_error("capture: " + path + " is not a capture log");
+        }
+    }
+
+    ~CaptureLog() {
+        if (data_) ::munmap(const_cast<char*>(data_), size_);
+    }
+
+    CaptureLog(const CaptureLog&) = delete;
+    CaptureLog& operator=(const CaptureLog&) = delete;
+
+    static constexpr std::size_t first() noexcept { return sizeof(capture::FileHeader); }
+
+    // Record at `offset`; false past the last whole record.
+    bool read(std::size_t offset, CapturedFrame& out) const noexcept {
+        if (offset > size_ || size_ - offset < sizeof(capture::RecordHeader)) return false;
+        const auto* h = reinterpret_cast<const capture::RecordHeader*>(data_ + offset);
+        const std::size_t body = std::size_t{h->venue_len} + h->symbol_len + h->frame_len;
+        if (size_ - offset - sizeof(capture::RecordHeader) < body) return false;
+        const char* p = data_ + offset + sizeof(capture::RecordHeader);
+        out.recv_ns = h->recv_ns;
+        out.venue = std::string_view(p, h->venue_len);
+        out.symbol = std::string_view(p + h->venue_len, h->symbol_len);
+        out.frame = std::string_view(p + h->venue_len + h->symbol_len, h->frame_len);
+        return true;
+    }
+
+    // Offset of the record after the (valid) one at `offset`.
+    std::size_t next(std::size_t offset) const noexcept {
+        const auto* h = reinterpret_cast<const capture::RecordHeader*>(data_ + offset);
+        return offset + sizeof(capture::RecordHeader) +
+               capture::padded(std::size_t{h->venue_len} + h->symbol_len + h->frame_len);
+    }
+
+    std::size_t size_bytes() const noexcept { return size_; }
+
+private:
+    const char* data_{nullptr};
+    std::size_t size_{0};
+};
+
+} // namespace md
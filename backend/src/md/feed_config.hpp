@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "feed_wait.hpp"
+
+namespace md { class FeedRuntime; class CaptureWriter; class SnapshotSetPublisher; }
+
+// Per-feed runtime knobs, threaded from server configuration through
+// VenueFactory::make_feed into each VenueFeed.
+struct FeedConfig {
+    WaitPolicy wait; // consumer wakeup strategy when the frame queue is empty
+    // Shared io/worker threads; null keeps the dedicated supervisor + consumer
+    // threads per feed.
+    std::shared_ptr<md::FeedRuntime> runtime;
+    // Share one WebSocket per venue across symbols (see md/ws_mux.hpp).
+    // Requires runtime; ignored without it.
+    bool multiplex_ws{false};
+    std::size_t max_symbols_per_ws{100};
+    // Recompute venue book checksums (Kraken, OKX) after every update and
+    // resync on mismatch.
+    bool verify_checksums{true};
+    // While frames are queued back to back, the consumer gathers them into one
+    // coalesced book apply (and publish check) for up to this long; 0 applies
+    // every frame on its own.
+    std::int64_t coalesce_budget_ns{50'000};
+    // Append every received frame to a capture log (md/capture_log.hpp) for
+    // offline replay; null disables capture.
+    std::shared_ptr<md::CaptureWriter> capture;
+    // Symbol-wide snapshot set (md/snapshot_set.hpp) that every published
+    // snapshot is also written into; set per symbol by FeedManager.
+    std::shared_ptr<md::SnapshotSetPublisher> snapshot_set;
+};
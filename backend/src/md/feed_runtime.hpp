@@ -0,0 +1,159 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "venues/ws_io_pool.hpp"
+#include "feed_wait.hpp"
+
+namespace md {
+
+// Unit of consumer work drained by a FeedRuntime worker. A task is pinned to one
+// worker for its whole lifetime, so run_slice() is always called from the same
+// thread: the single-writer-per-Book invariant holds without extra locking.
+struct FeedTask {
+    virtual ~FeedTask() = default;
+    // Process at most `budget` queued frames (plus idle housekeeping).
+    // Returns true if any frame was consumed.
+    virtual bool run_slice(std::size_t budget) = 0;
+};
+
+// Shared feed runtime: a fixed pool of io_context shards for every WebSocket
+// session plus a fixed set of parser/book workers draining the feed rings.
+// Thread count is io_threads + workers regardless of how many pairs are live.
+// Feeds opt in through FeedConfig::runtime; without it each VenueFeed keeps its
+// own supervisor and consumer threads.
+class FeedRuntime {
+public:
+    struct Options {
+        std::size_t io_threads{2}; // WebSocket io_context shards
+        std::size_t workers{2};    // parser/book worker threads
+        WaitPolicy wait;           // worker wakeup strategy when every ring is empty
+    };
+
+    // Shard + worker assignment for one feed.
+    struct Pin {
+        std::size_t io_shard{0};
+        std::size_t worker{0};
+    };
+
+    explicit FeedRuntime(Options opts)
+    : io_(std::max<std::size_t>(1, opts.io_threads)) {
+        const std::size_t n = std::max<std::size_t>(1, opts.workers);
+        workers_.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            workers_.push_back(std::make_unique<Worker>(opts.wait));
+        }
+        for (auto& w : workers_) {
+            Worker* raw = w.get();
+            raw->thread = std::thread([this, raw] { worker_loop(*raw); });
+        }
+    }
+
+    ~FeedRuntime() { stop(); }
+
+    FeedRuntime(const FeedRuntime&) = delete;
+    FeedRuntime& operator=(const FeedRuntime&) = delete;
+
+    // Stop workers and io shards. Feeds must be stopped first (they hold a
+    // shared_ptr to the runtime, so normal teardown order guarantees this).
+    void stop() {
+        if (stopped_.exchange(true)) return;
+        running_.store(false, std::memory_order_relaxed);
+        for (auto& w : workers_) w->waiter.wake();
+        for (auto& w : workers_) {
+            if (w->thread.joinable()) w->thread.join();
+        }
+        io_.stop();
+    }
+
+    // Next shard/worker assignment (round-robin).
+    Pin assign() {
+        const std::size_t seq = next_pin_.fetch_add(1, std::memory_order_relaxed);
+        return Pin{seq % io_.size(), seq % workers_.size()};
+    }
+
+    // Start draining `task` on its pinned worker.
+    void attach(FeedTask* task, const Pin& pin) {
+        Worker& w = *workers_[pin.worker];
+        {
+            std::lock_guard<std::mutex> lk(w.mu);
+            w.tasks.push_back(task);
+        }
+        wake(pin);
+    }
+
+    // Returns once the worker no longer runs `task`.
+    void detach(FeedTask* task, const Pin& pin) {
+        Worker& w = *workers_[pin.worker];
+        std::lock_guard<std::mutex> lk(w.mu);
+        w.tasks.erase(std::remove(w.tasks.begin(), w.tasks.end(), task), w.tasks.end());
+    }
+
+    // Producer side: a frame was queued for a feed on this worker.
+    void notify(const Pin& pin) {
+        Worker& w = *workers_[pin.worker];
+        w.signal.store(true, std::memory_order_release);
+        w.waiter.notify();
+    }
+
+    // Unconditional wakeup (reset/stop requests).
+    void wake(const Pin& pin) {
+        Worker& w = *workers_[pin.worker];
+        w.signal.store(true, std::memory_order_release);
+        w.waiter.wake();
+    }
+
+    WsIoPool& io() noexcept { return io_; }
+    std::size_t io_threads() const noexcept { return io_.size(); }
+    std::size_t workers() const noexcept { return workers_.size(); }
+
+private:
+    // Frames drained from one feed before moving to the next (fairness).
+    static constexpr std::size_t kSliceBudget = 64;
+
+    struct Worker {
+        explicit Worker(const WaitPolicy& policy) : waiter(policy) {}
+        std::mutex mu;                 // guards tasks; held for one sweep
+        std::vector<FeedTask*> tasks;
+        FeedWaiter waiter;
+        std::atomic<bool> signal{false};
+        std::thread thread;
+    };
+
+    void worker_loop(Worker& w) {
+        while (running_.load(std::memory_order_relaxed)) {
+            // Clear before the sweep: a push that lands after its feed was visited
+            // re-sets the flag, so the wait below returns immediately.
+            w.signal.store(false, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+
+            bool worked = false;
+            {
+                std::lock_guard<std::mutex> lk(w.mu);
+                for (FeedTask* task : w.tasks) {
+                    worked |= task->run_slice(kSliceBudget);
+                }
+            }
+            if (worked) continue;
+
+            w.waiter.wait([&] {
+                return w.signal.load(std::memory_order_acquire) ||
+                       !running_.load(std::memory_order_relaxed);
+            });
+        }
+    }
+
+    WsIoPool io_;
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::atomic<std::size_t> next_pin_{0};
+    std::atomic<bool> running_{true};
+    std::atomic<bool> stopped_{false};
+};
+
+} // namespace md
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+// Consumer wakeup strategies for an empty VenueFeed queue.
+enum class WaitStrategy {
+    BusySpin,     // spin with a pause hint; lowest wake latency, one core per feed
+    SpinThenPark, // spin briefly, then park until the producer signals
+    Blocking      // park immediately; cheapest for many idle feeds
+};
+
+struct WaitPolicy {
+    WaitStrategy strategy{WaitStrategy::SpinThenPark};
+    std::uint32_t spin_iterations{4096}; // pause-spins before parking (SpinThenPark)
+    // Upper bound on one park so the consumer can still run its staleness checks.
+    std::chrono::milliseconds park_timeout{100};
+};
+
+namespace md {
+
+// CPU hint for spin loops (x86 PAUSE / ARM YIELD).
+inline void cpu_relax() noexcept {
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__)
+    _mm_pause();
+#elif defined(__aarch64__) || defined(__arm__)
+    asm volatile("yield" ::: "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+// Single-consumer waiter paired with an SPSC queue.
+// - Consumer calls wait(ready) when the queue is empty; it returns once ready()
+//   holds or a park/spin window elapses (callers re-check their own state).
+// - Producer calls notify() after each push; it only touches the mutex when the
+//   consumer is actually parked, so the hot path is one fence and one load.
+class FeedWaiter {
+public:
+    explicit FeedWaiter(WaitPolicy policy = WaitPolicy{}) : policy_(policy) {}
+
+    FeedWaiter(const FeedWaiter&) = delete;
+    FeedWaiter& operator=(const FeedWaiter&) = delete;
+
+    template <class Ready>
+    void wait(Ready&& ready) {
+        switch (policy_.strategy) {
+            case WaitStrategy::BusySpin:
+                for (std::uint32_t i = 0; i < kBusySpinBatch; ++i) {
+                    if (ready()) return;
+                    cpu_relax();
+                }
+                return;
+            case WaitStrategy::SpinThenPark:
+                for (std::uint32_t i = 0; i < policy_.spin_iterations; ++i) {
+                    if (ready()) return;
+                    cpu_relax();
+                }
+                park(ready);
+                return;
+            case WaitStrategy::Blocking:
+                park(ready);
+                return;
+        }
+    }
+
+    // Producer: wake the consumer if it is parked.
+    void notify() {
+        // Pairs with the fence in park(): either the consumer sees the pushed item
+        // before sleeping, or we see parked_ and signal.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!parked_.load(std::memory_order_relaxed)) return;
+        std::lock_guard<std::mutex> lk(mu_);
+        cv_.notify_one();
+    }
+
+    // Unconditional wakeup (stop/reset requests).
+    void wake() {
+        std::lock_guard<std::mutex> lk(mu_);
+        kick_ = true;
+        cv_.notify_one();
+    }
+
+    const WaitPolicy& policy() const noexcept { return policy_; }
+
+private:
+    // Busy-spin returns periodically so the consumer loop can check stop/staleness.
+    static constexpr std::uint32_t kBusySpinBatch = 1u << 14;
+
+    template <class Ready>
+    void park(Ready& ready) {
+        parked_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (!ready()) {
+            std::unique_lock<std::mutex> lk(mu_);
+            cv_.wait_for(lk, policy_.park_timeout, [&] { return kick_ || ready(); });
+            kick_ = false;
+        }
+        parked_.store(false, std::memory_order_relaxed);
+    }
+
+    WaitPolicy policy_;
+    std::atomic<bool> parked_{false};
+    std::mutex mu_;
+    std::condition_variable cv_;
+    bool kick_{false}; // guarded by mu_
+};
+
+} // namespace md
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string_view>
+
+// Fixed-point price/size representation for the market-data path.
+// Prices and sizes are scaled int64 values on one decimal grid shared by every
+// venue, so book keys and cross-venue price comparisons are exact integer ops.
+// - Price grid: 1e-10 (covers sub-satoshi quote ticks; max price ~9.2e8).
+// - Size grid:  1e-8  (covers venue lot precision; max size ~9.2e10, larger
+//   sizes saturate, see parse_size()).
+// Doubles are derived from these keys (exact division by a power of ten) only
+// where arithmetic needs them: notional/fee math and the JSON edge.
+namespace md {
+
+using PriceTicks = std::int64_t;
+using SizeLots = std::int64_t;
+
+inline constexpr int kPriceDecimals = 10;
+inline constexpr int kSizeDecimals = 8;
+inline constexpr std::int64_t kPriceScale = 10'000'000'000;
+inline constexpr std::int64_t kSizeScale = 100'000'000;
+
+namespace detail {
+
+inline constexpr std::int64_t kPow10[] = {
+    1,
+    10,
+    100,
+    1'000,
+    10'000,
+    100'000,
+    1'000'000,
+    10'000'000,
+    100'000'000,
+    1'000'000'000,
+    10'000'000'000,
+    100'000'000'000,
+    1'000'000'000'000,
+    10'000'000'000'000,
+    100'000'000'000'000,
+    1'000'000'000'000'000,
+    10'000'000'000'000'000,
+    100'000'000'000'000'000,
+    1'000'000'000'000'000'000,
+};
+
+// SWAR digit conversion: eight ASCII digits loaded as one little-endian word.
+inline bool is_eight_digits(std::uint64_t w) noexcept {
+    return ((w & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull) &&
+           (((w + 0x0606060606060606ull) & 0xF0F0F0F0F0F0F0F0ull) == 0x3030303030303030ull);
+}
+
+inline std::uint64_t eight_digits_value(std::uint64_t w) noexcept {
+    w -= 0x3030303030303030ull;
+    w = (w * 10 + (w >> 8)) & 0x00FF00FF00FF00FFull;
+    w = (w * 100 + (w >> 16)) & 0x0000FFFF0000FFFFull;
+    return (w * 10000 + (w >> 32)) & 0xFFFFFFFFull;
+}
+
+// Fast path for the common wire form: digits with at most one '.', nothing
+// else, and at most 18 digits (so no rounding is needed). Eight-digit runs are
+// converted a word at a time. False hands the string to the general parser.
+inline bool parse_plain_decimal(std::string_view s, std::uint64_t& mantissa, int& exp10) noexcept {
+    const char* p = s.data();
+    const std::size_t n = s.size();
+    std::uint64_t m = 0;
+    int digits = 0;
+    int frac = -1; // digits after '.', -1 before it
+    std::size_t i = 0;
+    while (i < n) {
+        if (n - i >= 8 && digits <= 10) {
+            std::uint64_t w;
+            std::memcpy(&w, p + i, 8);
+            if constexpr (std::endian::native == std::endian::little) {
+                if (is_eight_digits(w)) {
+                    m = m * 100'000'000 + eight_digits_value(w);
+                    digits += 8;
+                    if (frac >= 0) frac += 8;
+                    i += 8;
+                    continue;
+                }
+            }
+        }
+        const char c = p[i++];
+        if (c >= '0' && c <= '9') {
+            if (++digits > 18) return false;
+            m = m * 10 + static_cast<std::uint64_t>(c - '0');
+            if (frac >= 0) ++frac;
+        } else if (c == '.' && frac < 0) {
+            frac = 0;
+        } else {
+            return false;
+        }
+    }
+    if (digits == 0) return false;
+    mantissa = m;
+    exp10 = frac > 0 ? -frac : 0;
+    return true;
+}
+
+// General form: optional '+', exponent, more than 18 digits (rounded half-up
+// on the first dropped digit), trailing non-number characters.
+inline bool parse_general(std::string_view s, std::uint64_t& mantissa, int& exp10) noexcept {
+    std::size_t i = 0;
+    const std::size_t n = s.size();
+    if (i < n && s[i] == '+') ++i;
+
+    // Collect up to 18 significant digits as mantissa; remember the decimal exponent.
+    mantissa = 0;
+    exp10 = 0;
+    int mant_digits = 0;
+    bool any_digit = false;
+    bool round_up = false;  // first dropped digit >= 5
+    bool dropped = false;
+
+    for (; i < n && s[i] >= '0' && s[i] <= '9'; ++i) {
+        any_digit = true;
+        const int digit = s[i] - '0';
+        if (mant_digits < 18) {
+            if (mantissa != 0 || digit != 0) ++mant_digits;
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(digit);
+        } else {
+            if (!dropped) round_up = digit >= 5;
+            dropped = true;
+            ++exp10;
+        }
+    }
+    if (i < n && s[i] == '.') {
+        ++i;
+        for (; i < n && s[i] >= '0' && s[i] <= '9'; ++i) {
+            any_digit = true;
+            const int digit = s[i] - '0';
+            if (mant_digits < 18) {
+                if (mantissa != 0 || digit != 0) ++mant_digits;
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(digit);
+                --exp10;
+            } else if (!dropped) {
+                round_up = digit >= 5;
+                dropped = true;
+            }
+        }
+    }
+    if (!any_digit) return false;
+
+    if (i < n && (s[i] == 'e' || s[i] == 'E')) {
+        ++i;
+        bool neg = false;
+        if (i < n && (s[i] == '+' || s[i] == '-')) {
+            neg = s[i] == '-';
+            ++i;
+        }
+        int e = 0;
+        bool exp_digit = false;
+        for (; i < n && s[i] >= '0' && s[i] <= '9'; ++i) {
+            exp_digit = true;
+            if (e < 1000) e = e * 10 + (s[i] - '0');
+        }
+        if (!exp_digit) return false;
+        exp10 += neg ? -e : e;
+    }
+
+    if (round_up) ++mantissa;
+    return true;
+}
+
+} // namespace detail
+
+// Parse a non-negative decimal string ("45283.51", "0.00100000", "5e-05") onto a
+// grid with `decimals` fractional digits. Digits beyond the grid are rounded
+// half-up. Parsing stops at the first character that cannot continue the
+// number (closing quote, comma, whitespace), so raw JSON tokens work as-is.
+// Returns false on empty input, negative values or int64 overflow; with
+// `saturate`, an overflowing value yields the int64 maximum instead.
+inline bool parse_fixed(std::string_view s, int decimals, std::int64_t& out, bool saturate = false) noexcept {
+    constexpr std::int64_t kMax = std::numeric_limits<std::int64_t>::max();
+
+    std::uint64_t mantissa = 0;
+    int exp10 = 0; // value = mantissa * 10^exp10 (before grid scaling)
+    if (!detail::parse_plain_decimal(s, mantissa, exp10) && !detail::parse_general(s, mantissa, exp10)) {
+        return false;
+    }
+
+    // Rescale mantissa * 10^exp10 onto the target grid.
+    const int shift = exp10 + decimals;
+    if (mantissa == 0) {
+        out = 0;
+        return true;
+    }
+    if (shift >= 0) {
+        const bool overflow = shift > 18 ||
+            mantissa > static_cast<std::uint64_t>(kMax) / static_cast<std::uint64_t>(detail::kPow10[shift]);
+        if (overflow) {
+            if (saturate) out = kMax;
+            return saturate;
+        }
+        const auto mul = static_cast<std::uint64_t>(detail::kPow10[shift]);
+        out = static_cast<std::int64_t>(mantissa * mul);
+        return true;
+    }
+    const int drop = -shift;
+    if (drop > 18) {
+        out = 0;
+        return true;
+    }
+    const auto div = static_cast<std::uint64_t>(detail::kPow10[drop]);
+    std::uint64_t q = mantissa / div;
+    if ((mantissa % div) * 2 >= div) ++q;
+    out = static_cast<std::int64_t>(q);
+    return true;
+}
+
+inline bool parse_price(std::string_view s, PriceTicks& out) noexcept {
+    return parse_fixed(s, kPriceDecimals, out);
+}
+
+// Sizes past the grid's range (meme-coin books reach ~1e11 units) saturate at
+// the int64 maximum: the level keeps a capped size instead of being rejected,
+// so a delta never leaves the previous size behind.
+inline bool parse_size(std::string_view s, SizeLots& out) noexcept {
+    return parse_fixed(s, kSizeDecimals, out, true);
+}
+
+inline double price_to_double(PriceTicks px) noexcept {
+    return static_cast<double>(px) / static_cast<double>(kPriceScale);
+}
+
+inline double size_to_double(SizeLots qty) noexcept {
+    return static_cast<double>(qty) / static_cast<double>(kSizeScale);
+}
+
+// For inputs that only exist as doubles (JSON numbers from clients, limit prices).
+inline PriceTicks price_from_double(double px) noexcept {
+    if (!std::isfinite(px) || px <= 0.0) return 0;
+    const double scaled = px * static_cast<double>(kPriceScale);
+    if (scaled >= static_cast<double>(std::numeric_limits<std::int64_t>::max())) {
+        return std::numeric_limits<std::int64_t>::max();
+    }
+    return static_cast<PriceTicks>(std::llround(scaled));
+}
+
+inline SizeLots size_from_double(double qty) noexcept {
+    if (!std::isfinite(qty) || qty <= 0.0) return 0;
+    const double scaled = qty * static_cast<double>(kSizeScale);
+    if (scaled >= static_cast<double>(std::numeric_limits<std::int64_t>::max())) {
+        return std::numeric_limits<std::int64_t>::max();
+    }
+    return static_cast<SizeLots>(std::llround(scaled));
+}
+
+} // namespace md
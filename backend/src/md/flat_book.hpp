@@ -0,0 +1,326 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <span>
+#include <vector>
+
+#include "book_coalesce.hpp"
+#include "book_events.hpp"
+#include "book_snapshot.hpp"
+
+// Per-venue full-depth limit order book backed by contiguous sorted arrays.
+// Drop-in alternative to Book (same apply/read API) for VenueFeed's BookT parameter.
+// - Each side is a std::vector of levels ordered worst-to-best, so the touch sits at
+//   back(): updates near the top of book shift only a few trailing elements.
+// - Lookups are binary searches over contiguous memory (no per-level heap nodes).
+// - Same single-writer model and delta/snapshot semantics as Book.
+class FlatBook {
+public:
+    struct Level {
+        md::PriceTicks px{0};
+        md::SizeLots qty{0};
+    };
+    using Side = std::vector<Level>;
+
+    FlatBook(std::string venue, std::string symbol)
+        : venue_(std::move(venue)), symbol_(std::move(symbol))
+        , venue_id_(md::venue_ids().intern(venue_))
+        , symbol_id_(md::symbol_ids().intern(symbol_)) {}
+
+    // Single-event apply (ignored unless it targets this book).
+    void apply(const BookEventBatch& batch, const BookEventHeader& ev) {
+        if (!matches(ev.venue, ev.symbol)) return;
+        apply_unlocked(ev, batch.levels(ev));
+    }
+
+    // Batch apply. Runs of several delta events are coalesced: the last write
+    // per price is merged into each side in one ordered pass (same end state
+    // as applying the events one by one). A lone delta event is applied as is.
+    void apply_many(const BookEventBatch& batch) {
+        const auto& events = batch.events();
+        for (std::size_t i = 0; i < events.size(); ++i) {
+            const auto& ev = events[i];
+            if (ev.kind == BookEventKind::Snapshot) {
+                flush_coalesced();
+                apply_snapshot(ev, batch.levels(ev));
+            } else if (bid_stage_.empty() && ask_stage_.empty() &&
+                       (i + 1 == events.size() || events[i + 1].kind == BookEventKind::Snapshot)) {
+                apply_deltas(ev, batch.levels(ev));
+            } else {
+                stage_deltas(ev, batch.levels(ev));
+            }
+        }
+        flush_coalesced();
+    }
+
+    // Read API for publisher path.
+    std::vector<std::pair<double,double>> top_bids(std::size_t n) const {
+        return take_top_pairs(bids_, n);
+    }
+    std::vector<std::pair<double,double>> top_asks(std::size_t n) const {
+        return take_top_pairs(asks_, n);
+    }
+    // O(1) top-of-book access, on the fixed-point grid (used by publish gating).
+    std::optional<std::pair<md::PriceTicks, md::SizeLots>> best_level(BookSide side) const noexcept {
+        const Side& levels = side == BookSide::Bid ? bids_ : asks_;
+        if (levels.empty()) return std::nullopt;
+        return std::make_pair(levels.back().px, levels.back().qty);
+    }
+    std::optional<std::pair<double,double>> best_bid() const noexcept {
+        if (bids_.empty()) return std::nullopt;
+        return std::make_pair(md::price_to_double(bids_.back().px), md::size_to_double(bids_.back().qty));
+    }
+    std::optional<std::pair<double,double>> best_ask() const noexcept {
+        if (asks_.empty()) return std::nullopt;
+        return std::make_pair(md::price_to_double(asks_.back().px), md::size_to_double(asks_.back().qty));
+    }
+
+    // Best-first walk over up to n levels of one side: f(px, qty) (checksums).
+    template <class F>
+    void visit_top(BookSide side, std::size_t n, F&& f) const {
+        const Side& levels = side == BookSide::Bid ? bids_ : asks_;
+        for (auto it = levels.rbegin(); it != levels.rend() && n > 0; ++it, --n) f(it->px, it->qty);
+    }
+
+    std::size_t bid_levels() const noexcept { return bids_.size(); }
+    std::size_t ask_levels() const noexcept { return asks_.size(); }
+
+    // Copy full-depth best-first levels with cumulative features for snapshot publication.
+    // Only chunks owning prices touched since the last call are rebuilt.
+    void copy_snapshot_levels(SnapshotLevels& bids_out,
+                              SnapshotLevels& asks_out) const {
+        refresh_curve(bids_, bid_curve_, bid_dirty_, BestBid{});
+        refresh_curve(asks_, ask_curve_, ask_dirty_, BestAsk{});
+        bids_out = bid_curve_;
+        asks_out = ask_curve_;
+    }
+
+    const std::string& venue()  const noexcept { return venue_; }
+    const std::string& symbol() const noexcept { return symbol_; }
+
+    void clear() {
+        bids_.clear();
+        asks_.clear();
+        bid_curve_.clear();
+        ask_curve_.clear();
+        bid_dirty_.reset();
+        ask_dirty_.reset();
+        last_seq_ = 0;
+    }
+
+private:
+    // Worst-to-best orderings: bids ascend towards the best (highest) price,
+    // asks descend towards the best (lowest) price.
+    using BidOrder = std::less<md::PriceTicks>;
+    using AskOrder = std::greater<md::PriceTicks>;
+    // Best-first orderings (reverse iteration order) used by snapshot chunking.
+    using BestBid = std::greater<md::PriceTicks>;
+    using BestAsk = std::less<md::PriceTicks>;
+
+    static bool valid_price(md::PriceTicks px) noexcept { return px > 0; }
+    static bool valid_size(md::SizeLots qty) noexcept { return qty > 0; }
+
+    // -------- apply helpers --------
+    void apply_unlocked(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        if (ev.kind == BookEventKind::Snapshot) apply_snapshot(ev, levels);
+        else                                    apply_deltas(ev, levels);
+    }
+
+    void apply_snapshot(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        // Sequenced snapshot older than what was applied (REST vs stream race).
+        if (ev.seq && last_seq_ && ev.seq <= last_seq_) return;
+        bids_.clear();
+        asks_.clear();
+        for (const auto& lvl : levels) {
+            if (lvl.op == BookOp::Delete) continue;
+            if (!valid_price(lvl.px) || !valid_size(lvl.qty)) continue;
+            if (lvl.side == BookSide::Bid) bids_.push_back(Level{lvl.px, lvl.qty});
+            else                           asks_.push_back(Level{lvl.px, lvl.qty});
+        }
+        normalize(bids_, BidOrder{});
+        normalize(asks_, AskOrder{});
+        bid_dirty_.mark_full();
+        ask_dirty_.mark_full();
+        if (ev.seq) last_seq_ = ev.seq;
+    }
+
+    void apply_deltas(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        if (ev.seq && last_seq_ && ev.seq <= last_seq_) return;
+
+        for (const auto& lvl : levels) {
+            if (!valid_price(lvl.px)) continue;
+            if (lvl.side == BookSide::Bid) {
+                apply_one(bids_, lvl, BidOrder{});
+                bid_dirty_.add(lvl.px, BestBid{});
+            } else {
+                apply_one(asks_, lvl, AskOrder{});
+                ask_dirty_.add(lvl.px, BestAsk{});
+            }
+        }
+        if (ev.seq) last_seq_ = ev.seq;
+    }
+
+    void stage_deltas(const BookEventHeader& ev, std::span<const BookLevelUpdate> levels) {
+        if (ev.seq && last_seq_ && ev.seq <= last_seq_) return;
+        for (const auto& lvl : levels) {
+            if (!valid_price(lvl.px)) continue;
+            if (lvl.side == BookSide::Bid) bid_stage_.add(lvl);
+            else                           ask_stage_.add(lvl);
+        }
+        if (ev.seq) last_seq_ = ev.seq;
+    }
+
+    void flush_coalesced() {
+        if (!bid_stage_.empty()) merge_side(bids_, bid_stage_, bid_dirty_, BidOrder{}, BestBid{});
+        if (!ask_stage_.empty()) merge_side(asks_, ask_stage_, ask_dirty_, AskOrder{}, BestAsk{});
+    }
+
+    // Sorted updates against the worst-to-best array, walked best-first from
+    // the touch: each update's slot lies at or below the previous one, found
+    // by a short backwards scan (bursts cluster near the touch) or a binary
+    // search of what is left. Enough updates to shift most of the side are
+    // merged into a fresh array in one linear pass instead.
+    template <class Stage, class Order, class Better>
+    void merge_side(Side& side, Stage& stage, DirtyPriceRange& dirty, Order order, Better better) {
+        constexpr std::size_t kMaxSteps = 4;
+        const auto updates = stage.drain();
+        if (updates.size() * 8 >= side.size()) {
+            merge_rebuild(side, updates, order);
+        } else {
+            std::size_t hi = side.size(); // slots at or past hi are better than every remaining update
+            for (auto u = updates.rbegin(); u != updates.rend(); ++u) {
+                std::size_t steps = 0;
+                while (hi > 0 && !order(side[hi - 1].px, u->px) && ++steps <= kMaxSteps) --hi;
+                if (steps > kMaxSteps) {
+                    hi = static_cast<std::size_t>(
+                        std::lower_bound(side.begin(), side.begin() + static_cast<std::ptrdiff_t>(hi), u->px,
+                                         [order](const Level& l, md::PriceTicks px) { return order(l.px, px); }) -
+                        side.begin());
+                }
+                const auto it = side.begin() + static_cast<std::ptrdiff_t>(hi);
+                const bool found = it != side.end() && it->px == u->px;
+                if (u->qty == 0) {
+                    if (found) side.erase(it);
+                } else if (found) {
+                    it->qty = u->qty;
+                } else {
+                    side.insert(it, Level{u->px, u->qty});
+                }
+            }
+        }
+        dirty.add(updates.front().px, better);
+        dirty.add(updates.back().px, better);
+        stage.clear();
+    }
+
+    template <class Order>
+    void merge_rebuild(Side& side, std::span<const md::CoalescedLevel> updates, Order order) {
+        merge_scratch_.clear();
+        merge_scratch_.reserve(side.size() + updates.size());
+        auto it = side.begin();
+        for (const auto& u : updates) {
+            for (; it != side.end() && order(it->px, u.px); ++it) merge_scratch_.push_back(*it);
+            if (it != side.end() && it->px == u.px) ++it; // replaced or erased
+            if (u.qty != 0) merge_scratch_.push_back(Level{u.px, u.qty});
+        }
+        merge_scratch_.insert(merge_scratch_.end(), it, side.end());
+        side.swap(merge_scratch_);
+    }
+
+    template <class Order>
+    static void apply_one(Side& side, const BookLevelUpdate& d, Order order) {
+        // Most venue traffic lands at or next to the touch; check it before searching.
+        auto it = side.end();
+        if (side.empty() || order(side.back().px, d.px)) {
+            it = side.end();
+        } else if (side.back().px == d.px) {
+            it = side.end() - 1;
+        } else {
+            it = std::lower_bound(side.begin(), side.end(), d.px,
+                                  [order](const Level& l, md::PriceTicks px) { return order(l.px, px); });
+        }
+        const bool found = it != side.end() && it->px == d.px;
+
+        if (d.op == BookOp::Delete || !valid_size(d.qty)) {
+            if (found) side.erase(it);
+            return;
+        }
+        if (found) it->qty = d.qty;
+        else       side.insert(it, Level{d.px, d.qty});
+    }
+
+    // Sort snapshot levels worst-to-best; for duplicate prices the later level wins
+    // (matches map assignment semantics in Book).
+    template <class Order>
+    static void normalize(Side& side, Order order) {
+        std::stable_sort(side.begin(), side.end(),
+                         [order](const Level& a, const Level& b) { return order(a.px, b.px); });
+        std::size_t out = 0;
+        for (std::size_t i = 0; i < side.size(); ++i) {
+            if (out > 0 && side[out - 1].px == side[i].px) {
+                side[out - 1] = side[i];
+            } else {
+                side[out++] = side[i];
+            }
+        }
+        side.resize(out);
+    }
+
+    template <class Better>
+    static void refresh_curve(const Side& side, SnapshotLevels& curve,
+                              DirtyPriceRange& dirty, Better better) {
+        if (!dirty.any) return;
+        // Reverse iteration is best-first; binary-search both span ends on it.
+        auto range = [&side, better](const std::optional<md::PriceTicks>& lo,
+                                     const std::optional<md::PriceTicks>& hi) {
+            auto cmp = [better](const Level& l, md::PriceTicks px) { return better(l.px, px); };
+            auto b = lo ? std::lower_bound(side.rbegin(), side.rend(), *lo, cmp) : side.rbegin();
+            auto e = hi ? std::lower_bound(b, side.rend(), *hi, cmp) : side.rend();
+            return std::make_pair(b, e);
+        };
+        auto proj = [](const Level& l) { return std::make_pair(l.px, l.qty); };
+        curve = SnapshotLevels::rebuild(curve, dirty, better, range, proj);
+        dirty.reset();
+    }
+
+    static std::vector<std::pair<double,double>> take_top_pairs(const Side& side, std::size_t n) {
+        std::vector<std::pair<double,double>> out;
+        out.reserve(std::min(n, side.size()));
+        for (auto it = side.rbegin(); it != side.rend() && out.size() < n; ++it) {
+            out.emplace_back(md::price_to_double(it->px), md::size_to_double(it->qty));
+        }
+        return out;
+    }
+
+    bool matches(md::VenueId v, md::SymbolId s) const noexcept {
+        return v == venue_id_ && s == symbol_id_;
+    }
+
+    // -------- state --------
+    std::string venue_;
+    std::string symbol_;
+    md::VenueId venue_id_;
+    md::SymbolId symbol_id_;
+
+    Side bids_; // worst-to-best (best bid at back)
+    Side asks_; // worst-to-best (best ask at back)
+    std::uint64_t last_seq_{0}; // 0 => unknown; otherwise last applied seq
+
+    // Last published chunked curves and the prices touched since.
+    mutable SnapshotLevels bid_curve_;
+    mutable SnapshotLevels ask_curve_;
+    mutable DirtyPriceRange bid_dirty_;
+    mutable DirtyPriceRange ask_dirty_;
+
+    // apply_many() staging, worst-to-best like the sides, and the merge target
+    // swapped with a side on a full merge.
+    md::SideCoalescer<BidOrder> bid_stage_;
+    md::SideCoalescer<AskOrder> ask_stage_;
+    Side merge_scratch_;
+};
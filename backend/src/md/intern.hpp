@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Small-integer ids for venue and canonical symbol names on the market-data path.
+// Names are interned once (per feed / parser), after which events carry plain
+// integers and books compare ids instead of strings.
+namespace md {
+
+using VenueId = std::uint16_t;
+using SymbolId = std::uint32_t;
+
+inline constexpr VenueId kNoVenue = 0;
+inline constexpr SymbolId kNoSymbol = 0;
+
+// Process-wide name <-> id table. Ids are dense, start at 1 (0 = unset) and stay
+// valid for the process lifetime; names are never removed. Lookups take a shared
+// lock, so intern() belongs on setup / cache-miss paths, not per level.
+template <typename Id>
+class InternTable {
+public:
+    Id intern(std::string_view name) {
+        {
+            std::shared_lock<std::shared_mutex> lk(mu_);
+            auto it = ids_.find(name);
+            if (it != ids_.end()) return it->second;
+        }
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        auto it = ids_.find(name);
+        if (it != ids_.end()) return it->second;
+        if (names_.size() >= std::numeric_limits<Id>::max()) {
+            throw std::length_error("md::InternTable: id space exhausted");
+        }
+        const std::string& stored = names_.emplace_back(name); // deque: stable address
+        const Id id = static_cast<Id>(names_.size());
+        ids_.emplace(std::string_view(stored), id);
+        return id;
+    }
+
+    // Name for an id returned by intern(); empty for 0 / unknown ids.
+    std::string_view name(Id id) const {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        if (id == 0 || id > names_.size()) return {};
+        return names_[id - 1];
+    }
+
+private:
+    mutable std::shared_mutex mu_;
+    std::deque<std::string> names_;
+    std::unordered_map<std::string_view, Id> ids_;
+};
+
+inline InternTable<VenueId>& venue_ids() {
+    static InternTable<VenueId> table;
+    return table;
+}
+
+inline InternTable<SymbolId>& symbol_ids() {
+    static InternTable<SymbolId> table;
+    return table;
+}
+
+// Parser-local venue-symbol -> canonical SymbolId cache. A feed sees one (or a
+// handful of) symbols, so a linear scan beats hashing and the canonicalising
+// codec plus the global table are only hit on the first frame of each symbol.
+class SymbolIdCache {
+public:
+    // `to_canonical(venue_sym)` runs only on a miss.
+    template <typename ToCanonical>
+    SymbolId get(std::string_view venue_sym, ToCanonical&& to_canonical) {
+        for (const auto& [name, id] : entries_) {
+            if (name == venue_sym) return id;
+        }
+        const SymbolId id = symbol_ids().intern(to_canonical(venue_sym));
+        entries_.emplace_back(std::string(venue_sym), id);
+        return id;
+    }
+
+private:
+    std::vector<std::pair<std::string, SymbolId>> entries_;
+};
+
+} // namespace md
@@ -0,0 +1,189 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "book_events.hpp"
+#include "snapshot_levels.hpp"
+
+// K-way merge of best-first book sides (one per venue) into one consolidated
+// best-first ladder, without flattening and sorting: O(N log K) for N rows.
+// - Sources are [first, last) ranges over BookSnapshotLevel, already ordered
+//   best-first for the merged side (SnapshotLevels, vectors, spans).
+// - Order: best price first; at equal price the larger size first, then the
+//   lower source index (callers that prefer fresher venues add them first).
+// - Heads are kept in a tournament (loser) tree: after popping the winner only
+//   its leaf-to-root path is replayed, log2(K) compare-and-selects that
+//   compile to conditional moves (no data-dependent branches for K <= 8).
+// Storage is reused across merges (no allocation once warmed up).
+namespace md {
+
+struct LevelMergeOptions {
+    std::size_t per_source_depth{std::numeric_limits<std::size_t>::max()}; // levels read from each source
+    std::size_t max_levels{std::numeric_limits<std::size_t>::max()};       // rows emitted in total
+    bool aggregate{false}; // one row per price, sizes summed across sources
+};
+
+struct MergedLevel {
+    // cum_qty/cum_notional are running totals over the merged ladder.
+    BookSnapshotLevel level;
+    std::uint32_t source{0}; // input index; for aggregated rows the first one at this price
+};
+
+template <class It>
+class LevelMerger {
+public:
+    explicit LevelMerger(BookSide side = BookSide::Bid) noexcept : side_(side) {}
+
+    void reset(BookSide side) noexcept {
+        side_ = side;
+        srcs_.clear();
+    }
+
+    // Appends a best-first source; its index is the number of sources before it.
+    void add(It first, It last) { srcs_.push_back(Source{first, first, last}); }
+
+    std::size_t sources() const noexcept { return srcs_.size(); }
+
+    // Emits merged rows best-first from the start of every source.
+    // emit(const MergedLevel&) may return false to stop early.
+    // Returns the number of rows emitted.
+    template <class Emit>
+    std::size_t run(const LevelMergeOptions& opts, Emit&& emit) {
+        if (srcs_.empty() || opts.max_levels == 0) return 0;
+        init(opts.per_source_depth);
+
+        std::size_t rows = 0;
+        double cum_qty = 0.0;
+        double cum_notional = 0.0;
+        MergedLevel pending;
+        bool has_pending = false;
+
+        // Returns false when the caller asked to stop.
+        auto flush = [&](MergedLevel& row) {
+            cum_qty += row.level.size;
+            cum_notional += row.level.price * row.level.size;
+            row.level.cum_qty = cum_qty;
+            row.level.cum_notional = cum_notional;
+            ++rows;
+            if constexpr (std::is_same_v<std::invoke_result_t<Emit&, const MergedLevel&>, bool>) {
+                return emit(static_cast<const MergedLevel&>(row));
+            } else {
+                emit(static_cast<const MergedLevel&>(row));
+                return true;
+            }
+        };
+
+        while (keys_[winner_] != kExhausted) {
+            const std::uint32_t s = winner_;
+            const BookSnapshotLevel& lvl = heads_[s];
+
+            if (!opts.aggregate) {
+                MergedLevel row{lvl, s};
+                if (!flush(row) || rows == opts.max_levels) return rows;
+            } else if (has_pending && pending.level.px == lvl.px) {
+                pending.level.qty += lvl.qty;
+                pending.level.size += lvl.size;
+            } else {
+                if (has_pending && (!flush(pending) || rows == opts.max_levels)) return rows;
+                pending = MergedLevel{lvl, s};
+                has_pending = true;
+            }
+
+            advance(s);
+            replay(s);
+        }
+        if (has_pending) flush(pending);
+        return rows;
+    }
+
+private:
+    static constexpr std::int64_t kExhausted = std::numeric_limits<std::int64_t>::max();
+
+    struct Source {
+        It first;
+        It it;
+        It last;
+        std::size_t left{0}; // levels still allowed by per_source_depth
+    };
+
+    // Smaller key = better row: price key (ascending), then larger size, then index.
+    bool less(std::uint32_t a, std::uint32_t b) const noexcept {
+        const std::int64_t ka = keys_[a], kb = keys_[b];
+        const std::int64_t qa = qtys_[a], qb = qtys_[b];
+        return (ka < kb) | ((ka == kb) & ((qa > qb) | ((qa == qb) & (a < b))));
+    }
+
+    void load(std::uint32_t s) {
+        Source& src = srcs_[s];
+        if (src.left == 0 || src.it == src.last) {
+            keys_[s] = kExhausted;
+            qtys_[s] = 0;
+            return;
+        }
+        heads_[s] = *src.it;
+        // Bids: higher price is better; negate so the tree always takes the minimum.
+        keys_[s] = side_ == BookSide::Bid ? -heads_[s].px : heads_[s].px;
+        qtys_[s] = heads_[s].qty;
+    }
+
+    void advance(std::uint32_t s) {
+        Source& src = srcs_[s];
+        ++src.it;
+        --src.left;
+        load(s);
+    }
+
+    void init(std::size_t per_source_depth) {
+        const std::size_t k = srcs_.size();
+        leaves_ = std::bit_ceil(k);
+        heads_.resize(leaves_);
+        keys_.assign(leaves_, kExhausted); // padding leaves never win
+        qtys_.assign(leaves_, 0);
+        for (std::size_t s = 0; s < k; ++s) {
+            srcs_[s].it = srcs_[s].first;
+            srcs_[s].left = per_source_depth;
+            load(static_cast<std::uint32_t>(s));
+        }
+
+        // Bottom-up build: every inner node keeps the loser of its match and
+        // passes the winner up; node 0 is unused, the overall winner is kept apart.
+        losers_.assign(leaves_, 0);
+        win_.resize(2 * leaves_);
+        for (std::size_t i = 0; i < leaves_; ++i) win_[leaves_ + i] = static_cast<std::uint32_t>(i);
+        for (std::size_t n = leaves_ - 1; n >= 1; --n) {
+            const std::uint32_t a = win_[2 * n], b = win_[2 * n + 1];
+            const bool a_wins = less(a, b);
+            win_[n] = a_wins ? a : b;
+            losers_[n] = a_wins ? b : a;
+        }
+        winner_ = win_[1];
+    }
+
+    // Source s changed its head: replay its matches up to the root.
+    void replay(std::uint32_t s) noexcept {
+        std::uint32_t cur = s;
+        for (std::size_t n = (leaves_ + s) >> 1; n >= 1; n >>= 1) {
+            const std::uint32_t other = losers_[n];
+            const bool other_wins = less(other, cur);
+            losers_[n] = other_wins ? cur : other;
+            cur = other_wins ? other : cur;
+        }
+        winner_ = cur;
+    }
+
+    BookSide side_;
+    std::vector<Source> srcs_;
+    std::vector<BookSnapshotLevel> heads_;
+    std::vector<std::int64_t> keys_;
+    std::vector<std::int64_t> qtys_;
+    std::vector<std::uint32_t> losers_; // per inner node: the source that lost its match
+    std::vector<std::uint32_t> win_; // build scratch
+    std::size_t leaves_{1};
+    std::uint32_t winner_{0};
+};
+
+} // namespace md
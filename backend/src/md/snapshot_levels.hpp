@@ -0,0 +1,253 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "fixed_point.hpp"
+
+// Precomputed per-level book features in best-to-worse order.
+// Shared by routing and UI consumers.
+// px/qty are the exact fixed-point keys (compare/order on these); price/size are
+// their double views for notional and fee arithmetic.
+struct BookSnapshotLevel {
+    md::PriceTicks px{0};
+    md::SizeLots qty{0};
+    double price{0.0};
+    double size{0.0};
+    double cum_qty{0.0};
+    double cum_notional{0.0};
+};
+
+// Prices touched on one book side since the last snapshot publication,
+// tracked as a best/worst bound under the side's best-first ordering.
+struct DirtyPriceRange {
+    bool any{false};
+    bool full{false}; // whole side replaced (snapshot/clear): rebuild from scratch
+    md::PriceTicks best{0};
+    md::PriceTicks worst{0};
+
+    template <class Better>
+    void add(md::PriceTicks px, Better better) noexcept {
+        if (!any) {
+            any = true;
+            best = worst = px;
+            return;
+        }
+        if (better(px, best)) best = px;
+        if (better(worst, px)) worst = px;
+    }
+    void mark_full() noexcept { any = true; full = true; }
+    void reset() noexcept { *this = DirtyPriceRange{}; }
+};
+
+// Persistent best-first ladder of BookSnapshotLevel split into immutable chunks.
+// - Consecutive snapshot versions share every chunk the book did not touch;
+//   publishing re-materializes only the chunks owning dirty prices.
+// - Chunks store chunk-local cum_qty/cum_notional; each version keeps per-chunk
+//   base offsets, so a change near the touch only rebases the suffix offsets
+//   (O(chunks), not O(levels)).
+// - Read API mirrors the std::vector subset readers use (size/empty/front/[]/range-for);
+//   elements are returned by value with global cumulative fields applied.
+class SnapshotLevels {
+public:
+    static constexpr std::size_t kChunkLevels = 64;    // target levels per chunk
+    static constexpr std::size_t kMinChunkLevels = 16; // smaller rebuilt spans absorb a neighbour
+
+    struct Chunk {
+        std::vector<BookSnapshotLevel> levels; // cum fields are chunk-local
+    };
+
+    struct ChunkRef {
+        std::shared_ptr<const Chunk> chunk;
+        std::size_t start{0};      // global index of chunk->levels[0]
+        double base_qty{0.0};      // totals of all preceding chunks
+        double base_notional{0.0};
+    };
+
+    class const_iterator {
+    public:
+        using iterator_category = std::forward_iterator_tag;
+        using value_type = BookSnapshotLevel;
+        using difference_type = std::ptrdiff_t;
+        using reference = BookSnapshotLevel;
+        using pointer = void;
+
+        const_iterator() = default;
+        const_iterator(const ChunkRef* ref, std::size_t off) noexcept
+            : ref_(ref), off_(off) {}
+
+        BookSnapshotLevel operator*() const noexcept { return materialize(*ref_, off_); }
+
+        const_iterator& operator++() noexcept {
+            if (++off_ >= ref_->chunk->levels.size()) {
+                ++ref_;
+                off_ = 0;
+            }
+            return *this;
+        }
+        const_iterator operator++(int) noexcept {
+            auto tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        bool operator==(const const_iterator& o) const noexcept {
+            return ref_ == o.ref_ && off_ == o.off_;
+        }
+        bool operator!=(const const_iterator& o) const noexcept { return !(*this == o); }
+
+    private:
+        const ChunkRef* ref_{nullptr};
+        std::size_t off_{0};
+    };
+
+    // -------- read API --------
+    std::size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    BookSnapshotLevel front() const noexcept { return materialize(refs_.front(), 0); }
+    BookSnapshotLevel back() const noexcept {
+        const auto& r = refs_.back();
+        return materialize(r, r.chunk->levels.size() - 1);
+    }
+
+    BookSnapshotLevel operator[](std::size_t i) const noexcept {
+        auto it = std::upper_bound(refs_.begin(), refs_.end(), i,
+                                   [](std::size_t v, const ChunkRef& r) { return v < r.start; });
+        --it;
+        return materialize(*it, i - it->start);
+    }
+
+    const_iterator begin() const noexcept {
+        return const_iterator(refs_.data(), 0);
+    }
+    const_iterator end() const noexcept {
+        return const_iterator(refs_.data() + refs_.size(), 0);
+    }
+
+    std::size_t chunk_count() const noexcept { return refs_.size(); }
+    const std::vector<ChunkRef>& chunks() const noexcept { return refs_; }
+
+    void clear() noexcept {
+        refs_.clear();
+        size_ = 0;
+    }
+
+    // -------- writer API (book owner thread) --------
+
+    // Rebuild from the chunks of `prev` that own prices in `dirty`, sharing the rest.
+    // - Better: strict best-first price ordering of the side.
+    // - range(lo, hi): best-first iterator pair over current book levels with
+    //   lo <= px (inclusive, nullopt = from the touch) and px < hi (exclusive,
+    //   nullopt = to the end), both under Better.
+    // - proj(*it): returns {PriceTicks, SizeLots}.
+    template <class Better, class RangeFn, class Proj>
+    static SnapshotLevels rebuild(const SnapshotLevels& prev,
+                                  const DirtyPriceRange& dirty,
+                                  Better better,
+                                  RangeFn&& range,
+                                  Proj proj) {
+        const std::size_t n = dirty.full ? 0 : prev.refs_.size();
+        std::size_t first = 0;
+        std::size_t last = n;
+        if (n > 0) {
+            first = prev.owning_chunk(dirty.best, better);
+            last = prev.owning_chunk(dirty.worst, better) + 1;
+        }
+
+        // Chunk i owns prices from its front up to (excluding) the front of chunk i+1,
+        // so the replaced span is bounded by the neighbouring chunk fronts.
+        auto bounds = [&](std::size_t f, std::size_t l) {
+            std::optional<md::PriceTicks> lo, hi;
+            if (f > 0) lo = prev.refs_[f].chunk->levels.front().px;
+            if (l < n) hi = prev.refs_[l].chunk->levels.front().px;
+            return range(lo, hi);
+        };
+
+        auto span = bounds(first, last);
+        std::size_t count = static_cast<std::size_t>(std::distance(span.first, span.second));
+        while (count < kMinChunkLevels && (first > 0 || last < n)) {
+            if (last < n) ++last;
+            else          --first;
+            span = bounds(first, last);
+            count = static_cast<std::size_t>(std::distance(span.first, span.second));
+        }
+
+        SnapshotLevels out;
+        out.refs_.reserve(first + (count + kChunkLevels - 1) / kChunkLevels + (n - last));
+        out.refs_.insert(out.refs_.end(), prev.refs_.begin(), prev.refs_.begin() + first);
+
+        std::size_t start = 0;
+        double base_qty = 0.0;
+        double base_notional = 0.0;
+        if (first > 0) {
+            const auto& tail = prev.refs_[first - 1];
+            const auto& last_lvl = tail.chunk->levels.back();
+            start = tail.start + tail.chunk->levels.size();
+            base_qty = tail.base_qty + last_lvl.cum_qty;
+            base_notional = tail.base_notional + last_lvl.cum_notional;
+        }
+
+        // Split the rebuilt span into near-equal chunks of about kChunkLevels.
+        const std::size_t pieces = count == 0 ? 0 : (count + kChunkLevels - 1) / kChunkLevels;
+        auto it = span.first;
+        for (std::size_t p = 0; p < pieces; ++p) {
+            const std::size_t len = count / pieces + (p < count % pieces ? 1 : 0);
+            auto chunk = std::make_shared<Chunk>();
+            chunk->levels.reserve(len);
+            double cum_qty = 0.0;
+            double cum_notional = 0.0;
+            for (std::size_t k = 0; k < len; ++k, ++it) {
+                const auto [px, qty] = proj(*it);
+                const double price = md::price_to_double(px);
+                const double size = md::size_to_double(qty);
+                cum_qty += size;
+                cum_notional += price * size;
+                chunk->levels.push_back(BookSnapshotLevel{px, qty, price, size, cum_qty, cum_notional});
+            }
+            out.refs_.push_back(ChunkRef{std::move(chunk), start, base_qty, base_notional});
+            start += len;
+            base_qty += cum_qty;
+            base_notional += cum_notional;
+        }
+
+        // Shared suffix: same chunks, new offsets.
+        for (std::size_t i = last; i < n; ++i) {
+            const auto& src = prev.refs_[i];
+            const auto& last_lvl = src.chunk->levels.back();
+            out.refs_.push_back(ChunkRef{src.chunk, start, base_qty, base_notional});
+            start += src.chunk->levels.size();
+            base_qty += last_lvl.cum_qty;
+            base_notional += last_lvl.cum_notional;
+        }
+
+        out.size_ = start;
+        return out;
+    }
+
+private:
+    static BookSnapshotLevel materialize(const ChunkRef& r, std::size_t off) noexcept {
+        BookSnapshotLevel lvl = r.chunk->levels[off];
+        lvl.cum_qty += r.base_qty;
+        lvl.cum_notional += r.base_notional;
+        return lvl;
+    }
+
+    // Last chunk whose front is at or better than px (chunk 0 if px beats every front).
+    template <class Better>
+    std::size_t owning_chunk(md::PriceTicks px, Better better) const noexcept {
+        auto it = std::partition_point(refs_.begin(), refs_.end(), [&](const ChunkRef& r) {
+            return !better(px, r.chunk->levels.front().px);
+        });
+        return it == refs_.begin() ? 0 : static_cast<std::size_t>(it - refs_.begin()) - 1;
+    }
+
+    std::vector<ChunkRef> refs_;
+    std::size_t size_{0};
+};
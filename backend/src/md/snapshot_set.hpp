@@ -0,0 +1,120 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <version>
+#include <vector>
+
+#include "book_snapshot.hpp"
+#include "intern.hpp"
+
+// Per-symbol set of every venue's latest BookSnapshot, republished as one
+// immutable object whenever any venue publishes. Routers take the whole set
+// with a single atomic load instead of one load_snapshot() per feed, so the
+// books they combine were all current at the same instant, and each entry's
+// transport_ns tells them whether that venue's connection is still live.
+namespace md {
+
+// shared_ptr with atomic load / store / CAS: std::atomic<std::shared_ptr>
+// where the library has it (per-object lock bit), otherwise the
+// std::atomic_* free functions (global lock table).
+template <class T>
+class AtomicSharedPtr {
+public:
+    AtomicSharedPtr() = default;
+    explicit AtomicSharedPtr(std::shared_ptr<T> p) noexcept : p_(std::move(p)) {}
+
+    AtomicSharedPtr(const AtomicSharedPtr&) = delete;
+    AtomicSharedPtr& operator=(const AtomicSharedPtr&) = delete;
+
+#if defined(__cpp_lib_atomic_shared_ptr)
+    std::shared_ptr<T> load() const noexcept { return p_.load(std::memory_order_acquire); }
+    void store(std::shared_ptr<T> p) noexcept { p_.store(std::move(p), std::memory_order_release); }
+    // On failure `expected` is updated to the current value.
+    bool compare_exchange(std::shared_ptr<T>& expected, std::shared_ptr<T> desired) noexcept {
+        return p_.compare_exchange_weak(expected, std::move(desired), std::memory_order_acq_rel,
+                                        std::memory_order_acquire);
+    }
+
+private:
+    std::atomic<std::shared_ptr<T>> p_;
+#else
+    std::shared_ptr<T> load() const noexcept { return std::atomic_load_explicit(&p_, std::memory_order_acquire); }
+    void store(std::shared_ptr<T> p) noexcept {
+        std::atomic_store_explicit(&p_, std::move(p), std::memory_order_release);
+    }
+    bool compare_exchange(std::shared_ptr<T>& expected, std::shared_ptr<T> desired) noexcept {
+        return std::atomic_compare_exchange_weak_explicit(&p_, &expected, std::move(desired),
+                                                          std::memory_order_acq_rel, std::memory_order_acquire);
+    }
+
+private:
+    std::shared_ptr<T> p_;
+#endif
+};
+
+struct SnapshotSet {
+    struct Venue {
+        VenueId venue_id{kNoVenue};
+        std::shared_ptr<const BookSnapshot> book; // null until the first publish / after a reset
+        // Steady-clock ns of the last frame seen on the venue's connection
+        // (heartbeats included), as of the last publish or touch(); 0 if none.
+        // A quiet book on a live connection keeps this current.
+        std::int64_t transport_ns{0};
+    };
+
+    std::uint64_t version{0}; // bumped on every publish
+    std::vector<Venue> venues; // registration order; indices are stable
+};
+
+// Owner of one symbol's SnapshotSet. Venues register once and then publish
+// from their own consumer threads; each publish copies the set with that
+// venue's entry replaced and CASes it in (a handful of venues, so the copy is
+// a few refcount bumps).
+class SnapshotSetPublisher {
+public:
+    SnapshotSetPublisher() : set_(std::make_shared<const SnapshotSet>()) {}
+
+    // Adds a venue slot (initially without a book) and returns its index.
+    std::size_t add_venue(VenueId venue_id) {
+        std::size_t slot = 0;
+        update([&](SnapshotSet& next) {
+            slot = next.venues.size();
+            next.venues.push_back(SnapshotSet::Venue{venue_id, nullptr});
+        });
+        return slot;
+    }
+
+    // Replaces the slot's book; null marks the venue as having no book.
+    void publish(std::size_t slot, std::shared_ptr<const BookSnapshot> book, std::int64_t transport_ns) {
+        update([&](SnapshotSet& next) {
+            next.venues[slot].book = book;
+            next.venues[slot].transport_ns = transport_ns;
+        });
+    }
+
+    // Refreshes the slot's transport clock, keeping its book.
+    void touch(std::size_t slot, std::int64_t transport_ns) {
+        update([&](SnapshotSet& next) { next.venues[slot].transport_ns = transport_ns; });
+    }
+
+    std::shared_ptr<const SnapshotSet> load() const noexcept { return set_.load(); }
+
+private:
+    template <class Mutate>
+    void update(Mutate&& mutate) {
+        auto current = set_.load();
+        for (;;) {
+            auto next = std::make_shared<SnapshotSet>(*current);
+            next->version = current->version + 1;
+            mutate(*next);
+            if (set_.compare_exchange(current, std::move(next))) return;
+        }
+    }
+
+    AtomicSharedPtr<const SnapshotSet> set_;
+};
+
+} // namespace md
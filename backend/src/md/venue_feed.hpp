@@ -2,6 +2,8 @@
 #include <algorithm>
 #include <atomic>
 #include <chrono>
+#include <concepts>
+#include <iostream>
 #include <memory>
 #include <mutex>
 #include <optional>
@@ -10,18 +12,29 @@
 #include <utility>
 #include <vector>
 
-#include "util/spsc_ring.hpp"
+#include "util/frame_pool.hpp"
+#include "util/spsc_queue.hpp"
+#include "feed_config.hpp"
 #include "feed_liveness.hpp"
+#include "feed_runtime.hpp"
+#include "feed_wait.hpp"
+#include "ws_mux.hpp"
 #include "venue_feed_iface.hpp"
 #include "book.hpp"
+#include "flat_book.hpp"
+#include "book_checksum.hpp"
 #include "book_events.hpp"
 #include "book_snapshot.hpp"
+#include "capture_log.hpp"
+#include "snapshot_set.hpp"
 
 // Backpressure policy when the queue is full
 enum class Backpressure {
     DropNewest,   // drop newest frame
-    DropOldest,   // evict one stale, then push newest
-    SignalResync  // set a flag for re-snapshot
+    DropOldest,   // newest frame overwrites the oldest queued one; the consumer resyncs
+    SignalResync, // drop newest frame and resync the book (deltas were lost)
+    Block         // producer waits for the consumer; offline replay only (a live
+                  // socket would stall)
 };
 
 // Adaptive gate for immutable snapshot publication.
@@ -32,25 +45,49 @@ struct PublishPolicy {
     double top_size_rel_change_trigger{0.05};      // 5% top-size change trigger
 };
 
-// VenueFeed is parameterized by concrete Ws type and concrete Parser type.
+// VenueFeed is parameterized by concrete Ws type, concrete Parser type and the
+// book engine (Book: ordered maps, FlatBook: contiguous sorted arrays).
 // Each VenueFeed owns:
 //  - a WS connection supervisor thread (auto-reconnects on disconnect/stale transport)
-//  - an SPSC ring for raw messages
-//  - a single consumer thread that parses and mutates the book
+//  - a pool of padded raw-frame buffers, handed to the consumer by index over an SPSC ring
+//  - a single consumer thread that parses and mutates the book, waking per FeedConfig::wait
 //  - immutable snapshots published atomically for UI and router readers
-template <typename WsT, typename ParserT, std::size_t QueuePow2 = 4096>
-class VenueFeed final : public IVenueFeed {
+// With FeedConfig::runtime set, the feed owns no threads: its WS session runs on a
+// pinned io shard and its ring is drained by a pinned FeedRuntime worker instead.
+// With a WsMux, the feed owns no connection either: the venue's shared socket
+// routes this symbol's frames into the ring.
+// Lost updates (parser-detected sequence gaps, venue checksum mismatches, ring
+// overflow) trigger an in-place resync: the consumer buffers new deltas while a
+// short-lived thread fetches the venue's REST depth snapshot, then applies the
+// snapshot plus the buffer. The WebSocket stays up; only a failed fetch falls
+// back to a transport reset. Connectors with instrument metadata (Kraken's
+// checksum precision) have it fetched by the same thread when the feed starts.
+template <typename WsT, typename ParserT, std::size_t QueuePow2 = 4096, typename BookT = Book>
+class VenueFeed final : public IVenueFeed, private md::FeedTask, private WsMuxSink {
 public:
     VenueFeed(std::string venue_name,
               std::string canonical_symbol,
               Backpressure bp = Backpressure::DropOldest,
-              PublishPolicy publish_policy = PublishPolicy{})
+              PublishPolicy publish_policy = PublishPolicy{},
+              FeedConfig config = FeedConfig{},
+              std::shared_ptr<WsMux<WsT, ParserT>> mux = nullptr)
     : venue_(std::move(venue_name))
     , canonical_(std::move(canonical_symbol))
+    , venue_id_(md::venue_ids().intern(venue_))
     , backpressure_(bp)
     , publish_policy_(publish_policy)
+    , waiter_(config.wait)
+    , verify_checksums_(config.verify_checksums)
+    , capture_(std::move(config.capture))
+    , snapshot_set_(std::move(config.snapshot_set))
+    , coalesce_budget_ns_(config.coalesce_budget_ns)
+    , runtime_(std::move(config.runtime))
+    , mux_(std::move(mux))
     , running_(false)
-    , book_(venue_, canonical_) {}
+    , book_(venue_, canonical_) {
+        if (mux_) parser_.set_shared_connection(true);
+        if (snapshot_set_) snapshot_set_slot_ = snapshot_set_->add_venue(venue_id_);
+    }
 
     // Start a self-healing transport loop for this venue symbol.
     void start_ws(const std::string& venue_symbol, unsigned short port = 443) override {
@@ -59,17 +96,52 @@ public:
 
         venue_symbol_ = venue_symbol;
         ws_port_ = port;
+        if constexpr (kInstrumentInfo) {
+            std::lock_guard<std::mutex> lk(resync_mu_);
+            start_fetcher();
+        }
+
+        if (mux_) {
+            start_consumer();
+            const auto* liveness = mux_->subscribe(venue_symbol_, this, ws_port_);
+            if (!liveness) {
+                std::cerr << "[feed] " << venue_ << " " << venue_symbol_
+                          << " is already routed on the shared connection\n";
+            }
+            mux_liveness_.store(liveness, std::memory_order_release);
+            return;
+        }
+
+        if (runtime_) {
+            start_consumer();
+            connect_async();
+            return;
+        }
 
         consumer_ = std::thread([this] { consume_loop(); });
         ws_thread_ = std::thread([this] { ws_supervisor_loop(); });
     }
 
     // Orderly stop consumer + websocket supervisor.
+    // An in-flight REST resync fetch is waited out (it captures `this`).
     void stop() override {
         running_.store(false, std::memory_order_relaxed);
-        stop_active_ws();
-        if (ws_thread_.joinable()) ws_thread_.join();
-        if (consumer_.joinable()) consumer_.join();
+        wake_consumer();
+        if (mux_) {
+            mux_->unsubscribe(venue_symbol_);
+            mux_liveness_.store(nullptr, std::memory_order_release);
+            stop_consumer();
+        } else {
+            stop_active_ws();
+            if (runtime_) {
+                stop_runtime_feed();
+            } else {
+                if (ws_thread_.joinable()) ws_thread_.join();
+                if (consumer_.joinable()) consumer_.join();
+            }
+        }
+        // The consumer is gone, so no new fetcher can start.
+        if (resync_fetcher_.joinable()) resync_fetcher_.join();
     }
 
     std::shared_ptr<const BookSnapshot> load_snapshot() const noexcept override {
@@ -77,6 +149,11 @@ public:
     }
 
     std::int64_t last_transport_ns() const noexcept override {
+        // Multiplexed: the shared connection's clock, so quiet symbols on a
+        // live socket are not reported stale.
+        if (const auto* shared = mux_liveness_.load(std::memory_order_acquire)) {
+            return shared->load(std::memory_order_acquire);
+        }
         return last_transport_ns_.load(std::memory_order_acquire);
     }
 
@@ -84,12 +161,56 @@ public:
         return last_book_update_ns_.load(std::memory_order_acquire);
     }
 
+    std::uint64_t sequence_gaps() const noexcept override {
+        return sequence_gaps_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t resyncs() const noexcept override {
+        return resyncs_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t checksum_mismatches() const noexcept override {
+        return checksum_mismatches_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t rejected_levels() const noexcept override {
+        return rejected_levels_.load(std::memory_order_relaxed);
+    }
+
+    std::uint64_t dropped_frames() const noexcept override {
+        return queue_.dropped() + slot_drops_.load(std::memory_order_relaxed);
+    }
+
     // Identity
     const std::string& venue() const override     { return venue_; }
     const std::string& canonical() const override { return canonical_; }
 
 private:
     static constexpr auto kReconnectBackoff = std::chrono::seconds(1);
+    // Frames drained by the dedicated consumer thread between running_ checks.
+    static constexpr std::size_t kConsumeBatch = 256;
+    // Levels coalesced into one book apply before it is flushed regardless of
+    // the latency budget.
+    static constexpr std::size_t kCoalesceMaxLevels = 4096;
+    // Levels buffered while a REST resync is in flight before giving up and
+    // reconnecting instead.
+    static constexpr std::size_t kResyncBufferMaxLevels = 1u << 18;
+    // Connector can fetch a REST depth snapshot (see IMarketWs).
+    static constexpr bool kRestResync = requires(const std::string& sym) {
+        { WsT::fetch_book_snapshot(sym) } -> std::convertible_to<std::optional<std::string>>;
+    };
+    // Minimum advance of the transport clock before an idle consumer republishes
+    // it into the snapshot set (see touch_snapshot_set()).
+    static constexpr std::int64_t kSetTouchIntervalNs = 1'000'000'000;
+    // Connector can fetch instrument metadata for the parser (see IMarketWs).
+    static constexpr bool kInstrumentInfo = requires(const std::string& sym) {
+        { WsT::fetch_instrument_info(sym) } -> std::convertible_to<std::optional<std::string>>;
+    };
+    // Offline connector (ReplayWs, see IMarketWs): no transport liveness.
+    static constexpr bool kOfflineWs = requires { requires WsT::kOffline; };
+
+    // Best (price, size) of one side on the fixed-point grid.
+    using TopLevel = std::pair<md::PriceTicks, md::SizeLots>;
 
     static std::int64_t now_ns() {
         using namespace std::chrono;
@@ -101,19 +222,16 @@ private:
         return duration_cast<milliseconds>(system_clock::now().time_since_epoch()).count();
     }
 
-    static bool materially_changed(
-        const std::optional<std::pair<double, double>>& prev,
-        const std::optional<std::pair<double, double>>& cur,
-        double size_rel_threshold) noexcept {
+    // Top level moved to another price, or its size changed by at least
+    // size_rel_threshold of the published size; exact on the fixed-point grid.
+    static bool materially_changed(const std::optional<TopLevel>& prev, const std::optional<TopLevel>& cur,
+                                   double size_rel_threshold) noexcept {
         if (prev.has_value() != cur.has_value()) return true;
         if (!prev.has_value()) return false;
+        if (prev->first != cur->first) return true;
 
-        constexpr double kPriceEps = 1e-12;
-        if (std::abs(prev->first - cur->first) > kPriceEps) return true;
-
-        const double base = std::max(std::abs(prev->second), kPriceEps);
-        const double rel = std::abs(cur->second - prev->second) / base;
-        return rel >= size_rel_threshold;
+        const md::SizeLots diff = cur->second > prev->second ? cur->second - prev->second : prev->second - cur->second;
+        return static_cast<double>(diff) >= size_rel_threshold * static_cast<double>(prev->second);
     }
 
     void stop_active_ws() noexcept {
@@ -123,20 +241,79 @@ private:
 
     void request_transport_reset() {
         reset_requested_.store(true, std::memory_order_release);
+        wake_consumer();
+        if (mux_) {
+            mux_->request_reset(venue_symbol_);
+            return;
+        }
         stop_active_ws();
     }
 
+    // Consumer without an owned connection: pinned runtime worker if there is a
+    // runtime, otherwise the dedicated consumer thread.
+    void start_consumer() {
+        if (runtime_) {
+            reset_feed_state();
+            pin_ = runtime_->assign();
+            runtime_->attach(this, pin_);
+        } else {
+            consumer_ = std::thread([this] { consume_loop(); });
+        }
+    }
+
+    void stop_consumer() {
+        if (runtime_) {
+            runtime_->detach(this, pin_);
+            reset_feed_state();
+        } else if (consumer_.joinable()) {
+            consumer_.join();
+        }
+    }
+
+    // WsMuxSink: io shard of the shared connection.
+    void on_mux_frame(std::string& frame) override {
+        last_transport_ns_.store(now_ns(), std::memory_order_release);
+        if (capture_) capture_->append(venue_, venue_symbol_, frame);
+        enqueue_frame(frame);
+    }
+
+    void on_mux_reset() override {
+        reset_requested_.store(true, std::memory_order_release);
+        stale_reset_inflight_.store(false, std::memory_order_release);
+        wake_consumer();
+    }
+
+    // Producer: a frame was queued.
+    void notify_consumer() {
+        if (runtime_) runtime_->notify(pin_);
+        else waiter_.notify();
+    }
+
+    // Unconditional consumer wakeup (reset/stop requests).
+    void wake_consumer() {
+        if (runtime_) runtime_->wake(pin_);
+        else waiter_.wake();
+    }
+
     void reset_feed_state() {
         // Drop queued raw messages from an old connection session.
-        std::string trash;
-        while (queue_.try_pop(trash)) {}
-
-        // Clear in-memory book and invalidate published snapshot.
+        std::uint32_t stale = 0;
+        while (queue_.try_pop(stale)) frames_.release(stale);
+        seen_overrun_ = queue_.overrun();
+
+        // Clear in-memory book and invalidate published snapshot; a new session
+        // starts with its own snapshot, so any pending resync is moot.
+        cancel_resync();
+        parser_.reset_sequence();
         book_.clear();
         std::shared_ptr<const BookSnapshot> empty_snapshot;
         std::atomic_store_explicit(&snapshot_, std::move(empty_snapshot), std::memory_order_release);
+        if (snapshot_set_) snapshot_set_->publish(snapshot_set_slot_, nullptr, 0);
+        set_transport_ns_ = 0;
 
         last_transport_ns_.store(0, std::memory_order_release);
+        coalesced_.clear();
+        coalesced_frames_ = 0;
         pending_updates_since_publish_ = 0;
         last_publish_ns_ = 0;
         last_published_best_bid_.reset();
@@ -150,32 +327,7 @@ private:
                 ws_session_counter_.fetch_add(1, std::memory_order_relaxed) + 1;
             active_ws_session_.store(session, std::memory_order_release);
 
-            auto ws_instance = std::make_unique<WsT>(
-                venue_symbol_,
-                [this, session](const std::string& raw) {
-                    if (session != active_ws_session_.load(std::memory_order_acquire)) {
-                        return;
-                    }
-
-                    last_transport_ns_.store(now_ns(), std::memory_order_release);
-                    std::string msg(raw);
-                    if (!queue_.try_push(std::move(msg))) {
-                        switch (backpressure_) {
-                            case Backpressure::DropNewest:
-                                // drop newest
-                                break;
-                            case Backpressure::DropOldest: {
-                                std::string stale;
-                                (void)queue_.try_pop(stale);
-                                (void)queue_.try_push(std::move(msg));
-                                break;
-                            }
-                            case Backpressure::SignalResync:
-                                // TODO: mark a flag to trigger REST resnapshot
-                                break;
-                        }
-                    }
-                });
+            auto ws_instance = make_ws(session);
 
             WsT* ws_raw = ws_instance.get();
             {
@@ -196,14 +348,123 @@ private:
             }
             reset_requested_.store(true, std::memory_order_release);
             stale_reset_inflight_.store(false, std::memory_order_release);
+            wake_consumer();
 
             if (!running_.load(std::memory_order_relaxed)) break;
             std::this_thread::sleep_for(kReconnectBackoff);
         }
     }
 
-    bool should_publish_after_update(std::int64_t ts_ns) {
-        ++pending_updates_since_publish_;
+    std::unique_ptr<WsT> make_ws(std::uint64_t session) {
+        auto on_frame = [this, session](std::string& frame) {
+            if (session != active_ws_session_.load(std::memory_order_acquire)) {
+                return;
+            }
+
+            last_transport_ns_.store(now_ns(), std::memory_order_release);
+            if (capture_) capture_->append(venue_, venue_symbol_, frame);
+            enqueue_frame(frame);
+        };
+        if constexpr (kOfflineWs) {
+            return std::make_unique<WsT>(venue_symbol_, std::move(on_frame), venue_);
+        } else {
+            return std::make_unique<WsT>(venue_symbol_, std::move(on_frame));
+        }
+    }
+
+    // Runtime mode: the supervisor loop as io-shard callbacks. Each session
+    // reconnects from its own on_closed after kReconnectBackoff.
+    void connect_async() {
+        std::lock_guard<std::mutex> lk(ws_mu_);
+        if (!running_.load(std::memory_order_relaxed)) return;
+
+        const std::uint64_t session =
+            ws_session_counter_.fetch_add(1, std::memory_order_relaxed) + 1;
+        active_ws_session_.store(session, std::memory_order_release);
+
+        // Replacing ws_ here (not in on_closed) keeps the old connector alive
+        // until its own callbacks have returned.
+        ws_ = make_ws(session);
+        io_inflight_.fetch_add(1, std::memory_order_acq_rel);
+        ws_->start_async(runtime_->io().shard(pin_.io_shard),
+                         [this] { on_ws_closed(); }, ws_port_);
+    }
+
+    void on_ws_closed() {
+        active_ws_session_.store(0, std::memory_order_release);
+        reset_requested_.store(true, std::memory_order_release);
+        stale_reset_inflight_.store(false, std::memory_order_release);
+        wake_consumer();
+
+        if (running_.load(std::memory_order_relaxed)) {
+            runtime_->io().post_after(
+                pin_.io_shard,
+                std::chrono::duration_cast<std::chrono::milliseconds>(kReconnectBackoff),
+                [this] {
+                    connect_async();
+                    io_inflight_.fetch_sub(1, std::memory_order_acq_rel);
+                });
+            return;
+        }
+        io_inflight_.fetch_sub(1, std::memory_order_acq_rel);
+    }
+
+    void stop_runtime_feed() {
+        // Wait out the closing session and any pending reconnect timer: both
+        // capture `this`.
+        while (io_inflight_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        {
+            std::lock_guard<std::mutex> lk(ws_mu_);
+            ws_.reset();
+        }
+        stop_consumer();
+    }
+
+    // Producer side: move the connector's frame into a pooled slot and queue its index.
+    void enqueue_frame(std::string& frame) {
+        if (backpressure_ == Backpressure::Block) {
+            while (queue_.full() && running_.load(std::memory_order_relaxed)) {
+                notify_consumer();
+                std::this_thread::yield();
+            }
+        }
+
+        // Pool covers a full queue, the slot held by the consumer and the one
+        // filled here, so a slot should always be available; if none is, the
+        // frame is lost like a queue overwrite and the book is resynced.
+        std::uint32_t slot = frames_.acquire();
+        if (slot == FramePool<kPoolSlots>::kNoSlot) {
+            slot_drops_.fetch_add(1, std::memory_order_relaxed);
+            resync_requested_.store(true, std::memory_order_release);
+            wake_consumer();
+            return;
+        }
+        frames_.fill(slot, frame);
+
+        if (backpressure_ == Backpressure::DropOldest) {
+            // A full queue hands back its oldest frame; the consumer sees the
+            // overrun when it gets there and resyncs.
+            std::uint32_t evicted = 0;
+            if (queue_.push_overwrite(slot, evicted)) frames_.recycle(evicted);
+            notify_consumer();
+            return;
+        }
+        if (!queue_.try_push(slot)) {
+            frames_.recycle(slot); // drop newest
+            if (backpressure_ == Backpressure::SignalResync) {
+                // This frame is lost: have the consumer resnapshot the book.
+                resync_requested_.store(true, std::memory_order_release);
+                wake_consumer();
+            }
+            return;
+        }
+        notify_consumer();
+    }
+
+    bool should_publish_after_update(std::int64_t ts_ns, std::uint32_t updates) {
+        pending_updates_since_publish_ += updates;
 
         const bool age_due =
             publish_policy_.min_publish_interval_ns <= 0 ||
@@ -213,8 +474,8 @@ private:
             publish_policy_.max_updates_per_publish > 0 &&
             pending_updates_since_publish_ >= publish_policy_.max_updates_per_publish;
 
-        const auto best_bid = book_.best_bid();
-        const auto best_ask = book_.best_ask();
+        const auto best_bid = book_.best_level(BookSide::Bid);
+        const auto best_ask = book_.best_level(BookSide::Ask);
         const bool top_due =
             materially_changed(last_published_best_bid_, best_bid,
                                publish_policy_.top_size_rel_change_trigger) ||
@@ -232,62 +493,346 @@ private:
         BookSnapshot snapshot_tmp;
         snapshot_tmp.venue  = venue_;
         snapshot_tmp.symbol = canonical_;
+        snapshot_tmp.venue_id = venue_id_;
         snapshot_tmp.seq    = seq;
         snapshot_tmp.ts_ns  = ts_ns;
         snapshot_tmp.ts_ms  = ts_ms;
         book_.copy_snapshot_levels(snapshot_tmp.bids, snapshot_tmp.asks);
 
         auto snapshot_ptr = std::make_shared<const BookSnapshot>(std::move(snapshot_tmp));
+        if (snapshot_set_) {
+            set_transport_ns_ = last_transport_ns();
+            snapshot_set_->publish(snapshot_set_slot_, snapshot_ptr, set_transport_ns_);
+        }
         std::atomic_store_explicit(&snapshot_, std::move(snapshot_ptr), std::memory_order_release);
 
         last_publish_ns_ = ts_ns;
         pending_updates_since_publish_ = 0;
-        last_published_best_bid_ = book_.best_bid();
-        last_published_best_ask_ = book_.best_ask();
+        last_published_best_bid_ = book_.best_level(BookSide::Bid);
+        last_published_best_ask_ = book_.best_level(BookSide::Ask);
+    }
+
+    // Idle consumer: carry the connection's liveness into the snapshot set entry
+    // so routers keep a quiet book whose socket still delivers frames
+    // (heartbeats, other symbols' frames on a shared connection).
+    void touch_snapshot_set(std::int64_t transport_ns) {
+        if (!snapshot_set_ || transport_ns - set_transport_ns_ < kSetTouchIntervalNs) return;
+        set_transport_ns_ = transport_ns;
+        snapshot_set_->touch(snapshot_set_slot_, transport_ns);
+    }
+
+    // FeedRuntime worker entry point; always called from this feed's pinned worker.
+    bool run_slice(std::size_t budget) override {
+        if (!running_.load(std::memory_order_relaxed)) return false;
+        return consume_some(budget);
     }
 
     /*
-     * Main consumer loop: try_pop from queue, parse, apply to book,
-     * then publish immutable snapshots for readers.
+     * Consumer step: try_pop up to `budget` frames, parse, apply to book,
+     * then publish immutable snapshots for readers. Shared by the dedicated
+     * consumer thread and FeedRuntime workers. Returns true if a frame was consumed.
+     * While frames are queued back to back, their events are coalesced and
+     * applied to the book once per FeedConfig::coalesce_budget_ns (or
+     * kCoalesceMaxLevels); an empty queue or any resync transition applies
+     * what has been gathered first.
     */
-    void consume_loop() {
-        ParserT parser;
-        std::vector<BookEvent> evs;
-        std::string raw;
-
-        reset_feed_state();
+    bool consume_some(std::size_t budget) {
+        std::uint32_t slot = 0;
+        std::size_t consumed = 0;
 
-        while (running_.load(std::memory_order_relaxed)) {
+        while (consumed < budget) {
             if (reset_requested_.exchange(false, std::memory_order_acq_rel)) {
                 reset_feed_state();
                 continue;
             }
+            if (resync_requested_.load(std::memory_order_relaxed) &&
+                resync_requested_.exchange(false, std::memory_order_acq_rel)) {
+                apply_coalesced();
+                begin_resync();
+            }
+            if (resync_ready_.load(std::memory_order_acquire)) {
+                apply_coalesced();
+                finish_resync();
+            }
+            if (instrument_ready_.load(std::memory_order_acquire)) load_instrument_info();
 
             // No message to consume; check transport staleness and trigger reset if needed.
-            if (!queue_.try_pop(raw)) {
-                const auto last_transport =
-                    last_transport_ns_.load(std::memory_order_acquire);
-                if (last_transport > 0) {
+            if (!queue_.try_pop(slot)) {
+                apply_coalesced();
+                const auto last_transport = last_transport_ns();
+                if (!kOfflineWs && last_transport > 0) {
                     const auto age_ns = now_ns() - last_transport;
                     if (age_ns > md::liveness::kTransportStaleNs &&
                         !stale_reset_inflight_.exchange(true, std::memory_order_acq_rel)) {
                         request_transport_reset();
                     }
                 }
-                std::this_thread::sleep_for(std::chrono::microseconds(100));
-                continue;
+                touch_snapshot_set(last_transport);
+                break;
+            }
+            ++consumed;
+
+            if (queue_.overrun() != seen_overrun_) {
+                // DropOldest overflow: frames ahead of this one were overwritten.
+                seen_overrun_ = queue_.overrun();
+                apply_coalesced();
+                begin_resync(); // the evicted deltas are gone; this frame gets buffered
+            }
+
+            evs_.clear();
+            // parser should parse full events; no depth limit here.
+            // The frame is parsed in place and its slot recycled once parsed.
+            const bool parsed = parser_.parse(frames_.frame(slot), evs_);
+            frames_.release(slot);
+            note_rejected_levels(evs_);
+            if (evs_.gap()) {
+                apply_coalesced();
+                sequence_gaps_.fetch_add(1, std::memory_order_relaxed);
+                begin_resync();
+            }
+            if (parsed && resync_active_) {
+                // A stream snapshot supersedes the pending REST one.
+                if (!evs_.has_snapshot()) {
+                    buffer_for_resync();
+                    continue;
+                }
+                cancel_resync();
+            }
+            if (parsed) coalesce_frame();
+        }
+        apply_coalesced();
+        return consumed > 0;
+    }
+
+    // Add the parsed frame to the pending apply; flush once the run is over budget.
+    void coalesce_frame() {
+        const auto ts_ns = now_ns();
+        if (coalesced_.empty()) {
+            std::swap(coalesced_, evs_); // common case: nothing to merge with
+            coalesced_since_ns_ = ts_ns;
+        } else {
+            coalesced_.append(evs_);
+        }
+        ++coalesced_frames_;
+        if (ts_ns - coalesced_since_ns_ >= coalesce_budget_ns_ ||
+            coalesced_.level_count() >= kCoalesceMaxLevels) {
+            apply_coalesced();
+        }
+    }
+
+    // Apply the gathered frames as one batch, verify the venue checksum of the
+    // last one and gate publication.
+    void apply_coalesced() {
+        if (coalesced_.empty()) return;
+        book_.apply_many(coalesced_);
+        const bool checksum_matches = !verify_checksums_ || checksum_ok(coalesced_);
+        const std::uint32_t frames = coalesced_frames_;
+        coalesced_.clear();
+        coalesced_frames_ = 0;
+        if (!checksum_matches) {
+            checksum_mismatches_.fetch_add(1, std::memory_order_relaxed);
+            begin_resync();
+            return; // keep the diverged book unpublished
+        }
+        const auto ts_ns = now_ns();
+        last_book_update_ns_.store(ts_ns, std::memory_order_release);
+        if (should_publish_after_update(ts_ns, frames)) {
+            publish_snapshot(ts_ns);
+        }
+    }
+
+    // Venue checksum (Kraken, OKX) after the last event of `applied`. A mismatch
+    // means the book diverged without a detectable gap, so it is resynced like one.
+    bool checksum_ok(const BookEventBatch& applied) const {
+        const auto& last = applied.events().back();
+        if (!last.has_checksum) return true;
+        const md::ChecksumRule* rule = parser_.checksum_rule();
+        return !rule || md::book_checksum(book_, *rule) == last.checksum;
+    }
+
+    // -------- in-place resync (consumer thread) --------
+
+    // Book lost updates: buffer new deltas and fetch a REST snapshot.
+    void begin_resync() {
+        if (resync_active_) return;
+        resyncs_.fetch_add(1, std::memory_order_relaxed);
+        if constexpr (!kRestResync) {
+            request_transport_reset();
+            return;
+        } else {
+            resync_active_ = true;
+            resync_buffer_.clear();
+
+            std::lock_guard<std::mutex> lk(resync_mu_);
+            ++resync_gen_;
+            resync_wanted_ = true;
+            start_fetcher();
+        }
+    }
+
+    // Run resync_fetch_loop() unless it is already running; caller holds resync_mu_.
+    void start_fetcher() {
+        if (fetch_inflight_ || !running_.load(std::memory_order_relaxed)) return;
+        fetch_inflight_ = true;
+        // A finished fetcher only has its wakeup left to run.
+        if (resync_fetcher_.joinable()) resync_fetcher_.join();
+        resync_fetcher_ = std::thread([this] { resync_fetch_loop(); });
+    }
+
+    void cancel_resync() {
+        resync_active_ = false;
+        resync_buffer_.clear();
+        std::lock_guard<std::mutex> lk(resync_mu_);
+        ++resync_gen_; // discard whatever the fetcher delivers next
+        resync_wanted_ = false;
+    }
+
+    // Count levels the parser could not represent; the first one is logged.
+    void note_rejected_levels(const BookEventBatch& evs) {
+        if (evs.rejected_levels() == 0) return;
+        if (rejected_levels_.fetch_add(evs.rejected_levels(), std::memory_order_relaxed) == 0) {
+            std::cerr << "[feed] " << venue_ << " " << canonical_
+                      << " dropped a level that does not parse onto the fixed-point grid\n";
+        }
+    }
+
+    void buffer_for_resync() {
+        resync_buffer_.append(evs_);
+        if (resync_buffer_.level_count() <= kResyncBufferMaxLevels) return;
+        std::cerr << "[feed] " << venue_ << " " << canonical_
+                  << " resync buffer overflow; reconnecting\n";
+        cancel_resync();
+        request_transport_reset();
+    }
+
+    // REST body arrived: snapshot, then replay the deltas buffered since the gap
+    // that it does not already cover. Sequenced snapshots (Binance) let Book
+    // skip the stale ones; otherwise deltas stamped before the snapshot's venue
+    // time (Coinbase, OKX) are dropped, and the rest (all of Kraken's) are
+    // replayed. A venue checksum on the last replayed delta (Kraken, OKX) must
+    // then match, or the resync starts over.
+    void finish_resync() {
+        resync_ready_.store(false, std::memory_order_relaxed);
+        std::optional<std::string> body;
+        {
+            std::lock_guard<std::mutex> lk(resync_mu_);
+            if (resync_body_gen_ != resync_gen_) return; // superseded
+            body = std::move(resync_body_);
+            resync_body_.reset();
+        }
+        if (!resync_active_) return;
+
+        resync_evs_.clear();
+        if (!body || !parser_.parse_rest_snapshot(*body, resync_evs_)) {
+            std::cerr << "[feed] " << venue_ << " " << canonical_
+                      << " REST resnapshot failed; reconnecting\n";
+            cancel_resync();
+            request_transport_reset();
+            return;
+        }
+        note_rejected_levels(resync_evs_);
+        book_.apply_many(resync_evs_);
+        if (const std::int64_t snapshot_ts = resync_evs_.events().back().venue_ts_ns; snapshot_ts != 0) {
+            resync_buffer_.drop_before(snapshot_ts);
+        }
+        book_.apply_many(resync_buffer_);
+        const bool checksum_matches = !verify_checksums_ || resync_buffer_.empty() || checksum_ok(resync_buffer_);
+        resync_active_ = false;
+        resync_buffer_.clear();
+        if (!checksum_matches) {
+            checksum_mismatches_.fetch_add(1, std::memory_order_relaxed);
+            begin_resync();
+            return; // keep the diverged book unpublished
+        }
+
+        const auto ts_ns = now_ns();
+        last_book_update_ns_.store(ts_ns, std::memory_order_release);
+        publish_snapshot(ts_ns);
+    }
+
+    // Instrument metadata body arrived: hand it to the parser.
+    void load_instrument_info() {
+        instrument_ready_.store(false, std::memory_order_relaxed);
+        std::optional<std::string> body;
+        {
+            std::lock_guard<std::mutex> lk(resync_mu_);
+            body = std::move(instrument_body_);
+            instrument_body_.reset();
+        }
+        if (body && !parser_.parse_instrument_info(*body)) {
+            std::cerr << "[feed] " << venue_ << " " << canonical_
+                      << " unreadable instrument metadata; checksums not verified\n";
+        }
+    }
+
+    // Fetcher thread: instrument metadata until one fetch succeeds (a failed
+    // one is retried by the next fetcher run), then one REST request per
+    // resync generation; a resync started while a request is in flight is
+    // served by the next loop iteration. A resync cancelled meanwhile (and not
+    // restarted) ends the loop instead.
+    void resync_fetch_loop() {
+        if constexpr (kInstrumentInfo) {
+            if (!instrument_fetched_) {
+                auto body = WsT::fetch_instrument_info(venue_symbol_);
+                if (body) {
+                    instrument_fetched_ = true;
+                    {
+                        std::lock_guard<std::mutex> lk(resync_mu_);
+                        instrument_body_ = std::move(body);
+                    }
+                    instrument_ready_.store(true, std::memory_order_release);
+                    wake_consumer();
+                } else {
+                    std::cerr << "[feed] " << venue_ << " " << canonical_
+                              << " instrument metadata fetch failed; checksums not verified\n";
+                }
             }
+        }
+        for (;;) {
+            std::uint64_t gen = 0;
+            {
+                std::lock_guard<std::mutex> lk(resync_mu_);
+                if (!resync_wanted_ || !running_.load(std::memory_order_relaxed)) {
+                    fetch_inflight_ = false;
+                    return;
+                }
+                gen = resync_gen_;
+            }
+            std::optional<std::string> body;
+            if constexpr (kRestResync) body = WsT::fetch_book_snapshot(venue_symbol_);
 
-            evs.clear();
-            // parser should parse full events; no depth limit here
-            if (parser.parse(raw, evs)) {
-                book_.apply_many(evs);
-                const auto ts_ns = now_ns();
-                last_book_update_ns_.store(ts_ns, std::memory_order_release);
-                if (should_publish_after_update(ts_ns)) {
-                    publish_snapshot(ts_ns);
+            {
+                std::lock_guard<std::mutex> lk(resync_mu_);
+                if (!resync_wanted_ || !running_.load(std::memory_order_relaxed)) {
+                    fetch_inflight_ = false;
+                    return;
                 }
+                if (gen != resync_gen_) continue;
+                resync_body_ = std::move(body);
+                resync_body_gen_ = gen;
+                resync_wanted_ = false;
+                fetch_inflight_ = false;
             }
+            resync_ready_.store(true, std::memory_order_release);
+            wake_consumer();
+            return;
+        }
+    }
+
+    // Dedicated consumer thread (no FeedRuntime).
+    void consume_loop() {
+        reset_feed_state();
+
+        while (running_.load(std::memory_order_relaxed)) {
+            if (consume_some(kConsumeBatch)) continue;
+            waiter_.wait([this] {
+                return !queue_.empty() ||
+                       reset_requested_.load(std::memory_order_acquire) ||
+                       resync_requested_.load(std::memory_order_acquire) ||
+                       resync_ready_.load(std::memory_order_acquire) ||
+                       instrument_ready_.load(std::memory_order_acquire) ||
+                       !running_.load(std::memory_order_relaxed);
+            });
         }
 
         reset_feed_state();
@@ -296,11 +841,27 @@ private:
     // Identity
     std::string venue_;
     std::string canonical_;
+    md::VenueId venue_id_;
     Backpressure backpressure_;
     PublishPolicy publish_policy_;
 
     // Per-venue components
-    SpscRing<std::string, QueuePow2> queue_;
+    static constexpr std::size_t kPoolSlots = QueuePow2 + 2;
+    FramePool<kPoolSlots> frames_;
+    SpscQueue<std::uint32_t, QueuePow2, SpscOverflow::OverwriteOldest> queue_; // indices into frames_
+    md::FeedWaiter waiter_;                    // consumer parks here when queue_ is empty
+    bool verify_checksums_;
+    std::shared_ptr<md::CaptureWriter> capture_; // null: no capture
+    std::shared_ptr<md::SnapshotSetPublisher> snapshot_set_; // null: per-feed snapshot only
+    std::size_t snapshot_set_slot_{0};
+    std::int64_t set_transport_ns_{0}; // transport_ns last written to the set entry (consumer-only)
+    std::int64_t coalesce_budget_ns_;
+    std::uint64_t seen_overrun_{0};            // consumer: queue_.overrun() already resynced for
+    std::shared_ptr<md::FeedRuntime> runtime_; // null: dedicated threads below
+    md::FeedRuntime::Pin pin_;
+    std::shared_ptr<WsMux<WsT, ParserT>> mux_;           // null: feed owns its connection
+    std::atomic<const std::atomic<std::int64_t>*> mux_liveness_{nullptr}; // shared connection's last-frame clock
+    std::atomic<std::uint32_t> io_inflight_{0}; // runtime mode: open sessions + reconnect timers
     mutable std::mutex ws_mu_;
     std::unique_ptr<WsT> ws_;
     std::thread ws_thread_;
@@ -320,8 +881,37 @@ private:
     std::atomic<std::int64_t> last_book_update_ns_{0};
     std::uint32_t pending_updates_since_publish_{0};
     std::int64_t last_publish_ns_{0};
-    std::optional<std::pair<double, double>> last_published_best_bid_;
-    std::optional<std::pair<double, double>> last_published_best_ask_;
-
-    Book book_;
+    std::optional<TopLevel> last_published_best_bid_;
+    std::optional<TopLevel> last_published_best_ask_;
+
+    BookT book_;
+    ParserT parser_;             // consumer-owned
+    BookEventBatch evs_;         // consumer-owned scratch, reused across frames
+    BookEventBatch coalesced_;   // parsed frames not yet applied to book_
+    std::uint32_t coalesced_frames_{0};
+    std::int64_t coalesced_since_ns_{0};
+
+    // In-place resync. resync_active_ and the batches are consumer-owned; the
+    // fetcher hands its result over under resync_mu_.
+    bool resync_active_{false};
+    BookEventBatch resync_buffer_;  // events received since the gap
+    BookEventBatch resync_evs_;     // parsed REST snapshot
+    std::atomic<bool> resync_requested_{false}; // SignalResync overflow
+    std::atomic<bool> resync_ready_{false};     // fetcher delivered a body
+    std::mutex resync_mu_;
+    std::uint64_t resync_gen_{0};               // bumped per resync start / cancel
+    bool resync_wanted_{false};                 // a resync awaits a body; cleared on cancel / delivery
+    std::uint64_t resync_body_gen_{0};
+    std::optional<std::string> resync_body_;
+    bool fetch_inflight_{false};
+    std::thread resync_fetcher_;
+    // Instrument metadata, handed over like the resync body.
+    std::atomic<bool> instrument_ready_{false};
+    std::optional<std::string> instrument_body_; // guarded by resync_mu_
+    bool instrument_fetched_{false};             // fetcher-only (runs are serialized)
+    std::atomic<std::uint64_t> sequence_gaps_{0};
+    std::atomic<std::uint64_t> resyncs_{0};
+    std::atomic<std::uint64_t> checksum_mismatches_{0};
+    std::atomic<std::uint64_t> rejected_levels_{0};
+    std::atomic<std::uint64_t> slot_drops_{0}; // frames dropped for want of a FramePool slot
 };
@@ -18,4 +18,14 @@ struct IVenueFeed {
     // Monotonic timestamps for feed liveness signals.
     virtual std::int64_t last_transport_ns() const noexcept = 0;
     virtual std::int64_t last_book_update_ns() const noexcept = 0;
+
+    // Book integrity counters: venue sequence gaps seen, venue checksum
+    // mismatches, resyncs started (gaps, mismatches and queue overflows),
+    // levels dropped because they do not fit the fixed-point grid and frames
+    // lost before parsing (full queue or no free frame slot).
+    virtual std::uint64_t sequence_gaps() const noexcept = 0;
+    virtual std::uint64_t checksum_mismatches() const noexcept = 0;
+    virtual std::uint64_t resyncs() const noexcept = 0;
+    virtual std::uint64_t rejected_levels() const noexcept = 0;
+    virtual std::uint64_t dropped_frames() const noexcept = 0;
 };
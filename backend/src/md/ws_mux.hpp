@@ -0,0 +1,248 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "feed_config.hpp"
+#include "feed_runtime.hpp"
+
+// Receives the demultiplexed frames of one symbol on a shared venue connection.
+// Callbacks run on the connection's io shard and never after unsubscribe() returns.
+struct WsMuxSink {
+    virtual ~WsMuxSink() = default;
+    virtual void on_mux_frame(std::string& frame) = 0; // may swap the frame out
+    virtual void on_mux_reset() = 0;                  // connection dropped: resync the book
+};
+
+// Per-venue WebSocket multiplexer: many symbols share one connection, added and
+// dropped at runtime with the venue's live subscribe/unsubscribe frames.
+// Frames are routed by ParserT::peek_symbol() (product_id / symbol / instId /
+// stream) to the owning VenueFeed's ring; frames without a symbol (heartbeats,
+// acks) only advance the connection's liveness clock.
+// Connections are capped at max_symbols_per_ws and run on FeedRuntime io shards;
+// a dropped connection resets every book on it and reconnects with all of its
+// symbols after kReconnectBackoff.
+template <typename WsT, typename ParserT>
+class WsMux {
+public:
+    WsMux(std::shared_ptr<md::FeedRuntime> runtime, std::size_t max_symbols_per_ws)
+    : runtime_(std::move(runtime))
+    , max_symbols_(max_symbols_per_ws == 0 ? 1 : max_symbols_per_ws) {}
+
+    ~WsMux() {
+        {
+            std::unique_lock<std::shared_mutex> lk(mu_);
+            stopping_ = true;
+            for (auto& conn : conns_) {
+                if (conn->live) conn->ws->stop();
+            }
+        }
+        // Session close callbacks and reconnect timers capture `this`.
+        while (io_inflight_.load(std::memory_order_acquire) != 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+
+    WsMux(const WsMux&) = delete;
+    WsMux& operator=(const WsMux&) = delete;
+
+    // Route `venue_symbol` to `sink`, subscribing it on a connection with room
+    // (opening one if needed). Returns that connection's liveness clock
+    // (steady-clock ns of its last frame), or nullptr if the symbol is taken.
+    const std::atomic<std::int64_t>* subscribe(const std::string& venue_symbol,
+                                               WsMuxSink* sink,
+                                               unsigned short port = 443) {
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        if (routes_.count(venue_symbol) != 0) return nullptr;
+        port_ = port;
+
+        Connection* conn = nullptr;
+        for (auto& c : conns_) {
+            if (c->symbols.size() < max_symbols_) {
+                conn = c.get();
+                break;
+            }
+        }
+        if (!conn) {
+            conns_.push_back(std::make_unique<Connection>());
+            conn = conns_.back().get();
+            conn->io_shard = runtime_->assign().io_shard;
+        }
+
+        routes_.emplace(venue_symbol, Route{sink, conn});
+        conn->symbols.push_back(venue_symbol);
+        if (conn->live) {
+            conn->ws->subscribe(venue_symbol);
+        } else if (!conn->reconnect_pending) {
+            connect(*conn);
+        }
+        return &conn->last_frame_ns;
+    }
+
+    // Drop `venue_symbol`; returns once its sink can no longer be called.
+    void unsubscribe(const std::string& venue_symbol) {
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        auto it = routes_.find(venue_symbol);
+        if (it == routes_.end()) return;
+        Connection& conn = *it->second.conn;
+        routes_.erase(it);
+        std::erase(conn.symbols, venue_symbol);
+
+        if (!conn.live) return;
+        if (conn.symbols.empty()) {
+            conn.ws->stop(); // idle connection; reopened on the next subscribe
+        } else {
+            conn.ws->unsubscribe(venue_symbol);
+        }
+    }
+
+    // Reconnect the connection carrying `venue_symbol` (stale transport).
+    void request_reset(const std::string& venue_symbol) {
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        auto it = routes_.find(venue_symbol);
+        if (it == routes_.end()) return;
+        Connection& conn = *it->second.conn;
+        if (!conn.live || conn.reset_inflight) return;
+        conn.reset_inflight = true;
+        conn.ws->stop();
+    }
+
+    // Open connections (diagnostics).
+    std::size_t connections() const {
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        std::size_t n = 0;
+        for (const auto& conn : conns_) n += conn->live ? 1 : 0;
+        return n;
+    }
+
+private:
+    static constexpr auto kReconnectBackoff = std::chrono::milliseconds(1000);
+
+    // One shared socket. Slots are never erased: an emptied connection is closed
+    // and reused by the next subscribe, so routes can hold plain pointers.
+    struct Connection {
+        std::size_t io_shard{0};
+        std::vector<std::string> symbols; // subscription order; front() seeds the URL/first subscribe
+        std::unique_ptr<WsT> ws;
+        std::atomic<std::uint64_t> session{0};
+        bool live{false};                 // session started, on_closed not yet seen
+        bool reconnect_pending{false};
+        bool reset_inflight{false};
+        std::atomic<std::int64_t> last_frame_ns{0};
+    };
+
+    struct Route {
+        WsMuxSink* sink;
+        Connection* conn;
+    };
+
+    static std::int64_t now_ns() {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    // Caller holds mu_ exclusively.
+    void connect(Connection& conn) {
+        if (stopping_ || conn.symbols.empty()) return;
+
+        const std::uint64_t session = session_counter_.fetch_add(1, std::memory_order_relaxed) + 1;
+        conn.session.store(session, std::memory_order_release);
+
+        // Replacing conn.ws here (not in on_closed) keeps the old connector alive
+        // until its own callbacks have returned.
+        conn.ws = std::make_unique<WsT>(
+            conn.symbols.front(),
+            [this, &conn, session](std::string& frame) { on_frame(conn, session, frame); });
+        conn.live = true;
+        conn.reset_inflight = false;
+        io_inflight_.fetch_add(1, std::memory_order_acq_rel);
+        conn.ws->start_async(runtime_->io().shard(conn.io_shard),
+                             [this, &conn] { on_closed(conn); }, port_);
+        for (std::size_t i = 1; i < conn.symbols.size(); ++i) {
+            conn.ws->subscribe(conn.symbols[i]);
+        }
+    }
+
+    // io shard: demultiplex one frame.
+    void on_frame(Connection& conn, std::uint64_t session, std::string& frame) {
+        conn.last_frame_ns.store(now_ns(), std::memory_order_release);
+
+        const std::string_view symbol = ParserT::peek_symbol(frame);
+        if (symbol.empty()) return;
+
+        std::shared_lock<std::shared_mutex> lk(mu_);
+        if (conn.session.load(std::memory_order_acquire) != session) return;
+        auto it = routes_.find(symbol);
+        if (it == routes_.end() || it->second.conn != &conn) return; // unsubscribed in flight
+        it->second.sink->on_mux_frame(frame);
+    }
+
+    // io shard: the connection's session ended.
+    void on_closed(Connection& conn) {
+        std::unique_lock<std::shared_mutex> lk(mu_);
+        conn.live = false;
+        conn.session.store(0, std::memory_order_release);
+        conn.last_frame_ns.store(0, std::memory_order_release);
+        for (const auto& symbol : conn.symbols) {
+            auto it = routes_.find(symbol);
+            if (it != routes_.end()) it->second.sink->on_mux_reset();
+        }
+
+        if (stopping_ || conn.symbols.empty()) {
+            io_inflight_.fetch_sub(1, std::memory_order_acq_rel);
+            return;
+        }
+        conn.reconnect_pending = true;
+        runtime_->io().post_after(conn.io_shard, kReconnectBackoff, [this, &conn] {
+            {
+                std::unique_lock<std::shared_mutex> lk2(mu_);
+                conn.reconnect_pending = false;
+                connect(conn);
+            }
+            io_inflight_.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    std::shared_ptr<md::FeedRuntime> runtime_;
+    std::size_t max_symbols_;
+
+    mutable std::shared_mutex mu_; // routes_, conns_ and Connection bookkeeping
+    std::map<std::string, Route, std::less<>> routes_;
+    std::vector<std::unique_ptr<Connection>> conns_;
+    unsigned short port_{443};
+    bool stopping_{false};
+
+    std::atomic<std::uint64_t> session_counter_{0};
+    std::atomic<std::uint32_t> io_inflight_{0}; // live sessions + reconnect timers
+};
+
+// Lazily created per-venue mux shared by every feed one factory builds while
+// FeedConfig::multiplex_ws is on. Feeds own the mux; the slot only caches it.
+template <typename WsT, typename ParserT>
+class WsMuxSlot {
+public:
+    std::shared_ptr<WsMux<WsT, ParserT>> get(const FeedConfig& config) {
+        if (!config.multiplex_ws || !config.runtime) return nullptr;
+        std::lock_guard<std::mutex> lk(mu_);
+        auto mux = mux_.lock();
+        if (!mux) {
+            mux = std::make_shared<WsMux<WsT, ParserT>>(config.runtime, config.max_symbols_per_ws);
+            mux_ = mux;
+        }
+        return mux;
+    }
+
+private:
+    std::mutex mu_;
+    std::weak_ptr<WsMux<WsT, ParserT>> mux_;
+};
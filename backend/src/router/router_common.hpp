@@ -7,12 +7,16 @@
 #include <memory>
 #include <optional>
 #include <algorithm>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <queue>
 #include <unordered_map>
 
+#include "md/intern.hpp"
 #include "md/venue_feed_iface.hpp"
+#include "router/routing_context.hpp"
 
 enum ExecutionType {
     MARKET,
@@ -21,11 +25,13 @@ enum ExecutionType {
 };
 
 struct RouteSlice {
-    std::string venue;
+    md::VenueId venue_id{md::kNoVenue}; // md::venue_ids()
     ExecutionType execution_type;
     // Aggregated planned amount, and planned average execution price for this venue leg.
     double quantity{0.0};
     double price{0.0};
+
+    std::string_view venue() const { return md::venue_ids().name(venue_id); }
 };
 
 struct RoutingDecision {
@@ -34,11 +40,34 @@ struct RoutingDecision {
     double routable_qty{0.0};
     double indicative_average_price{0.0};
     std::vector<RouteSlice> slices;
-    std::string message;
+    std::string_view message; // static string
+    // Venues left out because their book was older than the staleness bound.
+    std::uint32_t stale_venues{0};
+
+    // Ready for another route; slices keep their capacity.
+    void reset(double requested) noexcept {
+        fully_routable = false;
+        requested_qty = requested;
+        routable_qty = 0.0;
+        indicative_average_price = 0.0;
+        slices.clear();
+        message = {};
+        stale_venues = 0;
+    }
 };
 
 inline constexpr double kRoutingEps = 1e-12;
 
+// Books a router may use: non-null, within the staleness bound, in the
+// snapshot set's venue order. Only valid while the set is held.
+using RoutingBooks = std::span<const BookSnapshot* const>;
+
+// Interned id of the snapshot's venue; snapshots built outside VenueFeed
+// (tests, benches) may leave venue_id unset.
+inline md::VenueId snapshot_venue_id(const BookSnapshot& snapshot) {
+    return snapshot.venue_id != md::kNoVenue ? snapshot.venue_id : md::venue_ids().intern(snapshot.venue);
+}
+
 inline void set_routing_message(
     RoutingDecision& out,
     const std::optional<double>& limit_price)
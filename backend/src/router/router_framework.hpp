@@ -1,5 +1,6 @@
 #pragma once
 
+#include <chrono>
 #include <cstddef>
 #include <cstdint>
 #include <optional>
@@ -7,6 +8,7 @@
 #include <string_view>
 #include <unordered_map>
 
+#include "md/snapshot_set.hpp"
 #include "router/router_common.hpp"
 #include "router/versions/all_versions.hpp"
 #include "venues/venue_api.hpp"
@@ -16,17 +18,21 @@ namespace router {
 inline constexpr std::string_view kRouterV1 = "v1_best_price_sweep";
 inline constexpr std::string_view kRouterV2 = "v2_best_price_fee";
 inline constexpr std::string_view kRouterV3 = "v3_limit_curve";
-inline constexpr std::size_t kRouterVersionCount = 3;
+inline constexpr std::string_view kRouterV4 = "v4_cumulative_sweep";
+inline constexpr std::size_t kRouterVersionCount = 4;
 
 enum class RouterVersionId : std::uint8_t {
     V1BestPriceSweep = 1,
     V2BestPriceFee = 2,
-    V3LimitCurve = 3
+    V3LimitCurve = 3,
+    V4CumulativeSweep = 4
 };
 inline constexpr RouterVersionId kDefaultRouterVersionId = RouterVersionId::V1BestPriceSweep;
 
 inline std::string_view router_version_name(RouterVersionId version_id) {
     switch (version_id) {
+        case RouterVersionId::V4CumulativeSweep:
+            return kRouterV4;
         case RouterVersionId::V3LimitCurve:
             return kRouterV3;
         case RouterVersionId::V2BestPriceFee:
@@ -49,6 +55,9 @@ inline std::optional<RouterVersionId> parse_exact_router_version(
     if (requested_version == kRouterV3) {
         return RouterVersionId::V3LimitCurve;
     }
+    if (requested_version == kRouterV4) {
+        return RouterVersionId::V4CumulativeSweep;
+    }
     return std::nullopt;
 }
 
@@ -69,38 +78,92 @@ inline bool is_router_version_supported(std::string_view requested_version) {
     return parse_exact_router_version(requested_version).has_value();
 }
 
-inline RoutingDecision route_order(
+// Routes into `out` with all scratch state on `ctx`'s arena. With a warmed-up
+// context and a reused `out` (slices keep their capacity) a route makes no heap
+// allocations.
+//
+// The books all come from one SnapshotSet load, so they are mutually
+// consistent. Venues without a book, or (when max_book_age_ns > 0) whose
+// connection has seen no frame for more than max_book_age_ns (see
+// SnapshotSet::Venue::transport_ns), are left out and counted in
+// out.stale_venues. A quiet book on a live connection stays routable.
+inline void route_order(
+    RoutingContext& ctx,
     RouterVersionId version_id,
-    const std::vector<std::shared_ptr<IVenueFeed>>& feeds,
+    const md::SnapshotSet& set,
+    std::int64_t max_book_age_ns,
     const std::string& side_lower,
     double quantity,
     const std::optional<double>& limit_price,
     const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
-    const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info)
+    const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info,
+    RoutingDecision& out)
 {
-    RoutingDecision out;
+    RoutingContext::Scope scope(ctx);
+
+    auto fresh = ctx.make_vector<const BookSnapshot*>(set.venues.size());
+    std::uint32_t stale = 0;
+    const std::int64_t now_ns = max_book_age_ns > 0
+        ? std::chrono::duration_cast<std::chrono::nanoseconds>(
+              std::chrono::steady_clock::now().time_since_epoch()).count()
+        : 0;
+    for (const auto& venue : set.venues) {
+        if (!venue.book) continue;
+        if (max_book_age_ns > 0 && now_ns - venue.transport_ns > max_book_age_ns) {
+            ++stale;
+            continue;
+        }
+        fresh.push_back(venue.book.get());
+    }
+    const RoutingBooks books(fresh.data(), fresh.size());
+
     switch (version_id) {
+        case RouterVersionId::V4CumulativeSweep:
+            RouterV4CumulativeSweep::route_order(ctx, books, side_lower, quantity, limit_price, venue_static_info, venue_runtime_info, out);
+            break;
         case RouterVersionId::V3LimitCurve:
-            out = RouterV3LimitCurve::route_order(
-                feeds,
+            RouterV3LimitCurve::route_order(
+                ctx,
+                books,
                 side_lower,
                 quantity,
                 limit_price,
                 venue_static_info,
-                venue_runtime_info);
-            return out;
+                venue_runtime_info,
+                out);
+            break;
         case RouterVersionId::V2BestPriceFee:
-            out = RouterV2BestPriceFee::route_order(feeds, side_lower, quantity, limit_price, venue_static_info, venue_runtime_info);
-            return out;
+            RouterV2BestPriceFee::route_order(ctx, books, side_lower, quantity, limit_price, venue_static_info, venue_runtime_info, out);
+            break;
         case RouterVersionId::V1BestPriceSweep:
         default:
-            out = RouterV1BestPriceSweep::route_order(
-                feeds,
+            RouterV1BestPriceSweep::route_order(
+                ctx,
+                books,
                 side_lower,
                 quantity,
-                limit_price);
-            return out;
+                limit_price,
+                out);
+            break;
     }
+    out.stale_venues = stale;
+}
+
+// One-shot form on this thread's context; only the returned slices allocate.
+inline RoutingDecision route_order(
+    RouterVersionId version_id,
+    const md::SnapshotSet& set,
+    std::int64_t max_book_age_ns,
+    const std::string& side_lower,
+    double quantity,
+    const std::optional<double>& limit_price,
+    const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
+    const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info)
+{
+    RoutingDecision out;
+    route_order(RoutingContext::for_this_thread(), version_id, set, max_book_age_ns, side_lower, quantity,
+                limit_price, venue_static_info, venue_runtime_info, out);
+    return out;
 }
 
 } // namespace router
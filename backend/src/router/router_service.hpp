@@ -1,17 +1,23 @@
 #pragma once
 
 #include <algorithm>
+#include <exception>
+#include <memory>
 #include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
 #include <utility>
 #include <variant>
+#include <vector>
 
+#include <boost/asio/thread_pool.hpp>
 #include <pqxx/pqxx>
 
 #include "server/feed_manager.hpp"
 #include "router/router_framework.hpp"
 #include "supabase/storage_supabase.hpp"
+#include "util/fork_join.hpp"
 #include "venues/venue_api.hpp"
 
 struct RouterOrderRequest {
@@ -37,6 +43,7 @@ enum class RouterErrorCode {
     MarketNoLiquidity,
     InvalidRoutingPlan,
     DatabaseFailure,
+    BatchTooLarge,
 };
 
 struct RouterError {
@@ -44,8 +51,18 @@ struct RouterError {
     std::string message;
 };
 
+// Per-order outcomes of create_orders(), in request order. Only the orders
+// holding a RouterOrderResult were persisted.
+struct RouterBatchResult {
+    std::vector<std::variant<RouterOrderResult, RouterError>> orders;
+};
+
 class RouterService {
 public:
+    // Upper bound on create_orders() size; keeps the multi-row inserts well
+    // under Postgres' 65535 bind parameters per statement.
+    static constexpr std::size_t kMaxBatchOrders = 500;
+
     RouterService(FeedManager& feeds,
                   const std::string& db_conn_str,
                   router::RouterVersionId router_version,
@@ -87,9 +104,13 @@ public:
         /* ***********************************
          * CALCULATE ROUTING PATH
          ************************************/
+        // One load of the symbol's snapshot set: every venue's book as of the
+        // same instant; route_order leaves out the stale ones.
+        const auto books = routing_inputs->books->load();
         RoutingDecision routing = router::route_order(
             router_version_,
-            routing_inputs->feeds,
+            *books,
+            routing_inputs->max_book_age_ns,
             req.side_lower,
             req.quantity_requested,
             req.limit_price,
@@ -97,33 +118,8 @@ public:
             venue_runtime_info
         );
 
-        // For orders we require at least some immediately routable size.
-        // This is to guard when the entire side is empty for market orders.
-        // For limit orders we intentionally do NOT fail on liquidity; they remain open.
-        constexpr double kEps = 1e-12;
-        const bool has_routable_qty = routing.routable_qty > kEps;
-        if (!has_routable_qty) {
-            return RouterError{
-                RouterErrorCode::MarketNoLiquidity,
-                "order rejected: no liquidity on the book side across venues"
-            };
-        }
-        
-        // TODO: make sure routing logic is sane, so we can remove these lines
-        // Defensive validation before persisting legs.
-        if (routing.slices.empty()) {
-            return RouterError{
-                RouterErrorCode::InvalidRoutingPlan,
-                "invalid routing plan: routable quantity has no legs"
-            };
-        }
-        for (const auto& slice : routing.slices) {
-            if (slice.quantity <= kEps || slice.price <= kEps) {
-                return RouterError{
-                    RouterErrorCode::InvalidRoutingPlan,
-                    "invalid routing plan: leg quantity/price must be positive"
-                };
-            }
+        if (auto err = validate_routing(routing)) {
+            return *std::move(err);
         }
 
         // Orders stay open until exchange execution reports arrive.
@@ -194,7 +190,7 @@ public:
                             )
                             VALUES ($1, $2, 'planned', $3, $4, $5, 0, NOW(), NOW())
                         )",
-                        pqxx::params(order_id, slice.venue, slice.quantity,
+                        pqxx::params(order_id, slice.venue(), slice.quantity,
                                      *req.limit_price, slice.price)
                     );
                 } else {
@@ -207,7 +203,7 @@ public:
                             )
                             VALUES ($1, $2, 'planned', $3, $4, 0, NOW(), NOW())
                         )",
-                        pqxx::params(order_id, slice.venue, slice.quantity, slice.price)
+                        pqxx::params(order_id, slice.venue(), slice.quantity, slice.price)
                     );
                 }
             }
@@ -230,14 +226,292 @@ public:
         }
     }
 
+    // Routes and persists a basket of orders. Orders are grouped by symbol so
+    // each symbol's snapshot set is loaded (and its pair held) once, and each
+    // user's fee-tier volume is fetched once; symbols are routed in parallel.
+    // Every order that routes is persisted in one transaction, with one
+    // multi-row insert for the orders and one for their legs. Orders that fail
+    // to route are reported in place and not persisted; an error is returned
+    // only when nothing could be attempted or the transaction failed.
+    std::variant<RouterBatchResult, RouterError> create_orders(
+        const std::vector<RouterOrderRequest>& reqs) const
+    {
+        if (db_conn_str_.empty()) {
+            return RouterError{
+                RouterErrorCode::DatabaseNotConfigured,
+                "database not configured"
+            };
+        }
+        if (reqs.size() > kMaxBatchOrders) {
+            return RouterError{
+                RouterErrorCode::BatchTooLarge,
+                "batch exceeds " + std::to_string(kMaxBatchOrders) + " orders"
+            };
+        }
+
+        const std::size_t n = reqs.size();
+        std::vector<RoutingDecision> routing(n);
+        std::vector<std::optional<RouterError>> rejected(n);
+
+        struct SymbolGroup {
+            std::vector<std::size_t> orders;
+            std::optional<FeedManager::RoutingInputs> inputs; // holds the pair while in flight
+        };
+        std::vector<SymbolGroup> groups;
+        {
+            std::unordered_map<std::string, std::size_t> group_of;
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto [it, inserted] = group_of.try_emplace(reqs[i].symbol, groups.size());
+                if (inserted) groups.emplace_back();
+                groups[it->second].orders.push_back(i);
+            }
+        }
+        for (auto& group : groups) {
+            group.inputs = feeds_.acquire_routing_inputs(reqs[group.orders.front()].symbol);
+            if (!group.inputs) {
+                for (std::size_t i : group.orders) {
+                    rejected[i] = RouterError{RouterErrorCode::SymbolNotSupported, "symbol not supported"};
+                }
+            }
+        }
+
+        // Fetch each user's venue runtime inputs once for the whole batch.
+        std::unordered_map<std::string, std::unordered_map<std::string, VenueRuntimeInfo>> runtime_by_user;
+        try {
+            pqxx::connection conn(supabase::with_connect_timeout(db_conn_str_));
+            pqxx::work txn(conn);
+            for (const auto& req : reqs) {
+                if (!runtime_by_user.contains(req.user_id)) {
+                    runtime_by_user.emplace(req.user_id, fetch_user_venue_runtime_info(txn, req.user_id));
+                }
+            }
+            txn.commit();
+        } catch (const std::exception& e) {
+            return RouterError{
+                RouterErrorCode::DatabaseFailure,
+                std::string("failed to load user trailing volume: ") + e.what()
+            };
+        }
+
+        /* ***********************************
+         * CALCULATE ROUTING PATHS
+         ************************************/
+        // Groups touch disjoint orders; each worker routes on its own thread's
+        // context, from one snapshot set load per symbol taken right before routing.
+        auto route_group = [&](const SymbolGroup& group) {
+            const auto books = group.inputs->books->load();
+            for (std::size_t i : group.orders) {
+                const auto& req = reqs[i];
+                try {
+                    router::route_order(
+                        RoutingContext::for_this_thread(),
+                        router_version_,
+                        *books,
+                        group.inputs->max_book_age_ns,
+                        req.side_lower,
+                        req.quantity_requested,
+                        req.limit_price,
+                        venue_static_info_,
+                        runtime_by_user.at(req.user_id),
+                        routing[i]);
+                    rejected[i] = validate_routing(routing[i]);
+                } catch (const std::exception& e) {
+                    rejected[i] = RouterError{
+                        RouterErrorCode::InvalidRoutingPlan,
+                        std::string("routing failed: ") + e.what()
+                    };
+                } catch (...) {
+                    rejected[i] = RouterError{RouterErrorCode::InvalidRoutingPlan, "routing failed"};
+                }
+            }
+        };
+        std::vector<const SymbolGroup*> routable;
+        for (const auto& group : groups) {
+            if (group.inputs) routable.push_back(&group);
+        }
+        // The calling thread routes the last group itself.
+        util::fork_join(routing_pool(), routable.size(), [&](std::size_t g) { route_group(*routable[g]); });
+        groups.clear(); // release the pair holds
+
+        // Orders stay open until exchange execution reports arrive.
+        const std::string final_status = "open";
+        std::vector<std::size_t> accepted;
+        std::size_t leg_count = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (rejected[i]) continue;
+            accepted.push_back(i);
+            leg_count += routing[i].slices.size();
+        }
+
+        std::vector<std::string> order_ids(n);
+        if (!accepted.empty()) {
+            try {
+                pqxx::connection conn(supabase::with_connect_timeout(db_conn_str_));
+                pqxx::work txn(conn);
+
+                // Ids up front, so each leg row can name its order in the same
+                // statement and no RETURNING order has to be relied on.
+                const auto ids = txn.exec(
+                    "SELECT uuid_generate_v4()::text FROM generate_series(1, $1)",
+                    pqxx::params(static_cast<int>(accepted.size()))
+                );
+                for (std::size_t k = 0; k < accepted.size(); ++k) {
+                    order_ids[accepted[k]] = ids[static_cast<int>(k)][0].as<std::string>();
+                }
+
+                /*
+                * Log orders
+                */
+                std::string sql = R"(
+                    INSERT INTO public.orders (
+                        id, user_id, symbol, side, order_type,
+                        quantity_requested, limit_price,
+                        quantity_planned, price_planned_avg,
+                        fully_routable, routing_message,
+                        status, created_at, last_updated_at
+                    )
+                    VALUES )";
+                pqxx::params params;
+                int next_param = 1;
+                for (std::size_t i : accepted) {
+                    const auto& req = reqs[i];
+                    const auto& r = routing[i];
+                    append_values_row(sql, next_param, 12, "NOW(), NOW()");
+                    params.append(order_ids[i]);
+                    params.append(req.user_id);
+                    params.append(req.symbol);
+                    params.append(req.side_lower);
+                    params.append(req.type_lower);
+                    params.append(req.quantity_requested);
+                    params.append(req.limit_price);
+                    params.append(r.routable_qty);
+                    params.append(r.indicative_average_price);
+                    params.append(r.fully_routable);
+                    params.append(r.message);
+                    params.append(final_status);
+                }
+                txn.exec(sql, params);
+
+                /*
+                * Log orders_leg based on routing slices
+                */
+                if (leg_count > 0) {
+                    sql = R"(
+                        INSERT INTO public.order_legs (
+                            order_id, venue, quantity_planned,
+                            limit_price, price_planned, status,
+                            quantity_filled, created_at, last_updated_at
+                        )
+                        VALUES )";
+                    params = pqxx::params{};
+                    next_param = 1;
+                    for (std::size_t i : accepted) {
+                        for (const auto& slice : routing[i].slices) {
+                            append_values_row(sql, next_param, 5, "'planned', 0, NOW(), NOW()");
+                            params.append(order_ids[i]);
+                            params.append(slice.venue());
+                            params.append(slice.quantity);
+                            params.append(reqs[i].limit_price);
+                            params.append(slice.price);
+                        }
+                    }
+                    txn.exec(sql, params);
+                }
+
+                txn.commit();
+            } catch (const std::exception& e) {
+                return RouterError{
+                    RouterErrorCode::DatabaseFailure,
+                    e.what()
+                };
+            }
+        }
+
+        RouterBatchResult out;
+        out.orders.reserve(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (rejected[i]) {
+                out.orders.emplace_back(*std::move(rejected[i]));
+                continue;
+            }
+            out.orders.emplace_back(RouterOrderResult{
+                std::move(order_ids[i]),
+                final_status,
+                std::move(routing[i]),
+                runtime_by_user.at(reqs[i].user_id),
+            });
+        }
+        return out;
+    }
+
 private:
+    // Shared by all batches; single orders route on the request thread.
+    static boost::asio::thread_pool& routing_pool() {
+        static boost::asio::thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    // Appends "($k, ..., $k+columns-1, trailing)" (comma-separated from any
+    // previous row) to a multi-row VALUES list.
+    static void append_values_row(std::string& sql, int& next_param, int columns, std::string_view trailing) {
+        sql += next_param == 1 ? "(" : ", (";
+        for (int c = 0; c < columns; ++c) {
+            sql += '$';
+            sql += std::to_string(next_param++);
+            sql += ", ";
+        }
+        sql += trailing;
+        sql += ')';
+    }
+
+    // Orders that may be persisted: some immediately routable size, and sane legs.
+    static std::optional<RouterError> validate_routing(const RoutingDecision& routing) {
+        // For orders we require at least some immediately routable size.
+        // This is to guard when the entire side is empty for market orders.
+        // For limit orders we intentionally do NOT fail on liquidity; they remain open.
+        constexpr double kEps = 1e-12;
+        const bool has_routable_qty = routing.routable_qty > kEps;
+        if (!has_routable_qty) {
+            return RouterError{
+                RouterErrorCode::MarketNoLiquidity,
+                "order rejected: no liquidity on the book side across venues"
+            };
+        }
+
+        // TODO: make sure routing logic is sane, so we can remove these lines
+        // Defensive validation before persisting legs.
+        if (routing.slices.empty()) {
+            return RouterError{
+                RouterErrorCode::InvalidRoutingPlan,
+                "invalid routing plan: routable quantity has no legs"
+            };
+        }
+        for (const auto& slice : routing.slices) {
+            if (slice.quantity <= kEps || slice.price <= kEps) {
+                return RouterError{
+                    RouterErrorCode::InvalidRoutingPlan,
+                    "invalid routing plan: leg quantity/price must be positive"
+                };
+            }
+        }
+        return std::nullopt;
+    }
+
     std::unordered_map<std::string, VenueRuntimeInfo> fetch_user_venue_runtime_info(
         const std::string& user_id) const
     {
-        std::unordered_map<std::string, VenueRuntimeInfo> out;
-
         pqxx::connection conn(supabase::with_connect_timeout(db_conn_str_));
         pqxx::work txn(conn);
+        auto out = fetch_user_venue_runtime_info(txn, user_id);
+        txn.commit();
+        return out;
+    }
+
+    std::unordered_map<std::string, VenueRuntimeInfo> fetch_user_venue_runtime_info(
+        pqxx::work& txn,
+        const std::string& user_id) const
+    {
+        std::unordered_map<std::string, VenueRuntimeInfo> out;
 
         // Approximate trailing venue volume using planned leg notional over the last 30 days.
         // This keeps fee tiers meaningful before live execution reporting is wired in.
@@ -267,7 +541,6 @@ private:
 
         // TODO: Add also the latency and volatility runtime inputs
 
-        txn.commit();
         return out;
     }
 
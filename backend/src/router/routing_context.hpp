@@ -0,0 +1,105 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+
+#include "md/level_merge.hpp"
+#include "md/snapshot_levels.hpp"
+
+// Reusable scratch for route_order. Every per-call container a router needs
+// (venue states, cursors, heaps, per-venue totals, V3 curves) is a pmr
+// container on this arena, and V1's LevelMerger keeps its storage here.
+// - The arena is monotonic: nothing is freed during a route; Scope rewinds it
+//   when the route returns.
+// - If a route spills past the buffer, the next rewind grows the buffer to
+//   cover it, so after a warm-up routes of a similar size allocate nothing.
+//   Growth stops at kMaxRetainedBytes: one outsized route must not pin its
+//   scratch in every routing thread for good, so larger routes spill to the
+//   heap and free it on rewind.
+// - Not thread-safe; use one per thread (for_this_thread()).
+class RoutingContext {
+public:
+    static constexpr std::size_t kMaxRetainedBytes = 1024 * 1024;
+
+    explicit RoutingContext(std::size_t initial_bytes = 16 * 1024) { reserve(initial_bytes); }
+
+    RoutingContext(const RoutingContext&) = delete;
+    RoutingContext& operator=(const RoutingContext&) = delete;
+
+    std::pmr::memory_resource* resource() noexcept { return &*arena_; }
+
+    template <class T>
+    std::pmr::vector<T> make_vector(std::size_t reserve = 0) {
+        std::pmr::vector<T> v(resource());
+        v.reserve(reserve);
+        return v;
+    }
+
+    md::LevelMerger<SnapshotLevels::const_iterator>& merger() noexcept { return merger_; }
+
+    std::size_t capacity_bytes() const noexcept { return size_; }
+
+    // Rewinds the arena when the route returns; every container allocated
+    // from it must be gone by then.
+    class Scope {
+    public:
+        explicit Scope(RoutingContext& ctx) noexcept : ctx_(ctx) {}
+        ~Scope() { ctx_.rewind(); }
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        RoutingContext& ctx_;
+    };
+
+    static RoutingContext& for_this_thread() {
+        thread_local RoutingContext ctx;
+        return ctx;
+    }
+
+private:
+    // Upstream of the arena: records how much a route spilled past the buffer.
+    class SpillTracker final : public std::pmr::memory_resource {
+    public:
+        std::size_t spilled{0};
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t align) override {
+            spilled += bytes;
+            return std::pmr::new_delete_resource()->allocate(bytes, align);
+        }
+        void do_deallocate(void* p, std::size_t bytes, std::size_t align) override {
+            std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+        }
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    void reserve(std::size_t bytes) {
+        arena_.reset();
+        size_ = bytes;
+        buffer_ = std::make_unique<std::byte[]>(size_);
+        upstream_.spilled = 0;
+        arena_.emplace(buffer_.get(), size_, &upstream_);
+    }
+
+    void rewind() {
+        if (upstream_.spilled == 0 || size_ >= kMaxRetainedBytes) {
+            arena_->release();
+            upstream_.spilled = 0;
+            return;
+        }
+        reserve(std::min(std::bit_ceil(size_ + upstream_.spilled), kMaxRetainedBytes));
+    }
+
+    std::size_t size_{0};
+    std::unique_ptr<std::byte[]> buffer_;
+    SpillTracker upstream_;
+    std::optional<std::pmr::monotonic_buffer_resource> arena_;
+    md::LevelMerger<SnapshotLevels::const_iterator> merger_;
+};
@@ -3,3 +3,4 @@
 #include "router/versions/v1_best_price_sweep.hpp"
 #include "router/versions/v2_best_price_fee.hpp"
 #include "router/versions/v3_limit_curve.hpp"
+#include "router/versions/v4_cumulative_sweep.hpp"
@@ -23,8 +23,8 @@ inline double maker_effective_limit_price(double limit_price, bool is_buy, doubl
 struct RouterV2BestPriceFee {
 private:
     struct VenueState {
-        std::shared_ptr<const BookSnapshot> snapshot;
-        const std::string* venue{nullptr};
+        const BookSnapshot* snapshot{nullptr};
+        md::VenueId venue{md::kNoVenue};
         std::uint64_t seq{0};
         double maker_fee{0.0};
         double taker_fee{0.0};
@@ -33,24 +33,19 @@ private:
     struct GreedyBookResult {
         double filled_qty{0.0};
         double raw_notional{0.0};
-        std::vector<double> venue_qty;
-        std::vector<double> venue_notional;
+        std::pmr::vector<double> venue_qty;
+        std::pmr::vector<double> venue_notional;
     };
 
-    static std::vector<VenueState> collect_venue_states(
-        const std::vector<std::shared_ptr<IVenueFeed>>& feeds,
+    static std::pmr::vector<VenueState> collect_venue_states(
+        RoutingContext& ctx,
+        RoutingBooks books,
         const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
         const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info)
     {
-        std::vector<VenueState> states;
-        states.reserve(feeds.size());
-
-        for (const auto& feed : feeds) {
-            if (!feed) continue;
-
-            auto snapshot = feed->load_snapshot();
-            if (!snapshot) continue;
+        auto states = ctx.make_vector<VenueState>(books.size());
 
+        for (const BookSnapshot* snapshot : books) {
             double maker_fee = 0.0;
             double taker_fee = 0.0;
             auto info_it = venue_static_info.find(snapshot->venue);
@@ -69,7 +64,7 @@ private:
             states.push_back(
                 VenueState{
                     snapshot,
-                    &snapshot->venue,
+                    snapshot_venue_id(*snapshot),
                     snapshot->seq,
                     maker_fee,
                     taker_fee
@@ -81,72 +76,67 @@ private:
     }
 
     static GreedyBookResult route_immediate_greedy(
-        const std::vector<VenueState>& states,
+        RoutingContext& ctx,
+        const std::pmr::vector<VenueState>& states,
         bool is_buy,
         double quantity,
         const std::optional<double>& limit_price)
     {
-        GreedyBookResult result;
-        result.venue_qty.assign(states.size(), 0.0);
-        result.venue_notional.assign(states.size(), 0.0);
+        GreedyBookResult result{
+            0.0,
+            0.0,
+            std::pmr::vector<double>(states.size(), 0.0, ctx.resource()),
+            std::pmr::vector<double>(states.size(), 0.0, ctx.resource())
+        };
 
         if (quantity <= kRoutingEps || states.empty()) return result;
 
         struct SnapshotCursor {
-            const std::string* venue{nullptr};
-            const std::vector<BookSnapshotLevel>* levels{nullptr};
+            SnapshotLevels::const_iterator it;
+            SnapshotLevels::const_iterator end;
             std::uint64_t seq{0};
-            std::size_t idx{0};
             double taker_fee{0.0}; // fixed for this order
+            BookSnapshotLevel cur{}; // materialized level at `it`
 
-            bool valid() const noexcept {
-                return levels != nullptr && idx < levels->size();
+            SnapshotCursor(const SnapshotLevels& levels, std::uint64_t s, double fee)
+                : it(levels.begin()), end(levels.end()), seq(s), taker_fee(fee) {
+                if (valid()) cur = *it;
             }
 
-            double price() const noexcept {
-                if (!valid()) return 0.0;
-                return (*levels)[idx].price;
+            bool valid() const noexcept {
+                return it != end;
             }
 
-            double size() const noexcept {
-                if (!valid()) return 0.0;
-                return (*levels)[idx].size;
-            }
+            md::PriceTicks px() const noexcept { return valid() ? cur.px : 0; }
+            double price() const noexcept { return valid() ? cur.price : 0.0; }
+            double size() const noexcept { return valid() ? cur.size : 0.0; }
 
             void next() noexcept {
                 if (!valid()) return;
-                ++idx;
+                ++it;
+                if (valid()) cur = *it;
             }
         };
 
-        std::vector<SnapshotCursor> cursors;
-        cursors.reserve(states.size());
-        std::vector<std::size_t> state_idx_by_cursor;
-        state_idx_by_cursor.reserve(states.size());
+        auto cursors = ctx.make_vector<SnapshotCursor>(states.size());
+        auto state_idx_by_cursor = ctx.make_vector<std::size_t>(states.size());
 
         for (std::size_t i = 0; i < states.size(); ++i) {
             const auto& state = states[i];
             if (!state.snapshot) continue;
 
-            const auto* levels = &(is_buy ? state.snapshot->asks : state.snapshot->bids);
-            if (levels->empty()) continue;
+            const auto& levels = is_buy ? state.snapshot->asks : state.snapshot->bids;
+            if (levels.empty()) continue;
 
             state_idx_by_cursor.push_back(i);
-            cursors.push_back(
-                SnapshotCursor{
-                    state.venue,
-                    levels,
-                    state.seq,
-                    0,
-                    state.taker_fee
-                }
-            );
+            cursors.emplace_back(levels, state.seq, state.taker_fee);
         }
 
         if (cursors.empty()) return result;
 
         struct HeapNode {
             std::size_t cursor_idx{0};
+            md::PriceTicks px{0}; // exact tie-break key
             double price{0.0};
             double effective_price{0.0};
             double size{0.0};
@@ -160,16 +150,17 @@ private:
                         ? a.effective_price > b.effective_price
                         : a.effective_price < b.effective_price;
                 }
-                if (a.price != b.price) {
-                    return is_buy ? a.price > b.price : a.price < b.price;
+                if (a.px != b.px) {
+                    return is_buy ? a.px > b.px : a.px < b.px;
                 }
                 if (a.size != b.size) return a.size < b.size;
                 return a.seq < b.seq;
             }
         };
 
-        std::priority_queue<HeapNode, std::vector<HeapNode>, HeapCompare> heap(
-            HeapCompare{is_buy}
+        std::priority_queue<HeapNode, std::pmr::vector<HeapNode>, HeapCompare> heap(
+            HeapCompare{is_buy},
+            ctx.make_vector<HeapNode>(cursors.size())
         );
 
         auto make_node = [&](std::size_t cursor_idx) {
@@ -177,6 +168,7 @@ private:
             const double px = c.price();
             return HeapNode{
                 cursor_idx,
+                c.px(),
                 px,
                 fee_adjusted_price(px, is_buy, c.taker_fee),
                 c.size(),
@@ -188,14 +180,15 @@ private:
             heap.push(make_node(i));
         }
 
+        const md::PriceTicks limit_px = limit_price.has_value() ? md::price_from_double(*limit_price) : 0;
         double remaining = quantity;
         while (remaining > kRoutingEps && !heap.empty()) {
             const auto lvl = heap.top();
             heap.pop();
 
             if (limit_price.has_value()) {
-                if (is_buy && lvl.price > *limit_price) continue;
-                if (!is_buy && lvl.price < *limit_price) continue;
+                if (is_buy && lvl.px > limit_px) continue;
+                if (!is_buy && lvl.px < limit_px) continue;
             }
 
             const double take_qty = std::min(remaining, lvl.size);
@@ -220,7 +213,7 @@ private:
     }
 
     static std::optional<std::size_t> choose_best_maker_venue(
-        const std::vector<VenueState>& states,
+        const std::pmr::vector<VenueState>& states,
         bool is_buy,
         double limit_price)
     {
@@ -233,7 +226,7 @@ private:
         std::uint64_t best_seq = 0;
 
         for (std::size_t i = 0; i < states.size(); ++i) {
-            if (!states[i].venue) continue;
+            if (!states[i].snapshot) continue;
             const double effective = maker_effective_limit_price(limit_price, is_buy, states[i].maker_fee);
             if (!best_idx.has_value()) {
                 best_idx = i;
@@ -268,39 +261,40 @@ private:
     }
 
 public:
-    static RoutingDecision route_order(
-        const std::vector<std::shared_ptr<IVenueFeed>>& feeds,
+    static void route_order(
+        RoutingContext& ctx,
+        RoutingBooks books,
         const std::string& side_lower,
         double quantity,
         const std::optional<double>& limit_price,
         const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
-        const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info)
+        const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info,
+        RoutingDecision& out)
     {
-        RoutingDecision out;
-        out.requested_qty = quantity;
+        out.reset(quantity);
 
         if (quantity <= 0.0) {
             out.message = "invalid quantity";
-            return out;
+            return;
         }
 
         const bool is_buy = side_lower == "buy";
         const bool is_sell = side_lower == "sell";
         if (!is_buy && !is_sell) {
             out.message = "invalid side";
-            return out;
+            return;
         }
 
-        const auto states = collect_venue_states(feeds, venue_static_info, venue_runtime_info);
+        const auto states = collect_venue_states(ctx, books, venue_static_info, venue_runtime_info);
         if (states.empty()) {
             out.message = "no liquidity available";
-            return out;
+            return;
         }
 
-        const auto immediate = route_immediate_greedy(states, is_buy, quantity, limit_price);
+        auto immediate = route_immediate_greedy(ctx, states, is_buy, quantity, limit_price);
 
-        std::vector<double> venue_qty = immediate.venue_qty;
-        std::vector<double> venue_notional = immediate.venue_notional;
+        auto& venue_qty = immediate.venue_qty;
+        auto& venue_notional = immediate.venue_notional;
         double total_notional = immediate.raw_notional;
         double routed_qty = immediate.filled_qty;
         double remaining = std::max(0.0, quantity - routed_qty);
@@ -328,7 +322,7 @@ public:
             if (q <= kRoutingEps) continue;
             out.slices.push_back(
                 RouteSlice{
-                    *states[i].venue,
+                    states[i].venue,
                     ExecutionType::LIMIT_ALLOW_TAKER,
                     q,
                     venue_notional[i] / q
@@ -337,6 +331,5 @@ public:
         }
 
         set_routing_message(out, limit_price);
-        return out;
     }
 };
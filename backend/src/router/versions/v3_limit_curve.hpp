@@ -14,12 +14,12 @@ constexpr double kMaxFillProb            = 0.98;
 constexpr double kUnderfillPenaltyFrac   = 0.0005;  // 5 bps of reference price per unfilled unit
 
 struct VenueRouteState {
-    std::string venue;
+    md::VenueId venue_id{md::kNoVenue};
     double maker_fee{0.0};
     double taker_fee{0.0};
     double latency_ms{0.0};
     double volatility{0.0};
-    std::shared_ptr<const BookSnapshot> snapshot;
+    const BookSnapshot* snapshot{nullptr};
 };
 
 struct CurveSegment {
@@ -32,7 +32,7 @@ struct CurveSegment {
 struct ModeCurve {
     bool feasible{false};
     ExecutionType execution_type{LIMIT_POST_ONLY};
-    std::vector<CurveSegment> segments;
+    std::pmr::vector<CurveSegment> segments;
 };
 
 struct VenueCurves {
@@ -89,13 +89,14 @@ inline bool post_only_would_cross(
     double limit_price,
     const BookSnapshot& book)
 {
+    const md::PriceTicks limit_px = md::price_from_double(limit_price);
     if (buy_side) {
         if (book.asks.empty()) return false;
-        return limit_price >= book.asks.front().price - kRoutingEps;
+        return limit_px >= book.asks.front().px;
     }
 
     if (book.bids.empty()) return false;
-    return limit_price <= book.bids.front().price + kRoutingEps;
+    return limit_px <= book.bids.front().px;
 }
 
 inline double queue_ahead_same_side(
@@ -103,27 +104,19 @@ inline double queue_ahead_same_side(
     double limit_price,
     const BookSnapshot& book)
 {
+    const md::PriceTicks limit_px = md::price_from_double(limit_price);
     double q = 0.0;
 
+    // Levels at or better than the limit rest ahead of a new order at the limit.
     if (buy_side) {
         for (const auto& lvl : book.bids) {
-            if (lvl.price > limit_price + kRoutingEps) {
-                q += lvl.size;
-            } else if (std::fabs(lvl.price - limit_price) <= kRoutingEps) {
-                q += lvl.size;
-            } else {
-                break;
-            }
+            if (lvl.px < limit_px) break;
+            q += lvl.size;
         }
     } else {
         for (const auto& lvl : book.asks) {
-            if (lvl.price < limit_price - kRoutingEps) {
-                q += lvl.size;
-            } else if (std::fabs(lvl.price - limit_price) <= kRoutingEps) {
-                q += lvl.size;
-            } else {
-                break;
-            }
+            if (lvl.px > limit_px) break;
+            q += lvl.size;
         }
     }
 
@@ -145,17 +138,18 @@ inline bool improves_spread(
     double limit_price,
     const BookSnapshot& book)
 {
+    const md::PriceTicks limit_px = md::price_from_double(limit_price);
     if (buy_side) {
         if (book.bids.empty()) return false;
         if (book.asks.empty()) return true;
-        return (limit_price > book.bids.front().price + kRoutingEps) &&
-               (limit_price < book.asks.front().price - kRoutingEps);
+        return (limit_px > book.bids.front().px) &&
+               (limit_px < book.asks.front().px);
     }
 
     if (book.asks.empty()) return false;
     if (book.bids.empty()) return true;
-    return (limit_price < book.asks.front().price - kRoutingEps) &&
-           (limit_price > book.bids.front().price + kRoutingEps);
+    return (limit_px < book.asks.front().px) &&
+           (limit_px > book.bids.front().px);
 }
 
 inline bool joins_touch_without_improving(
@@ -163,13 +157,14 @@ inline bool joins_touch_without_improving(
     double limit_price,
     const BookSnapshot& book)
 {
+    const md::PriceTicks limit_px = md::price_from_double(limit_price);
     if (buy_side) {
         if (book.bids.empty()) return false;
-        return std::fabs(limit_price - book.bids.front().price) <= kRoutingEps;
+        return limit_px == book.bids.front().px;
     }
 
     if (book.asks.empty()) return false;
-    return std::fabs(limit_price - book.asks.front().price) <= kRoutingEps;
+    return limit_px == book.asks.front().px;
 }
 
 /*
@@ -217,7 +212,7 @@ inline double underfill_penalty_per_unit(double reference_price) {
 
 inline double best_reference_taker_unit_cost(
     bool buy_side,
-    const std::vector<VenueRouteState>& venues)
+    const std::pmr::vector<VenueRouteState>& venues)
 {
     double best = std::numeric_limits<double>::infinity();
 
@@ -240,7 +235,7 @@ inline double best_reference_taker_unit_cost(
     return best;
 }
 
-inline double global_mid_price_estimate(const std::vector<VenueRouteState>& venues)
+inline double global_mid_price_estimate(const std::pmr::vector<VenueRouteState>& venues)
 {
     double best_bid = -std::numeric_limits<double>::infinity();
     double best_ask =  std::numeric_limits<double>::infinity();
@@ -293,10 +288,10 @@ inline ModeCurve build_post_only_curve(
     double limit_price,
     const VenueRouteState& vr,
     double fallback_reference_unit_cost,
-    double reference_price)
+    double reference_price,
+    std::pmr::memory_resource* mr)
 {
-    ModeCurve curve;
-    curve.execution_type = LIMIT_POST_ONLY;
+    ModeCurve curve{false, LIMIT_POST_ONLY, std::pmr::vector<CurveSegment>(mr)};
 
     if (!vr.snapshot || total_qty_cap <= kRoutingEps) {
         return curve;
@@ -341,10 +336,10 @@ inline ModeCurve build_allow_taker_curve(
     double limit_price,
     const VenueRouteState& vr,
     double fallback_reference_unit_cost,
-    double reference_price)
+    double reference_price,
+    std::pmr::memory_resource* mr)
 {
-    ModeCurve curve;
-    curve.execution_type = LIMIT_ALLOW_TAKER;
+    ModeCurve curve{false, LIMIT_ALLOW_TAKER, std::pmr::vector<CurveSegment>(mr)};
 
     if (!vr.snapshot || total_qty_cap <= kRoutingEps) {
         return curve;
@@ -354,14 +349,15 @@ inline ModeCurve build_allow_taker_curve(
     const auto& opp_levels = buy_side ? book.asks : book.bids;
 
     double remaining = total_qty_cap;
+    const md::PriceTicks limit_px = md::price_from_double(limit_price);
 
     // Deterministic taker prefix from the crossing part of one allow-taker order.
     for (const auto& lvl : opp_levels) {
         if (remaining <= kRoutingEps) break;
 
         const bool crosses = buy_side
-            ? (lvl.price <= limit_price + kRoutingEps)
-            : (lvl.price >= limit_price - kRoutingEps);
+            ? (lvl.px <= limit_px)
+            : (lvl.px >= limit_px);
 
         if (!crosses) break;
         if (lvl.size <= kRoutingEps) continue;
@@ -423,22 +419,23 @@ inline const ModeCurve& curve_for_mode(
 
 struct RouterV3LimitCurve {
 public:
-    static RoutingDecision route_order(
-        const std::vector<std::shared_ptr<IVenueFeed>>& feeds,
+    static void route_order(
+        RoutingContext& ctx,
+        RoutingBooks books,
         const std::string& side_lower,
         double quantity,
         const std::optional<double>& limit_price,
         const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
-        const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info)
+        const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info,
+        RoutingDecision& out)
     {
-        RoutingDecision out;
-        out.requested_qty = quantity;
+        out.reset(quantity);
 
         const bool buy_side = side_lower == "buy";
 
         if (side_lower != "buy" && side_lower != "sell") {
             out.message = "Invalid side_lower. Expected 'buy' or 'sell'.";
-            return out;
+            return;
         }
 
         if (quantity <= kRoutingEps) {
@@ -446,21 +443,24 @@ public:
             out.routable_qty = 0.0;
             out.indicative_average_price = 0.0;
             out.message = "Zero quantity requested.";
-            return out;
+            return;
         }
 
         if (!limit_price) {
-            return route_market_order_heap(
-                feeds,
+            route_market_order_heap(
+                ctx,
+                books,
                 buy_side,
                 quantity,
                 venue_static_info,
                 venue_runtime_info,
                 out);
+            return;
         }
 
-        return route_limit_order_expected_cost(
-            feeds,
+        route_limit_order_expected_cost(
+            ctx,
+            books,
             buy_side,
             quantity,
             *limit_price,
@@ -509,8 +509,9 @@ private:
     * Market order routing via heap-based SOR
     * ****************************************************************
     */
-    static RoutingDecision route_market_order_heap(
-        const std::vector<std::shared_ptr<IVenueFeed>>& feeds,
+    static void route_market_order_heap(
+        RoutingContext& ctx,
+        RoutingBooks books,
         bool buy,
         double quantity,
         const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
@@ -518,9 +519,9 @@ private:
         RoutingDecision& out)
     {
         struct VenueBook {
-            std::string venue;
+            md::VenueId venue_id;
             double taker_fee;
-            std::shared_ptr<const BookSnapshot> snapshot;
+            const BookSnapshot* snapshot;
         };
 
         struct HeapNode {
@@ -550,39 +551,35 @@ private:
         /*
         * (1) Load snapshots and per-venue taker fee. Store snapshot and fee together in VenueBook struct
         */
-        std::vector<VenueBook> books;
-        books.reserve(feeds.size());
-
-        for (const auto& feed : feeds) {
-            if (!feed) continue;
-            auto snap = feed->load_snapshot();
-            if (!snap) continue;
+        auto venue_books = ctx.make_vector<VenueBook>(books.size());
 
+        for (const BookSnapshot* snap : books) {
             const double fee = taker_fee_for_venue(
                 snap->venue,
                 venue_static_info,
                 venue_runtime_info);
 
-            books.push_back({snap->venue, fee, snap});
+            venue_books.push_back({snapshot_venue_id(*snap), fee, snap});
         }
 
         /*
         * (2) Initialize a heap with best level per venue, using **fee-adjusted** effective price
         */
-        const int venue_count = static_cast<int>(books.size());
-        std::priority_queue<HeapNode, std::vector<HeapNode>, HeapCompare> heap(
-            HeapCompare{buy}
+        const int venue_count = static_cast<int>(venue_books.size());
+        std::priority_queue<HeapNode, std::pmr::vector<HeapNode>, HeapCompare> heap(
+            HeapCompare{buy},
+            ctx.make_vector<HeapNode>(venue_books.size())
         );
 
         for (int i = 0; i < venue_count; ++i) {
-            const auto& book = *books[i].snapshot;
+            const auto& book = *venue_books[i].snapshot;
             const auto& levels = buy ? book.asks : book.bids;
             if (levels.empty()) continue;
 
             const double eff = router_v3_detail::effective_price(
                 buy,
                 levels[0].price,
-                books[i].taker_fee);
+                venue_books[i].taker_fee);
 
             heap.push({i, 0, eff});
         }
@@ -590,8 +587,8 @@ private:
         /*
         * (3) Pops best level repeatedly, consumes quantity, pushes next level from same venue until order fully filled/heap exhausted.
         */
-        std::vector<double> qty_by_venue(venue_count, 0.0);
-        std::vector<double> notional_by_venue(venue_count, 0.0);
+        std::pmr::vector<double> qty_by_venue(venue_count, 0.0, ctx.resource());
+        std::pmr::vector<double> notional_by_venue(venue_count, 0.0, ctx.resource());
 
         double remaining = quantity;
 
@@ -600,7 +597,7 @@ private:
             heap.pop();
 
             const int venue_idx = node.venue_index;
-            const auto& vb = books[venue_idx];      //TODO inefficient copy?????
+            const auto& vb = venue_books[venue_idx];      //TODO inefficient copy?????
             const auto& book = *vb.snapshot;
 
             const auto& levels = buy ? book.asks : book.bids;
@@ -639,7 +636,7 @@ private:
             const double notional = notional_by_venue[i];
 
             RouteSlice slice;
-            slice.venue = books[i].venue;
+            slice.venue_id = venue_books[i].venue_id;
             slice.execution_type = MARKET;
             slice.quantity = q;
             slice.price = notional / q;
@@ -659,8 +656,6 @@ private:
         out.message = out.fully_routable
             ? "Market order routed via heap-based SOR."
             : "Market order partially filled due to insufficient liquidity.";
-
-        return out;
     }
 
 
@@ -669,8 +664,9 @@ private:
     * Limit order routing via frontier-based SOR with expected cost optimization
     * ****************************************************************
     */
-    static RoutingDecision route_limit_order_expected_cost(
-        const std::vector<std::shared_ptr<IVenueFeed>>& feeds,
+    static void route_limit_order_expected_cost(
+        RoutingContext& ctx,
+        RoutingBooks books,
         bool buy_side,
         double quantity,
         double limit_price,
@@ -680,16 +676,11 @@ private:
     {
         using namespace router_v3_detail;
 
-        std::vector<VenueRouteState> venues;
-        venues.reserve(feeds.size());
-
-        for (const auto& feed : feeds) {
-            if (!feed) continue;
-            auto snap = feed->load_snapshot();
-            if (!snap) continue;
+        auto venues = ctx.make_vector<VenueRouteState>(books.size());
 
+        for (const BookSnapshot* snap : books) {
             VenueRouteState vr;
-            vr.venue = snap->venue;
+            vr.venue_id = snapshot_venue_id(*snap);
             vr.snapshot = snap;
             vr.maker_fee = maker_fee_for_venue(
                 snap->venue,
@@ -711,7 +702,7 @@ private:
 
         if (venues.empty()) {
             out.message = "No venue snapshots available.";
-            return out;
+            return;
         }
 
         const int venue_count = static_cast<int>(venues.size());
@@ -724,35 +715,42 @@ private:
             reference_price = limit_price;
         }
 
-        std::vector<VenueCurves> all_curves(venue_count);
+        // Curves are built in place so their segments stay on the arena.
+        auto all_curves = ctx.make_vector<VenueCurves>(venues.size());
         for (int v = 0; v < venue_count; ++v) {
-            all_curves[v].post_only = build_post_only_curve(
-                buy_side,
-                quantity,
-                limit_price,
-                venues[v],
-                fallback_reference_unit_cost,
-                reference_price);
-
-            all_curves[v].allow_taker = build_allow_taker_curve(
-                buy_side,
-                quantity,
-                limit_price,
-                venues[v],
-                fallback_reference_unit_cost,
-                reference_price);
+            all_curves.push_back(VenueCurves{
+                build_post_only_curve(
+                    buy_side,
+                    quantity,
+                    limit_price,
+                    venues[v],
+                    fallback_reference_unit_cost,
+                    reference_price,
+                    ctx.resource()),
+                build_allow_taker_curve(
+                    buy_side,
+                    quantity,
+                    limit_price,
+                    venues[v],
+                    fallback_reference_unit_cost,
+                    reference_price,
+                    ctx.resource())
+            });
         }
 
-        std::priority_queue<HeapNode, std::vector<HeapNode>, HeapCompare> heap;
+        std::priority_queue<HeapNode, std::pmr::vector<HeapNode>, HeapCompare> heap(
+            HeapCompare{},
+            ctx.make_vector<HeapNode>(2 * venues.size())
+        );
 
         // Per-venue state.
         // chosen_mode_by_venue: -1 unset, 0 POST_ONLY, 1 ALLOW_TAKER
-        std::vector<int> chosen_mode_by_venue(venue_count, -1);
-        std::vector<std::uint32_t> generation_by_venue(venue_count, 0);
+        std::pmr::vector<int> chosen_mode_by_venue(venue_count, -1, ctx.resource());
+        std::pmr::vector<std::uint32_t> generation_by_venue(venue_count, 0, ctx.resource());
 
         // Aggregation arrays.
-        std::vector<double> qty_by_venue(venue_count, 0.0);
-        std::vector<double> planned_notional_by_venue(venue_count, 0.0);
+        std::pmr::vector<double> qty_by_venue(venue_count, 0.0, ctx.resource());
+        std::pmr::vector<double> planned_notional_by_venue(venue_count, 0.0, ctx.resource());
 
         // Seed heap with both initial mode frontiers where feasible.
         for (int v = 0; v < venue_count; ++v) {
@@ -848,7 +846,7 @@ private:
             if (qty_by_venue[v] <= kRoutingEps) continue;
 
             RouteSlice slice;
-            slice.venue = venues[v].venue;
+            slice.venue_id = venues[v].venue_id;
             slice.execution_type = (chosen_mode_by_venue[v] == 1)
                 ? LIMIT_ALLOW_TAKER
                 : LIMIT_POST_ONLY;
@@ -865,7 +863,7 @@ private:
                 if (a.execution_type != b.execution_type) {
                     return static_cast<int>(a.execution_type) < static_cast<int>(b.execution_type);
                 }
-                return a.venue < b.venue;
+                return a.venue() < b.venue();
             });
 
         out.routable_qty = quantity - remaining;
@@ -885,7 +883,5 @@ private:
         } else {
             out.message = "Limit order not routable under current venue/mode frontier.";
         }
-
-        return out;
     }
 };
@@ -0,0 +1,282 @@
+#pragma once
+
+#include "router/router_common.hpp"
+#include "router/versions/v2_best_price_fee.hpp"
+#include "venues/venue_api.hpp"
+
+// Fee-aware best-price strategy (same decisions as V2) without a level-by-level
+// heap walk:
+// - Every venue's side is a best-first ladder whose snapshot already carries
+//   cum_qty/cum_notional, and the fee-adjusted price is monotone along it, so
+//   "supply at fee-adjusted price <= E" is one binary search per venue.
+// - The marginal price E* (the best E whose combined supply covers the order)
+//   is found by binary-searching each venue's ladder against that supply.
+// - Levels strictly better than E* are taken whole, read from the prefix sums;
+//   only the levels exactly at E* are filled one by one, in V2's tie order
+//   (better raw price, then larger size, then fresher snapshot).
+// Cost is O(V^2 log(levels swept) log depth) instead of O(levels swept * log V),
+// so deep sweeps stay in the microseconds. The limit leg and maker residual follow V2.
+struct RouterV4CumulativeSweep {
+private:
+    struct VenueState {
+        const BookSnapshot* snapshot{nullptr};
+        const SnapshotLevels* levels{nullptr}; // side being taken
+        std::size_t tradable{0};               // leading levels inside the limit price
+        double maker_fee{0.0};
+        double taker_fee{0.0};
+    };
+
+    // Number of leading levels for which pred holds; pred must hold on a
+    // prefix of the ladder. O(log chunks + log chunk size).
+    template <class Pred>
+    static std::size_t prefix_count(const SnapshotLevels& levels, Pred pred) {
+        const auto& refs = levels.chunks();
+        auto chunk = std::partition_point(refs.begin(), refs.end(), [&](const SnapshotLevels::ChunkRef& r) {
+            return pred(r.chunk->levels.front());
+        });
+        if (chunk == refs.begin()) return 0;
+        --chunk;
+        const auto& in = chunk->chunk->levels;
+        return chunk->start + static_cast<std::size_t>(std::partition_point(in.begin(), in.end(), pred) - in.begin());
+    }
+
+    // Cumulative (qty, notional) of the first n levels.
+    static std::pair<double, double> prefix_sums(const SnapshotLevels& levels, std::size_t n) {
+        if (n == 0) return {0.0, 0.0};
+        const BookSnapshotLevel last = levels[n - 1];
+        return {last.cum_qty, last.cum_notional};
+    }
+
+    static double taker_price(const VenueState& v, const BookSnapshotLevel& lvl, bool is_buy) {
+        return fee_adjusted_price(lvl.price, is_buy, v.taker_fee);
+    }
+
+    // Levels of v (within the limit) whose taker price is at least as good as
+    // `effective` (strictly better when `strict`).
+    static std::size_t count_at_or_better(const VenueState& v, bool is_buy, double effective, bool strict) {
+        if (v.tradable == 0) return 0;
+        const std::size_t n = prefix_count(*v.levels, [&](const BookSnapshotLevel& lvl) {
+            const double e = taker_price(v, lvl, is_buy);
+            if (strict) return is_buy ? e < effective : e > effective;
+            return is_buy ? e <= effective : e >= effective;
+        });
+        return std::min(n, v.tradable);
+    }
+
+    // Combined supply at taker price `effective` or better reaches `target`.
+    static bool covers(const std::pmr::vector<VenueState>& states, bool is_buy, double effective, double target) {
+        double qty = 0.0;
+        for (const auto& v : states) {
+            qty += prefix_sums(*v.levels, count_at_or_better(v, is_buy, effective, false)).first;
+            if (qty >= target) return true;
+        }
+        return false;
+    }
+
+    static std::pmr::vector<VenueState> collect_venue_states(
+        RoutingContext& ctx,
+        RoutingBooks books,
+        bool is_buy,
+        const std::optional<double>& limit_price,
+        const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
+        const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info)
+    {
+        auto states = ctx.make_vector<VenueState>(books.size());
+        const md::PriceTicks limit_px = limit_price.has_value() ? md::price_from_double(*limit_price) : 0;
+
+        for (const BookSnapshot* snapshot : books) {
+            VenueState v;
+            v.levels = is_buy ? &snapshot->asks : &snapshot->bids;
+            v.tradable = !limit_price.has_value()
+                ? v.levels->size()
+                : prefix_count(*v.levels, [&](const BookSnapshotLevel& lvl) {
+                      return is_buy ? lvl.px <= limit_px : lvl.px >= limit_px;
+                  });
+
+            auto info_it = venue_static_info.find(snapshot->venue);
+            if (info_it != venue_static_info.end()) {
+                double trailing_volume_usd = 0.0;
+                auto runtime_it = venue_runtime_info.find(snapshot->venue);
+                if (runtime_it != venue_runtime_info.end()) {
+                    trailing_volume_usd = std::max(0.0, runtime_it->second.trailing_volume_usd);
+                }
+                const auto tier = info_it->second.fees.tier_for_volume(trailing_volume_usd);
+                v.maker_fee = tier.maker_fee;
+                v.taker_fee = tier.taker_fee;
+            }
+            v.snapshot = snapshot;
+            states.push_back(v);
+        }
+        return states;
+    }
+
+    // Fills `quantity` of taker liquidity; venue_qty/venue_notional are indexed like states.
+    static double route_immediate(
+        RoutingContext& ctx,
+        const std::pmr::vector<VenueState>& states,
+        bool is_buy,
+        double quantity,
+        std::pmr::vector<double>& venue_qty,
+        std::pmr::vector<double>& venue_notional)
+    {
+        const double target = quantity - kRoutingEps;
+
+        // (1) Marginal taker price: for each venue, the first of its levels at
+        //     which the combined supply covers the order; E* is the best of those.
+        std::optional<double> marginal;
+        for (const auto& v : states) {
+            auto covers_at = [&](std::size_t i) {
+                return covers(states, is_buy, taker_price(v, (*v.levels)[i], is_buy), target);
+            };
+            // Only levels better than the current E* can improve it.
+            const std::size_t end = marginal ? count_at_or_better(v, is_buy, *marginal, true) : v.tradable;
+            // Gallop from the touch so small orders stay cheap on deep books.
+            std::size_t lo = 0, hi = 1;
+            while (hi < end && !covers_at(hi - 1)) {
+                lo = hi;
+                hi = std::min(end, 2 * hi);
+            }
+            hi = std::min(hi, end);
+            while (lo < hi) {
+                const std::size_t mid = lo + (hi - lo) / 2;
+                if (covers_at(mid)) hi = mid;
+                else lo = mid + 1;
+            }
+            if (lo == end) continue;
+            const double e = taker_price(v, (*v.levels)[lo], is_buy);
+            if (!marginal || (is_buy ? e < *marginal : e > *marginal)) marginal = e;
+        }
+
+        // (2) Whole levels strictly better than E* (everything when supply runs out).
+        struct Marginal {
+            std::size_t state{0};
+            BookSnapshotLevel level;
+        };
+        auto at_marginal = ctx.make_vector<Marginal>();
+        double filled = 0.0;
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            const auto& v = states[i];
+            const std::size_t full = marginal ? count_at_or_better(v, is_buy, *marginal, true) : v.tradable;
+            const auto [q, n] = prefix_sums(*v.levels, full);
+            venue_qty[i] += q;
+            venue_notional[i] += n;
+            filled += q;
+            if (!marginal) continue;
+            const std::size_t upto = count_at_or_better(v, is_buy, *marginal, false);
+            for (std::size_t k = full; k < upto; ++k) at_marginal.push_back(Marginal{i, (*v.levels)[k]});
+        }
+
+        // (3) Levels exactly at E*, in V2's heap order.
+        std::sort(at_marginal.begin(), at_marginal.end(), [&](const Marginal& a, const Marginal& b) {
+            if (a.level.px != b.level.px) return is_buy ? a.level.px < b.level.px : a.level.px > b.level.px;
+            if (a.level.size != b.level.size) return a.level.size > b.level.size;
+            return states[a.state].snapshot->seq > states[b.state].snapshot->seq;
+        });
+        for (const auto& m : at_marginal) {
+            const double take = std::min(quantity - filled, m.level.size);
+            if (take <= kRoutingEps) break;
+            venue_qty[m.state] += take;
+            venue_notional[m.state] += take * m.level.price;
+            filled += take;
+        }
+        return filled;
+    }
+
+    static std::optional<std::size_t> choose_best_maker_venue(
+        const std::pmr::vector<VenueState>& states,
+        bool is_buy,
+        double limit_price)
+    {
+        std::optional<std::size_t> best_idx;
+        double best_effective = 0.0;
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            const double effective = maker_effective_limit_price(limit_price, is_buy, states[i].maker_fee);
+            if (!best_idx.has_value()) {
+                best_idx = i;
+                best_effective = effective;
+                continue;
+            }
+            const bool better = is_buy ? effective < best_effective - kRoutingEps
+                                       : effective > best_effective + kRoutingEps;
+            const bool tie_fresher = std::abs(effective - best_effective) <= kRoutingEps &&
+                                     states[i].snapshot->seq > states[*best_idx].snapshot->seq;
+            if (better || tie_fresher) {
+                best_idx = i;
+                best_effective = effective;
+            }
+        }
+        return best_idx;
+    }
+
+public:
+    static void route_order(
+        RoutingContext& ctx,
+        RoutingBooks books,
+        const std::string& side_lower,
+        double quantity,
+        const std::optional<double>& limit_price,
+        const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
+        const std::unordered_map<std::string, VenueRuntimeInfo>& venue_runtime_info,
+        RoutingDecision& out)
+    {
+        out.reset(quantity);
+
+        if (quantity <= 0.0) {
+            out.message = "invalid quantity";
+            return;
+        }
+
+        const bool is_buy = side_lower == "buy";
+        const bool is_sell = side_lower == "sell";
+        if (!is_buy && !is_sell) {
+            out.message = "invalid side";
+            return;
+        }
+
+        const auto states = collect_venue_states(ctx, books, is_buy, limit_price, venue_static_info, venue_runtime_info);
+        if (states.empty()) {
+            out.message = "no liquidity available";
+            return;
+        }
+
+        std::pmr::vector<double> venue_qty(states.size(), 0.0, ctx.resource());
+        std::pmr::vector<double> venue_notional(states.size(), 0.0, ctx.resource());
+        double routed_qty = route_immediate(ctx, states, is_buy, quantity, venue_qty, venue_notional);
+        double remaining = std::max(0.0, quantity - routed_qty);
+
+        if (limit_price.has_value() && remaining > kRoutingEps) {
+            const auto maker_idx = choose_best_maker_venue(states, is_buy, *limit_price);
+            if (maker_idx.has_value()) {
+                venue_qty[*maker_idx] += remaining;
+                venue_notional[*maker_idx] += remaining * (*limit_price);
+                routed_qty += remaining;
+                remaining = 0.0;
+            }
+        }
+
+        double total_notional = 0.0;
+        for (double n : venue_notional) total_notional += n;
+
+        out.routable_qty = routed_qty;
+        out.fully_routable = remaining <= kRoutingEps;
+        if (out.routable_qty > kRoutingEps) {
+            out.indicative_average_price = total_notional / out.routable_qty;
+        }
+
+        out.slices.reserve(states.size());
+        for (std::size_t i = 0; i < states.size(); ++i) {
+            const double q = venue_qty[i];
+            if (q <= kRoutingEps) continue;
+            out.slices.push_back(
+                RouteSlice{
+                    snapshot_venue_id(*states[i].snapshot),
+                    ExecutionType::LIMIT_ALLOW_TAKER,
+                    q,
+                    venue_notional[i] / q
+                }
+            );
+        }
+
+        set_routing_message(out, limit_price);
+    }
+};
@@ -0,0 +1,202 @@
+#include "server/book_stream.hpp"
+
+#include <boost/asio/bind_executor.hpp>
+#include <boost/asio/post.hpp>
+#include <algorithm>
+#include <tuple>
+
+#include "server/feed_manager.hpp"
+
+namespace {
+
+const std::shared_ptr<const std::string> kHeartbeat = std::make_shared<const std::string>(": ping\n\n");
+
+bool status_changed(const UIConsolidated& a, const UIConsolidated& b)
+{
+    return a.is_cold != b.is_cold || a.is_warming != b.is_warming ||
+           a.is_quiet != b.is_quiet || a.venues != b.venues;
+}
+
+// Levels whose size differs between two ladders, keyed by (venue, px);
+// removed levels are reported with size 0.
+void diff_side(const std::vector<UILadderLevel>& prev, const std::vector<UILadderLevel>& next,
+               std::vector<UILadderLevel>& out)
+{
+    auto key_less = [](const UILadderLevel* a, const UILadderLevel* b) {
+        return std::tie(a->venue, a->px) < std::tie(b->venue, b->px);
+    };
+    std::vector<const UILadderLevel*> a, b;
+    a.reserve(prev.size());
+    b.reserve(next.size());
+    for (const auto& lvl : prev) a.push_back(&lvl);
+    for (const auto& lvl : next) b.push_back(&lvl);
+    std::sort(a.begin(), a.end(), key_less);
+    std::sort(b.begin(), b.end(), key_less);
+
+    std::size_t i = 0, j = 0;
+    while (i < a.size() || j < b.size()) {
+        if (j == b.size() || (i < a.size() && key_less(a[i], b[j]))) {
+            UILadderLevel gone = *a[i++];
+            gone.size = 0;
+            gone.qty = 0;
+            out.push_back(std::move(gone));
+        } else if (i == a.size() || key_less(b[j], a[i])) {
+            out.push_back(*b[j++]);
+        } else {
+            if (a[i]->qty != b[j]->qty) out.push_back(*b[j]);
+            ++i;
+            ++j;
+        }
+    }
+}
+
+} // namespace
+
+BookStreamHub::BookStreamHub(boost::asio::io_context& ioc, FeedManager& feeds, BookStreamOptions opts)
+: feeds_(feeds), opts_(opts), strand_(boost::asio::make_strand(ioc)), timer_(strand_) {}
+
+bool BookStreamHub::subscribe(const std::string& symbol, std::size_t depth,
+                              std::shared_ptr<HttpServer::EventSink> sink)
+{
+    auto ui = feeds_.get_or_subscribe(symbol);
+    if (!ui) return false;
+    depth = std::clamp<std::size_t>(depth, 1, kMaxDepth);
+    boost::asio::post(strand_, [self = shared_from_this(), symbol, depth, ui = std::move(ui),
+                                sink = std::move(sink)]() mutable {
+        self->add(symbol, depth, std::move(ui), std::move(sink));
+    });
+    return true;
+}
+
+void BookStreamHub::add(const std::string& symbol, std::size_t depth, std::shared_ptr<UIMasterFeed> ui, Sink sink)
+{
+    Channel& ch = channels_[symbol + '/' + std::to_string(depth)];
+    if (!ch.ui) {
+        ch.symbol = symbol;
+        ch.depth = depth;
+        ch.ui = std::move(ui);
+        ch.last_touch = Clock::now();
+    }
+    ch.joining.push_back(std::move(sink));
+    if (!ticking_) {
+        ticking_ = true;
+        tick();
+    }
+}
+
+void BookStreamHub::tick()
+{
+    const auto now = Clock::now();
+    for (auto it = channels_.begin(); it != channels_.end();) {
+        Channel& ch = it->second;
+        auto gone = [](const Sink& s) { return s->closed(); };
+        ch.sinks.erase(std::remove_if(ch.sinks.begin(), ch.sinks.end(), gone), ch.sinks.end());
+        ch.joining.erase(std::remove_if(ch.joining.begin(), ch.joining.end(), gone), ch.joining.end());
+        if (ch.sinks.empty() && ch.joining.empty()) {
+            it = channels_.erase(it);
+            continue;
+        }
+        update(ch, now);
+        ++it;
+    }
+    if (channels_.empty()) {
+        ticking_ = false;
+        return;
+    }
+    timer_.expires_after(opts_.frame_interval);
+    timer_.async_wait(boost::asio::bind_executor(strand_, [self = shared_from_this()](const boost::system::error_code& ec) {
+        if (ec) {
+            self->ticking_ = false;
+            return;
+        }
+        self->tick();
+    }));
+}
+
+void BookStreamHub::update(Channel& ch, Clock::time_point now)
+{
+    // Watching a pair counts as using it: keep FeedManager from sweeping it
+    // (and pick up a fresh UIMasterFeed if it was re-created meanwhile).
+    if (now - ch.last_touch >= opts_.heartbeat) {
+        ch.last_touch = now;
+        if (auto ui = feeds_.get_or_subscribe(ch.symbol)) ch.ui = std::move(ui);
+    }
+
+    Frame delta;
+    bool resnapshot = false;
+    UIBookView next = ch.ui->consolidated(ch.depth);
+    if (next.book != ch.last.book) {
+        if (!ch.last.book || status_changed(*ch.last.book, *next.book)) {
+            resnapshot = true;
+        } else {
+            delta = delta_frame(ch, *next.book);
+        }
+        if (resnapshot || delta) ++ch.seq;
+        ch.last = std::move(next);
+        ch.snapshot.reset();
+    }
+
+    bool sent = false;
+    for (const auto& sink : ch.sinks) {
+        // A subscriber whose frames were dropped needs a standalone snapshot.
+        if (resnapshot || sink->take_overflow()) {
+            sink->send(snapshot_frame(ch));
+            sent = true;
+        } else if (delta) {
+            sink->send(delta);
+            sent = true;
+        }
+    }
+    if (!ch.joining.empty()) {
+        for (auto& sink : ch.joining) {
+            sink->send(snapshot_frame(ch));
+            ch.sinks.push_back(std::move(sink));
+        }
+        ch.joining.clear();
+        sent = true;
+    }
+
+    if (sent) {
+        ch.last_frame = now;
+    } else if (now - ch.last_frame >= opts_.heartbeat) {
+        // Keeps proxies from timing the stream out and surfaces dead clients.
+        for (const auto& sink : ch.sinks) sink->send(kHeartbeat);
+        ch.last_frame = now;
+    }
+}
+
+BookStreamHub::Frame BookStreamHub::snapshot_frame(Channel& ch)
+{
+    if (!ch.snapshot) {
+        // Reuses the cached /api/book body: `{"seq":N,` + body without its `{`.
+        const std::string& body = *ch.last.json;
+        std::string frame = "event: snapshot\ndata: {\"seq\":" + std::to_string(ch.seq) + ",";
+        frame.append(body, 1, std::string::npos);
+        frame += "\n\n";
+        ch.snapshot = std::make_shared<const std::string>(std::move(frame));
+    }
+    return ch.snapshot;
+}
+
+// Null when no level changed.
+BookStreamHub::Frame BookStreamHub::delta_frame(const Channel& ch, const UIConsolidated& next)
+{
+    std::vector<UILadderLevel> bids, asks;
+    diff_side(ch.last.book->bids, next.bids, bids);
+    diff_side(ch.last.book->asks, next.asks, asks);
+    if (bids.empty() && asks.empty()) return nullptr;
+
+    std::string frame = "event: delta\ndata: ";
+    JsonWriter w(frame);
+    w.begin_object().field("seq", ch.seq + 1);
+    if (next.last_updated_ms > 0) {
+        w.field("last_updated_ms", next.last_updated_ms);
+    } else {
+        w.field("last_updated_ms", nullptr);
+    }
+    w.key("bids"); write_ladder(w, bids);
+    w.key("asks"); write_ladder(w, asks);
+    w.end_object();
+    frame += "\n\n";
+    return std::make_shared<const std::string>(std::move(frame));
+}
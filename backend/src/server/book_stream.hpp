@@ -0,0 +1,76 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <boost/asio/strand.hpp>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "server/http_server.hpp"
+#include "ui/master_feed.hpp"
+
+class FeedManager;
+
+struct BookStreamOptions {
+    std::chrono::milliseconds frame_interval{100}; // at most one frame per stream per interval
+    std::chrono::seconds heartbeat{10};            // comment frame on quiet streams
+};
+
+// Server-push consolidated books for GET /api/book/stream (text/event-stream).
+// - One channel per (symbol, depth). Every frame_interval it reads the pair's
+//   cached consolidated book (UIMasterFeed::consolidated); only a new build,
+//   i.e. a venue published or changed liveness, produces a frame.
+// - A changed ladder goes out as one `delta` event listing the levels whose
+//   size changed (size 0 = level gone), keyed by (venue, price). Status or
+//   venue-set changes, new subscribers and subscribers that fell behind get a
+//   full `snapshot` event. Every event carries the channel's seq; a delta is
+//   seq + 1 of the frame before it.
+// - Frames are encoded once per channel and the same buffer is handed to every
+//   subscriber, so per-viewer cost is the socket write.
+// Channel state lives on a strand of the server's io_context.
+class BookStreamHub : public std::enable_shared_from_this<BookStreamHub> {
+public:
+    static constexpr std::size_t kMaxDepth = 10;
+
+    BookStreamHub(boost::asio::io_context& ioc, FeedManager& feeds, BookStreamOptions opts = {});
+
+    // Streams `symbol` to `sink`; false if the symbol is not supported.
+    // Thread-safe.
+    bool subscribe(const std::string& symbol, std::size_t depth,
+                   std::shared_ptr<HttpServer::EventSink> sink);
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Sink = std::shared_ptr<HttpServer::EventSink>;
+    using Frame = std::shared_ptr<const std::string>;
+
+    struct Channel {
+        std::string symbol;
+        std::size_t depth{0};
+        std::shared_ptr<UIMasterFeed> ui;
+        std::vector<Sink> sinks;
+        std::vector<Sink> joining;         // waiting for their first snapshot
+        UIBookView last;                   // book the subscribers have
+        std::uint64_t seq{0};              // stream event sequence
+        Frame snapshot;                    // `last` as a snapshot event, built on demand
+        Clock::time_point last_frame{};
+        Clock::time_point last_touch{};
+    };
+
+    void add(const std::string& symbol, std::size_t depth, std::shared_ptr<UIMasterFeed> ui, Sink sink);
+    void tick();
+    void update(Channel& ch, Clock::time_point now);
+    Frame snapshot_frame(Channel& ch);
+    Frame delta_frame(const Channel& ch, const UIConsolidated& next);
+
+    FeedManager& feeds_;
+    BookStreamOptions opts_;
+    boost::asio::strand<boost::asio::io_context::executor_type> strand_;
+    boost::asio::steady_timer timer_;
+    std::unordered_map<std::string, Channel> channels_; // key: symbol + '/' + depth
+    bool ticking_{false};
+};
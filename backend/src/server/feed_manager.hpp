@@ -14,6 +14,8 @@
 #include <utility>
 #include <vector>
 
+#include "md/feed_liveness.hpp"
+#include "md/snapshot_set.hpp"
 #include "ui/master_feed.hpp"
 #include "venues/venue_api.hpp"
 #include "venues/venue_factory.hpp"
@@ -33,6 +35,14 @@ public:
         std::chrono::seconds sweep_interval{std::chrono::seconds(15)};
         std::vector<std::string> hot_pairs;
         bool prewarm_all{false};
+        FeedConfig feed_config; // applied to every VenueFeed this manager creates
+        // Routing skips a venue whose connection has seen no frame (heartbeats
+        // included) for longer than this; zero routes on books of any age. A
+        // quiet book on a live connection stays routable. Defaults to the
+        // transport staleness bound the UI applies (md/feed_liveness.hpp).
+        std::chrono::milliseconds max_book_age{
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::nanoseconds(md::liveness::kTransportStaleNs))};
     };
 
     // RAII guard that keeps a pair from being swept while routing/execution is in-flight.
@@ -79,6 +89,8 @@ public:
 
     struct RoutingInputs {
         std::vector<std::shared_ptr<IVenueFeed>> feeds;
+        std::shared_ptr<const md::SnapshotSetPublisher> books; // all venues' books, one atomic load
+        std::int64_t max_book_age_ns{0};
         PairRoutingGuard guard;
     };
 
@@ -143,6 +155,10 @@ public:
         entry.ui = std::make_shared<UIMasterFeed>(symbol);
         entry.last_access = now;
         entry.pinned = hot_pairs_.count(symbol) > 0;
+        entry.books = std::make_shared<md::SnapshotSetPublisher>();
+
+        FeedConfig feed_config = opts_.feed_config;
+        feed_config.snapshot_set = entry.books;
 
         bool registered = false;
         for (auto idx : sit->second) {
@@ -151,7 +167,7 @@ public:
             if (!venue.factory) continue;
 
             auto feed = venue.factory->make_feed
-                ? venue.factory->make_feed(symbol)
+                ? venue.factory->make_feed(symbol, feed_config)
                 : nullptr;
             if (!feed) {
                 std::cerr << "[setup] Venue '" << venue.name
@@ -210,6 +226,9 @@ public:
 
         RoutingInputs out;
         out.feeds = it->second.feeds;
+        out.books = it->second.books;
+        out.max_book_age_ns =
+            std::chrono::duration_cast<std::chrono::nanoseconds>(opts_.max_book_age).count();
         out.guard = PairRoutingGuard(this, symbol);
         return out;
     }
@@ -260,6 +279,7 @@ private:
         std::string symbol;
         std::shared_ptr<UIMasterFeed> ui;
         std::vector<std::shared_ptr<IVenueFeed>> feeds;
+        std::shared_ptr<md::SnapshotSetPublisher> books; // shared with the feeds, which publish into it
         std::chrono::steady_clock::time_point last_access{};
         bool pinned{false};
         std::size_t inflight_routing{0};
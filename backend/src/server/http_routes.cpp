@@ -1,18 +1,23 @@
 #include "server/http_routes.hpp"
 
 #include <boost/url.hpp>
+#include <boost/asio/thread_pool.hpp>
 #include <boost/beast/http.hpp>
 #include <string_view>
 #include <string>
 #include <optional>
 #include <algorithm>
-#include <sstream>
+#include <iostream>
 #include <memory>
 #include <unordered_map>
+#include <variant>
 #include <vector>
-#include "util/json_encode.hpp"
+#include "util/fork_join.hpp"
+#include "util/json_writer.hpp"
 #include "ui/master_feed.hpp"
+#include "ui/book_wire.hpp"
 #include "server/feed_manager.hpp"
+#include "server/book_stream.hpp"
 #include "router/router_service.hpp"
 #include "execution/market_executor.hpp"
 #include "execution/limit_executor.hpp"
@@ -26,6 +31,188 @@ namespace urls  = boost::urls;
 
 namespace {
 
+// Body: {"error": message}, escaped.
+void set_json_error(http::response<http::string_body>& res, std::string_view message)
+{
+    auto& body = res.body();
+    body.clear();
+    JsonWriter(body).begin_object().field("error", message).end_object();
+}
+
+// NULL columns become JSON null.
+void write_nullable_string(JsonWriter& w, std::string_view key, const pqxx::field& f)
+{
+    if (f.is_null()) w.field(key, nullptr);
+    else             w.field(key, f.view());
+}
+
+void write_nullable_double(JsonWriter& w, std::string_view key, const pqxx::field& f)
+{
+    if (f.is_null()) w.field(key, nullptr);
+    else             w.field(key, f.as<double>());
+}
+
+// Number field that may arrive as a JSON double or integer.
+template <class Value>
+bool get_number(Value&& v, double& out)
+{
+    if (!v.get_double().get(out)) return true;
+    std::int64_t as_int = 0;
+    if (v.get_int64().get(as_int)) return false;
+    out = static_cast<double>(as_int);
+    return true;
+}
+
+// Reads symbol / side / type / quantity_requested / limit_price of one order
+// (an /api/orders body or an /api/orders/batch entry) into `out`, lowercasing
+// side and type. Returns the client-facing error on invalid input.
+template <class Object>
+std::optional<std::string_view> parse_order_fields(Object& obj, RouterOrderRequest& out)
+{
+    std::string_view symbol_sv, side_sv, type_sv;
+    // Check for required string fields
+    if (obj["symbol"].get(symbol_sv) || obj["side"].get(side_sv) || obj["type"].get(type_sv)) {
+        return "missing required fields";
+    }
+
+    auto qty_val = obj["quantity_requested"];
+    if (qty_val.error()) return "missing quantity_requested field";
+    if (!get_number(qty_val, out.quantity_requested)) return "quantity_requested must be a number";
+
+    out.symbol = std::string(symbol_sv);
+    // Lowercase side and type for the database enums
+    out.side_lower = std::string(side_sv);
+    std::transform(out.side_lower.begin(), out.side_lower.end(), out.side_lower.begin(), ::tolower);
+    out.type_lower = std::string(type_sv);
+    std::transform(out.type_lower.begin(), out.type_lower.end(), out.type_lower.begin(), ::tolower);
+
+    if (out.side_lower != "buy" && out.side_lower != "sell") return "side must be 'buy' or 'sell'";
+    if (out.type_lower != "market" && out.type_lower != "limit") return "type must be 'market' or 'limit'";
+    if (out.quantity_requested <= 0) return "quantity_requested must be positive";
+
+    out.limit_price.reset();
+    if (out.type_lower == "limit") {
+        auto price_val = obj["limit_price"];
+        if (price_val.error()) return "limit orders require a limit_price";
+        double price = 0.0;
+        if (!get_number(price_val, price)) return "limit price must be a number";
+        if (price <= 0) return "limit price must be positive";
+        out.limit_price = price;
+    }
+    return std::nullopt;
+}
+
+// Hands a persisted order to its executor: market orders are fill-simulated
+// inline, limit orders rest asynchronously.
+void start_execution(FeedManager& feeds,
+                     const std::string& db_conn_str,
+                     const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
+                     const RouterOrderRequest& req,
+                     const RouterOrderResult& result)
+{
+    if (req.type_lower == "market") {
+        MarketExecutor executor(feeds, db_conn_str, venue_static_info);
+        auto exec_result = executor.execute(
+            result.order_id,
+            req.symbol,
+            req.side_lower,
+            result.routing,
+            result.venue_runtime_info);
+        if (!exec_result.ok) {
+            std::cerr << "[market_executor] fill simulation failed for order "
+                      << result.order_id << ": " << exec_result.error << "\n";
+        }
+    } else if (req.type_lower == "limit" && req.limit_price.has_value()) {
+        LimitExecutor executor(feeds, db_conn_str, venue_static_info);
+        executor.execute_async(
+            result.order_id,
+            req.symbol,
+            req.side_lower,
+            *req.limit_price,
+            result.routing,
+            result.venue_runtime_info);
+    }
+}
+
+// Batch executions block on MarketExecutor's database round-trips, so they
+// get a small pool of their own instead of the CPU-sized routing pool; this
+// also bounds how many executions hold a database connection at once.
+constexpr unsigned kBatchExecutionThreads = 4;
+
+boost::asio::thread_pool& batch_execution_pool()
+{
+    static boost::asio::thread_pool pool(kBatchExecutionThreads);
+    return pool;
+}
+
+// Executes a batch's routed orders, one symbol per batch_execution_pool() task
+// (the request thread takes the last symbol itself), and returns once all have
+// run. A symbol's orders execute in request order.
+void start_batch_execution(FeedManager& feeds,
+                           const std::string& db_conn_str,
+                           const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
+                           const std::vector<RouterOrderRequest>& reqs,
+                           const RouterBatchResult& batch)
+{
+    std::vector<std::vector<std::size_t>> groups;
+    {
+        std::unordered_map<std::string_view, std::size_t> group_of;
+        for (std::size_t i = 0; i < batch.orders.size(); ++i) {
+            if (!std::holds_alternative<RouterOrderResult>(batch.orders[i])) continue;
+            const auto [it, inserted] = group_of.try_emplace(reqs[i].symbol, groups.size());
+            if (inserted) groups.emplace_back();
+            groups[it->second].push_back(i);
+        }
+    }
+
+    util::fork_join(batch_execution_pool(), groups.size(), [&](std::size_t g) {
+        for (std::size_t i : groups[g]) {
+            const auto& result = std::get<RouterOrderResult>(batch.orders[i]);
+            try {
+                start_execution(feeds, db_conn_str, venue_static_info, reqs[i], result);
+            } catch (const std::exception& e) {
+                std::cerr << "[batch] execution failed for order " << result.order_id << ": " << e.what() << "\n";
+            } catch (...) {
+                std::cerr << "[batch] execution failed for order " << result.order_id << "\n";
+            }
+        }
+    });
+}
+
+// "order_id", "status" and the "routing" object of a routed order, into the
+// currently open object.
+void write_order_result(JsonWriter& w, const RouterOrderResult& result)
+{
+    const RoutingDecision& routing = result.routing;
+    const bool has_routable_qty = routing.routable_qty > 0.0;
+    const double remaining_qty =
+        std::max(0.0, routing.requested_qty - routing.routable_qty);
+
+    w.field("order_id", result.order_id)
+        .field("status", result.status)
+        .key("routing").begin_object()
+        .field("message", routing.message)
+        .field("fully_routable", routing.fully_routable)
+        .field("requested_qty", routing.requested_qty)
+        .field("routable_qty", routing.routable_qty)
+        .field("remaining_qty", remaining_qty)
+        .field("stale_venues", routing.stale_venues);
+    if (has_routable_qty) {
+        w.field("indicative_average_price", routing.indicative_average_price);
+    } else {
+        w.field("indicative_average_price", nullptr);
+    }
+    w.key("slices").begin_array();
+    for (const auto& slice : routing.slices) {
+        w.begin_object()
+            .field("venue", slice.venue())
+            .field("quantity", slice.quantity)
+            .field("price", slice.price)
+            .end_object();
+    }
+    w.end_array().end_object();
+}
+
 // Handle /api/auth/signup endpoint
 void handle_signup(const std::string& db_conn_str,
                           const std::string& request_body,
@@ -99,23 +286,20 @@ void handle_signup(const std::string& db_conn_str,
         txn.commit();
 
         auto row = result[0];
-        std::ostringstream os;
-        os << "{"
-           << "\"user_id\":\"" << row[0].as<std::string>() << "\","
-           << "\"email\":\"" << json_escape(row[1].as<std::string>()) << "\","
-           << "\"first_name\":\"" << json_escape(row[2].as<std::string>()) << "\","
-           << "\"last_name\":\"" << json_escape(row[3].as<std::string>()) << "\""
-           << "}";
-
         res.result(http::status::ok);
         res.set(http::field::content_type, "application/json");
-        res.body() = os.str();
+        auto& body = res.body();
+        body.clear();
+        JsonWriter(body).begin_object()
+            .field("user_id", row[0].view())
+            .field("email", row[1].view())
+            .field("first_name", row[2].view())
+            .field("last_name", row[3].view())
+            .end_object();
     } catch (const std::exception& e) {
         res.result(http::status::internal_server_error);
         res.set(http::field::content_type, "application/json");
-        std::ostringstream os;
-        os << "{\"error\":\"" << json_escape(e.what()) << "\"}";
-        res.body() = os.str();
+        set_json_error(res, e.what());
     }
 }
 
@@ -183,23 +367,20 @@ void handle_login(const std::string& db_conn_str,
             return;
         }
 
-        std::ostringstream os;
-        os << "{"
-           << "\"user_id\":\"" << row[0].as<std::string>() << "\","
-           << "\"email\":\"" << json_escape(row[1].as<std::string>()) << "\","
-           << "\"first_name\":\"" << json_escape(row[3].as<std::string>()) << "\","
-           << "\"last_name\":\"" << json_escape(row[4].as<std::string>()) << "\""
-           << "}";
-
         res.result(http::status::ok);
         res.set(http::field::content_type, "application/json");
-        res.body() = os.str();
+        auto& body = res.body();
+        body.clear();
+        JsonWriter(body).begin_object()
+            .field("user_id", row[0].view())
+            .field("email", row[1].view())
+            .field("first_name", row[3].view())
+            .field("last_name", row[4].view())
+            .end_object();
     } catch (const std::exception& e) {
         res.result(http::status::internal_server_error);
         res.set(http::field::content_type, "application/json");
-        std::ostringstream os;
-        os << "{\"error\":\"" << json_escape(e.what()) << "\"}";
-        res.body() = os.str();
+        set_json_error(res, e.what());
     }
 }
 
@@ -230,215 +411,179 @@ void handle_create_order(FeedManager& feeds,
         }
         auto doc = std::move(doc_res.value());
 
-        std::string_view user_id_sv, symbol_sv, side_sv, type_sv;
-        
         /* *************************************************
          * ************** Parse Order Details **************
          *************************************************
         */
-
-        // Check for required string fields
-        if (doc["user_id"].get(user_id_sv) || doc["symbol"].get(symbol_sv) ||
-            doc["side"].get(side_sv) || doc["type"].get(type_sv)) {
+        std::string_view user_id_sv;
+        if (doc["user_id"].get(user_id_sv)) {
             res.result(http::status::bad_request);
             res.set(http::field::content_type, "application/json");
             res.body() = R"({"error":"missing required fields"})";
             return;
         }
-
-        // Get quantity_requested as a number
-        double quantity_requested = 0.0;
-        auto qty_val = doc["quantity_requested"];
-        if (qty_val.error()) {
+        RouterOrderRequest router_req;
+        router_req.user_id = std::string(user_id_sv);
+        if (const auto err = parse_order_fields(doc, router_req)) {
             res.result(http::status::bad_request);
             res.set(http::field::content_type, "application/json");
-            res.body() = R"({"error":"missing quantity_requested field"})";
+            set_json_error(res, *err);
             return;
         }
-        
-        // Try to get as double (handles both int and double)
-        if (qty_val.get_double().get(quantity_requested)) {
-            // If get_double fails, try get_int64
-            std::int64_t qty_int = 0;
-            if (qty_val.get_int64().get(qty_int)) {
-                res.result(http::status::bad_request);
-                res.set(http::field::content_type, "application/json");
-                res.body() = R"({"error":"quantity_requested must be a number"})";
-                return;
-            }
-            quantity_requested = static_cast<double>(qty_int);
-        }
-
-        std::string user_id(user_id_sv);
-        std::string symbol(symbol_sv);
-        std::string side_str(side_sv);
-        std::string type_str(type_sv);
 
-        // Convert side to lowercase for database enum
-        std::string side_lower = side_str;
-        std::transform(side_lower.begin(), side_lower.end(), side_lower.begin(), ::tolower);
+        /* ***********************************
+         * ************** Router **************
+         ***********************************
+        */
+        // TODO: Make router and exchange execution service async.
 
-        // Convert type to lowercase for database enum
-        std::string type_lower = type_str;
-        std::transform(type_lower.begin(), type_lower.end(), type_lower.begin(), ::tolower);
+        // Grab routing inputs (market data feeds) for the symbol, which also ensures the feed is live and subscribed.
+        RouterService router(feeds, db_conn_str, router_version, venue_static_info);
 
-        if (side_lower != "buy" && side_lower != "sell") {
-            res.result(http::status::bad_request);
+        //! CALCULATE ORDER ROUTING PATH HERE
+        auto routed = router.create_order(router_req);
+        // Any error occurs during routing setup (e.g. unsupported symbol / DB issue).
+        if (std::holds_alternative<RouterError>(routed)) {
+            const auto& err = std::get<RouterError>(routed);
+            http::status status = http::status::internal_server_error;
+            if (err.code == RouterErrorCode::SymbolNotSupported) {
+                status = http::status::not_found;
+            } else if (err.code == RouterErrorCode::MarketNoLiquidity) {
+                status = http::status::service_unavailable;
+            }
+            res.result(status);
             res.set(http::field::content_type, "application/json");
-            res.body() = R"({"error":"side must be 'buy' or 'sell'"})";
+            set_json_error(res, err.message);
             return;
         }
 
-        if (type_lower != "market" && type_lower != "limit") {
+        const auto& result = std::get<RouterOrderResult>(routed);
+        start_execution(feeds, db_conn_str, venue_static_info, router_req, result);
+
+        res.result(http::status::ok);
+        res.set(http::field::content_type, "application/json");
+        auto& body = res.body();
+        body.clear();
+        JsonWriter w(body);
+        w.begin_object();
+        write_order_result(w, result);
+        w.end_object();
+    } catch (const std::exception& e) {
+        res.result(http::status::internal_server_error);
+        res.set(http::field::content_type, "application/json");
+        set_json_error(res, e.what());
+    }
+}
+
+// Handle /api/orders/batch POST endpoint
+// Body: {"user_id": ..., "orders": [{symbol, side, type, quantity_requested, limit_price?}, ...]}
+// Response: {"orders": [...]} in request order; each entry is either a routed
+// order (as from /api/orders) or {"error": message} for an order that was not placed.
+void handle_create_orders_batch(FeedManager& feeds,
+                                const std::string& db_conn_str,
+                                router::RouterVersionId router_version,
+                                const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
+                                const std::string& request_body,
+                                http::response<http::string_body>& res)
+{
+    if (db_conn_str.empty()) {
+        res.result(http::status::internal_server_error);
+        res.set(http::field::content_type, "application/json");
+        res.body() = R"({"error":"database not configured"})";
+        return;
+    }
+
+    try {
+        simdjson::padded_string pj(request_body);
+        simdjson::ondemand::parser parser;
+        auto doc_res = parser.iterate(pj);
+        if (doc_res.error()) {
             res.result(http::status::bad_request);
             res.set(http::field::content_type, "application/json");
-            res.body() = R"({"error":"type must be 'market' or 'limit'"})";
+            res.body() = R"({"error":"invalid json"})";
             return;
         }
+        auto doc = std::move(doc_res.value());
 
-        if (quantity_requested <= 0) {
+        std::string_view user_id_sv;
+        simdjson::ondemand::array orders_json;
+        if (doc["user_id"].get(user_id_sv) || doc["orders"].get_array().get(orders_json)) {
             res.result(http::status::bad_request);
             res.set(http::field::content_type, "application/json");
-            res.body() = R"({"error":"quantity_requested must be positive"})";
+            res.body() = R"({"error":"missing required fields"})";
             return;
         }
+        const std::string user_id(user_id_sv);
 
-        std::optional<double> limit_price;
-        if (type_lower == "limit") {
-            auto price_val = doc["limit_price"];
-            if (price_val.error()) {
+        // Validate the whole basket before routing any of it; an oversized
+        // basket is rejected without parsing the rest of it.
+        std::vector<RouterOrderRequest> router_reqs;
+        for (auto entry : orders_json) {
+            if (router_reqs.size() == RouterService::kMaxBatchOrders) {
                 res.result(http::status::bad_request);
                 res.set(http::field::content_type, "application/json");
-                res.body() = R"({"error":"limit orders require a limit_price"})";
+                set_json_error(res, "batch exceeds " + std::to_string(RouterService::kMaxBatchOrders) + " orders");
                 return;
             }
-            
-            double price = 0.0;
-            if (price_val.get_double().get(price)) {
-                // Try as int64 if double fails
-                std::int64_t price_int = 0;
-                if (price_val.get_int64().get(price_int)) {
-                    res.result(http::status::bad_request);
-                    res.set(http::field::content_type, "application/json");
-                    res.body() = R"({"error":"limit price must be a number"})";
-                    return;
-                }
-                price = static_cast<double>(price_int);
+            simdjson::ondemand::object obj;
+            std::optional<std::string_view> err;
+            RouterOrderRequest req;
+            req.user_id = user_id;
+            if (entry.get_object().get(obj)) {
+                err = "order must be an object";
+            } else {
+                err = parse_order_fields(obj, req);
             }
-            
-            if (price <= 0) {
+            if (err) {
                 res.result(http::status::bad_request);
                 res.set(http::field::content_type, "application/json");
-                res.body() = R"({"error":"limit price must be positive"})";
+                set_json_error(res, "orders[" + std::to_string(router_reqs.size()) + "]: " + std::string(*err));
                 return;
             }
-            limit_price = price;
+            router_reqs.push_back(std::move(req));
+        }
+        if (router_reqs.empty()) {
+            res.result(http::status::bad_request);
+            res.set(http::field::content_type, "application/json");
+            res.body() = R"({"error":"orders must not be empty"})";
+            return;
         }
 
-        /* ***********************************
-         * ************** Router **************
-         ***********************************
-        */
-        // TODO: Make router and exchange execution service async.
-
-        // Grab routing inputs (market data feeds) for the symbol, which also ensures the feed is live and subscribed.
         RouterService router(feeds, db_conn_str, router_version, venue_static_info);
-        RouterOrderRequest router_req{
-            user_id,
-            symbol,
-            side_lower,
-            type_lower,
-            quantity_requested,
-            limit_price,
-        };
-        
-        //! CALCULATE ORDER ROUTING PATH HERE
-        auto routed = router.create_order(router_req);
-        // Any error occurs during routing setup (e.g. unsupported symbol / DB issue).
+        auto routed = router.create_orders(router_reqs);
         if (std::holds_alternative<RouterError>(routed)) {
             const auto& err = std::get<RouterError>(routed);
-            http::status status = http::status::internal_server_error;
-            if (err.code == RouterErrorCode::SymbolNotSupported) {
-                status = http::status::not_found;
-            } else if (err.code == RouterErrorCode::MarketNoLiquidity) {
-                status = http::status::service_unavailable;
-            }
-            res.result(status);
+            res.result(err.code == RouterErrorCode::BatchTooLarge
+                ? http::status::bad_request
+                : http::status::internal_server_error);
             res.set(http::field::content_type, "application/json");
-            std::ostringstream os;
-            os << "{\"error\":\"" << json_escape(err.message) << "\"}";
-            res.body() = os.str();
+            set_json_error(res, err.message);
             return;
         }
 
-        const auto& result = std::get<RouterOrderResult>(routed);
-        const RoutingDecision& routing = result.routing;
-
-        if (type_lower == "market") {
-            MarketExecutor executor(feeds, db_conn_str, venue_static_info);
-            auto exec_result = executor.execute(
-                result.order_id,
-                symbol,
-                side_lower,
-                routing,
-                result.venue_runtime_info);
-            if (!exec_result.ok) {
-                std::cerr << "[market_executor] fill simulation failed for order "
-                          << result.order_id << ": " << exec_result.error << "\n";
-            }
-        } else if (type_lower == "limit" && limit_price.has_value()) {
-            LimitExecutor executor(feeds, db_conn_str, venue_static_info);
-            executor.execute_async(
-                result.order_id,
-                symbol,
-                side_lower,
-                *limit_price,
-                routing,
-                result.venue_runtime_info);
-        }
-        const bool has_routable_qty = routing.routable_qty > 0.0;
-        const double remaining_qty =
-            std::max(0.0, routing.requested_qty - routing.routable_qty);
-
-        std::ostringstream os;
-        os << "{"
-           << "\"order_id\":\"" << result.order_id << "\","
-           << "\"status\":\"" << json_escape(result.status) << "\","
-           << "\"routing\":{"
-           << "\"message\":\"" << json_escape(routing.message) << "\","
-           << "\"fully_routable\":" << (routing.fully_routable ? "true" : "false") << ","
-           << "\"requested_qty\":" << routing.requested_qty << ","
-           << "\"routable_qty\":" << routing.routable_qty << ","
-           << "\"remaining_qty\":" << remaining_qty << ",";
-
-        if (has_routable_qty) {
-            os << "\"indicative_average_price\":" << routing.indicative_average_price << ",";
-        } else {
-            os << "\"indicative_average_price\":null,";
-        }
-
-        os << "\"slices\":[";
-        for (std::size_t i = 0; i < routing.slices.size(); ++i) {
-            if (i > 0) os << ",";
-            os << "{"
-               << "\"venue\":\"" << json_escape(routing.slices[i].venue) << "\","
-               << "\"quantity\":" << routing.slices[i].quantity << ","
-               << "\"price\":" << routing.slices[i].price
-               << "}";
-        }
-        os << "]"
-           << "}"
-           << "}";
+        const auto& batch = std::get<RouterBatchResult>(routed);
+        start_batch_execution(feeds, db_conn_str, venue_static_info, router_reqs, batch);
 
         res.result(http::status::ok);
         res.set(http::field::content_type, "application/json");
-        res.body() = os.str();
+        auto& body = res.body();
+        body.clear();
+        JsonWriter w(body);
+        w.begin_object().key("orders").begin_array();
+        for (const auto& order : batch.orders) {
+            w.begin_object();
+            if (const auto* result = std::get_if<RouterOrderResult>(&order)) {
+                write_order_result(w, *result);
+            } else {
+                w.field("error", std::get<RouterError>(order).message);
+            }
+            w.end_object();
+        }
+        w.end_array().end_object();
     } catch (const std::exception& e) {
         res.result(http::status::internal_server_error);
         res.set(http::field::content_type, "application/json");
-        std::ostringstream os;
-        os << "{\"error\":\"" << json_escape(e.what()) << "\"}";
-        res.body() = os.str();
+        set_json_error(res, e.what());
     }
 }
 
@@ -498,23 +643,20 @@ void handle_cancel_order(const std::string& db_conn_str,
         txn.commit();
 
         auto row = result[0];
-        std::ostringstream os;
-        os << "{"
-           << "\"order_id\":\"" << row[0].as<std::string>() << "\","
-           << "\"status\":\"" << json_escape(row[1].as<std::string>()) << "\","
-           << "\"terminal_at\":\"" << json_escape(row[2].as<std::string>()) << "\","
-           << "\"last_updated_at\":\"" << json_escape(row[3].as<std::string>()) << "\""
-           << "}";
-
         res.result(http::status::ok);
         res.set(http::field::content_type, "application/json");
-        res.body() = os.str();
+        auto& body = res.body();
+        body.clear();
+        JsonWriter(body).begin_object()
+            .field("order_id", row[0].view())
+            .field("status", row[1].view())
+            .field("terminal_at", row[2].view())
+            .field("last_updated_at", row[3].view())
+            .end_object();
     } catch (const std::exception& e) {
         res.result(http::status::internal_server_error);
         res.set(http::field::content_type, "application/json");
-        std::ostringstream os;
-        os << "{\"error\":\"" << json_escape(e.what()) << "\"}";
-        res.body() = os.str();
+        set_json_error(res, e.what());
     }
 }
 
@@ -564,77 +706,39 @@ void handle_get_orders(const std::string& db_conn_str,
 
         auto result = txn.exec(query, pqxx::params(user_id));
 
-        std::ostringstream os;
-        os << "{\"orders\":[";
-        bool first = true;
-        for (const auto& row : result) {
-            if (!first) os << ",";
-            first = false;
-
-            os << "{"
-               << "\"id\":\"" << row[0].as<std::string>() << "\","
-               << "\"symbol\":\"" << json_escape(row[1].as<std::string>()) << "\","
-               << "\"side\":\"" << json_escape(row[2].as<std::string>()) << "\","
-               << "\"order_type\":\"" << json_escape(row[3].as<std::string>()) << "\","
-               << "\"quantity_requested\":" << row[4].as<double>() << ",";
-
-            if (!row[5].is_null()) {
-                os << "\"limit_price\":" << row[5].as<double>() << ",";
-            } else {
-                os << "\"limit_price\":null,";
-            }
-
-            os << "\"quantity_planned\":" << row[6].as<double>() << ","
-               << "\"price_planned_avg\":" << row[7].as<double>() << ","
-               << "\"fully_routable\":" << (row[8].as<bool>() ? "true" : "false") << ",";
-
-            if (!row[9].is_null()) {
-                os << "\"routing_message\":\"" << json_escape(row[9].as<std::string>()) << "\",";
-            } else {
-                os << "\"routing_message\":null,";
-            }
-
-            os << "\"quantity_filled\":" << row[10].as<double>() << ",";
-            if (!row[11].is_null()) {
-                os << "\"price_filled_avg\":" << row[11].as<double>() << ",";
-            } else {
-                os << "\"price_filled_avg\":null,";
-            }
-
-            os << "\"status\":\"" << json_escape(row[12].as<std::string>()) << "\","
-               << "\"created_at\":\"" << json_escape(row[13].as<std::string>()) << "\"";
-
-            if (!row[14].is_null()) {
-                os << ",\"execution_started_at\":\"" << json_escape(row[14].as<std::string>()) << "\"";
-            } else {
-                os << ",\"execution_started_at\":null";
-            }
-
-            if (!row[15].is_null()) {
-                os << ",\"terminal_at\":\"" << json_escape(row[15].as<std::string>()) << "\"";
-            } else {
-                os << ",\"terminal_at\":null";
-            }
-
-            if (!row[16].is_null()) {
-                os << ",\"last_updated_at\":\"" << json_escape(row[16].as<std::string>()) << "\"";
-            } else {
-                os << ",\"last_updated_at\":null";
-            }
-
-            os << "}";
-        }
-        os << "]}";
-
         res.result(http::status::ok);
         res.set(http::field::content_type, "application/json");
-        res.body() = os.str();
+        auto& body = res.body();
+        body.clear();
+        body.reserve(256 * result.size() + 16);
+        JsonWriter w(body);
+        w.begin_object().key("orders").begin_array();
+        for (const auto& row : result) {
+            w.begin_object()
+                .field("id", row[0].view())
+                .field("symbol", row[1].view())
+                .field("side", row[2].view())
+                .field("order_type", row[3].view())
+                .field("quantity_requested", row[4].as<double>());
+            write_nullable_double(w, "limit_price", row[5]);
+            w.field("quantity_planned", row[6].as<double>())
+                .field("price_planned_avg", row[7].as<double>())
+                .field("fully_routable", row[8].as<bool>());
+            write_nullable_string(w, "routing_message", row[9]);
+            w.field("quantity_filled", row[10].as<double>());
+            write_nullable_double(w, "price_filled_avg", row[11]);
+            w.field("status", row[12].view())
+                .field("created_at", row[13].view());
+            write_nullable_string(w, "execution_started_at", row[14]);
+            write_nullable_string(w, "terminal_at", row[15]);
+            write_nullable_string(w, "last_updated_at", row[16]);
+            w.end_object();
+        }
+        w.end_array().end_object();
     } catch (const std::exception& e) {
         res.result(http::status::internal_server_error);
         res.set(http::field::content_type, "application/json");
-        std::ostringstream os;
-        os << "{\"error\":\"" << json_escape(e.what()) << "\"}";
-        res.body() = os.str();
+        set_json_error(res, e.what());
     }
 }
 
@@ -707,113 +811,75 @@ void handle_get_order_details(const std::string& db_conn_str,
         auto legs_result = txn.exec(legs_query, pqxx::params(order_id));
 
         const auto row = order_result[0];
-        std::ostringstream os;
-        os << "{";
-        os << "\"order\":{";
-        os << "\"id\":\"" << row[0].as<std::string>() << "\",";
-        os << "\"user_id\":\"" << row[1].as<std::string>() << "\",";
-        os << "\"symbol\":\"" << json_escape(row[2].as<std::string>()) << "\",";
-        os << "\"side\":\"" << json_escape(row[3].as<std::string>()) << "\",";
-        os << "\"order_type\":\"" << json_escape(row[4].as<std::string>()) << "\",";
-        os << "\"quantity_requested\":" << row[5].as<double>() << ",";
-
-        if (!row[6].is_null()) os << "\"limit_price\":" << row[6].as<double>() << ",";
-        else                   os << "\"limit_price\":null,";
-
-        os << "\"quantity_planned\":" << row[7].as<double>() << ",";
-        os << "\"price_planned_avg\":" << row[8].as<double>() << ",";
-        os << "\"fully_routable\":" << (row[9].as<bool>() ? "true" : "false") << ",";
-
-        if (!row[10].is_null()) os << "\"routing_message\":\"" << json_escape(row[10].as<std::string>()) << "\",";
-        else                    os << "\"routing_message\":null,";
-
-        os << "\"quantity_filled\":" << row[11].as<double>() << ",";
-        if (!row[12].is_null()) os << "\"price_filled_avg\":" << row[12].as<double>() << ",";
-        else                    os << "\"price_filled_avg\":null,";
-
-        os << "\"status\":\"" << json_escape(row[13].as<std::string>()) << "\",";
-
-        if (!row[14].is_null()) os << "\"failure_code\":\"" << json_escape(row[14].as<std::string>()) << "\",";
-        else                    os << "\"failure_code\":null,";
-
-        if (!row[15].is_null()) os << "\"failure_message\":\"" << json_escape(row[15].as<std::string>()) << "\",";
-        else                    os << "\"failure_message\":null,";
-
-        os << "\"created_at\":\"" << json_escape(row[16].as<std::string>()) << "\",";
-        if (!row[17].is_null()) os << "\"execution_started_at\":\"" << json_escape(row[17].as<std::string>()) << "\",";
-        else                    os << "\"execution_started_at\":null,";
-
-        if (!row[18].is_null()) os << "\"terminal_at\":\"" << json_escape(row[18].as<std::string>()) << "\",";
-        else                    os << "\"terminal_at\":null,";
-
-        if (!row[19].is_null()) os << "\"last_updated_at\":\"" << json_escape(row[19].as<std::string>()) << "\",";
-        else                    os << "\"last_updated_at\":null,";
-        os << "\"total_commission_usd\":" << row[20].as<double>();
-        os << "},";
-
-        os << "\"legs\":[";
-        bool first_leg = true;
-        for (const auto& leg : legs_result) {
-            if (!first_leg) os << ",";
-            first_leg = false;
-
-            os << "{";
-            os << "\"id\":\"" << leg[0].as<std::string>() << "\",";
-            os << "\"venue\":\"" << json_escape(leg[1].as<std::string>()) << "\",";
-            os << "\"status\":\"" << json_escape(leg[2].as<std::string>()) << "\",";
-            os << "\"quantity_planned\":" << leg[3].as<double>() << ",";
-            if (!leg[4].is_null()) os << "\"limit_price\":" << leg[4].as<double>() << ",";
-            else                   os << "\"limit_price\":null,";
-            os << "\"price_planned\":" << leg[5].as<double>() << ",";
-            if (!leg[6].is_null()) os << "\"quantity_submitted\":" << leg[6].as<double>() << ",";
-            else                   os << "\"quantity_submitted\":null,";
-            if (!leg[7].is_null()) os << "\"price_submitted\":" << leg[7].as<double>() << ",";
-            else                   os << "\"price_submitted\":null,";
-            os << "\"quantity_filled\":" << leg[8].as<double>() << ",";
-            if (!leg[9].is_null()) os << "\"price_filled_avg\":" << leg[9].as<double>() << ",";
-            else                   os << "\"price_filled_avg\":null,";
-            if (!leg[10].is_null()) os << "\"client_order_id\":\"" << json_escape(leg[10].as<std::string>()) << "\",";
-            else                    os << "\"client_order_id\":null,";
-            if (!leg[11].is_null()) os << "\"venue_order_id\":\"" << json_escape(leg[11].as<std::string>()) << "\",";
-            else                    os << "\"venue_order_id\":null,";
-            if (!leg[12].is_null()) os << "\"error_code\":\"" << json_escape(leg[12].as<std::string>()) << "\",";
-            else                    os << "\"error_code\":null,";
-            if (!leg[13].is_null()) os << "\"error_message\":\"" << json_escape(leg[13].as<std::string>()) << "\",";
-            else                    os << "\"error_message\":null,";
-            os << "\"created_at\":\"" << json_escape(leg[14].as<std::string>()) << "\",";
-            if (!leg[15].is_null()) os << "\"submitted_at\":\"" << json_escape(leg[15].as<std::string>()) << "\",";
-            else                    os << "\"submitted_at\":null,";
-            if (!leg[16].is_null()) os << "\"acknowledged_at\":\"" << json_escape(leg[16].as<std::string>()) << "\",";
-            else                    os << "\"acknowledged_at\":null,";
-            if (!leg[17].is_null()) os << "\"first_fill_at\":\"" << json_escape(leg[17].as<std::string>()) << "\",";
-            else                    os << "\"first_fill_at\":null,";
-            if (!leg[18].is_null()) os << "\"last_fill_at\":\"" << json_escape(leg[18].as<std::string>()) << "\",";
-            else                    os << "\"last_fill_at\":null,";
-            if (!leg[19].is_null()) os << "\"terminal_at\":\"" << json_escape(leg[19].as<std::string>()) << "\",";
-            else                    os << "\"terminal_at\":null,";
-            if (!leg[20].is_null()) os << "\"last_updated_at\":\"" << json_escape(leg[20].as<std::string>()) << "\",";
-            else                    os << "\"last_updated_at\":null,";
-            os << "\"commission_usd\":" << leg[21].as<double>();
-            os << "}";
-        }
-        os << "]";
-        os << "}";
-
         res.result(http::status::ok);
         res.set(http::field::content_type, "application/json");
-        res.body() = os.str();
+        auto& body = res.body();
+        body.clear();
+        body.reserve(1024 + 512 * legs_result.size());
+        JsonWriter w(body);
+        w.begin_object().key("order").begin_object()
+            .field("id", row[0].view())
+            .field("user_id", row[1].view())
+            .field("symbol", row[2].view())
+            .field("side", row[3].view())
+            .field("order_type", row[4].view())
+            .field("quantity_requested", row[5].as<double>());
+        write_nullable_double(w, "limit_price", row[6]);
+        w.field("quantity_planned", row[7].as<double>())
+            .field("price_planned_avg", row[8].as<double>())
+            .field("fully_routable", row[9].as<bool>());
+        write_nullable_string(w, "routing_message", row[10]);
+        w.field("quantity_filled", row[11].as<double>());
+        write_nullable_double(w, "price_filled_avg", row[12]);
+        w.field("status", row[13].view());
+        write_nullable_string(w, "failure_code", row[14]);
+        write_nullable_string(w, "failure_message", row[15]);
+        w.field("created_at", row[16].view());
+        write_nullable_string(w, "execution_started_at", row[17]);
+        write_nullable_string(w, "terminal_at", row[18]);
+        write_nullable_string(w, "last_updated_at", row[19]);
+        w.field("total_commission_usd", row[20].as<double>())
+            .end_object();
+
+        w.key("legs").begin_array();
+        for (const auto& leg : legs_result) {
+            w.begin_object()
+                .field("id", leg[0].view())
+                .field("venue", leg[1].view())
+                .field("status", leg[2].view())
+                .field("quantity_planned", leg[3].as<double>());
+            write_nullable_double(w, "limit_price", leg[4]);
+            w.field("price_planned", leg[5].as<double>());
+            write_nullable_double(w, "quantity_submitted", leg[6]);
+            write_nullable_double(w, "price_submitted", leg[7]);
+            w.field("quantity_filled", leg[8].as<double>());
+            write_nullable_double(w, "price_filled_avg", leg[9]);
+            write_nullable_string(w, "client_order_id", leg[10]);
+            write_nullable_string(w, "venue_order_id", leg[11]);
+            write_nullable_string(w, "error_code", leg[12]);
+            write_nullable_string(w, "error_message", leg[13]);
+            w.field("created_at", leg[14].view());
+            write_nullable_string(w, "submitted_at", leg[15]);
+            write_nullable_string(w, "acknowledged_at", leg[16]);
+            write_nullable_string(w, "first_fill_at", leg[17]);
+            write_nullable_string(w, "last_fill_at", leg[18]);
+            write_nullable_string(w, "terminal_at", leg[19]);
+            write_nullable_string(w, "last_updated_at", leg[20]);
+            w.field("commission_usd", leg[21].as<double>())
+                .end_object();
+        }
+        w.end_array().end_object();
     } catch (const std::exception& e) {
         res.result(http::status::internal_server_error);
         res.set(http::field::content_type, "application/json");
-        std::ostringstream os;
-        os << "{\"error\":\"" << json_escape(e.what()) << "\"}";
-        res.body() = os.str();
+        set_json_error(res, e.what());
     }
 }
 
-// Handle /api/book endpoint
+// Handle /api/book endpoint. `wire` selects the binary encoding (ui/book_wire.hpp).
 void handle_book(FeedManager& feeds,
                         const urls::url_view& url,
+                        bool wire,
                         http::response<http::string_body>& res)
 {
     // Maximum UI depth accepted by /api/book.
@@ -838,7 +904,7 @@ void handle_book(FeedManager& feeds,
         if (p.key == "depth") {
             try {
                 std::size_t d = std::stoul(std::string(p.value));
-                std::size_t max_d = debug ? MAX_DEBUG_DEPTH : MAX_TOP_DEPTH;
+                std::size_t max_d = (debug || wire) ? MAX_DEBUG_DEPTH : MAX_TOP_DEPTH;
                 if (d > 0 && d <= max_d) {
                     depth = d;
                 }
@@ -863,70 +929,53 @@ void handle_book(FeedManager& feeds,
         return;
     }
 
-    UIConsolidated snap = ui->snapshot_consolidated(depth);
+    // Shared with every concurrent reader of this depth until a venue republishes.
+    UIBookView view = ui->consolidated(depth);
+    const UIConsolidated& snap = *view.book;
 
-    std::ostringstream os;
     if (snap.is_cold) {
         res.result(http::status::service_unavailable);
     } else {
         res.result(http::status::ok);
     }
+    res.set(http::field::vary, "Accept");
 
-    os << "{";
-    os << "\"status\":{";
-    os << "\"code\":" << (snap.is_cold ? 503 : 200) << ",";
-    os << "\"message\":\""
-       << (snap.is_cold
-               ? "Market data transport stale: all venues cold"
-               : (snap.is_warming
-                      ? "Market data warming up: connecting to venues"
-                      : (snap.is_quiet
-                      ? "Market data quiet: transport alive, no recent book updates"
-                      : "OK")))
-       << "\"";
-    os << "},";
-    if (snap.last_updated_ms > 0) {
-        os << "\"last_updated_ms\":" << snap.last_updated_ms << ",";
-    } else {
-        os << "\"last_updated_ms\":null,";
+    if (wire) {
+        res.set(http::field::content_type, kBookWireContentType);
+        res.body().clear();
+        write_book_wire(res.body(), snap);
+        return;
     }
-    os << "\"symbol\":\"" << json_escape(snap.symbol) << "\",";
-    os << "\"venues\":[";
-    for (std::size_t i = 0; i < snap.venues.size(); ++i) {
-        if (i > 0) os << ",";
-        os << "\"" << json_escape(snap.venues[i]) << "\"";
+    res.set(http::field::content_type, "application/json");
+
+    if (!debug) {
+        res.body() = *view.json;
+        return;
     }
-    os << "],";
 
-    // Consolidated ladders with venue information for UI
-    os << "\"bids\":"; json_ladder_array(os, snap.bids); os << ",";
-    os << "\"asks\":"; json_ladder_array(os, snap.asks);
+    auto& body = res.body();
+    body.clear();
+    JsonWriter w(body);
+    w.begin_object();
+    write_book_fields(w, snap);
 
     // Optional debug: per-venue level counts in the final output
-    if (debug) {
-        std::unordered_map<std::string, std::pair<std::size_t, std::size_t>> by_venue;
-        for (const auto& lvl : snap.bids) {
-            by_venue[lvl.venue].first++;
-        }
-        for (const auto& lvl : snap.asks) {
-            by_venue[lvl.venue].second++;
-        }
-        os << ",\"debug\":{\"by_venue\":{";
-        bool first = true;
-        for (const auto& v : snap.venues) {
-            auto it = by_venue.find(v);
-            std::size_t bc = (it != by_venue.end()) ? it->second.first : 0;
-            std::size_t ac = (it != by_venue.end()) ? it->second.second : 0;
-            if (!first) os << ",";
-            first = false;
-            os << "\"" << json_escape(v) << "\":{\"bids\":" << bc << ",\"asks\":" << ac << "}";
-        }
-        os << "},\"depth\":" << depth << "}";
+    std::unordered_map<std::string, std::pair<std::size_t, std::size_t>> by_venue;
+    for (const auto& lvl : snap.bids) {
+        by_venue[lvl.venue].first++;
     }
-    os << "}"; // root object
-
-    res.set(http::field::content_type, "application/json");
-    res.body() = os.str();
+    for (const auto& lvl : snap.asks) {
+        by_venue[lvl.venue].second++;
+    }
+    w.key("debug").begin_object().key("by_venue").begin_object();
+    for (const auto& v : snap.venues) {
+        auto it = by_venue.find(v);
+        std::size_t bc = (it != by_venue.end()) ? it->second.first : 0;
+        std::size_t ac = (it != by_venue.end()) ? it->second.second : 0;
+        w.key(v).begin_object().field("bids", bc).field("asks", ac).end_object();
+    }
+    w.end_object().field("depth", depth).end_object();
+    w.end_object(); // root object
 }
 
 // Handle /api/pairs endpoint
@@ -936,21 +985,31 @@ void handle_pairs(const FeedManager& feeds,
     std::vector<std::string> pairs = feeds.list_supported_pairs();
     std::sort(pairs.begin(), pairs.end());
 
-    std::ostringstream os;
-    os << "{\"pairs\":[";
-    for (std::size_t i = 0; i < pairs.size(); ++i) {
-        if (i > 0) os << ",";
-        os << "\"" << json_escape(pairs[i]) << "\"";
-    }
-    os << "]}";
-
     res.result(http::status::ok);
     res.set(http::field::content_type, "application/json");
-    res.body() = os.str();
+    auto& body = res.body();
+    body.clear();
+    JsonWriter w(body);
+    w.begin_object().key("pairs").begin_array();
+    for (const auto& pair : pairs) w.value(pair);
+    w.end_array().end_object();
 }
 
 } // namespace
 
+bool is_blocking_request(const http::request<http::string_body>& req)
+{
+    if (req.method() == http::verb::options) return false;
+    std::string_view target{req.target().data(), req.target().size()};
+    const std::string_view path = target.substr(0, target.find('?'));
+    // In-memory market data; everything else touches the DB or routes an order.
+    if (req.method() == http::verb::get &&
+        (path == "/api/health" || path == "/api/pairs" || path == "/api/book" || path == "/api/book/stream")) {
+        return false;
+    }
+    return true;
+}
+
 void handle_request(FeedManager& feeds,
                     const std::string& db_conn_str,
                     router::RouterVersionId router_version,
@@ -988,7 +1047,19 @@ void handle_request(FeedManager& feeds,
 
     // /api/book?symbol=BTC-USD&depth=10
     if (req.method() == http::verb::get && url.path() == "/api/book") {
-        handle_book(feeds, url, res);
+        const std::string_view accept{req[http::field::accept].data(), req[http::field::accept].size()};
+        handle_book(feeds, url, accept.find(kBookWireContentType) != std::string_view::npos, res);
+        return;
+    }
+
+    // /api/book/stream?symbol=BTC-USD&depth=10 (served by open_book_stream;
+    // reaching here means the symbol was missing or unsupported)
+    if (req.method() == http::verb::get && url.path() == "/api/book/stream") {
+        const bool has_symbol = url.params().contains("symbol");
+        res.result(has_symbol ? http::status::not_found : http::status::bad_request);
+        res.set(http::field::content_type, "application/json");
+        res.body() = has_symbol ? R"({"error":"symbol not supported"})"
+                                : R"({"error":"symbol parameter required"})";
         return;
     }
 
@@ -1010,6 +1081,12 @@ void handle_request(FeedManager& feeds,
         return;
     }
 
+    // /api/orders/batch
+    if (req.method() == http::verb::post && url.path() == "/api/orders/batch") {
+        handle_create_orders_batch(feeds, db_conn_str, router_version, venue_static_info, req.body(), res);
+        return;
+    }
+
     // /api/orders?user_id=...
     if (req.method() == http::verb::get && url.path() == "/api/orders") {
         handle_get_orders(db_conn_str, url, res);
@@ -1046,3 +1123,30 @@ void handle_request(FeedManager& feeds,
     res.set(http::field::content_type, "application/json");
     res.body() = R"({"error":"not found"})";
 }
+
+bool open_book_stream(BookStreamHub& hub,
+                      const http::request<http::string_body>& req,
+                      const std::shared_ptr<HttpServer::EventSink>& sink)
+{
+    if (req.method() != http::verb::get) return false;
+    std::string_view target{req.target().data(), req.target().size()};
+    auto parsed_result = urls::parse_origin_form(target);
+    if (!parsed_result || parsed_result->path() != "/api/book/stream") return false;
+
+    std::string symbol;
+    std::size_t depth = BookStreamHub::kMaxDepth;
+    for (auto const& p : parsed_result->params()) {
+        if (p.key == "symbol") {
+            symbol = std::string(p.value);
+        } else if (p.key == "depth") {
+            try {
+                std::size_t d = std::stoul(std::string(p.value));
+                if (d > 0 && d <= BookStreamHub::kMaxDepth) depth = d;
+            } catch (...) {
+                // ignore invalid input
+            }
+        }
+    }
+    if (symbol.empty()) return false;
+    return hub.subscribe(symbol, depth, sink);
+}
@@ -2,12 +2,15 @@
 
 #include <boost/beast/http.hpp>
 #include <cstdint>
+#include <memory>
 #include <string>
 #include <unordered_map>
 
+#include "server/http_server.hpp"
 #include "venues/venue_api.hpp"
 
 class FeedManager;
+class BookStreamHub;
 namespace router { enum class RouterVersionId : std::uint8_t; }
 
 void handle_request(
@@ -17,3 +20,14 @@ void handle_request(
     const std::unordered_map<std::string, VenueStaticInfo>& venue_static_info,
     const boost::beast::http::request<boost::beast::http::string_body>& req,
     boost::beast::http::response<boost::beast::http::string_body>& res);
+
+// True for requests whose handler blocks on the database or order routing;
+// HttpServer runs those on its worker pool so market-data reads stay fast.
+bool is_blocking_request(const boost::beast::http::request<boost::beast::http::string_body>& req);
+
+// HttpServer StreamFn for GET /api/book/stream?symbol=...&depth=...: subscribes
+// `sink` to the hub. Returns false (leaving the request to handle_request)
+// for other targets and for missing or unsupported symbols.
+bool open_book_stream(BookStreamHub& hub,
+                      const boost::beast::http::request<boost::beast::http::string_body>& req,
+                      const std::shared_ptr<HttpServer::EventSink>& sink);
@@ -6,8 +6,19 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <boost/asio/ssl.hpp>
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
 #include <boost/asio/strand.hpp>
+#include <boost/asio/thread_pool.hpp>
+#include <boost/asio/write.hpp>
+#include <openssl/ssl.h>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <exception>
 #include <memory>
+#include <optional>
 #include <string>
 #include <functional>
 
@@ -15,12 +26,66 @@ namespace http = boost::beast::http;
 using tcp = boost::asio::ip::tcp;
 namespace ssl = boost::asio::ssl;
 
+// HTTPS/1.1 server.
+// - Every connection runs on its own strand, so the io_context may be run by
+//   any number of threads.
+// - Connections stay open between requests (keep-alive) until the client asks
+//   to close or stays idle for Options::idle_timeout. Requests are read ahead
+//   while earlier ones are handled (pipelining, up to Options::max_pipelined)
+//   and answered in arrival order.
+// - Requests the BlockingFn flags (DB, routing) run on a fixed worker pool so
+//   they never hold an I/O thread; cheap ones are answered on the I/O thread.
+//   When Options::max_pending_blocking of them are queued or running, further
+//   ones get 503 right away.
+// - A StreamFn (set_stream_handler) may take a request as a server-push
+//   stream: the connection answers with text/event-stream headers and then
+//   carries whatever frames are sent to its EventSink, until the client goes
+//   away.
 class HttpServer {
 public:
-    using HandlerFn = std::function<void(const http::request<http::string_body>&, http::response<http::string_body>&)>;
+    using Request = http::request<http::string_body>;
+    using Response = http::response<http::string_body>;
+    using HandlerFn = std::function<void(const Request&, Response&)>;
+    using BlockingFn = std::function<bool(const Request&)>;
+
+    struct Options {
+        std::size_t workers{0};                   // blocking-handler threads; 0 = run every handler inline
+        std::size_t max_pending_blocking{256};    // queued + running blocking requests before 503
+        std::size_t max_pipelined{16};            // requests in flight per connection
+        std::chrono::seconds idle_timeout{30};    // handshake / keep-alive idle limit
+        std::size_t body_limit{1024 * 1024};      // request body bytes
+        std::size_t max_queued_events{64};        // per stream before a slow client's frames are dropped
+    };
+
+    // Push side of a streaming connection. send() may be called from any
+    // thread; frames are shared, so one encode can serve every subscriber.
+    class EventSink {
+    public:
+        virtual ~EventSink() = default;
+        // Queue one complete event-stream frame; false once the client is gone.
+        virtual bool send(std::shared_ptr<const std::string> frame) = 0;
+        // True (once) after the client fell behind and its queued frames were
+        // dropped: the next frame should stand on its own (a full snapshot).
+        virtual bool take_overflow() noexcept = 0;
+        virtual bool closed() const noexcept = 0;
+    };
+    // True if it took the request as a stream (keeping the sink for as long as
+    // it publishes); false hands the request to the HandlerFn.
+    using StreamFn = std::function<bool(const Request&, const std::shared_ptr<EventSink>&)>;
 
     HttpServer(boost::asio::io_context& ioc, ssl::context& ssl_ctx, tcp::endpoint ep, HandlerFn handler)
-    : ioc_(ioc), ssl_ctx_(ssl_ctx), acceptor_(ioc), handler_(std::move(handler)) {
+    : HttpServer(ioc, ssl_ctx, ep, std::move(handler), Options{}, nullptr) {}
+
+    HttpServer(boost::asio::io_context& ioc, ssl::context& ssl_ctx, tcp::endpoint ep, HandlerFn handler,
+               Options opts, BlockingFn is_blocking)
+    : ioc_(ioc), ssl_ctx_(ssl_ctx), acceptor_(ioc), shared_(std::make_shared<Shared>()) {
+        shared_->handler = std::move(handler);
+        shared_->is_blocking = std::move(is_blocking);
+        shared_->opts = opts;
+        if (opts.workers > 0 && shared_->is_blocking) {
+            shared_->pool = std::make_unique<boost::asio::thread_pool>(opts.workers);
+        }
+
         boost::beast::error_code ec;
         acceptor_.open(ep.protocol(), ec);
         if (ec) throw std::runtime_error("open: " + ec.message());
@@ -32,51 +97,257 @@ public:
         if (ec) throw std::runtime_error("listen: " + ec.message());
     }
 
+    ~HttpServer() {
+        if (shared_->pool) shared_->pool->join();
+    }
+
+    // Call before run().
+    void set_stream_handler(StreamFn fn) { shared_->stream = std::move(fn); }
+
     void run() { do_accept(); }
 
+    // Lets returning clients resume a TLS session (server-side session cache
+    // for session IDs, stateless tickets for TLS 1.3) instead of paying for a
+    // full handshake on every new connection.
+    static void enable_session_resumption(ssl::context& ctx, long cache_size = 20'000,
+                                          std::chrono::seconds lifetime = std::chrono::hours(2)) {
+        SSL_CTX* native = ctx.native_handle();
+        static constexpr unsigned char kSessionIdContext[] = "md-router";
+        SSL_CTX_set_session_id_context(native, kSessionIdContext, sizeof(kSessionIdContext) - 1);
+        SSL_CTX_set_session_cache_mode(native, SSL_SESS_CACHE_SERVER);
+        SSL_CTX_sess_set_cache_size(native, cache_size);
+        SSL_CTX_set_timeout(native, static_cast<long>(lifetime.count()));
+        SSL_CTX_clear_options(native, SSL_OP_NO_TICKET);
+    }
+
 private:
+    struct Shared {
+        HandlerFn handler;
+        BlockingFn is_blocking;
+        StreamFn stream;
+        Options opts;
+        std::unique_ptr<boost::asio::thread_pool> pool; // null: handlers run inline
+        std::atomic<std::size_t> pending_blocking{0};
+    };
+
+    // Runs the route handler and applies the headers every response carries.
+    static std::shared_ptr<Response> build_response(const Shared& shared, const Request& req) {
+        auto res = std::make_shared<Response>();
+        res->version(req.version());
+        try {
+            shared.handler(req, *res);
+        } catch (const std::exception&) {
+            *res = Response{};
+            res->version(req.version());
+            res->result(http::status::internal_server_error);
+            res->set(http::field::content_type, "application/json");
+            res->body() = R"({"error":"internal error"})";
+        }
+        // CORS
+        res->set(http::field::access_control_allow_origin, "*");
+        res->set(http::field::access_control_allow_headers, "*");
+        res->set(http::field::access_control_allow_methods, "GET, POST, PATCH, OPTIONS");
+        if (req.method() == http::verb::options) {
+            res->result(http::status::ok);
+            res->set(http::field::content_type, "text/plain");
+            res->body() = "";
+        }
+        res->keep_alive(req.keep_alive());
+        res->prepare_payload();
+        return res;
+    }
+
+    static std::shared_ptr<Response> busy_response(const Request& req) {
+        auto res = std::make_shared<Response>(http::status::service_unavailable, req.version());
+        res->set(http::field::content_type, "application/json");
+        res->set(http::field::retry_after, "1");
+        res->set(http::field::access_control_allow_origin, "*");
+        res->body() = R"({"error":"server busy"})";
+        res->keep_alive(req.keep_alive());
+        res->prepare_payload();
+        return res;
+    }
+
+    static std::shared_ptr<Response> stream_response(const Request& req) {
+        auto res = std::make_shared<Response>(http::status::ok, req.version());
+        res->set(http::field::content_type, "text/event-stream");
+        res->set(http::field::cache_control, "no-cache");
+        res->set("X-Accel-Buffering", "no");
+        res->set(http::field::access_control_allow_origin, "*");
+        res->keep_alive(true); // no Content-Length: the body runs until close
+        return res;
+    }
+
     struct Session : public std::enable_shared_from_this<Session> {
+        // One pipelined request; res stays null until its handler finishes.
+        struct Pending {
+            std::shared_ptr<Response> res;
+            bool stream{false}; // res is the header of a server-push stream
+        };
+
         boost::beast::ssl_stream<tcp::socket> stream_;
         boost::beast::flat_buffer buffer_;
-        HttpServer::HandlerFn handler_;
-        Session(tcp::socket s, ssl::context& ssl_ctx, HandlerFn h)
-            : stream_(std::move(s), ssl_ctx), handler_(std::move(h)) {}
-        void run() { do_handshake(); }
+        std::shared_ptr<Shared> shared_;
+        boost::asio::steady_timer idle_timer_;
+        std::optional<http::request_parser<http::string_body>> parser_;
+        std::deque<std::shared_ptr<Pending>> pending_; // arrival order
+        bool reading_{false};
+        bool writing_{false};
+        bool read_done_{false}; // client closed, asked to close, or errored
+        bool closed_{false};
+        bool streaming_{false}; // stream header sent; events_ go out as they come
+        std::deque<std::shared_ptr<const std::string>> events_;
+        std::atomic<bool> stream_closed_{false};   // read by EventSink::send on any thread
+        std::atomic<bool> stream_overflow_{false};
+
+        Session(tcp::socket s, ssl::context& ssl_ctx, std::shared_ptr<Shared> shared)
+            : stream_(std::move(s), ssl_ctx), shared_(std::move(shared)), idle_timer_(stream_.get_executor()) {}
+
+        void run() {
+            // Accepted onto a strand; start there.
+            boost::asio::dispatch(stream_.get_executor(), [self = shared_from_this()] { self->do_handshake(); });
+        }
+
         void do_handshake() {
+            arm_idle_timer();
             auto self = shared_from_this();
             stream_.async_handshake(ssl::stream_base::server,
                 [self](boost::beast::error_code ec) {
-                    if (ec) return;
+                    if (ec) return self->abort();
                     self->do_read();
                 });
         }
+
+        // Idle = nothing in flight but the read of the next request.
+        void arm_idle_timer() {
+            idle_timer_.expires_after(shared_->opts.idle_timeout);
+            idle_timer_.async_wait([self = shared_from_this()](boost::beast::error_code ec) {
+                if (ec || self->closed_ || self->streaming_) return;
+                if (self->pending_.empty() && !self->writing_) self->abort();
+            });
+        }
+
         void do_read() {
+            if (read_done_ || reading_ || closed_ || pending_.size() >= shared_->opts.max_pipelined) return;
+            parser_.emplace();
+            parser_->body_limit(shared_->opts.body_limit);
+            reading_ = true;
             auto self = shared_from_this();
-            auto req = std::make_shared<http::request<http::string_body>>();
-            http::async_read(stream_, buffer_, *req,
-                [self, req](boost::beast::error_code ec, std::size_t){
-                    if (ec == http::error::end_of_stream) return self->do_close();
-                    if (ec) return;
-                    auto res = std::make_shared<http::response<http::string_body>>();
-                    res->version(req->version());
-                    res->keep_alive(false);
-                    self->handler_(*req, *res);
-                    // CORS
-                    res->set(http::field::access_control_allow_origin, "*");
-                    res->set(http::field::access_control_allow_headers, "*");
-                    res->set(http::field::access_control_allow_methods, "GET, POST, PATCH, OPTIONS");
-                    if (req->method() == http::verb::options) {
-                        res->result(http::status::ok);
-                        res->set(http::field::content_type, "text/plain");
-                        res->body() = "";
+            http::async_read(stream_, buffer_, *parser_,
+                [self](boost::beast::error_code ec, std::size_t) { self->on_read(ec); });
+        }
+
+        void on_read(boost::beast::error_code ec) {
+            reading_ = false;
+            if (ec) {
+                read_done_ = true;
+                if (ec != http::error::end_of_stream) return abort();
+                return finish_if_drained();
+            }
+
+            auto req = std::make_shared<Request>(parser_->release());
+            auto slot = std::make_shared<Pending>();
+            pending_.push_back(slot);
+            if (!req->keep_alive()) read_done_ = true;
+            handle(std::move(req), std::move(slot));
+            do_read(); // pipelining: read the next request while this one runs
+        }
+
+        void handle(std::shared_ptr<Request> req, std::shared_ptr<Pending> slot) {
+            Shared& shared = *shared_;
+            if (shared.stream) {
+                auto sink = std::make_shared<StreamSink>(shared_from_this());
+                if (shared.stream(*req, sink)) {
+                    // The connection now belongs to the stream: no more requests.
+                    read_done_ = true;
+                    slot->stream = true;
+                    slot->res = stream_response(*req);
+                    return do_write();
+                }
+            }
+            if (!shared.pool || !shared.is_blocking(*req)) {
+                slot->res = build_response(shared, *req);
+                return do_write();
+            }
+            if (shared.pending_blocking.fetch_add(1, std::memory_order_relaxed) >= shared.opts.max_pending_blocking) {
+                shared.pending_blocking.fetch_sub(1, std::memory_order_relaxed);
+                slot->res = busy_response(*req);
+                return do_write();
+            }
+            boost::asio::post(*shared.pool, [self = shared_from_this(), req = std::move(req), slot = std::move(slot)] {
+                auto res = build_response(*self->shared_, *req);
+                self->shared_->pending_blocking.fetch_sub(1, std::memory_order_relaxed);
+                boost::asio::post(self->stream_.get_executor(), [self, slot, res = std::move(res)] {
+                    slot->res = res;
+                    self->do_write();
+                });
+            });
+        }
+
+        // Writes the oldest response once it is ready (responses keep request order).
+        void do_write() {
+            if (writing_ || closed_) return;
+            if (pending_.empty() || !pending_.front()->res) return finish_if_drained();
+            writing_ = true;
+            auto res = pending_.front()->res;
+            const bool stream = pending_.front()->stream;
+            auto self = shared_from_this();
+            http::async_write(stream_, *res,
+                [self, res, stream](boost::beast::error_code ec, std::size_t) {
+                    self->writing_ = false;
+                    if (ec) return self->abort();
+                    self->pending_.pop_front();
+                    if (stream) {
+                        self->streaming_ = true;
+                        return self->write_events();
+                    }
+                    if (!res->keep_alive()) {
+                        self->read_done_ = true;
+                        self->pending_.clear();
+                        return self->do_close();
                     }
-                    http::async_write(self->stream_, *res,
-                        [self, res](boost::beast::error_code, std::size_t){
-                            self->do_close();
-                        });
+                    if (self->pending_.empty()) self->arm_idle_timer();
+                    self->do_write();
+                    self->do_read(); // resumes if the pipeline limit had paused reading
                 });
         }
+
+        // Strand side of EventSink::send.
+        void push_event(std::shared_ptr<const std::string> frame) {
+            if (closed_) return;
+            if (events_.size() >= shared_->opts.max_queued_events) {
+                // Too slow for the stream: drop what has not started going out.
+                events_.erase(events_.begin() + (streaming_ && writing_ ? 1 : 0), events_.end());
+                stream_overflow_.store(true, std::memory_order_release);
+            }
+            events_.push_back(std::move(frame));
+            write_events();
+        }
+
+        void write_events() {
+            if (!streaming_ || writing_ || closed_ || events_.empty()) return;
+            writing_ = true;
+            auto frame = events_.front();
+            auto self = shared_from_this();
+            boost::asio::async_write(stream_, boost::asio::buffer(*frame),
+                [self, frame](boost::beast::error_code ec, std::size_t) {
+                    self->writing_ = false;
+                    if (ec) return self->abort();
+                    self->events_.pop_front();
+                    self->write_events();
+                });
+        }
+
+        void finish_if_drained() {
+            if (read_done_ && !reading_ && !writing_ && pending_.empty()) do_close();
+        }
+
         void do_close() {
+            if (closed_) return;
+            closed_ = true;
+            stream_closed_.store(true, std::memory_order_release);
+            events_.clear();
+            idle_timer_.cancel();
             auto self = shared_from_this();
             stream_.async_shutdown([self](boost::beast::error_code ec) {
                 if (ec == boost::asio::error::eof ||
@@ -87,13 +358,45 @@ private:
                 self->stream_.next_layer().shutdown(tcp::socket::shutdown_send, ignored);
             });
         }
+
+        // Error or idle timeout: drop the connection without a TLS goodbye.
+        void abort() {
+            if (closed_) return;
+            closed_ = true;
+            stream_closed_.store(true, std::memory_order_release);
+            events_.clear();
+            idle_timer_.cancel();
+            boost::beast::error_code ignored;
+            stream_.next_layer().close(ignored);
+        }
+    };
+
+    // Holds its session open for as long as the subscriber keeps the sink.
+    struct StreamSink : EventSink {
+        std::shared_ptr<Session> session;
+
+        explicit StreamSink(std::shared_ptr<Session> s) : session(std::move(s)) {}
+
+        bool send(std::shared_ptr<const std::string> frame) override {
+            if (closed()) return false;
+            boost::asio::post(session->stream_.get_executor(), [s = session, frame = std::move(frame)]() mutable {
+                s->push_event(std::move(frame));
+            });
+            return true;
+        }
+        bool take_overflow() noexcept override {
+            return session->stream_overflow_.exchange(false, std::memory_order_acq_rel);
+        }
+        bool closed() const noexcept override {
+            return session->stream_closed_.load(std::memory_order_acquire);
+        }
     };
 
     void do_accept() {
         acceptor_.async_accept(
             boost::asio::make_strand(ioc_),
             [this](boost::beast::error_code ec, tcp::socket s){
-                if (!ec) std::make_shared<Session>(std::move(s), ssl_ctx_, handler_)->run();
+                if (!ec) std::make_shared<Session>(std::move(s), ssl_ctx_, shared_)->run();
                 do_accept();
             });
     }
@@ -101,5 +404,5 @@ private:
     boost::asio::io_context& ioc_;
     ssl::context& ssl_ctx_;
     tcp::acceptor acceptor_;
-    HandlerFn handler_;
+    std::shared_ptr<Shared> shared_;
 };
@@ -15,11 +15,14 @@
 #include <string_view>
 
 #include "server/feed_manager.hpp"
+#include "md/feed_runtime.hpp"
+#include "md/capture_log.hpp"
 #include "venues/venue_registry.hpp"
 #include "venues/venue_api.hpp"
 #include "server/venues_config.hpp"
 #include "server/http_server.hpp"
 #include "server/http_routes.hpp"
+#include "server/book_stream.hpp"
 #include "router/router_framework.hpp"
 #include "supabase/storage_supabase.hpp"
 
@@ -147,6 +150,23 @@ std::string parse_env_string(const char* name, const std::string& fallback = {})
     return std::string(raw);
 }
 
+// FEED_WAIT_STRATEGY: busy_spin | spin_park | blocking (default spin_park).
+WaitPolicy parse_wait_policy_env() {
+    WaitPolicy policy;
+    const std::string raw = parse_env_string("FEED_WAIT_STRATEGY");
+    if (raw == "busy_spin") {
+        policy.strategy = WaitStrategy::BusySpin;
+    } else if (raw == "blocking") {
+        policy.strategy = WaitStrategy::Blocking;
+    } else if (!raw.empty() && raw != "spin_park") {
+        std::cerr << "[feed] Unknown FEED_WAIT_STRATEGY='" << raw
+                  << "', using spin_park." << std::endl;
+    }
+    policy.spin_iterations = static_cast<std::uint32_t>(
+        parse_env_int("FEED_WAIT_SPINS", static_cast<int>(policy.spin_iterations)));
+    return policy;
+}
+
 [[noreturn]] void fail_tls_configuration(const std::string& msg) {
     throw std::runtime_error(
         "TLS configuration error: " + msg +
@@ -216,6 +236,50 @@ int main() {
     feed_opts.idle_timeout = std::chrono::seconds(parse_env_int("FEED_IDLE_SECONDS", 180));
     feed_opts.sweep_interval = std::chrono::seconds(parse_env_int("FEED_SWEEP_SECONDS", 15));
     feed_opts.prewarm_all = parse_env_bool("FEED_PREWARM_ALL", false);
+    feed_opts.feed_config.wait = parse_wait_policy_env();
+    // FEED_VERIFY_CHECKSUMS=0 skips Kraken/OKX book checksum verification.
+    feed_opts.feed_config.verify_checksums = parse_env_bool("FEED_VERIFY_CHECKSUMS", true);
+    // FEED_COALESCE_US: how long a backlogged consumer gathers queued frames into
+    // one book apply (0 = apply every frame on its own).
+    feed_opts.feed_config.coalesce_budget_ns = 1000LL * parse_env_int(
+        "FEED_COALESCE_US", static_cast<int>(feed_opts.feed_config.coalesce_budget_ns / 1000));
+    // ROUTER_MAX_BOOK_AGE_MS: routing leaves out venues whose connection has
+    // seen no frame for longer than this (0 = no bound).
+    feed_opts.max_book_age = std::chrono::milliseconds(parse_env_int(
+        "ROUTER_MAX_BOOK_AGE_MS", static_cast<int>(feed_opts.max_book_age.count())));
+    // FEED_CAPTURE_PATH=<file> appends every received WS frame to a binary
+    // capture log for offline replay (test/test_replay.cpp).
+    const std::string capture_path = parse_env_string("FEED_CAPTURE_PATH");
+    if (!capture_path.empty()) {
+        try {
+            feed_opts.feed_config.capture = std::make_shared<md::CaptureWriter>(capture_path);
+            std::cout << "[feed] Capturing frames to " << capture_path << std::endl;
+        } catch (const std::exception& e) {
+            std::cerr << "[feed] " << e.what() << "; capture disabled" << std::endl;
+        }
+    }
+
+    // FEED_RUNTIME_IO_THREADS / FEED_RUNTIME_WORKERS > 0 switch every feed onto a
+    // shared, fixed-size thread pool instead of two threads per feed.
+    // FEED_WS_MUX=1 shares one WebSocket per venue across pairs (up to
+    // FEED_WS_MUX_MAX_SYMBOLS each); it runs on the shared runtime, so it enables
+    // one with default sizes if none was configured.
+    const int runtime_io_threads = parse_env_int("FEED_RUNTIME_IO_THREADS", 0);
+    const int runtime_workers = parse_env_int("FEED_RUNTIME_WORKERS", 0);
+    feed_opts.feed_config.multiplex_ws = parse_env_bool("FEED_WS_MUX", false);
+    feed_opts.feed_config.max_symbols_per_ws = static_cast<std::size_t>(parse_env_int(
+        "FEED_WS_MUX_MAX_SYMBOLS", static_cast<int>(feed_opts.feed_config.max_symbols_per_ws)));
+    if (runtime_io_threads > 0 || runtime_workers > 0 || feed_opts.feed_config.multiplex_ws) {
+        md::FeedRuntime::Options runtime_opts;
+        if (runtime_io_threads > 0) runtime_opts.io_threads = static_cast<std::size_t>(runtime_io_threads);
+        if (runtime_workers > 0) runtime_opts.workers = static_cast<std::size_t>(runtime_workers);
+        runtime_opts.wait = feed_opts.feed_config.wait;
+        feed_opts.feed_config.runtime = std::make_shared<md::FeedRuntime>(runtime_opts);
+        std::cout << "[feed] Shared runtime: " << feed_opts.feed_config.runtime->io_threads()
+                  << " io threads, " << feed_opts.feed_config.runtime->workers()
+                  << " workers"
+                  << (feed_opts.feed_config.multiplex_ws ? ", multiplexed WS" : "") << std::endl;
+    }
 
     bool prewarm_all = feed_opts.prewarm_all;
 
@@ -256,7 +320,21 @@ int main() {
         throw std::runtime_error("Invalid HTTPS_PORT value. Must be between 1 and 65535.");
     }
 
-    boost::asio::io_context ioc{1};   // TODO: Make multiple HTTP threads
+    // HTTPS_IO_THREADS: threads running the server's io_context (connections
+    // are strand-serialized). HTTPS_WORKERS: pool for handlers that block on the
+    // DB or order routing, so they never stall /api/book; up to
+    // HTTPS_MAX_PENDING of those may be queued before new ones get 503.
+    // HTTPS_IDLE_SECONDS: keep-alive connections idle longer are closed.
+    const unsigned hw_threads = std::max(1u, std::thread::hardware_concurrency());
+    const int https_io_threads = std::max(1, parse_env_int("HTTPS_IO_THREADS", static_cast<int>(std::min(hw_threads, 4u))));
+    HttpServer::Options http_opts;
+    http_opts.workers = static_cast<std::size_t>(parse_env_int("HTTPS_WORKERS", 8));
+    http_opts.max_pending_blocking = static_cast<std::size_t>(parse_env_int(
+        "HTTPS_MAX_PENDING", static_cast<int>(http_opts.max_pending_blocking)));
+    http_opts.idle_timeout = std::chrono::seconds(parse_env_int(
+        "HTTPS_IDLE_SECONDS", static_cast<int>(http_opts.idle_timeout.count())));
+
+    boost::asio::io_context ioc{https_io_threads};
     ssl::context ssl_ctx{ssl::context::tls_server};
     ssl_ctx.set_options(
         ssl::context::default_workarounds |
@@ -267,6 +345,7 @@ int main() {
     );
     ssl_ctx.use_certificate_chain_file(tls_cert_file);
     ssl_ctx.use_private_key_file(tls_key_file, ssl::context::file_format::pem);
+    HttpServer::enable_session_resumption(ssl_ctx);
 
     tcp::endpoint ep{
         boost::asio::ip::make_address(bind_address),
@@ -277,13 +356,30 @@ int main() {
               << std::endl;
     HttpServer server{ioc, ssl_ctx, ep, [&](auto const& req, auto& res){
       handle_request(feed_manager, db_conn_str, router_version, venue_static_info, req, res);
-    }};
+    }, http_opts, is_blocking_request};
+
+    // GET /api/book/stream: pushed consolidated books, at most BOOK_STREAM_FPS
+    // frames per second per symbol (default 10).
+    BookStreamOptions stream_opts;
+    const int stream_fps = parse_env_int("BOOK_STREAM_FPS", 10);
+    if (stream_fps > 0) stream_opts.frame_interval = std::chrono::milliseconds(std::max(1, 1000 / stream_fps));
+    auto book_stream = std::make_shared<BookStreamHub>(ioc, feed_manager, stream_opts);
+    server.set_stream_handler([&book_stream](auto const& req, auto const& sink) {
+        return open_book_stream(*book_stream, req, sink);
+    });
     server.run();
 
-    std::cout << "HTTPS listening on " << bind_address << ":" << https_port << std::endl;
+    std::cout << "HTTPS listening on " << bind_address << ":" << https_port
+              << " (" << https_io_threads << " io threads, " << http_opts.workers << " workers)" << std::endl;
     std::cout << "Server started successfully" << std::endl;
-    
+
+    std::vector<std::thread> io_threads;
+    io_threads.reserve(static_cast<std::size_t>(https_io_threads - 1));
+    for (int i = 1; i < https_io_threads; ++i) {
+        io_threads.emplace_back([&ioc] { ioc.run(); });
+    }
     ioc.run();
+    for (auto& t : io_threads) t.join();
 
     feed_manager.shutdown();
     return 0;
@@ -0,0 +1,108 @@
+#include "book_wire.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include "md/fixed_point.hpp"
+
+namespace {
+
+void put_varint(std::string& out, std::uint64_t v)
+{
+    char buf[10];
+    std::size_t n = 0;
+    while (v >= 0x80) {
+        buf[n++] = static_cast<char>((v & 0x7f) | 0x80);
+        v >>= 7;
+    }
+    buf[n++] = static_cast<char>(v);
+    out.append(buf, n);
+}
+
+void put_zigzag(std::string& out, std::int64_t v)
+{
+    put_varint(out, (static_cast<std::uint64_t>(v) << 1) ^ static_cast<std::uint64_t>(v >> 63));
+}
+
+void put_string(std::string& out, std::string_view s)
+{
+    put_varint(out, s.size());
+    out.append(s);
+}
+
+constexpr std::int64_t pow10(int n)
+{
+    std::int64_t v = 1;
+    while (n-- > 0) v *= 10;
+    return v;
+}
+
+// Trailing decimal zeros shared by every ladder value, at most `decimals`.
+template <class Get>
+int common_zeros(const UIConsolidated& snap, int decimals, Get get)
+{
+    int zeros = decimals;
+    std::int64_t unit = pow10(zeros);
+    auto scan = [&](const std::vector<UILadderLevel>& rows) {
+        for (const auto& lvl : rows) {
+            const std::int64_t v = get(lvl);
+            while (zeros > 0 && v % unit != 0) {
+                --zeros;
+                unit /= 10;
+            }
+        }
+    };
+    scan(snap.bids);
+    scan(snap.asks);
+    return zeros;
+}
+
+} // namespace
+
+void write_book_wire(std::string& out, const UIConsolidated& snap)
+{
+    // Dictionary: the listed venues first, then any other venue on a ladder.
+    std::vector<std::string_view> dict(snap.venues.begin(), snap.venues.end());
+    std::unordered_map<std::string_view, std::uint32_t> ids;
+    for (std::uint32_t i = 0; i < dict.size(); ++i) ids.emplace(dict[i], i);
+    auto id_of = [&](const std::string& venue) {
+        auto [it, inserted] = ids.emplace(venue, static_cast<std::uint32_t>(dict.size()));
+        if (inserted) dict.push_back(venue);
+        return it->second;
+    };
+    for (const auto& lvl : snap.bids) id_of(lvl.venue);
+    for (const auto& lvl : snap.asks) id_of(lvl.venue);
+
+    const int px_zeros = common_zeros(snap, md::kPriceDecimals, [](const UILadderLevel& l) { return l.px; });
+    const int qty_zeros = common_zeros(snap, md::kSizeDecimals, [](const UILadderLevel& l) { return l.qty; });
+    const std::int64_t px_unit = pow10(px_zeros);
+    const std::int64_t qty_unit = pow10(qty_zeros);
+
+    out.reserve(out.size() + 64 + 16 * dict.size() + 8 * (snap.bids.size() + snap.asks.size()));
+    out += static_cast<char>(kBookWireVersion);
+    put_varint(out, static_cast<std::uint64_t>(book_status_code(snap)));
+    put_string(out, book_status_message(snap));
+    put_varint(out, snap.last_updated_ms > 0 ? static_cast<std::uint64_t>(snap.last_updated_ms) : 0);
+    put_string(out, snap.symbol);
+    put_varint(out, dict.size());
+    put_varint(out, snap.venues.size());
+    for (auto venue : dict) put_string(out, venue);
+    out += static_cast<char>(md::kPriceDecimals - px_zeros);
+    out += static_cast<char>(md::kSizeDecimals - qty_zeros);
+
+    auto put_side = [&](const std::vector<UILadderLevel>& rows) {
+        put_varint(out, rows.size());
+        std::int64_t prev = 0;
+        for (const auto& lvl : rows) {
+            const std::int64_t px = lvl.px / px_unit;
+            put_varint(out, ids.find(lvl.venue)->second);
+            put_zigzag(out, px - prev);
+            put_varint(out, static_cast<std::uint64_t>(std::max<std::int64_t>(lvl.qty, 0) / qty_unit));
+            prev = px;
+        }
+    };
+    put_side(snap.bids);
+    put_side(snap.asks);
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <string>
+
+#include "master_feed.hpp"
+
+// Compact binary encoding of UIConsolidated for /api/book, served when the
+// request carries `Accept: application/x-book-wire` (decoder: decodeBook in
+// frontend/lib/api.ts). A 4-venue, 1000-level book is ~8x smaller than the
+// JSON body and cheaper to produce and parse.
+//
+// Layout (varint = unsigned LEB128, zigzag = signed as varint,
+// string = varint byte length + UTF-8 bytes):
+//   u8      version (kBookWireVersion)
+//   varint  status code, string status message
+//   varint  last_updated_ms (0 = null)
+//   string  symbol
+//   varint  venue dictionary size, varint `listed`, then one string per
+//           venue; the first `listed` entries are the book's `venues` list
+//   u8      price decimals, u8 size decimals (common trailing zeros of the
+//           fixed-point PriceTicks/SizeLots are dropped)
+//   bids, then asks: varint row count, then per row
+//     varint  venue id (index into the dictionary)
+//     zigzag  price: first row absolute, then the step from the previous row
+//     varint  size
+// Row values are integers scaled by 10^decimals, exact in a JS number.
+inline constexpr char kBookWireContentType[] = "application/x-book-wire";
+inline constexpr unsigned char kBookWireVersion = 1;
+
+// Appends the encoding of `snap` to `out`.
+void write_book_wire(std::string& out, const UIConsolidated& snap);
@@ -1,5 +1,6 @@
 #include "master_feed.hpp"
 #include "md/feed_liveness.hpp"
+#include "md/level_merge.hpp"
 #include <algorithm>
 #include <chrono>
 #include <unordered_set>
@@ -12,6 +13,17 @@ std::int64_t now_ns() {
     using namespace std::chrono;
     return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
 }
+
+UIBookView make_view(std::shared_ptr<UIConsolidated> book) {
+    // ~60 bytes per ladder row.
+    std::string json;
+    json.reserve(256 + 64 * (book->bids.size() + book->asks.size()));
+    JsonWriter w(json);
+    w.begin_object();
+    write_book_fields(w, *book);
+    w.end_object();
+    return UIBookView{std::move(book), std::make_shared<const std::string>(std::move(json))};
+}
 }
 
 void UIMasterFeed::add_feed(std::shared_ptr<IVenueFeed> feed) {
@@ -24,147 +36,202 @@ void UIMasterFeed::add_feed(std::shared_ptr<IVenueFeed> feed) {
     feeds_.push_back(std::move(feed));
 }
 
-UIConsolidated UIMasterFeed::snapshot_consolidated(std::size_t depth) const {
-    UIConsolidated out;
-    out.symbol = canonical_;
-
-    struct FeedState {
-        std::string venue;
-        std::shared_ptr<const BookSnapshot> snapshot;
-        std::int64_t last_transport_ns{0};
-        std::int64_t last_book_update_ns{0};
-    };
+void write_ladder(JsonWriter& w, const std::vector<UILadderLevel>& rows)
+{
+    w.begin_array();
+    for (const auto& lvl : rows) {
+        w.begin_object()
+            .key("price").decimal(lvl.px, md::kPriceDecimals)
+            .key("size").decimal(lvl.qty, md::kSizeDecimals)
+            .field("venue", lvl.venue)
+            .end_object();
+    }
+    w.end_array();
+}
+
+const char* book_status_message(const UIConsolidated& snap)
+{
+    return snap.is_cold
+               ? "Market data transport stale: all venues cold"
+               : (snap.is_warming
+                      ? "Market data warming up: connecting to venues"
+                      : (snap.is_quiet
+                      ? "Market data quiet: transport alive, no recent book updates"
+                      : "OK"));
+}
 
-    // Take a snapshot of all venues and liveness metadata.
-    std::vector<FeedState> states;
-    {
-        std::lock_guard<std::mutex> lk(m_);
-        states.reserve(feeds_.size());
-        for (auto& f : feeds_) {
-            states.push_back(FeedState{
-                f->venue(),
-                f->load_snapshot(),          // atomic book snapshot
-                f->last_transport_ns(),      // monotonic transport liveness
-                f->last_book_update_ns(),    // monotonic book update recency
-            });
+void write_book_fields(JsonWriter& w, const UIConsolidated& snap)
+{
+    w.key("status").begin_object()
+        .field("code", book_status_code(snap))
+        .field("message", book_status_message(snap))
+        .end_object();
+    if (snap.last_updated_ms > 0) {
+        w.field("last_updated_ms", snap.last_updated_ms);
+    } else {
+        w.field("last_updated_ms", nullptr);
+    }
+    w.field("symbol", snap.symbol);
+    w.key("venues").begin_array();
+    for (const auto& v : snap.venues) w.value(v);
+    w.end_array();
+
+    // Consolidated ladders with venue information for UI
+    w.key("bids"); write_ladder(w, snap.bids);
+    w.key("asks"); write_ladder(w, snap.asks);
+}
+
+UIBookView UIMasterFeed::consolidated(std::size_t depth) const {
+    BuildKey key;
+    std::vector<std::shared_ptr<const BookSnapshot>> live;
+    std::unique_lock<std::mutex> lk(cache_m_, std::defer_lock);
+    for (;;) {
+        gather(key, live);
+        lk.lock();
+        CacheSlot& slot = cache_[depth];
+        if (slot.view.book && slot.key == key) return slot.view;
+        if (!slot.building) {
+            slot.building = true;
+            break;
         }
+        // Another reader is rebuilding this depth; its result most likely
+        // covers ours too. Re-read the feeds afterwards, ours are older now.
+        cache_cv_.wait(lk, [&] { return !slot.building; });
+        lk.unlock();
     }
+    lk.unlock();
+
+    UIBookView view;
+    try {
+        view = build(key, live, depth);
+    } catch (...) {
+        lk.lock();
+        cache_[depth].building = false;
+        lk.unlock();
+        cache_cv_.notify_all();
+        throw;
+    }
+
+    lk.lock();
+    CacheSlot& slot = cache_[depth];
+    slot.key = std::move(key);
+    slot.view = view;
+    slot.building = false;
+    lk.unlock();
+    cache_cv_.notify_all();
+    return view;
+}
+
+UIConsolidated UIMasterFeed::snapshot_consolidated(std::size_t depth) const {
+    return *consolidated(depth).book;
+}
+
+void UIMasterFeed::gather(BuildKey& key,
+                          std::vector<std::shared_ptr<const BookSnapshot>>& live) const {
+    key.feeds.clear();
+    key.seen_transport = false;
+    key.recent_update = false;
+    live.clear();
 
     const auto now = now_ns();
-    std::vector<std::shared_ptr<const BookSnapshot>> connected_snapshots;
-    connected_snapshots.reserve(states.size());
-    bool has_connected_transport = false;
-    bool has_seen_transport = false;
-    bool has_recent_book_update = false;
-
-    // Keep feeds with active transport; mark "quiet" if transport is alive but
-    // no recent book updates have arrived.
-    for (const auto& state : states) {
-        if (state.last_transport_ns > 0 || state.last_book_update_ns > 0) {
-            has_seen_transport = true;
-        }
-        if (state.last_transport_ns <= 0) continue;
-        if (now - state.last_transport_ns > md::liveness::kTransportStaleNs) continue;
+    std::lock_guard<std::mutex> lk(m_);
+    for (const auto& f : feeds_) {
+        auto snapshot = f->load_snapshot();                 // atomic book snapshot
+        const auto transport_ns = f->last_transport_ns();   // monotonic transport liveness
+        const auto book_update_ns = f->last_book_update_ns(); // monotonic book update recency
 
-        has_connected_transport = true;
-        if (state.last_book_update_ns > 0 &&
-            now - state.last_book_update_ns <= md::liveness::kQuietBookNs) {
-            has_recent_book_update = true;
+        if (transport_ns > 0 || book_update_ns > 0) {
+            key.seen_transport = true;
         }
+        // Keep feeds with active transport; mark "quiet" if transport is alive but
+        // no recent book updates have arrived.
+        const bool connected =
+            transport_ns > 0 && now - transport_ns <= md::liveness::kTransportStaleNs;
+        key.feeds.emplace_back(snapshot ? snapshot->seq : 0, connected);
+        if (!connected) continue;
+
+        if (book_update_ns > 0 && now - book_update_ns <= md::liveness::kQuietBookNs) {
+            key.recent_update = true;
+        }
+        if (snapshot) live.push_back(std::move(snapshot));
+    }
+}
+
+UIBookView UIMasterFeed::build(const BuildKey& key,
+                               const std::vector<std::shared_ptr<const BookSnapshot>>& live,
+                               std::size_t depth) const {
+    auto out = std::make_shared<UIConsolidated>();
+    out->symbol = canonical_;
 
-        auto& snapshot = state.snapshot;
-        if (!snapshot) continue;
+    const bool has_connected_transport =
+        std::any_of(key.feeds.begin(), key.feeds.end(), [](const auto& f) { return f.second; });
+
+    std::vector<const BookSnapshot*> connected_snapshots;
+    connected_snapshots.reserve(live.size());
+    for (const auto& snapshot : live) {
         if (snapshot->ts_ns <= 0) continue;
         if (snapshot->bids.empty() && snapshot->asks.empty()) continue;
 
-        connected_snapshots.push_back(snapshot);
-        if (snapshot->ts_ms > out.last_updated_ms) {
-            out.last_updated_ms = snapshot->ts_ms;
+        connected_snapshots.push_back(snapshot.get());
+        if (snapshot->ts_ms > out->last_updated_ms) {
+            out->last_updated_ms = snapshot->ts_ms;
         }
     }
 
     if (!has_connected_transport) {
-        if (!has_seen_transport) {
-            out.is_warming = true;
-            return out;
+        if (!key.seen_transport) {
+            out->is_warming = true;
+        } else {
+            out->is_cold = true;
         }
-        out.is_cold = true;
-        return out;
+        return make_view(std::move(out));
     }
 
-    out.is_quiet = !has_recent_book_update;
+    out->is_quiet = !key.recent_update;
 
     if (connected_snapshots.empty()) {
-        return out;
+        return make_view(std::move(out));
     }
 
     // Only expose venues that are currently contributing live, non-empty book levels.
     std::unordered_set<std::string> active_venues;
     for (const auto& snapshot : connected_snapshots) {
         if (active_venues.insert(snapshot->venue).second) {
-            out.venues.push_back(snapshot->venue);
+            out->venues.push_back(snapshot->venue);
         }
     }
-    std::sort(out.venues.begin(), out.venues.end());
-
-    // Flatten all per-venue ladders into a single list with venue info.
-    std::vector<UILadderLevel> all_bids;
-    std::vector<UILadderLevel> all_asks;
-    all_bids.reserve(connected_snapshots.size() * depth);
-    all_asks.reserve(connected_snapshots.size() * depth);
-
-    for (auto& snapshot : connected_snapshots) {
-        std::size_t taken_bids = 0;
-        for (const auto& lvl : snapshot->bids) {
-            if (taken_bids++ >= depth) break;
-            all_bids.push_back(UILadderLevel{snapshot->venue, lvl.price, lvl.size});
+    std::sort(out->venues.begin(), out->venues.end());
+
+    // Merge the per-venue ladders (each already best-first) into one list with
+    // venue info; bids highest price first, asks lowest price first, ties by
+    // larger size. `depth` is enforced per venue; do not trim globally here.
+    md::LevelMergeOptions opts;
+    opts.per_source_depth = depth;
+    auto merge_side = [&](BookSide side, std::vector<UILadderLevel>& rows) {
+        md::LevelMerger<SnapshotLevels::const_iterator> merger(side);
+        for (const auto* snapshot : connected_snapshots) {
+            const auto& levels = side == BookSide::Bid ? snapshot->bids : snapshot->asks;
+            merger.add(levels.begin(), levels.end());
         }
-        std::size_t taken_asks = 0;
-        for (const auto& lvl : snapshot->asks) {
-            if (taken_asks++ >= depth) break;
-            all_asks.push_back(UILadderLevel{snapshot->venue, lvl.price, lvl.size});
-        }
-    }
-
-    // Sort the merged ladders.
-    // Note: `depth` is enforced per venue above; do not trim globally here.
-    auto sort_merged = [](auto& v, bool bids_side) {
-        if (v.empty()) return;
-
-        if (bids_side) {
-            // Bids highest price first, tie-breaker by larger size.
-            std::sort(v.begin(), v.end(),
-                      [](const UILadderLevel& a, const UILadderLevel& b) {
-                          if (a.price != b.price) return a.price > b.price;
-                          return a.size > b.size;
-                      });
-        } else {
-            // Asks lowest price first, tie-breaker by larger size.
-            std::sort(v.begin(), v.end(),
-                      [](const UILadderLevel& a, const UILadderLevel& b) {
-                          if (a.price != b.price) return a.price < b.price;
-                          return a.size > b.size;
-                      });
-        }
-
+        rows.reserve(connected_snapshots.size() * depth);
+        merger.run(opts, [&](const md::MergedLevel& m) {
+            const auto& lvl = m.level;
+            rows.push_back(UILadderLevel{connected_snapshots[m.source]->venue, lvl.price, lvl.size, lvl.px, lvl.qty});
+        });
     };
-
-    sort_merged(all_bids, true);
-    sort_merged(all_asks, false);
-
-    out.bids = std::move(all_bids);
-    out.asks = std::move(all_asks);
+    merge_side(BookSide::Bid, out->bids);
+    merge_side(BookSide::Ask, out->asks);
 
     // Log top of the consolidated book for ml training
-    if (!out.bids.empty() && !out.asks.empty()) {
+    if (!out->bids.empty() && !out->asks.empty()) {
         ml_logger.log_snapshot(
             "consolidated", 
-            out.bids.front().price, 
-            out.bids.front().size, 
-            out.asks.front().price, 
-            out.asks.front().size
+            out->bids.front().price, 
+            out->bids.front().size, 
+            out->asks.front().price, 
+            out->asks.front().size
         );
     }
 
-    return out;
+    return make_view(std::move(out));
 }
@@ -5,14 +5,19 @@
 #include <utility>
 #include <cstdint>
 #include <mutex>
+#include <condition_variable>
+#include <map>
 
 #include "md/venue_feed_iface.hpp"
+#include "util/json_writer.hpp"
 
 // One row in the UI ladder with venue information.
 struct UILadderLevel {
     std::string venue;
     double price{0};
     double size{0};
+    md::PriceTicks px{0}; // exact keys used for merge ordering
+    md::SizeLots qty{0};
 };
 
 // A unified consolidated view for the UI.
@@ -40,6 +45,25 @@ struct UIConsolidated {
     std::int64_t last_updated_ms{0};
 };
 
+// Status reported with a consolidated book: 503 when every venue is cold.
+inline int book_status_code(const UIConsolidated& snap) { return snap.is_cold ? 503 : 200; }
+const char* book_status_message(const UIConsolidated& snap);
+
+// Ladder as a JSON array of {price, size, venue}; price and size are printed
+// exactly from the fixed-point px/qty.
+void write_ladder(JsonWriter& w, const std::vector<UILadderLevel>& rows);
+
+// Fields of the /api/book JSON body (status, symbol, venues, ladders), written
+// into the currently open object.
+void write_book_fields(JsonWriter& w, const UIConsolidated& snap);
+
+// One consolidated build, shared read-only by every reader that asked for the
+// same depth while its inputs were unchanged.
+struct UIBookView {
+    std::shared_ptr<const UIConsolidated> book;
+    std::shared_ptr<const std::string> json; // `{` write_book_fields(*book) `}`
+};
+
 // UIMasterFeed collects IVenueFeed readers and builds a consolidated ladder
 // by merging top levels from immutable per-venue BookSnapshot objects.
 // Thread-safe for add/get.
@@ -51,12 +75,44 @@ public:
     // Register a venue feed (must match symbol).
     void add_feed(std::shared_ptr<IVenueFeed> feed);
 
-    // Build a consolidated ladder of depth N for both sides.
+    // Consolidated ladder of depth N for both sides, cached per depth.
+    // - A build depends only on each venue's snapshot seq and liveness class
+    //   (live/stale, quiet/recent). While none of those changed, callers get
+    //   the same shared book and JSON body back without merging or encoding.
+    // - When they did change, the first caller rebuilds; concurrent callers
+    //   for that depth wait for its result instead of building it again.
     // Reads each venue's snapshot atomically (lock-free from venues’ perspective).
+    UIBookView consolidated(std::size_t depth) const;
+
+    // Build a consolidated ladder of depth N for both sides (copy of consolidated()).
     UIConsolidated snapshot_consolidated(std::size_t depth) const;
 
 private:
+    // Everything a build reads from the feeds; equal keys give equal books.
+    struct BuildKey {
+        std::vector<std::pair<std::uint64_t, bool>> feeds; // (snapshot seq, transport live)
+        bool seen_transport{false};
+        bool recent_update{false};
+
+        bool operator==(const BuildKey&) const = default;
+    };
+
+    struct CacheSlot {
+        BuildKey key;
+        UIBookView view;     // empty until the first build
+        bool building{false};
+    };
+
+    void gather(BuildKey& key, std::vector<std::shared_ptr<const BookSnapshot>>& live) const;
+    UIBookView build(const BuildKey& key,
+                     const std::vector<std::shared_ptr<const BookSnapshot>>& live,
+                     std::size_t depth) const;
+
     std::string canonical_;
     mutable std::mutex m_; // protects feeds_
     std::vector<std::shared_ptr<IVenueFeed>> feeds_;
+
+    mutable std::mutex cache_m_; // protects cache_
+    mutable std::condition_variable cache_cv_;
+    mutable std::map<std::size_t, CacheSlot> cache_; // key: depth
 };
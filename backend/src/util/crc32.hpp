@@ -0,0 +1,195 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define UTIL_CRC32_CLMUL 1
+#elif defined(__aarch64__) && defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#define UTIL_CRC32_ARMV8 1
+#endif
+
+// CRC-32 (IEEE 802.3 / zlib polynomial), as used by exchange book checksums.
+// crc32(data, n, prev) continues a running value exactly like zlib's crc32().
+//
+// Paths, picked once at runtime:
+// - x86: PCLMULQDQ carry-less multiply folding (64-byte blocks, Barrett
+//   reduction). The SSE4.2 crc32 instruction computes CRC-32C (Castagnoli),
+//   a different polynomial, so it cannot serve here.
+// - AArch64 with the CRC extension: the __crc32d family (IEEE polynomial).
+// - Otherwise, and for short tails: slicing-by-8 tables.
+namespace util {
+
+namespace detail {
+
+inline constexpr std::uint32_t kCrc32Poly = 0xEDB88320u; // 0x04C11DB7, bit-reflected
+
+struct Crc32Tables {
+    std::uint32_t t[8][256];
+};
+
+constexpr Crc32Tables make_crc32_tables() {
+    Crc32Tables tab{};
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        std::uint32_t c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1) ? (c >> 1) ^ kCrc32Poly : c >> 1;
+        tab.t[0][i] = c;
+    }
+    for (std::uint32_t i = 0; i < 256; ++i) {
+        for (int s = 1; s < 8; ++s) {
+            const std::uint32_t prev = tab.t[s - 1][i];
+            tab.t[s][i] = (prev >> 8) ^ tab.t[0][prev & 0xff];
+        }
+    }
+    return tab;
+}
+
+inline constexpr Crc32Tables kCrc32Tables = make_crc32_tables();
+
+// Table path on the raw (pre-inverted) register.
+inline std::uint32_t crc32_sliced(const unsigned char* p, std::size_t n, std::uint32_t crc) noexcept {
+    const auto& t = kCrc32Tables.t;
+    if constexpr (std::endian::native == std::endian::little) {
+        while (n >= 8) {
+            std::uint32_t lo, hi;
+            std::memcpy(&lo, p, 4);
+            std::memcpy(&hi, p + 4, 4);
+            lo ^= crc;
+            crc = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^
+                  t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+                  t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^
+                  t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+            p += 8;
+            n -= 8;
+        }
+    }
+    while (n--) crc = (crc >> 8) ^ t[0][(crc ^ *p++) & 0xff];
+    return crc;
+}
+
+#if defined(UTIL_CRC32_CLMUL)
+
+// acc * x^k folded onto the next 128-bit block.
+__attribute__((target("pclmul,sse4.1")))
+inline __m128i crc32_fold(__m128i acc, __m128i k, __m128i next) noexcept {
+    const __m128i lo = _mm_clmulepi64_si128(acc, k, 0x00);
+    const __m128i hi = _mm_clmulepi64_si128(acc, k, 0x11);
+    return _mm_xor_si128(_mm_xor_si128(hi, lo), next);
+}
+
+// Folds n bytes (n >= 64, multiple of 16) into the raw register.
+// Constants are the bit-reflected x^k mod P values from Intel's "Fast CRC
+// Computation for Generic Polynomials Using PCLMULQDQ" (also used by zlib).
+__attribute__((target("pclmul,sse4.1")))
+inline std::uint32_t crc32_clmul(const unsigned char* p, std::size_t n, std::uint32_t crc) noexcept {
+    alignas(16) static constexpr std::uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static constexpr std::uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static constexpr std::uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static constexpr std::uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    auto load = [](const unsigned char* q) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(q)); };
+
+    __m128i x1 = _mm_xor_si128(load(p), _mm_cvtsi32_si128(static_cast<int>(crc)));
+    __m128i x2 = load(p + 16);
+    __m128i x3 = load(p + 32);
+    __m128i x4 = load(p + 48);
+    p += 64;
+    n -= 64;
+
+    // Four independent 128-bit lanes, 64 bytes per step.
+    __m128i k = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    while (n >= 64) {
+        x1 = crc32_fold(x1, k, load(p));
+        x2 = crc32_fold(x2, k, load(p + 16));
+        x3 = crc32_fold(x3, k, load(p + 32));
+        x4 = crc32_fold(x4, k, load(p + 48));
+        p += 64;
+        n -= 64;
+    }
+
+    // Lanes into one, then the remaining 16-byte blocks.
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    x1 = crc32_fold(x1, k, x2);
+    x1 = crc32_fold(x1, k, x3);
+    x1 = crc32_fold(x1, k, x4);
+    while (n >= 16) {
+        x1 = crc32_fold(x1, k, load(p));
+        p += 16;
+        n -= 16;
+    }
+
+    // 128 -> 64 bits.
+    const __m128i mask32 = _mm_setr_epi32(~0, 0, ~0, 0);
+    __m128i x2r = _mm_clmulepi64_si128(x1, k, 0x10);
+    x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2r);
+    k = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2r = _mm_srli_si128(x1, 4);
+    x1 = _mm_xor_si128(_mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x00), x2r);
+
+    // Barrett reduction to 32 bits.
+    k = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x1, mask32), k, 0x10);
+    x2r = _mm_clmulepi64_si128(_mm_and_si128(x2r, mask32), k, 0x00);
+    x1 = _mm_xor_si128(x1, x2r);
+    return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+inline bool crc32_has_clmul() noexcept {
+    static const bool has = __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+    return has;
+}
+
+#elif defined(UTIL_CRC32_ARMV8)
+
+inline std::uint32_t crc32_armv8(const unsigned char* p, std::size_t n, std::uint32_t crc) noexcept {
+    while (n >= 8) {
+        std::uint64_t w;
+        std::memcpy(&w, p, 8);
+        crc = __crc32d(crc, w);
+        p += 8;
+        n -= 8;
+    }
+    while (n--) crc = __crc32b(crc, *p++);
+    return crc;
+}
+
+#endif
+
+} // namespace detail
+
+// Portable reference path (tables only); crc32() must agree with it.
+inline std::uint32_t crc32_portable(const void* data, std::size_t n, std::uint32_t prev = 0) noexcept {
+    return ~detail::crc32_sliced(static_cast<const unsigned char*>(data), n, ~prev);
+}
+
+inline std::uint32_t crc32(const void* data, std::size_t n, std::uint32_t prev = 0) noexcept {
+    const auto* p = static_cast<const unsigned char*>(data);
+    std::uint32_t crc = ~prev;
+#if defined(UTIL_CRC32_CLMUL)
+    if (n >= 64 && detail::crc32_has_clmul()) {
+        const std::size_t bulk = n & ~static_cast<std::size_t>(15);
+        crc = detail::crc32_clmul(p, bulk, crc);
+        p += bulk;
+        n -= bulk;
+    }
+#elif defined(UTIL_CRC32_ARMV8)
+    return ~detail::crc32_armv8(p, n, crc);
+#endif
+    return ~detail::crc32_sliced(p, n, crc);
+}
+
+// True when crc32() runs on carry-less multiply / CRC instructions.
+inline bool crc32_hardware() noexcept {
+#if defined(UTIL_CRC32_CLMUL)
+    return detail::crc32_has_clmul();
+#elif defined(UTIL_CRC32_ARMV8)
+    return true;
+#else
+    return false;
+#endif
+}
+
+} // namespace util
@@ -0,0 +1,46 @@
+#pragma once
+#include <cstddef>
+#include <latch>
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/thread_pool.hpp>
+
+namespace util {
+
+// Runs task(0) .. task(n - 1), all but the last on `pool` and the last on the
+// calling thread, and returns once every one has finished.
+//
+// Tasks may reference the caller's stack: each posted task counts the latch
+// down from a guard, and the caller waits for all of them before it returns
+// or rethrows. Tasks are expected to report their own errors; anything that
+// still escapes a posted task is dropped, and anything escaping the inline
+// task (or a failed post) is rethrown once the posted tasks are done.
+template <typename Task>
+void fork_join(boost::asio::thread_pool& pool, std::size_t n, Task&& task) {
+    if (n == 0) return;
+    struct CountDown {
+        std::latch& latch;
+        ~CountDown() { latch.count_down(); }
+    };
+    std::latch done(static_cast<std::ptrdiff_t>(n - 1));
+    std::size_t posted = 0;
+    try {
+        for (; posted + 1 < n; ++posted) {
+            boost::asio::post(pool, [&done, &task, i = posted] {
+                CountDown guard{done};
+                try {
+                    task(i);
+                } catch (...) {
+                }
+            });
+        }
+        task(n - 1);
+    } catch (...) {
+        done.count_down(static_cast<std::ptrdiff_t>(n - 1 - posted)); // tasks never posted
+        done.wait();
+        throw;
+    }
+    done.wait();
+}
+
+} // namespace util
@@ -0,0 +1,95 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "spsc_queue.hpp"
+
+// Fixed pool of reusable raw-frame buffers handed from one WS reader thread
+// (producer) to one feed consumer thread by slot index.
+// - Frames live in std::string storage that keeps its capacity across reuse,
+//   so steady-state traffic performs no allocation. Buffers that grew past
+//   kRetainBytes (full-book snapshots) are freed on release instead.
+// - Producers swap their filled read buffer into an acquired slot (pointer
+//   swap, no copy) and get the slot's previous storage back for the next read.
+// - kPadding spare bytes are kept past size() so JSON parsers can read the
+//   frame in place (covers SIMDJSON_PADDING).
+// - Free slot indices flow consumer -> producer through an SPSC queue into a
+//   producer-side stack, so acquire() hands out the most recently freed slot:
+//   a feed keeps reusing the few slots its queue depth needs instead of
+//   cycling (and growing) all of them. Slots the producer gets back itself (a
+//   frame it dropped, or one evicted from an overwriting queue) go straight
+//   onto the stack via recycle().
+template <std::size_t Slots>
+class FramePool {
+    static_assert(Slots > 0 && Slots < UINT32_MAX, "Slots must fit a slot index");
+
+public:
+    static constexpr std::size_t kPadding = 64;
+    static constexpr std::size_t kRetainBytes = 64 * 1024;
+    static constexpr std::uint32_t kNoSlot = UINT32_MAX;
+
+    FramePool() {
+        spare_.reserve(Slots);
+        for (std::uint32_t i = Slots; i-- > 0;) spare_.push_back(i); // slot 0 on top
+    }
+
+    // Non-copyable
+    FramePool(const FramePool&) = delete;
+    FramePool& operator=(const FramePool&) = delete;
+
+    // Producer: take the most recently freed slot index, or kNoSlot when every
+    // slot is in flight.
+    std::uint32_t acquire() {
+        std::uint32_t released = 0;
+        while (free_.try_pop(released)) spare_.push_back(released);
+        if (spare_.empty()) return kNoSlot;
+        const std::uint32_t idx = spare_.back();
+        spare_.pop_back();
+        return idx;
+    }
+
+    // Producer: take back a slot that never reached (or was evicted from) the
+    // consumer.
+    void recycle(std::uint32_t idx) {
+        spare_.push_back(idx);
+    }
+
+    // Consumer: hand a slot back once its frame has been parsed.
+    void release(std::uint32_t idx) {
+        std::string& buf = slots_[idx].buf;
+        if (buf.capacity() > kRetainBytes) std::string().swap(buf);
+        (void)free_.try_push(idx);
+    }
+
+    // Move `frame` into slot `idx` without copying; `frame` receives the slot's
+    // previous (cleared, capacity-retaining) storage.
+    void fill(std::uint32_t idx, std::string& frame) {
+        std::string& slot = slots_[idx].buf;
+        ensure_padding(frame);
+        slot.swap(frame);
+        frame.clear();
+    }
+
+    std::string& frame(std::uint32_t idx) noexcept { return slots_[idx].buf; }
+    const std::string& frame(std::uint32_t idx) const noexcept { return slots_[idx].buf; }
+
+    static constexpr std::size_t slots() noexcept { return Slots; }
+
+    // Guarantee kPadding readable bytes past size(); reallocates only when the
+    // buffer has never held a frame this large.
+    static void ensure_padding(std::string& s) {
+        if (s.capacity() - s.size() < kPadding) s.reserve(s.size() + kPadding);
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::string buf;
+    };
+
+    Slot slots_[Slots];
+    SpscQueue<std::uint32_t, std::bit_ceil(Slots)> free_; // released, not yet moved to spare_
+    std::vector<std::uint32_t> spare_;                    // producer-only free stack
+};
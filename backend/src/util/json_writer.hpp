@@ -0,0 +1,228 @@
+#pragma once
+#include <cassert>
+#include <charconv>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+// Append-only JSON encoder for response bodies and stream frames.
+// - Writes into a caller-owned std::string (e.g. the beast response body),
+//   so one reserved buffer is filled in place; no streams, locales or
+//   virtual calls.
+// - Commas are inserted automatically: key() then one value inside objects,
+//   values inside arrays. Nesting up to 63 levels.
+// - Doubles use the shortest representation that round-trips
+//   (std::to_chars); non-finite values become null. decimal() prints exact
+//   fixed-point integers (PriceTicks/SizeLots) with trailing zeros trimmed.
+// - Strings are escaped 8 bytes at a time: a SWAR test finds words with a
+//   quote, backslash or control byte; clean words are appended as is.
+class JsonWriter {
+public:
+    explicit JsonWriter(std::string& out) noexcept : out_(out) {}
+
+    std::string& buffer() noexcept { return out_; }
+
+    JsonWriter& begin_object() { return open('{'); }
+    JsonWriter& end_object() { return close('}'); }
+    JsonWriter& begin_array() { return open('['); }
+    JsonWriter& end_array() { return close(']'); }
+
+    JsonWriter& key(std::string_view k) {
+        separate();
+        append_string(out_, k);
+        out_ += ':';
+        after_key_ = true;
+        return *this;
+    }
+
+    JsonWriter& value(std::string_view s) {
+        separate();
+        append_string(out_, s);
+        return *this;
+    }
+    JsonWriter& value(const std::string& s) { return value(std::string_view(s)); }
+    JsonWriter& value(const char* s) { return value(std::string_view(s)); }
+
+    JsonWriter& value(bool b) {
+        separate();
+        out_ += b ? "true" : "false";
+        return *this;
+    }
+
+    JsonWriter& value(std::nullptr_t) {
+        separate();
+        out_ += "null";
+        return *this;
+    }
+
+    JsonWriter& value(double v) {
+        separate();
+        append_double(out_, v);
+        return *this;
+    }
+
+    template <std::integral T>
+        requires(!std::same_as<T, bool>)
+    JsonWriter& value(T v) {
+        separate();
+        char buf[24];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out_.append(buf, r.ptr);
+        return *this;
+    }
+
+    // Fixed-point number: scaled / 10^decimals, exact (0 <= decimals <= 18).
+    JsonWriter& decimal(std::int64_t scaled, int decimals) {
+        separate();
+        append_decimal(out_, scaled, decimals);
+        return *this;
+    }
+
+    // Pre-encoded JSON value, copied verbatim.
+    JsonWriter& raw(std::string_view json) {
+        separate();
+        out_ += json;
+        return *this;
+    }
+
+    template <class T>
+    JsonWriter& field(std::string_view k, const T& v) {
+        return key(k).value(v);
+    }
+
+    // Quoted, escaped JSON string.
+    static void append_string(std::string& out, std::string_view s) {
+        out += '"';
+        append_escaped(out, s);
+        out += '"';
+    }
+
+    // Escaped string contents (no quotes).
+    static void append_escaped(std::string& out, std::string_view s) {
+        const char* p = s.data();
+        const char* const end = p + s.size();
+        const char* clean = p; // start of the pending unescaped run
+        while (end - p >= 8) {
+            std::uint64_t w;
+            std::memcpy(&w, p, 8);
+            if (!needs_escape(w)) {
+                p += 8;
+                continue;
+            }
+            for (const char* stop = p + 8; p < stop; ++p) {
+                if (escape_char(out, clean, p)) clean = p + 1;
+            }
+        }
+        for (; p < end; ++p) {
+            if (escape_char(out, clean, p)) clean = p + 1;
+        }
+        out.append(clean, end);
+    }
+
+    static void append_double(std::string& out, double v) {
+        if (!std::isfinite(v)) {
+            out += "null";
+            return;
+        }
+        char buf[32];
+        const auto r = std::to_chars(buf, buf + sizeof(buf), v);
+        out.append(buf, r.ptr);
+    }
+
+    static void append_decimal(std::string& out, std::int64_t scaled, int decimals) {
+        assert(decimals >= 0 && decimals <= 18);
+        std::uint64_t mag = scaled < 0 ? 0 - static_cast<std::uint64_t>(scaled) : static_cast<std::uint64_t>(scaled);
+        if (scaled < 0) out += '-';
+        const std::uint64_t unit = kPow10[decimals];
+        char buf[24];
+        auto r = std::to_chars(buf, buf + sizeof(buf), mag / unit);
+        out.append(buf, r.ptr);
+        std::uint64_t frac = mag % unit;
+        if (frac == 0) return;
+        int digits = decimals;
+        while (frac % 10 == 0) {
+            frac /= 10;
+            --digits;
+        }
+        out += '.';
+        r = std::to_chars(buf, buf + sizeof(buf), frac);
+        const int len = static_cast<int>(r.ptr - buf);
+        out.append(static_cast<std::size_t>(digits - len), '0');
+        out.append(buf, r.ptr);
+    }
+
+private:
+    static constexpr std::uint64_t kPow10[] = {
+        1ull, 10ull, 100ull, 1'000ull, 10'000ull, 100'000ull, 1'000'000ull, 10'000'000ull,
+        100'000'000ull, 1'000'000'000ull, 10'000'000'000ull, 100'000'000'000ull,
+        1'000'000'000'000ull, 10'000'000'000'000ull, 100'000'000'000'000ull,
+        1'000'000'000'000'000ull, 10'000'000'000'000'000ull, 100'000'000'000'000'000ull,
+        1'000'000'000'000'000'000ull,
+    };
+
+    // Any byte < 0x20, '"' or '\\' in the word (may over-report after a hit).
+    static bool needs_escape(std::uint64_t w) noexcept {
+        constexpr std::uint64_t kOnes = 0x0101010101010101ull;
+        constexpr std::uint64_t kHigh = 0x8080808080808080ull;
+        auto has_zero = [](std::uint64_t v) { return (v - kOnes) & ~v & kHigh; };
+        const std::uint64_t control = (w - kOnes * 0x20) & ~w & kHigh;
+        return (control | has_zero(w ^ (kOnes * '"')) | has_zero(w ^ (kOnes * '\\'))) != 0;
+    }
+
+    // Flushes [clean, p) and writes the escape for *p; false if *p needs none.
+    static bool escape_char(std::string& out, const char* clean, const char* p) {
+        const auto c = static_cast<unsigned char>(*p);
+        if (c >= 0x20 && c != '"' && c != '\\') return false;
+        out.append(clean, p);
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n";  break;
+            case '\r': out += "\\r";  break;
+            case '\t': out += "\\t";  break;
+            case '\b': out += "\\b";  break;
+            case '\f': out += "\\f";  break;
+            default: {
+                static constexpr char kHex[] = "0123456789abcdef";
+                const char u[6] = {'\\', 'u', '0', '0', kHex[c >> 4], kHex[c & 0xf]};
+                out.append(u, sizeof(u));
+                break;
+            }
+        }
+        return true;
+    }
+
+    void separate() {
+        if (after_key_) {
+            after_key_ = false;
+            return;
+        }
+        const std::uint64_t bit = std::uint64_t{1} << depth_;
+        if (has_items_ & bit) out_ += ',';
+        has_items_ |= bit;
+    }
+
+    JsonWriter& open(char c) {
+        separate();
+        out_ += c;
+        assert(depth_ < 63);
+        ++depth_;
+        has_items_ &= ~(std::uint64_t{1} << depth_);
+        return *this;
+    }
+
+    JsonWriter& close(char c) {
+        assert(depth_ > 0 && !after_key_);
+        --depth_;
+        out_ += c;
+        return *this;
+    }
+
+    std::string& out_;
+    std::uint64_t has_items_{0}; // bit d: container at depth d already has an element
+    unsigned depth_{0};
+    bool after_key_{false};
+};
@@ -0,0 +1,248 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+// What a full SpscQueue does with a push.
+enum class SpscOverflow {
+    Reject,         // try_push fails; the caller keeps the element
+    OverwriteOldest // push_overwrite evicts the oldest unread element to the producer
+};
+
+// Single-Producer / Single-Consumer bounded queue.
+// - CapacityPow2 must be a power of two; all CapacityPow2 slots are usable.
+// - The producer and consumer indices live on separate cache lines, next to a
+//   cached copy of the other side's index: a push only re-reads the consumer's
+//   index when its cached view says the queue is full, a pop only re-reads the
+//   producer's index when its cached view says the queue is empty.
+// - try_push_bulk/try_pop_bulk move a run of elements with one index
+//   publication per call.
+// - dropped(): elements refused (Reject) or evicted (OverwriteOldest);
+//   size(): approximate occupancy. Both may be read from any thread.
+//
+// OverwriteOldest keeps a sequence word per slot. A producer that finds the
+// queue full claims the oldest slot with a CAS, and the consumer takes
+// elements with a CAS on the same word, so exactly one side ends up owning
+// each element: the producer gets the evicted element back (to recycle it),
+// and the consumer skips positions it lost and counts them in overrun().
+// It requires a T that std::atomic handles lock-free (indices, pointers).
+template <typename T, std::size_t CapacityPow2, SpscOverflow Overflow = SpscOverflow::Reject>
+class SpscQueue {
+    static_assert(CapacityPow2 > 0 && (CapacityPow2 & (CapacityPow2 - 1)) == 0,
+                  "Capacity must be power of two");
+    static_assert(Overflow == SpscOverflow::Reject ||
+                  (std::is_trivially_copyable_v<T> && std::atomic<T>::is_always_lock_free),
+                  "OverwriteOldest needs a lock-free atomic element type");
+
+    static constexpr bool kOverwrite = Overflow == SpscOverflow::OverwriteOldest;
+    static constexpr std::size_t kCacheLine = 64;
+    static constexpr std::uint64_t kMask = CapacityPow2 - 1;
+
+public:
+    SpscQueue() {
+        if constexpr (kOverwrite) {
+            for (std::uint64_t i = 0; i < CapacityPow2; ++i) {
+                buf_[i].seq.store(free_seq(i), std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Non-copyable
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    // -------- producer --------
+
+    // False (and counted in dropped()) when full.
+    bool try_push(T v) {
+        if constexpr (kOverwrite) {
+            Slot& s = buf_[head_local_ & kMask];
+            if (s.seq.load(std::memory_order_acquire) != free_seq(head_local_)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            publish(s, v);
+            return true;
+        } else {
+            if (!has_room(1)) {
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+            buf_[head_local_ & kMask] = std::move(v);
+            head_.store(++head_local_, std::memory_order_release);
+            return true;
+        }
+    }
+
+    // Push up to n elements from src; returns how many were pushed (the rest
+    // are counted in dropped()).
+    std::size_t try_push_bulk(const T* src, std::size_t n) {
+        if constexpr (kOverwrite) {
+            std::size_t pushed = 0;
+            while (pushed < n && try_push(src[pushed])) ++pushed;
+            if (pushed < n) dropped_.fetch_add(n - pushed - 1, std::memory_order_relaxed);
+            return pushed;
+        } else {
+            std::size_t room = CapacityPow2 - static_cast<std::size_t>(head_local_ - cached_tail_);
+            if (room < n) {
+                cached_tail_ = tail_.load(std::memory_order_acquire);
+                room = CapacityPow2 - static_cast<std::size_t>(head_local_ - cached_tail_);
+            }
+            const std::size_t count = std::min(room, n);
+            for (std::size_t i = 0; i < count; ++i) buf_[(head_local_ + i) & kMask] = src[i];
+            if (count < n) dropped_.fetch_add(n - count, std::memory_order_relaxed);
+            if (count == 0) return 0;
+            head_local_ += count;
+            head_.store(head_local_, std::memory_order_release);
+            return count;
+        }
+    }
+
+    // OverwriteOldest: always pushes. Returns true if the oldest unread element
+    // was evicted to make room; it is moved to `evicted`.
+    bool push_overwrite(T v, T& evicted) requires kOverwrite {
+        Slot& s = buf_[head_local_ & kMask];
+        std::uint64_t seq = s.seq.load(std::memory_order_acquire);
+        bool evict = false;
+        if (seq == full_seq(head_local_ - CapacityPow2)) {
+            // Oldest element still unread: claim it unless the consumer takes it first.
+            const T old = s.value.load(std::memory_order_relaxed);
+            if (s.seq.compare_exchange_strong(seq, free_seq(head_local_),
+                                              std::memory_order_acq_rel, std::memory_order_acquire)) {
+                evicted = old;
+                evict = true;
+                dropped_.fetch_add(1, std::memory_order_relaxed);
+            }
+        }
+        publish(s, v);
+        return evict;
+    }
+
+    // Producer view: no room for another try_push.
+    bool full() {
+        if constexpr (kOverwrite) {
+            return buf_[head_local_ & kMask].seq.load(std::memory_order_acquire) != free_seq(head_local_);
+        } else {
+            return !has_room(1);
+        }
+    }
+
+    // -------- consumer --------
+
+    bool try_pop(T& out) {
+        if constexpr (kOverwrite) {
+            for (;;) {
+                Slot& s = buf_[tail_local_ & kMask];
+                std::uint64_t seq = s.seq.load(std::memory_order_acquire);
+                if (seq == full_seq(tail_local_)) {
+                    const T v = s.value.load(std::memory_order_relaxed);
+                    if (s.seq.compare_exchange_strong(seq, free_seq(tail_local_ + CapacityPow2),
+                                                      std::memory_order_acq_rel, std::memory_order_acquire)) {
+                        out = v;
+                        tail_.store(++tail_local_, std::memory_order_release);
+                        return true;
+                    }
+                } else if (seq == free_seq(tail_local_)) {
+                    return false; // not written yet
+                }
+                skip_lost();
+            }
+        } else {
+            if (tail_local_ == cached_head_) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                if (tail_local_ == cached_head_) return false;
+            }
+            out = std::move(buf_[tail_local_ & kMask]);
+            tail_.store(++tail_local_, std::memory_order_release);
+            return true;
+        }
+    }
+
+    // Pop up to max elements into dst; returns how many were popped.
+    std::size_t try_pop_bulk(T* dst, std::size_t max) {
+        if constexpr (kOverwrite) {
+            std::size_t popped = 0;
+            while (popped < max && try_pop(dst[popped])) ++popped;
+            return popped;
+        } else {
+            std::size_t avail = static_cast<std::size_t>(cached_head_ - tail_local_);
+            if (avail < max) {
+                cached_head_ = head_.load(std::memory_order_acquire);
+                avail = static_cast<std::size_t>(cached_head_ - tail_local_);
+            }
+            const std::size_t count = std::min(avail, max);
+            for (std::size_t i = 0; i < count; ++i) dst[i] = std::move(buf_[(tail_local_ + i) & kMask]);
+            if (count == 0) return 0;
+            tail_local_ += count;
+            tail_.store(tail_local_, std::memory_order_release);
+            return count;
+        }
+    }
+
+    // Consumer view: nothing to pop.
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_local_;
+    }
+
+    // Consumer: elements overwritten before it reached them (OverwriteOldest).
+    std::uint64_t overrun() const noexcept { return overrun_; }
+
+    // -------- any thread --------
+
+    std::size_t size() const noexcept {
+        const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+        const std::uint64_t head = head_.load(std::memory_order_relaxed);
+        return head > tail ? static_cast<std::size_t>(std::min<std::uint64_t>(head - tail, CapacityPow2)) : 0;
+    }
+    std::uint64_t dropped() const noexcept { return dropped_.load(std::memory_order_relaxed); }
+    static constexpr std::size_t capacity() noexcept { return CapacityPow2; }
+
+private:
+    // OverwriteOldest slot states for position p: free_seq(p) = writable for p,
+    // full_seq(p) = holds the element pushed at p.
+    static constexpr std::uint64_t free_seq(std::uint64_t pos) noexcept { return pos * 2; }
+    static constexpr std::uint64_t full_seq(std::uint64_t pos) noexcept { return pos * 2 + 1; }
+
+    struct Slot {
+        std::atomic<std::uint64_t> seq{0};
+        std::atomic<T> value{};
+    };
+    using Storage = std::conditional_t<kOverwrite, Slot, T>;
+
+    bool has_room(std::size_t n) {
+        if (head_local_ - cached_tail_ + n <= CapacityPow2) return true;
+        cached_tail_ = tail_.load(std::memory_order_acquire);
+        return head_local_ - cached_tail_ + n <= CapacityPow2;
+    }
+
+    void publish(Slot& s, const T& v) requires kOverwrite {
+        s.value.store(v, std::memory_order_relaxed);
+        s.seq.store(full_seq(head_local_), std::memory_order_release);
+        head_.store(++head_local_, std::memory_order_release);
+    }
+
+    // The slot at tail_local_ was overwritten: jump to the oldest position
+    // still in the queue (at least one step) and count the skipped ones.
+    void skip_lost() requires kOverwrite {
+        const std::uint64_t head = head_.load(std::memory_order_acquire);
+        const std::uint64_t next = head > tail_local_ + CapacityPow2 ? head - CapacityPow2 : tail_local_ + 1;
+        overrun_ += next - tail_local_;
+        tail_local_ = next;
+        tail_.store(tail_local_, std::memory_order_release);
+    }
+
+    // Producer line.
+    alignas(kCacheLine) std::atomic<std::uint64_t> head_{0}; // next position to write
+    std::uint64_t head_local_{0};
+    std::uint64_t cached_tail_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+    // Consumer line.
+    alignas(kCacheLine) std::atomic<std::uint64_t> tail_{0}; // next position to read
+    std::uint64_t tail_local_{0};
+    std::uint64_t cached_head_{0};
+    std::uint64_t overrun_{0};
+    alignas(kCacheLine) Storage buf_[CapacityPow2]; // T, or Slot for OverwriteOldest
+};
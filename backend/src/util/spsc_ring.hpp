@@ -6,6 +6,7 @@
 #include <new>
 
 // Single-Producer / Single-Consumer ring buffer.
+// Superseded by util/spsc_queue.hpp; kept as the baseline in bench/bench_spsc.cpp.
 // - CapacityPow2 must be a power-of-two (e.g., 1024).
 // - SPSC: exactly one producer thread calls try_push,
 //         exactly one consumer thread calls try_pop.
@@ -10,10 +10,12 @@
 inline VenueFactory make_binance_factory() {
     VenueFactory factory;
     factory.name = "Binance";
-    factory.make_feed = [](const std::string& canonical) -> std::shared_ptr<IVenueFeed> {
+    auto mux = std::make_shared<WsMuxSlot<BinanceWs, BinanceBookParser>>();
+    factory.make_feed = [mux](const std::string& canonical,
+                              const FeedConfig& config) -> std::shared_ptr<IVenueFeed> {
         using Feed = VenueFeed<BinanceWs, BinanceBookParser>;
         return std::make_shared<Feed>(
-            "Binance", canonical, Backpressure::DropOldest);
+            "Binance", canonical, Backpressure::DropOldest, PublishPolicy{}, config, mux->get(config));
     };
     factory.make_api = []() -> std::unique_ptr<IVenueApi> {
         return std::make_unique<BinanceVenueApi>();
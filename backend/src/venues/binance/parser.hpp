@@ -1,13 +1,16 @@
 #pragma once
 #include "md/book_parser.hpp"
 #include "md/book_events.hpp"
+#include "md/fixed_point.hpp"
 #include "md/symbol_codec.hpp"
+#include "venues/frame_peek.hpp"
+#include "venues/json_scan.hpp"
+#include "venues/simdjson_frame.hpp"
 
 #include <simdjson.h>
 #include <string>
-#include <vector>
 #include <chrono>
-#include <cstdlib>
+#include <cstdint>
 #include <iostream>
 
 // Parses Binance Spot Partial Book Depth stream (depth20@100ms).
@@ -22,15 +25,37 @@ class BinanceBookParser : public IBookParser {
 public:
     BinanceBookParser() = default;
 
-    bool parse(const std::string& raw, std::vector<BookEvent>& out) override {
+    // Venue symbol of a frame without parsing it (WS multiplexing):
+    // "btcusdt@depth20@100ms" -> "btcusdt". Empty for SUBSCRIBE acks.
+    static std::string_view peek_symbol(std::string_view raw) {
+        const std::string_view stream = venues::peek_string_field(raw, "stream");
+        return stream.substr(0, stream.find('@'));
+    }
+
+    bool parse(const std::string& raw, BookEventBatch& out) override {
+        const auto mark = out.mark();
+        const std::uint64_t last_update_id = last_update_id_;
+        switch (scan(raw, out)) {
+            case venues::ScanStatus::Produced: return true;
+            case venues::ScanStatus::NoEvents: return false;
+            case venues::ScanStatus::Fallback:
+                out.rewind(mark);
+                last_update_id_ = last_update_id; // the reparse sees the same id again
+                break;
+        }
+        return parse_generic(raw, out);
+    }
+
+    // Full simdjson walk: the fallback for frames scan() does not handle.
+    bool parse_generic(const std::string& raw, BookEventBatch& out) {
         // Accept either raw depth message (single stream) or wrapped (combined stream)
         const bool has_stream = raw.find("\"stream\"") != std::string::npos;
         const bool has_depth = raw.find("\"bids\"") != std::string::npos &&
                               raw.find("\"asks\"") != std::string::npos;
         if (!has_depth) return false;
 
-        simdjson::padded_string pj(raw);
-        auto doc_res = parser_.iterate(pj);
+        // Iterate the frame in place (pooled frames carry SIMDJSON padding).
+        auto doc_res = parser_.iterate(venues::padded_frame(raw, scratch_));
         if (auto err = doc_res.error()) {
             std::cerr << "[binance-parser] iterate error: " << err << "\n";
             return false;
@@ -38,17 +63,16 @@ public:
         simdjson::ondemand::document doc = std::move(doc_res.value());
 
         simdjson::ondemand::object data_obj;
-        std::string canonical;
+        md::SymbolId symbol = md::kNoSymbol;
 
         if (has_stream) {
             std::string_view stream_sv;
             if (doc["stream"].get_string().get(stream_sv)) return false;
             // "btcusdt@depth20@100ms" -> "btcusdt"
-            std::string stream_str(stream_sv);
-            const std::size_t at = stream_str.find('@');
-            const std::string venue_sym = (at != std::string::npos)
-                ? stream_str.substr(0, at) : stream_str;
-            canonical = SymbolCodec::to_canonical("binance", venue_sym);
+            const std::string_view venue_sym = stream_sv.substr(0, stream_sv.find('@'));
+            symbol = symbols_.get(venue_sym, [](std::string_view v) {
+                return SymbolCodec::to_canonical("binance", std::string(v));
+            });
 
             if (doc["data"].get_object().get(data_obj)) return false;
         } else {
@@ -57,44 +81,139 @@ public:
             return false;
         }
 
-        const auto now_ns = monotonic_ns();
+        // Each frame is a full top-20 snapshot, so a skipped lastUpdateId is no
+        // gap; an older one is a stale frame and is dropped.
+        std::uint64_t update_id = 0;
+        if (!data_obj["lastUpdateId"].get_uint64().get(update_id)) {
+            if (update_id <= last_update_id_) return false;
+            last_update_id_ = update_id;
+        }
+
+        last_symbol_ = symbol;
+        out.begin(BookEventKind::Snapshot, venue_id_, symbol, monotonic_ns(), update_id);
+        emit_side(data_obj, "bids", BookSide::Bid, out);
+        emit_side(data_obj, "asks", BookSide::Ask, out);
+        return out.commit();
+    }
+
+    // GET api.binance.com/api/v3/depth: {"lastUpdateId":N,"bids":[["px","qty"]],"asks":[...]}
+    // Same update-id space as the stream, so Book skips it if frames overtook it.
+    bool parse_rest_snapshot(const std::string& body, BookEventBatch& out) override {
+        if (last_symbol_ == md::kNoSymbol) return false;
+        auto doc_res = parser_.iterate(venues::padded_frame(body, scratch_));
+        if (doc_res.error()) return false;
+        simdjson::ondemand::document doc = std::move(doc_res.value());
 
-        BookEventSnapshot snap;
-        snap.venue  = "Binance";
-        snap.symbol = canonical;
-        snap.ts_ns  = now_ns;
+        simdjson::ondemand::object data_obj;
+        if (doc.get_object().get(data_obj)) return false;
+        std::uint64_t update_id = 0;
+        if (data_obj["lastUpdateId"].get_uint64().get(update_id)) return false;
+
+        out.begin(BookEventKind::Snapshot, venue_id_, last_symbol_, monotonic_ns(), update_id);
+        emit_side(data_obj, "bids", BookSide::Bid, out);
+        emit_side(data_obj, "asks", BookSide::Ask, out);
+        return out.commit();
+    }
 
-        emit_side(data_obj, "bids", canonical, BookSide::Bid, now_ns, snap.levels);
-        emit_side(data_obj, "asks", canonical, BookSide::Ask, now_ns, snap.levels);
+    void reset_sequence() override { last_update_id_ = 0; }
 
-        if (!snap.levels.empty()) {
-            out.emplace_back(std::move(snap));
-            return true;
+private:
+    // One-pass scanner for the combined-stream schema:
+    // {"stream":"btcusdt@depth20@100ms","data":{"lastUpdateId":N,"bids":[["px","qty"]],"asks":[...]}}
+    venues::ScanStatus scan(std::string_view raw, BookEventBatch& out) {
+        using venues::ScanStatus;
+        venues::JsonScanner js(raw);
+        if (!js.begin_object()) return ScanStatus::Fallback;
+
+        md::SymbolId symbol = md::kNoSymbol;
+        bool produced = false;
+        std::string_view key;
+        while (js.next_key(key)) {
+            if (key == "stream") {
+                std::string_view stream;
+                if (!js.string(stream)) break;
+                const std::string_view venue_sym = stream.substr(0, stream.find('@'));
+                symbol = symbols_.get(venue_sym, [](std::string_view v) {
+                    return SymbolCodec::to_canonical("binance", std::string(v));
+                });
+            } else if (key == "data") {
+                if (symbol == md::kNoSymbol) return ScanStatus::Fallback;
+                switch (scan_depth(js, symbol, out)) {
+                    case ScanStatus::Produced: produced = true; break;
+                    case ScanStatus::NoEvents: return ScanStatus::NoEvents; // stale frame
+                    case ScanStatus::Fallback: return ScanStatus::Fallback;
+                }
+            } else if (!js.skip_value()) {
+                break;
+            }
         }
-        return false;
+        if (js.failed()) return ScanStatus::Fallback;
+        return produced ? ScanStatus::Produced : ScanStatus::NoEvents;
+    }
+
+    venues::ScanStatus scan_depth(venues::JsonScanner& js, md::SymbolId symbol, BookEventBatch& out) {
+        using venues::ScanStatus;
+        if (!js.begin_object()) return ScanStatus::Fallback;
+        bool open = false;
+        std::string_view key;
+        while (js.next_key(key)) {
+            if (key == "lastUpdateId") {
+                std::uint64_t update_id = 0;
+                if (open || !js.uint64(update_id)) return ScanStatus::Fallback;
+                if (update_id <= last_update_id_) return ScanStatus::NoEvents;
+                last_update_id_ = update_id;
+                last_symbol_ = symbol;
+                out.begin(BookEventKind::Snapshot, venue_id_, symbol, monotonic_ns(), update_id);
+                open = true;
+            } else if (key == "bids" || key == "asks") {
+                if (!open || !scan_levels(js, key == "bids" ? BookSide::Bid : BookSide::Ask, out)) {
+                    return ScanStatus::Fallback;
+                }
+            } else if (!js.skip_value()) {
+                return ScanStatus::Fallback;
+            }
+        }
+        if (js.failed() || !open) return ScanStatus::Fallback;
+        return out.commit() ? ScanStatus::Produced : ScanStatus::NoEvents;
+    }
+
+    static bool scan_levels(venues::JsonScanner& js, BookSide side, BookEventBatch& out) {
+        if (!js.begin_array()) return false;
+        while (js.next_element()) {
+            if (!js.begin_array()) return false;
+            std::string_view px_sv, qty_sv;
+            std::size_t idx = 0;
+            while (js.next_element()) {
+                bool ok = true;
+                if (idx == 0)      ok = js.string(px_sv);
+                else if (idx == 1) ok = js.string(qty_sv);
+                else               ok = js.skip_value();
+                if (!ok) return false;
+                ++idx;
+            }
+            if (js.failed()) return false;
+            md::PriceTicks px = 0;
+            md::SizeLots qty = 0;
+            if (idx < 2) continue;
+            if (!md::parse_price(px_sv, px) || !md::parse_size(qty_sv, qty)) {
+                out.reject_level();
+                continue;
+            }
+            if (px <= 0 || qty <= 0) continue;
+            out.add_level(side, px, qty);
+        }
+        return !js.failed();
     }
 
-private:
     static std::int64_t monotonic_ns() {
         using namespace std::chrono;
         return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
     }
 
-    static double fast_atof(std::string_view sv) {
-        constexpr std::size_t kBufSize = 32;
-        if (sv.empty() || sv.size() >= kBufSize) return 0.0;
-        char buf[kBufSize];
-        sv.copy(buf, sv.size());
-        buf[sv.size()] = '\0';
-        return std::strtod(buf, nullptr);
-    }
-
     static void emit_side(simdjson::ondemand::object& obj,
                           const char* key,
-                          const std::string& canonical,
                           BookSide side,
-                          std::int64_t ts_ns,
-                          std::vector<BookEventDelta>& levels) {
+                          BookEventBatch& out) {
         auto arr_res = obj[key].get_array();
         if (arr_res.error()) return;
         auto arr = arr_res.value();
@@ -114,21 +233,21 @@ private:
             }
             if (idx < 2) continue;
 
-            const double px = fast_atof(px_sv);
-            const double qty = fast_atof(qty_sv);
-            if (px <= 0.0 || qty <= 0.0) continue;
-
-            BookEventDelta d;
-            d.venue  = "Binance";
-            d.symbol = canonical;
-            d.side   = side;
-            d.price  = px;
-            d.size   = qty;
-            d.op     = BookOp::Upsert;
-            d.ts_ns  = ts_ns;
-            levels.emplace_back(std::move(d));
+            md::PriceTicks px = 0;
+            md::SizeLots qty = 0;
+            if (!md::parse_price(px_sv, px) || !md::parse_size(qty_sv, qty)) {
+                out.reject_level();
+                continue;
+            }
+            if (px <= 0 || qty <= 0) continue;
+            out.add_level(side, px, qty);
         }
     }
 
+    const md::VenueId venue_id_ = md::venue_ids().intern("Binance");
+    md::SymbolIdCache symbols_; // stream symbol -> canonical id, filled on first sight
+    md::SymbolId last_symbol_{md::kNoSymbol}; // stream symbol, for REST resnapshots
+    std::uint64_t last_update_id_{0};
     simdjson::ondemand::parser parser_;
+    simdjson::padded_string scratch_; // fallback copy for unpadded frames
 };
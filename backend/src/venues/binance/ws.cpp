@@ -1,4 +1,6 @@
 #include "ws.hpp"
+#include "venues/http_json.hpp"
+#include "venues/ws_session.hpp"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
@@ -6,7 +8,10 @@
 #include <boost/asio/ip/tcp.hpp>
 #include <openssl/ssl.h>
 #include <atomic>
+#include <cctype>
+#include <cstdint>
 #include <memory>
+#include <vector>
 #include <iostream>
 
 namespace beast = boost::beast;
@@ -21,10 +26,12 @@ struct BinanceWs::Impl
     std::string symbol;
     OnMsg on_msg;
 
-    net::io_context ioc{1};
+    std::unique_ptr<net::io_context> ioc; // blocking start() only
     net::ssl::context ssl_ctx{net::ssl::context::tls_client};
     std::unique_ptr<websocket::stream<beast::ssl_stream<tcp::socket>>> ws;
     std::atomic<bool> stop_flag{false};
+    std::shared_ptr<AsyncWsSession> session; // start_async() only
+    std::uint64_t request_id{0};             // SUBSCRIBE/UNSUBSCRIBE ids
 
     Impl(std::string sym, OnMsg cb)
         : symbol(std::move(sym)), on_msg(std::move(cb))
@@ -33,18 +40,38 @@ struct BinanceWs::Impl
         ssl_ctx.set_verify_mode(net::ssl::verify_peer);
     }
 
+    static std::string stream_name(const std::string& sym)
+    {
+        return sym + "@depth20@100ms";
+    }
+
+    std::string stream_path() const
+    {
+        return "/stream?streams=" + stream_name(symbol);
+    }
+
+    // Extra streams on a live combined-stream connection (the constructor symbol
+    // is already in the URL).
+    std::vector<std::string> subscription_messages(const std::string& sym, bool subscribe)
+    {
+        return {std::string("{\"method\":\"") + (subscribe ? "SUBSCRIBE" : "UNSUBSCRIBE")
+              + "\",\"params\":[\"" + stream_name(sym) + "\"],\"id\":"
+              + std::to_string(++request_id) + "}"};
+    }
+
     void run(unsigned short port)
     {
         try
         {
             // Combined stream: /stream?streams=<symbol>@depth20@100ms
             // Parser expects wrapped format {"stream":"...","data":{...}}
-            std::string path = "/stream?streams=" + symbol + "@depth20@100ms";
+            std::string path = stream_path();
 
-            tcp::resolver resolver{ioc};
+            ioc = std::make_unique<net::io_context>(1);
+            tcp::resolver resolver{*ioc};
             auto const results = resolver.resolve(host, std::to_string(port));
 
-            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(ioc, ssl_ctx);
+            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(*ioc, ssl_ctx);
 
             net::connect(beast::get_lowest_layer(*ws), results);
 
@@ -63,10 +90,13 @@ struct BinanceWs::Impl
             }));
             ws->handshake(host, path);
 
-            beast::flat_buffer buffer;
+            // Frames are read straight into a string the feed can take ownership of
+            // (the callback may swap it out); the buffer is reused for the next read.
+            std::string frame;
             while (!stop_flag.load(std::memory_order_relaxed))
             {
-                buffer.clear();
+                frame.clear();
+                auto buffer = net::dynamic_buffer(frame);
                 beast::error_code ec;
                 ws->read(buffer, ec);
                 if (ec)
@@ -80,8 +110,7 @@ struct BinanceWs::Impl
                     }
                     throw beast::system_error{ec};
                 }
-                std::string data = beast::buffers_to_string(buffer.cdata());
-                if (on_msg) on_msg(data);
+                if (on_msg) on_msg(frame); // Callback with received message from websocket
             }
 
             if (ws) {
@@ -95,11 +124,34 @@ struct BinanceWs::Impl
         }
     }
 
+    // Same session as run(), driven by completion handlers on a shared io_context.
+    void run_async(net::io_context& shared_ioc, OnClosed on_closed, unsigned short port)
+    {
+        WsSessionSpec spec;
+        spec.tag = "binance-ws";
+        spec.host = host;
+        spec.port = std::to_string(port);
+        spec.path = stream_path();
+        spec.user_agent = "binance-ws-connector/0.1";
+        session = AsyncWsSession::launch(shared_ioc, std::move(spec), on_msg, std::move(on_closed));
+    }
+
+    // Live (un)subscribe on the start_async() session; see IMarketWs.
+    void send_subscription(const std::string& venue_symbol, bool subscribe)
+    {
+        if (!session) return;
+        for (auto& msg : subscription_messages(venue_symbol, subscribe)) session->send(std::move(msg));
+    }
+
     void stop() noexcept
     {
         stop_flag.store(true, std::memory_order_relaxed);
+        if (session) {
+            session->stop();
+            return;
+        }
         if (ws) {
-            net::post(ioc, [s = ws.get()] {
+            net::post(ws->get_executor(), [s = ws.get()] {
                 beast::error_code ec;
                 s->close(websocket::close_code::normal, ec);
                 beast::get_lowest_layer(*s).shutdown(tcp::socket::shutdown_both, ec);
@@ -115,4 +167,21 @@ BinanceWs::BinanceWs(std::string symbol, OnMsg cb)
 BinanceWs::~BinanceWs() { delete impl_; }
 
 void BinanceWs::start(unsigned short port) { impl_->run(port); }
+void BinanceWs::start_async(net::io_context& ioc, OnClosed on_closed, unsigned short port)
+{
+    impl_->run_async(ioc, std::move(on_closed), port);
+}
+void BinanceWs::subscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, true); }
+void BinanceWs::unsubscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, false); }
 void BinanceWs::stop() noexcept { impl_->stop(); }
+
+std::optional<std::string> BinanceWs::fetch_book_snapshot(const std::string& venue_symbol)
+{
+    // Matches the depth20 stream; REST symbols are upper case ("btcusdt" -> "BTCUSDT").
+    std::string symbol = venue_symbol;
+    for (auto& c : symbol) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+    return venues::http_json::https_get(
+        "api.binance.com",
+        "/api/v3/depth?symbol=" + symbol + "&limit=20",
+        "binance-ws-connector/0.1");
+}
@@ -10,10 +10,12 @@
 inline VenueFactory make_coinbase_factory() {
     VenueFactory factory;
     factory.name = "Coinbase";
-    factory.make_feed = [](const std::string& canonical) -> std::shared_ptr<IVenueFeed> {
+    auto mux = std::make_shared<WsMuxSlot<CoinbaseWs, CoinbaseBookParser>>();
+    factory.make_feed = [mux](const std::string& canonical,
+                              const FeedConfig& config) -> std::shared_ptr<IVenueFeed> {
         using Feed = VenueFeed<CoinbaseWs, CoinbaseBookParser>;
         return std::make_shared<Feed>(
-            "Coinbase", canonical, Backpressure::DropOldest);
+            "Coinbase", canonical, Backpressure::DropOldest, PublishPolicy{}, config, mux->get(config));
     };
     factory.make_api = []() -> std::unique_ptr<IVenueApi> {
         return std::make_unique<CoinbaseVenueApi>();
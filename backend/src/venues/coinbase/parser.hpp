@@ -1,31 +1,63 @@
 #pragma once
 #include "md/book_parser.hpp"
 #include "md/book_events.hpp"
+#include "md/fixed_point.hpp"
 #include "md/symbol_codec.hpp"
+#include "venues/frame_peek.hpp"
+#include "venues/json_scan.hpp"
+#include "venues/simdjson_frame.hpp"
+#include "venues/venue_time.hpp"
 
 #include <simdjson.h>
 #include <string>
-#include <vector>
 #include <chrono>
-#include <cstdlib>
+#include <cstdint>
+#include <utility>
 #include <iostream>
 
 class CoinbaseBookParser : public IBookParser {
 public:
     CoinbaseBookParser() = default;
 
-    bool parse(const std::string& raw, std::vector<BookEvent>& out) override {
+    // Venue symbol of a frame without parsing it (WS multiplexing); empty for
+    // connection-level frames such as heartbeats and subscription acks.
+    static std::string_view peek_symbol(std::string_view raw) {
+        return venues::peek_string_field(raw, "product_id");
+    }
+
+    bool parse(const std::string& raw, BookEventBatch& out) override {
+        const auto mark = out.mark();
+        const bool had_seq = have_seq_;
+        const std::uint64_t last_seq = last_seq_;
+        switch (scan(raw, out)) {
+            case venues::ScanStatus::Produced: return true;
+            case venues::ScanStatus::NoEvents: return false;
+            case venues::ScanStatus::Fallback:
+                out.rewind(mark);
+                have_seq_ = had_seq; // the reparse checks the same sequence_num again
+                last_seq_ = last_seq;
+                break;
+        }
+        return parse_generic(raw, out);
+    }
+
+    // Full simdjson walk: the fallback for frames scan() does not handle.
+    bool parse_generic(const std::string& raw, BookEventBatch& out) {
+        check_sequence(raw, out);
         if (raw.find("\"channel\":\"l2_data\"") == std::string::npos) return false;
 
-        // Make a safely padded copy for simdjson ondemand
-        simdjson::padded_string pj(raw);
-        auto doc_res = parser_.iterate(pj);
+        // Iterate the frame in place (pooled frames carry SIMDJSON padding).
+        auto doc_res = parser_.iterate(venues::padded_frame(raw, scratch_));
         if (auto err = doc_res.error()) {
             std::cerr << "[coinbase-parser] iterate error: " << err << "\n";
             return false;
         }
         simdjson::ondemand::document doc = std::move(doc_res.value());
 
+        std::int64_t venue_ts = 0;
+        std::string_view ts_sv;
+        if (!doc["timestamp"].get(ts_sv)) venues::parse_rfc3339_utc(ts_sv, venue_ts);
+
         // events[]
         auto events_res = doc["events"].get_array();
         if (auto err = events_res.error()) {
@@ -35,6 +67,7 @@ public:
         auto events = events_res.value();
 
         const auto now_ns = monotonic_ns();
+        bool produced = false;
 
         for (simdjson::ondemand::value ev_val : events) {
             simdjson::ondemand::object ev;
@@ -46,75 +79,205 @@ public:
             std::string_view type_sv, prod_sv;
             if (ev["type"].get(type_sv)) continue;
             if (ev["product_id"].get(prod_sv)) continue;
-            const std::string canonical = SymbolCodec::to_canonical("coinbase", std::string(prod_sv));
+
+            BookEventKind kind;
+            if (type_sv == "snapshot")    kind = BookEventKind::Snapshot;
+            else if (type_sv == "update") kind = BookEventKind::Delta;
+            else continue;
 
             simdjson::ondemand::array updates;
             if (ev["updates"].get(updates)) continue;
 
-            if (type_sv == "snapshot") {
-                BookEventSnapshot snap;
-                snap.venue  = "Coinbase";
-                snap.symbol = canonical;
-                snap.ts_ns  = now_ns;
-
-                for (auto u : updates) {
-                    simdjson::ondemand::object o;
-                    if (u.get_object().get(o)) continue;
-
-                    std::string_view side_sv, px_sv, qty_sv;
-                    if (o["side"].get(side_sv)) continue;
-                    if (o["price_level"].get(px_sv)) continue;   // usually strings
-                    if (o["new_quantity"].get(qty_sv)) continue; // usually strings
-
-                    BookEventDelta d;
-                    d.venue  = "Coinbase";
-                    d.symbol = snap.symbol;
-                    d.side   = (side_sv == "bid") ? BookSide::Bid : BookSide::Ask;
-                    d.price  = fast_atof(px_sv);
-                    d.size   = fast_atof(qty_sv);
-                    d.op     = (d.size == 0.0) ? BookOp::Delete : BookOp::Upsert;
-                    d.ts_ns  = now_ns;
-                    snap.levels.emplace_back(std::move(d));
+            const md::SymbolId symbol = symbols_.get(prod_sv, [](std::string_view v) {
+                return SymbolCodec::to_canonical("coinbase", std::string(v));
+            });
+            out.begin(kind, venue_id_, symbol, now_ns);
+            out.set_venue_ts(venue_ts);
+
+            for (auto u : updates) {
+                simdjson::ondemand::object o;
+                if (u.get_object().get(o)) continue;
+
+                std::string_view side_sv, px_sv, qty_sv;
+                if (o["side"].get(side_sv)) continue;
+                if (o["price_level"].get(px_sv)) continue;   // usually strings
+                if (o["new_quantity"].get(qty_sv)) continue; // usually strings
+
+                md::PriceTicks px = 0;
+                md::SizeLots qty = 0;
+                if (!md::parse_price(px_sv, px) || !md::parse_size(qty_sv, qty)) {
+                    out.reject_level();
+                    continue;
                 }
-                if (!snap.levels.empty()) out.emplace_back(std::move(snap));
-            } else if (type_sv == "update") {
-                for (auto u : updates) {
-                    simdjson::ondemand::object o;
-                    if (u.get_object().get(o)) continue;
-
-                    std::string_view side_sv, px_sv, qty_sv;
-                    if (o["side"].get(side_sv)) continue;
-                    if (o["price_level"].get(px_sv)) continue;
-                    if (o["new_quantity"].get(qty_sv)) continue;
-
-                    BookEventDelta d;
-                    d.venue  = "Coinbase";
-                    d.symbol = canonical;
-                    d.side   = (side_sv == "bid") ? BookSide::Bid : BookSide::Ask;
-                    d.price  = fast_atof(px_sv);
-                    d.size   = fast_atof(qty_sv);
-                    d.op     = (d.size == 0.0) ? BookOp::Delete : BookOp::Upsert;
-                    d.ts_ns  = now_ns;
-                    out.emplace_back(std::move(d));
+                out.add_level((side_sv == "bid") ? BookSide::Bid : BookSide::Ask, px, qty);
+            }
+            produced |= out.commit();
+        }
+        return produced;
+    }
+
+    // GET api.coinbase.com/api/v3/brokerage/market/product_book:
+    // {"pricebook":{"product_id":"BTC-USD","bids":[{"price":"..","size":".."}],"asks":[...],"time":".."}}
+    // No sequence: "time" is matched against the l2_data "timestamp" of buffered deltas.
+    bool parse_rest_snapshot(const std::string& body, BookEventBatch& out) override {
+        auto doc_res = parser_.iterate(venues::padded_frame(body, scratch_));
+        if (doc_res.error()) return false;
+        simdjson::ondemand::document doc = std::move(doc_res.value());
+
+        simdjson::ondemand::object book;
+        if (doc["pricebook"].get_object().get(book)) return false;
+        std::string_view prod_sv;
+        if (book["product_id"].get(prod_sv)) return false;
+
+        const md::SymbolId symbol = symbols_.get(prod_sv, [](std::string_view v) {
+            return SymbolCodec::to_canonical("coinbase", std::string(v));
+        });
+        out.begin(BookEventKind::Snapshot, venue_id_, symbol, monotonic_ns());
+        for (const auto& [key, side] : {std::pair{"bids", BookSide::Bid}, std::pair{"asks", BookSide::Ask}}) {
+            simdjson::ondemand::array levels;
+            if (book[key].get(levels)) continue;
+            for (auto l : levels) {
+                simdjson::ondemand::object o;
+                if (l.get_object().get(o)) continue;
+                std::string_view px_sv, qty_sv;
+                if (o["price"].get(px_sv) || o["size"].get(qty_sv)) continue;
+                md::PriceTicks px = 0;
+                md::SizeLots qty = 0;
+                if (!md::parse_price(px_sv, px) || !md::parse_size(qty_sv, qty)) {
+                    out.reject_level();
+                    continue;
                 }
+                out.add_level(side, px, qty);
             }
         }
-        return !out.empty();
+        std::string_view time_sv;
+        std::int64_t venue_ts = 0;
+        if (!book["time"].get(time_sv) && venues::parse_rfc3339_utc(time_sv, venue_ts)) out.set_venue_ts(venue_ts);
+        return out.commit();
     }
 
+    void reset_sequence() override { have_seq_ = false; }
+    void set_shared_connection(bool shared) override { check_seq_ = !shared; }
+
 private:
+    // One-pass scanner for the l2_data schema:
+    // {"channel":"l2_data","timestamp":"..",...,"events":[{"type":"snapshot"|"update","product_id":"BTC-USD",
+    //   "updates":[{"side":"bid","event_time":"..","price_level":"..","new_quantity":".."}]}]}
+    venues::ScanStatus scan(std::string_view raw, BookEventBatch& out) {
+        using venues::ScanStatus;
+        venues::JsonScanner js(raw);
+        if (!js.begin_object()) return ScanStatus::Fallback;
+
+        std::string_view channel, timestamp;
+        bool produced = false;
+        std::string_view key;
+        while (js.next_key(key)) {
+            if (key == "channel") {
+                if (!js.string(channel)) break;
+            } else if (key == "timestamp") {
+                if (!js.string(timestamp)) break;
+            } else if (key == "sequence_num") {
+                std::uint64_t seq = 0;
+                if (!js.uint64(seq)) break;
+                check_sequence(seq, out); // every channel, heartbeats included
+            } else if (key == "events" && channel != "l2_data") {
+                if (channel.empty()) return ScanStatus::Fallback;
+                if (!js.skip_value()) break;
+            } else if (key == "events") {
+                if (!js.begin_array()) break;
+                const auto now_ns = monotonic_ns();
+                std::int64_t venue_ts = 0; // 0 if "timestamp" is missing or follows "events"
+                venues::parse_rfc3339_utc(timestamp, venue_ts);
+                while (js.next_element()) {
+                    if (!scan_event(js, now_ns, venue_ts, out, produced)) return ScanStatus::Fallback;
+                }
+            } else if (!js.skip_value()) {
+                break;
+            }
+        }
+        if (js.failed() || channel.empty()) return ScanStatus::Fallback;
+        return produced ? ScanStatus::Produced : ScanStatus::NoEvents;
+    }
+
+    bool scan_event(venues::JsonScanner& js, std::int64_t now_ns, std::int64_t venue_ts, BookEventBatch& out,
+                    bool& produced) {
+        if (!js.begin_object()) return false;
+        std::string_view key, type, product;
+        while (js.next_key(key)) {
+            if (key == "type") {
+                if (!js.string(type)) return false;
+            } else if (key == "product_id") {
+                if (!js.string(product)) return false;
+            } else if (key == "updates") {
+                BookEventKind kind;
+                if (type == "snapshot")    kind = BookEventKind::Snapshot;
+                else if (type == "update") kind = BookEventKind::Delta;
+                else return false; // levels before type/product_id
+                if (product.empty() || !js.begin_array()) return false;
+
+                const md::SymbolId symbol = symbols_.get(product, [](std::string_view v) {
+                    return SymbolCodec::to_canonical("coinbase", std::string(v));
+                });
+                out.begin(kind, venue_id_, symbol, now_ns);
+                out.set_venue_ts(venue_ts);
+                while (js.next_element()) {
+                    if (!scan_update(js, out)) return false;
+                }
+                if (js.failed()) return false;
+                produced |= out.commit();
+            } else if (!js.skip_value()) {
+                return false;
+            }
+        }
+        return !js.failed();
+    }
+
+    static bool scan_update(venues::JsonScanner& js, BookEventBatch& out) {
+        if (!js.begin_object()) return false;
+        std::string_view key, side, px_sv, qty_sv;
+        bool ok = true;
+        while (ok && js.next_key(key)) {
+            if (key == "side")              ok = js.string(side);
+            else if (key == "price_level")  ok = js.number_token(px_sv);
+            else if (key == "new_quantity") ok = js.number_token(qty_sv);
+            else                            ok = js.skip_value();
+        }
+        if (!ok || js.failed()) return false;
+        md::PriceTicks px = 0;
+        md::SizeLots qty = 0;
+        if (side.empty()) return true; // skipped, as in parse_generic
+        if (!md::parse_price(px_sv, px) || !md::parse_size(qty_sv, qty)) {
+            out.reject_level();
+            return true;
+        }
+        out.add_level(side == "bid" ? BookSide::Bid : BookSide::Ask, px, qty);
+        return true;
+    }
+
+    // sequence_num is connection-wide: every frame (heartbeats and acks included)
+    // increments it, so a skipped number means a lost frame of some channel.
+    void check_sequence(const std::string& raw, BookEventBatch& out) {
+        std::uint64_t seq = 0;
+        if (venues::peek_uint_field(raw, "sequence_num", seq)) check_sequence(seq, out);
+    }
+
+    void check_sequence(std::uint64_t seq, BookEventBatch& out) {
+        if (!check_seq_) return;
+        if (have_seq_ && seq != last_seq_ + 1) out.mark_gap();
+        last_seq_ = seq;
+        have_seq_ = true;
+    }
+
     static std::int64_t monotonic_ns() {
         using namespace std::chrono;
         return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
     }
-    static double fast_atof(std::string_view sv) {
-        constexpr std::size_t kBufSize = 32;
-        if (sv.empty() || sv.size() >= kBufSize) return 0.0;
-        char buf[kBufSize];
-        sv.copy(buf, sv.size());
-        buf[sv.size()] = '\0';
-        return std::strtod(buf, nullptr);
-    }
 
+    const md::VenueId venue_id_ = md::venue_ids().intern("Coinbase");
+    md::SymbolIdCache symbols_; // product_id -> canonical id, filled on first sight
+    bool check_seq_{true};      // off on a shared (multiplexed) connection
+    bool have_seq_{false};
+    std::uint64_t last_seq_{0};
     simdjson::ondemand::parser parser_;
+    simdjson::padded_string scratch_; // fallback copy for unpadded frames
 };
@@ -1,4 +1,6 @@
 #include "ws.hpp"
+#include "venues/http_json.hpp"
+#include "venues/ws_session.hpp"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
@@ -8,6 +10,7 @@
 #include <openssl/ssl.h>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <iostream>
 
 namespace beast = boost::beast;
@@ -23,10 +26,11 @@ struct CoinbaseWs::Impl
     std::string product;
     OnMsg on_msg;
 
-    net::io_context ioc{1};
+    std::unique_ptr<net::io_context> ioc; // blocking start() only
     net::ssl::context ssl_ctx{net::ssl::context::tls_client};
     std::unique_ptr<websocket::stream<beast::ssl_stream<tcp::socket>>> ws;
     std::atomic<bool> stop_flag{false};
+    std::shared_ptr<AsyncWsSession> session; // start_async() only
 
     Impl(std::string product_id, OnMsg cb)
     : product(std::move(product_id)), on_msg(std::move(cb))
@@ -36,15 +40,28 @@ struct CoinbaseWs::Impl
         ssl_ctx.set_verify_mode(net::ssl::verify_peer);
     }
 
+    // level2 + heartbeats (un)subscribe frames for one product
+    std::vector<std::string> subscription_messages(const std::string& product_id, bool subscribe) const
+    {
+        const std::string type = subscribe ? "subscribe" : "unsubscribe";
+        return {
+            "{\"type\":\"" + type + "\",\"channel\":\"" + channel
+                + "\",\"product_ids\":[\"" + product_id + "\"]}",
+            "{\"type\":\"" + type + "\",\"channel\":\"heartbeats\""
+                + ",\"product_ids\":[\"" + product_id + "\"]}",
+        };
+    }
+
     void run(unsigned short port)
     {
         try
         {
-            tcp::resolver resolver{ioc};
+            ioc = std::make_unique<net::io_context>(1);
+            tcp::resolver resolver{*ioc};
             auto const results = resolver.resolve(host, std::to_string(port));
 
             // Make the socket + SSL + WS stack
-            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(ioc, ssl_ctx);
+            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(*ioc, ssl_ctx);
 
             // TCP connect
             net::connect(beast::get_lowest_layer(*ws), results);
@@ -70,22 +87,24 @@ struct CoinbaseWs::Impl
             // Subscribe to Level 2 (order book) for the product
             // Payload shape per Coinbase Advanced Trade WS: channel "level2"
             // {"type":"subscribe","channel":"level2","product_ids":["BTC-USD"]}
-            std::string sub = std::string("{\"type\":\"subscribe\",\"channel\":\"") + channel
-                            + "\",\"product_ids\":[\"" + product + "\"]}";
+            const auto subs = subscription_messages(product, true);
+            std::string sub = subs[0];
             ws->write(net::buffer(sub)  );
 
             // Subscribe to Coinbase heartbeats so illiquid pairs can still be
             // considered transport-live even when no L2 updates are emitted.
             // Docs: https://docs.cdp.coinbase.com/coinbase-app/advanced-trade-apis/websocket/websocket-channels
-            std::string hb_sub = std::string("{\"type\":\"subscribe\",\"channel\":\"heartbeats\"")
-                               + ",\"product_ids\":[\"" + product + "\"]}";
+            std::string hb_sub = subs[1];
             ws->write(net::buffer(hb_sub));
 
             // Loop to read messages from websocket, calling on_msg callback for each message received
-            beast::flat_buffer buffer;
+            // Frames are read straight into a string the feed can take ownership of
+            // (the callback may swap it out); the buffer is reused for the next read.
+            std::string frame;
             while (!stop_flag.load(std::memory_order_relaxed))
             {
-                buffer.clear();
+                frame.clear();
+                auto buffer = net::dynamic_buffer(frame);
                 beast::error_code ec;
                 ws->read(buffer, ec);
                 if (ec)
@@ -101,8 +120,7 @@ struct CoinbaseWs::Impl
                     // Expected during stop() or orderly remote shutdown
                     throw beast::system_error{ec};
                 }
-                std::string data = beast::buffers_to_string(buffer.cdata());
-                if (on_msg) on_msg(data); // Callback with received message from websocket
+                if (on_msg) on_msg(frame); // Callback with received message from websocket
             }
 
             // Clean shutdown
@@ -117,11 +135,35 @@ struct CoinbaseWs::Impl
         }
     }
 
+    // Same session as run(), driven by completion handlers on a shared io_context.
+    void run_async(net::io_context& shared_ioc, OnClosed on_closed, unsigned short port)
+    {
+        WsSessionSpec spec;
+        spec.tag = "coinbase-ws";
+        spec.host = host;
+        spec.port = std::to_string(port);
+        spec.path = "/";
+        spec.user_agent = "coinbase-ws-connector/0.3";
+        spec.subscribe = subscription_messages(product, true);
+        session = AsyncWsSession::launch(shared_ioc, std::move(spec), on_msg, std::move(on_closed));
+    }
+
+    // Live (un)subscribe on the start_async() session; see IMarketWs.
+    void send_subscription(const std::string& venue_symbol, bool subscribe)
+    {
+        if (!session) return;
+        for (auto& msg : subscription_messages(venue_symbol, subscribe)) session->send(std::move(msg));
+    }
+
     void stop() noexcept
     {
         stop_flag.store(true, std::memory_order_relaxed);
+        if (session) {
+            session->stop();
+            return;
+        }
         if (ws) {
-            net::post(ioc, [s = ws.get()] {
+            net::post(ws->get_executor(), [s = ws.get()] {
                 beast::error_code ec;
                 s->close(websocket::close_code::normal, ec);         // WS close frame
                 beast::get_lowest_layer(*s).shutdown(tcp::socket::shutdown_both, ec);
@@ -136,4 +178,18 @@ CoinbaseWs::~CoinbaseWs() { delete impl_; }
 
 // The outer class methods just forward to the implementation
 void CoinbaseWs::start(unsigned short port) { impl_->run(port); }
+void CoinbaseWs::start_async(net::io_context& ioc, OnClosed on_closed, unsigned short port)
+{
+    impl_->run_async(ioc, std::move(on_closed), port);
+}
+void CoinbaseWs::subscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, true); }
+void CoinbaseWs::unsubscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, false); }
 void CoinbaseWs::stop() noexcept { impl_->stop(); }
+
+std::optional<std::string> CoinbaseWs::fetch_book_snapshot(const std::string& venue_symbol)
+{
+    return venues::http_json::https_get(
+        "api.coinbase.com",
+        "/api/v3/brokerage/market/product_book?product_id=" + venue_symbol + "&limit=1000",
+        "coinbase-ws-connector/0.3");
+}
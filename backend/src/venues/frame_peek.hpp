@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+// Cheap field lookup on raw WS frames, ahead of the full simdjson parse.
+// Used to demultiplex frames from a shared (multi-symbol) connection and to read
+// connection-level sequence numbers without a full parse.
+namespace venues {
+
+namespace detail {
+
+inline bool is_json_space(char c) { return c == ' ' || c == '\t' || c == '\n' || c == '\r'; }
+
+// Offset of the first value character of `"key":` in `frame`, or npos.
+inline std::size_t find_field_value(std::string_view frame, std::string_view key) {
+    std::size_t pos = 0;
+    while ((pos = frame.find(key, pos)) != std::string_view::npos) {
+        const std::size_t key_end = pos + key.size();
+        if (pos == 0 || frame[pos - 1] != '"' || key_end >= frame.size() || frame[key_end] != '"') {
+            pos = key_end;
+            continue;
+        }
+
+        std::size_t i = key_end + 1;
+        while (i < frame.size() && is_json_space(frame[i])) ++i;
+        if (i >= frame.size() || frame[i] != ':') {
+            pos = key_end;
+            continue;
+        }
+        ++i;
+        while (i < frame.size() && is_json_space(frame[i])) ++i;
+        return i < frame.size() ? i : std::string_view::npos;
+    }
+    return std::string_view::npos;
+}
+
+} // namespace detail
+
+// Value of the first `"key":"value"` string field in `frame` (whitespace around
+// the colon tolerated). Empty if the key is absent or its value is not a string.
+inline std::string_view peek_string_field(std::string_view frame, std::string_view key) {
+    const std::size_t i = detail::find_field_value(frame, key);
+    if (i == std::string_view::npos || frame[i] != '"') return {};
+
+    const std::size_t begin = i + 1;
+    const std::size_t end = frame.find('"', begin);
+    if (end == std::string_view::npos) return {};
+    return frame.substr(begin, end - begin);
+}
+
+// Value of the first `"key":123` unsigned integer field in `frame`.
+// False if the key is absent or its value is not a plain unsigned integer.
+inline bool peek_uint_field(std::string_view frame, std::string_view key, std::uint64_t& out) {
+    std::size_t i = detail::find_field_value(frame, key);
+    if (i == std::string_view::npos || frame[i] < '0' || frame[i] > '9') return false;
+
+    std::uint64_t v = 0;
+    for (; i < frame.size() && frame[i] >= '0' && frame[i] <= '9'; ++i) {
+        v = v * 10 + static_cast<std::uint64_t>(frame[i] - '0');
+    }
+    out = v;
+    return true;
+}
+
+} // namespace venues
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string_view>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// Forward-only JSON cursor for the per-venue book scanners (venues/*/parser.hpp).
+// Each scanner walks one known frame schema in a single pass, dispatching on
+// keys as they arrive instead of looking them up, and hands number tokens
+// straight to md::parse_fixed. Anything outside the schema it was written for
+// (escaped strings, fields in an unexpected order, malformed input) makes the
+// scanner give up; the parser then rewinds the batch and runs its simdjson path.
+namespace venues {
+
+// Outcome of a schema scanner on one frame.
+enum class ScanStatus : std::uint8_t {
+    Produced, // book events appended
+    NoEvents, // well-formed frame with nothing for the book (acks, heartbeats)
+    Fallback  // outside the scanner's schema; reparse with simdjson
+};
+
+class JsonScanner {
+public:
+    explicit JsonScanner(std::string_view text) noexcept
+        : begin_(text.data()), p_(text.data()), end_(text.data() + text.size()) {}
+
+    bool failed() const noexcept { return failed_; }
+
+    // Enter an object/array (after optional whitespace).
+    bool begin_object() noexcept { return consume('{'); }
+    bool begin_array() noexcept { return consume('['); }
+
+    // Next member key of the current object, positioned on its value.
+    // False at the closing '}' (consumed) or on error (failed() set).
+    // Each call works on a local cursor and stores it once: the scanner lives
+    // in memory across calls, and a load/store of p_ per step would chain
+    // store-forwarding latency through the whole frame.
+    bool next_key(std::string_view& key) noexcept {
+        const char* p = skip_ws(p_);
+        if (p < end_ && *p == '}') {
+            p_ = p + 1;
+            return false;
+        }
+        if (p < end_ && *p == ',') p = skip_ws(p + 1);
+        if (p >= end_ || *p != '"') return fail();
+        const char* close = find_quote_or_escape(p + 1);
+        if (!close || *close == '\\') return fail();
+        key = std::string_view(p + 1, static_cast<std::size_t>(close - p - 1));
+        p = skip_ws(close + 1);
+        if (p >= end_ || *p != ':') return fail();
+        p_ = p + 1;
+        return true;
+    }
+
+    // Position on the next element of the current array.
+    // False at the closing ']' (consumed) or on error (failed() set).
+    bool next_element() noexcept {
+        const char* p = skip_ws(p_);
+        if (p < end_ && *p == ']') {
+            p_ = p + 1;
+            return false;
+        }
+        if (p < end_ && *p == ',') p = skip_ws(p + 1);
+        p_ = p;
+        return p < end_ || fail();
+    }
+
+    // String contents (quotes stripped). Escapes are not decoded: a backslash
+    // fails the scan so the simdjson fallback handles the frame.
+    bool string(std::string_view& out) noexcept {
+        const char* p = skip_ws(p_);
+        if (p >= end_ || *p != '"') return fail();
+        const char* close = find_quote_or_escape(p + 1);
+        if (!close || *close == '\\') return fail();
+        out = std::string_view(p + 1, static_cast<std::size_t>(close - p - 1));
+        p_ = close + 1;
+        return true;
+    }
+
+    // A decimal either quoted ("45283.5") or bare (45283.5): the token text.
+    bool number_token(std::string_view& out) noexcept {
+        const char* p = skip_ws(p_);
+        if (p < end_ && *p == '"') return string(out);
+        const char* begin = p;
+        while (p < end_ && is_number_char(*p)) ++p;
+        if (p == begin) return fail();
+        out = std::string_view(begin, static_cast<std::size_t>(p - begin));
+        p_ = p;
+        return true;
+    }
+
+    bool int64(std::int64_t& out) noexcept {
+        std::string_view tok;
+        if (!number_token(tok)) return false;
+        std::size_t i = 0;
+        const bool neg = !tok.empty() && tok[0] == '-';
+        if (neg) ++i;
+        if (i == tok.size()) return fail();
+        std::uint64_t v = 0;
+        for (; i < tok.size(); ++i) {
+            if (tok[i] < '0' || tok[i] > '9') return fail();
+            v = v * 10 + static_cast<std::uint64_t>(tok[i] - '0');
+        }
+        out = neg ? -static_cast<std::int64_t>(v) : static_cast<std::int64_t>(v);
+        return true;
+    }
+
+    bool uint64(std::uint64_t& out) noexcept {
+        std::int64_t v = 0;
+        if (!int64(v) || v < 0) return fail();
+        out = static_cast<std::uint64_t>(v);
+        return true;
+    }
+
+    // Skip one value of any type, nested containers included.
+    bool skip_value() noexcept {
+        const char* p = skip_ws(p_);
+        if (p >= end_) return fail();
+        if (*p == '"') {
+            p = skip_string(p);
+        } else if (*p == '{' || *p == '[') {
+            int depth = 0;
+            while (p && p < end_) {
+                const char c = *p;
+                if (c == '"') {
+                    p = skip_string(p);
+                    continue;
+                }
+                ++p;
+                if (c == '{' || c == '[') {
+                    ++depth;
+                } else if ((c == '}' || c == ']') && --depth == 0) {
+                    break;
+                }
+            }
+            if (depth != 0) p = nullptr;
+        } else {
+            const char* begin = p;
+            while (p < end_ && (is_number_char(*p) || (*p >= 'a' && *p <= 'z'))) ++p;
+            if (p == begin) p = nullptr;
+        }
+        if (!p) return fail();
+        p_ = p;
+        return true;
+    }
+
+private:
+    static bool is_number_char(char c) noexcept {
+        return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' || c == 'e' || c == 'E';
+    }
+
+    static bool is_ws(char c) noexcept { return c == ' ' || c == '\n' || c == '\r' || c == '\t'; }
+
+    const char* skip_ws(const char* p) const noexcept {
+        while (p < end_ && is_ws(*p)) ++p;
+        return p;
+    }
+
+    bool consume(char c) noexcept {
+        const char* p = skip_ws(p_);
+        if (p >= end_ || *p != c) return fail();
+        p_ = p + 1;
+        return true;
+    }
+
+    // First '"' or '\\' at or after `from` (null if none). The text is
+    // classified 64 bytes at a time into a bitmap, so locating the end of each
+    // string is a shift and a count-trailing-zeros rather than a byte loop with
+    // a data-dependent exit (the mispredicted branch dominates short strings).
+    const char* find_quote_or_escape(const char* from) noexcept {
+        while (from < end_) {
+            const char* base = begin_ + ((from - begin_) & ~std::ptrdiff_t{63});
+            if (base != block_) load_block(base);
+            const std::uint64_t bits = block_bits_ >> (from - base);
+            if (bits) return from + std::countr_zero(bits);
+            from = base + 64;
+        }
+        return nullptr;
+    }
+
+    void load_block(const char* base) noexcept {
+        block_ = base;
+        std::uint64_t bits = 0;
+#if defined(__SSE2__)
+        if (end_ - base >= 64) {
+            const __m128i quote = _mm_set1_epi8('"');
+            const __m128i escape = _mm_set1_epi8('\\');
+            for (int i = 0; i < 4; ++i) {
+                const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + 16 * i));
+                const __m128i hit = _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, escape));
+                bits |= static_cast<std::uint64_t>(static_cast<std::uint16_t>(_mm_movemask_epi8(hit))) << (16 * i);
+            }
+            block_bits_ = bits;
+            return;
+        }
+#endif
+        const std::ptrdiff_t n = end_ - base < 64 ? end_ - base : 64;
+        for (std::ptrdiff_t i = 0; i < n; ++i) {
+            if (base[i] == '"' || base[i] == '\\') bits |= std::uint64_t{1} << i;
+        }
+        block_bits_ = bits;
+    }
+
+    // Past the string opening at `p`, stepping over escapes (skipped values
+    // are never read); null if unterminated.
+    const char* skip_string(const char* p) noexcept {
+        const char* close = find_quote_or_escape(p + 1);
+        while (close && *close == '\\') {
+            if (end_ - close < 2) return nullptr;
+            close = find_quote_or_escape(close + 2);
+        }
+        return close ? close + 1 : nullptr;
+    }
+
+    bool fail() noexcept {
+        failed_ = true;
+        return false;
+    }
+
+    const char* begin_;
+    const char* p_;
+    const char* end_;
+    const char* block_{nullptr}; // 64-byte block classified in block_bits_
+    std::uint64_t block_bits_{0};
+    bool failed_{false};
+};
+
+} // namespace venues
@@ -10,10 +10,12 @@
 inline VenueFactory make_kraken_factory() {
     VenueFactory factory;
     factory.name = "Kraken";
-    factory.make_feed = [](const std::string& canonical) -> std::shared_ptr<IVenueFeed> {
+    auto mux = std::make_shared<WsMuxSlot<KrakenWs, KrakenBookParser>>();
+    factory.make_feed = [mux](const std::string& canonical,
+                              const FeedConfig& config) -> std::shared_ptr<IVenueFeed> {
         using Feed = VenueFeed<KrakenWs, KrakenBookParser>;
         return std::make_shared<Feed>(
-            "Kraken", canonical, Backpressure::DropOldest);
+            "Kraken", canonical, Backpressure::DropOldest, PublishPolicy{}, config, mux->get(config));
     };
     factory.make_api = []() -> std::unique_ptr<IVenueApi> {
         return std::make_unique<KrakenVenueApi>();
@@ -1,26 +1,48 @@
 #pragma once
 #include "md/book_parser.hpp"
 #include "md/book_events.hpp"
+#include "md/fixed_point.hpp"
 #include "md/symbol_codec.hpp"
+#include "venues/frame_peek.hpp"
+#include "venues/json_scan.hpp"
+#include "venues/simdjson_frame.hpp"
 
 #include <simdjson.h>
+#include <cstdint>
 #include <string>
-#include <vector>
 #include <chrono>
+#include <utility>
 #include <iostream>
 
 class KrakenBookParser : public IBookParser {
 public:
     KrakenBookParser() = default;
 
-    bool parse(const std::string& raw, std::vector<BookEvent>& out) override {
+    // Venue symbol of a frame without parsing it (WS multiplexing); empty for
+    // connection-level frames such as heartbeats and status.
+    static std::string_view peek_symbol(std::string_view raw) {
+        return venues::peek_string_field(raw, "symbol");
+    }
+
+    bool parse(const std::string& raw, BookEventBatch& out) override {
+        const auto mark = out.mark();
+        switch (scan(raw, out)) {
+            case venues::ScanStatus::Produced: return true;
+            case venues::ScanStatus::NoEvents: return false;
+            case venues::ScanStatus::Fallback: out.rewind(mark); break;
+        }
+        return parse_generic(raw, out);
+    }
+
+    // Full simdjson walk: the fallback for frames scan() does not handle.
+    bool parse_generic(const std::string& raw, BookEventBatch& out) {
         // Fast reject for irrelevant messages
         if (raw.find("\"channel\":\"book\"") == std::string::npos ||
             raw.find("\"method\":\"subscribe\"") != std::string::npos)
             return false;
 
-        simdjson::padded_string pj(raw);
-        auto doc_res = parser_.iterate(pj);
+        // Iterate the frame in place (pooled frames carry SIMDJSON padding).
+        auto doc_res = parser_.iterate(venues::padded_frame(raw, scratch_));
         if (auto err = doc_res.error()) {
             std::cerr << "[kraken-parser] iterate error: " << err << "\n";
             return false;
@@ -45,6 +67,11 @@ public:
         const auto now_ns = monotonic_ns();
         bool produced = false;
 
+        BookEventKind kind;
+        if (type_sv == "snapshot")    kind = BookEventKind::Snapshot;
+        else if (type_sv == "update") kind = BookEventKind::Delta;
+        else return false;
+
         for (simdjson::ondemand::value dv : data_arr) {
             simdjson::ondemand::object obj;
             if (dv.get_object().get(obj)) continue;
@@ -52,43 +79,203 @@ public:
             std::string_view sym_sv;
             if (obj["symbol"].get(sym_sv)) continue;
 
-            const std::string canonical = SymbolCodec::to_canonical("kraken", std::string(sym_sv));
+            const md::SymbolId symbol = symbols_.get(sym_sv, [](std::string_view v) {
+                return SymbolCodec::to_canonical("kraken", std::string(v));
+            });
+            last_symbol_ = symbol;
+            out.begin(kind, venue_id_, symbol, now_ns);
+            emit_side(obj, "bids", BookSide::Bid, out);
+            emit_side(obj, "asks", BookSide::Ask, out);
+            std::uint64_t crc = 0;
+            if (!obj["checksum"].get_uint64().get(crc)) out.set_checksum(static_cast<std::uint32_t>(crc));
+            produced |= out.commit();
+        }
+        return produced;
+    }
+
+    // CRC32 over the top 10 levels at the instrument's price/qty precision, which
+    // book frames cannot tell (JSON numbers drop trailing zeros), so verification
+    // starts once parse_instrument_info() has supplied it.
+    const md::ChecksumRule* checksum_rule() const override {
+        return have_precision_ ? &checksum_rule_ : nullptr;
+    }
+
+    // GET api.kraken.com/0/public/AssetPairs?pair=XBTUSD:
+    // {"error":[],"result":{"XXBTZUSD":{"altname":"XBTUSD","wsname":"XBT/USD",...,
+    //   "pair_decimals":1,"lot_decimals":8,...}}}
+    // pair_decimals / lot_decimals are the v2 instrument channel's
+    // price_precision / qty_precision.
+    bool parse_instrument_info(const std::string& body) override {
+        auto doc_res = parser_.iterate(venues::padded_frame(body, scratch_));
+        if (doc_res.error()) return false;
+        simdjson::ondemand::document doc = std::move(doc_res.value());
 
-            if (type_sv == "snapshot") {
-                BookEventSnapshot snap;
-                snap.venue  = "Kraken";
-                snap.symbol = canonical;
-                snap.ts_ns  = now_ns;
+        simdjson::ondemand::object result;
+        if (doc["result"].get_object().get(result)) return false;
+        for (auto field : result) {
+            simdjson::ondemand::object pair;
+            if (field.value().get_object().get(pair)) return false;
+            std::int64_t price_decimals = 0, qty_decimals = 0;
+            if (pair["pair_decimals"].get_int64().get(price_decimals)) return false;
+            if (pair["lot_decimals"].get_int64().get(qty_decimals)) return false;
+            if (price_decimals < 0 || price_decimals > kMaxDecimals ||
+                qty_decimals < 0 || qty_decimals > kMaxDecimals) {
+                return false;
+            }
+            checksum_rule_.price_decimals = static_cast<int>(price_decimals);
+            checksum_rule_.qty_decimals = static_cast<int>(qty_decimals);
+            have_precision_ = true;
+            return true; // single-pair query
+        }
+        return false;
+    }
 
-                // parse bids
-                emit_side(obj, "bids", canonical, BookSide::Bid, now_ns, snap.levels);
-                // parse asks
-                emit_side(obj, "asks", canonical, BookSide::Ask, now_ns, snap.levels);
+    // GET api.kraken.com/0/public/Depth:
+    // {"error":[],"result":{"XXBTZUSD":{"asks":[["price","volume",ts],...],"bids":[...]}}}
+    // The result key is Kraken's internal pair name, so the event takes the symbol
+    // of the WS stream being resynced.
+    bool parse_rest_snapshot(const std::string& body, BookEventBatch& out) override {
+        if (last_symbol_ == md::kNoSymbol) return false;
+        auto doc_res = parser_.iterate(venues::padded_frame(body, scratch_));
+        if (doc_res.error()) return false;
+        simdjson::ondemand::document doc = std::move(doc_res.value());
 
-                if (!snap.levels.empty()) {
-                    out.emplace_back(std::move(snap));
-                    produced = true;
+        simdjson::ondemand::object result;
+        if (doc["result"].get_object().get(result)) return false;
+        for (auto field : result) {
+            simdjson::ondemand::object book;
+            if (field.value().get_object().get(book)) return false;
+
+            out.begin(BookEventKind::Snapshot, venue_id_, last_symbol_, monotonic_ns());
+            for (const auto& [key, side] : {std::pair{"asks", BookSide::Ask}, std::pair{"bids", BookSide::Bid}}) {
+                simdjson::ondemand::array levels;
+                if (book[key].get(levels)) continue;
+                for (auto l : levels) {
+                    simdjson::ondemand::array row;
+                    if (l.get_array().get(row)) continue;
+                    std::string_view px_sv, qty_sv;
+                    std::size_t idx = 0;
+                    for (auto e : row) {
+                        if (idx == 0 && e.get_string().get(px_sv)) break;
+                        if (idx == 1 && e.get_string().get(qty_sv)) break;
+                        if (++idx == 2) break;
+                    }
+                    md::PriceTicks px = 0;
+                    md::SizeLots qty = 0;
+                    if (idx < 2) continue;
+                    if (!md::parse_price(px_sv, px) || !md::parse_size(qty_sv, qty)) {
+                        out.reject_level();
+                        continue;
+                    }
+                    out.add_level(side, px, qty);
                 }
-            } else if (type_sv == "update") {
-                emit_updates(obj, "bids", canonical, BookSide::Bid, now_ns, out, produced);
-                emit_updates(obj, "asks", canonical, BookSide::Ask, now_ns, out, produced);
             }
+            return out.commit(); // single-pair query
         }
-        return produced;
+        return false;
     }
 
 private:
+    // One-pass scanner for the v2 book schema:
+    // {"channel":"book","type":"snapshot"|"update","data":[{"symbol":"BTC/USD",
+    //   "bids":[{"price":45283.5,"qty":0.1}],"asks":[...],"checksum":3310070434,...}]}
+    venues::ScanStatus scan(std::string_view raw, BookEventBatch& out) {
+        using venues::ScanStatus;
+        venues::JsonScanner js(raw);
+        if (!js.begin_object()) return ScanStatus::Fallback;
+
+        bool book = false;
+        bool have_kind = false;
+        BookEventKind kind = BookEventKind::Delta;
+        bool produced = false;
+        std::string_view key;
+        while (js.next_key(key)) {
+            if (key == "channel") {
+                std::string_view channel;
+                if (!js.string(channel)) break;
+                if (channel != "book") return ScanStatus::NoEvents;
+                book = true;
+            } else if (key == "type") {
+                std::string_view type;
+                if (!js.string(type)) break;
+                if (type == "snapshot")    kind = BookEventKind::Snapshot;
+                else if (type == "update") kind = BookEventKind::Delta;
+                else return ScanStatus::NoEvents;
+                have_kind = true;
+            } else if (key == "method") {
+                return ScanStatus::NoEvents; // subscribe/unsubscribe acks
+            } else if (key == "data") {
+                if (!book || !have_kind || !js.begin_array()) return ScanStatus::Fallback;
+                const auto now_ns = monotonic_ns();
+                while (js.next_element()) {
+                    if (!scan_book(js, kind, now_ns, out, produced)) return ScanStatus::Fallback;
+                }
+            } else if (!js.skip_value()) {
+                break;
+            }
+        }
+        if (js.failed() || !book) return ScanStatus::Fallback;
+        return produced ? ScanStatus::Produced : ScanStatus::NoEvents;
+    }
+
+    bool scan_book(venues::JsonScanner& js, BookEventKind kind, std::int64_t now_ns,
+                   BookEventBatch& out, bool& produced) {
+        if (!js.begin_object()) return false;
+        bool open = false;
+        std::string_view key;
+        while (js.next_key(key)) {
+            if (key == "symbol") {
+                std::string_view sym;
+                if (open || !js.string(sym)) return false;
+                const md::SymbolId symbol = symbols_.get(sym, [](std::string_view v) {
+                    return SymbolCodec::to_canonical("kraken", std::string(v));
+                });
+                last_symbol_ = symbol;
+                out.begin(kind, venue_id_, symbol, now_ns);
+                open = true;
+            } else if (key == "bids" || key == "asks") {
+                if (!open || !scan_levels(js, key == "bids" ? BookSide::Bid : BookSide::Ask, out)) return false;
+            } else if (key == "checksum") {
+                std::uint64_t crc = 0;
+                if (!open || !js.uint64(crc)) return false;
+                out.set_checksum(static_cast<std::uint32_t>(crc));
+            } else if (!js.skip_value()) {
+                return false;
+            }
+        }
+        if (js.failed() || !open) return false;
+        produced |= out.commit();
+        return true;
+    }
+
+    bool scan_levels(venues::JsonScanner& js, BookSide side, BookEventBatch& out) {
+        if (!js.begin_array()) return false;
+        while (js.next_element()) {
+            if (!js.begin_object()) return false;
+            std::string_view key, px_tok, qty_tok;
+            while (js.next_key(key)) {
+                bool ok = true;
+                if (key == "price")    ok = js.number_token(px_tok);
+                else if (key == "qty") ok = js.number_token(qty_tok);
+                else                   ok = js.skip_value();
+                if (!ok) return false;
+            }
+            if (js.failed()) return false;
+            add_level_tokens(px_tok, qty_tok, side, out);
+        }
+        return !js.failed();
+    }
+
     static std::int64_t monotonic_ns() {
         using namespace std::chrono;
         return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
     }
 
-    static void emit_side(simdjson::ondemand::object& obj,
+    // Append one side's levels to the open event (snapshot or update alike).
+    void emit_side(simdjson::ondemand::object& obj,
                           const char* key,
-                          const std::string& canonical,
                           BookSide side,
-                          std::int64_t ts_ns,
-                          std::vector<BookEventDelta>& levels) {
+                          BookEventBatch& out) {
         auto arr_res = obj[key].get_array();
         if (arr_res.error()) return;
         auto arr = arr_res.value();
@@ -97,53 +284,36 @@ private:
             simdjson::ondemand::object level;
             if (elem.get_object().get(level)) continue;
 
-            double px = 0.0, qty = 0.0;
-            if (level["price"].get(px)) continue;
-            if (level["qty"].get(qty)) continue;
-
-            BookEventDelta d;
-            d.venue  = "Kraken";
-            d.symbol = canonical;
-            d.side   = side;
-            d.price  = px;
-            d.size   = qty;
-            d.op     = (qty == 0.0) ? BookOp::Delete : BookOp::Upsert;
-            d.ts_ns  = ts_ns;
-            levels.emplace_back(std::move(d));
+            // Kraken v2 sends price/qty as JSON numbers; read the raw token so the
+            // decimal digits land on the fixed-point grid without a double round trip.
+            std::string_view px_tok, qty_tok;
+            if (level["price"].raw_json_token().get(px_tok)) continue;
+            if (level["qty"].raw_json_token().get(qty_tok)) continue;
+
+            add_level_tokens(px_tok, qty_tok, side, out);
         }
     }
 
-    static void emit_updates(simdjson::ondemand::object& obj,
-                             const char* key,
-                             const std::string& canonical,
-                             BookSide side,
-                             std::int64_t ts_ns,
-                             std::vector<BookEvent>& out,
-                             bool& produced_flag) {
-        auto arr_res = obj[key].get_array();
-        if (arr_res.error()) return;
-        auto arr = arr_res.value();
-
-        for (auto elem : arr) {
-            simdjson::ondemand::object level;
-            if (elem.get_object().get(level)) continue;
-
-            double px = 0.0, qty = 0.0;
-            if (level["price"].get(px)) continue;
-            if (level["qty"].get(qty)) continue;
-
-            BookEventDelta d;
-            d.venue  = "Kraken";
-            d.symbol = canonical;
-            d.side   = side;
-            d.price  = px;
-            d.size   = qty;
-            d.op     = (qty == 0.0) ? BookOp::Delete : BookOp::Upsert;
-            d.ts_ns  = ts_ns;
-            out.emplace_back(std::move(d));
-            produced_flag = true;
+    // Convert one level's number tokens.
+    static void add_level_tokens(std::string_view px_tok, std::string_view qty_tok,
+                                 BookSide side, BookEventBatch& out) {
+        md::PriceTicks px = 0;
+        md::SizeLots qty = 0;
+        if (!md::parse_price(px_tok, px) || !md::parse_size(qty_tok, qty)) {
+            out.reject_level();
+            return;
         }
+        out.add_level(side, px, qty);
     }
 
+    const md::VenueId venue_id_ = md::venue_ids().intern("Kraken");
+    md::SymbolIdCache symbols_; // venue symbol -> canonical id, filled on first sight
+    md::SymbolId last_symbol_{md::kNoSymbol}; // stream symbol, for REST resnapshots
+    // Precision beyond this is no instrument's; rejected as a malformed reply.
+    static constexpr std::int64_t kMaxDecimals = 16;
+
+    md::ChecksumRule checksum_rule_{md::ChecksumStyle::Kraken, 10, 0, 0};
+    bool have_precision_{false}; // set by parse_instrument_info()
     simdjson::ondemand::parser parser_;
+    simdjson::padded_string scratch_; // fallback copy for unpadded frames
 };
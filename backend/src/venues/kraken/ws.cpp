@@ -1,4 +1,6 @@
 #include "ws.hpp"
+#include "venues/http_json.hpp"
+#include "venues/ws_session.hpp"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
@@ -8,6 +10,7 @@
 #include <openssl/ssl.h>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <iostream>
 
 namespace beast = boost::beast;
@@ -26,10 +29,11 @@ struct KrakenWs::Impl
     std::string trigger;
     OnMsg on_msg;
 
-    net::io_context ioc{1};
+    std::unique_ptr<net::io_context> ioc; // blocking start() only
     net::ssl::context ssl_ctx{net::ssl::context::tls_client};
     std::unique_ptr<websocket::stream<beast::ssl_stream<tcp::socket>>> ws;
     std::atomic<bool> stop_flag{false};
+    std::shared_ptr<AsyncWsSession> session; // start_async() only
 
     Impl(std::string sym, OnMsg cb, std::string ev)
     : symbol(std::move(sym)), trigger(std::move(ev)), on_msg(std::move(cb))
@@ -38,14 +42,22 @@ struct KrakenWs::Impl
         ssl_ctx.set_verify_mode(net::ssl::verify_peer);
     }
 
+    std::vector<std::string> subscription_messages(const std::string& sym, bool subscribe) const
+    {
+        return {std::string("{\"method\":\"") + (subscribe ? "subscribe" : "unsubscribe")
+              + "\",\"params\":{\"channel\":\"" + channel
+              + "\",\"symbol\":[\"" + sym + "\"],\"depth\":" + depth + "}}"};
+    }
+
     void run(unsigned short port)
     {
         try
         {
-            tcp::resolver resolver{ioc};
+            ioc = std::make_unique<net::io_context>(1);
+            tcp::resolver resolver{*ioc};
             auto const results = resolver.resolve(host, std::to_string(port));
 
-            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(ioc, ssl_ctx);
+            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(*ioc, ssl_ctx);
 
             // TCP connect
             net::connect(beast::get_lowest_layer(*ws), results);
@@ -71,15 +83,17 @@ struct KrakenWs::Impl
 
             // Subscribe to v2 "book" channel with depth preference
             // Docs pattern: {"method":"subscribe","params":{"channel":"book","symbol":["BTC/USD"],"depth":10}}
-            std::string body = std::string("{\"method\":\"subscribe\",\"params\":{\"channel\":\"") + channel
-                               + "\",\"symbol\":[\"" + symbol + "\"],\"depth\":" + depth + "}}";
+            std::string body = subscription_messages(symbol, true).front();
             ws->write(net::buffer(body));
             
             // Read loop — throw on unexpected errors; break on expected shutdown
-            beast::flat_buffer buffer;
+            // Frames are read straight into a string the feed can take ownership of
+            // (the callback may swap it out); the buffer is reused for the next read.
+            std::string frame;
             while (!stop_flag.load(std::memory_order_relaxed))
             {
-                buffer.clear();
+                frame.clear();
+                auto buffer = net::dynamic_buffer(frame);
                 beast::error_code ec;
                 ws->read(buffer, ec);
                 if (ec)
@@ -95,8 +109,7 @@ struct KrakenWs::Impl
                     // Anything else: escalate to outer catch
                     throw beast::system_error{ec};
                 }
-                std::string data = beast::buffers_to_string(buffer.cdata());
-                if (on_msg) on_msg(data); // Callback with received message from websocket
+                if (on_msg) on_msg(frame); // Callback with received message from websocket
             }
 
             if (ws) {
@@ -110,11 +123,36 @@ struct KrakenWs::Impl
         }
     }
 
+    // Same session as run(), driven by completion handlers on a shared io_context.
+    void run_async(net::io_context& shared_ioc, OnClosed on_closed, unsigned short port)
+    {
+        WsSessionSpec spec;
+        spec.tag = "kraken-ws";
+        spec.host = host;
+        spec.port = std::to_string(port);
+        spec.path = path;
+        spec.user_agent = "kraken-ws-connector/0.3";
+        spec.origin = "https://docs.kraken.com";
+        spec.subscribe = subscription_messages(symbol, true);
+        session = AsyncWsSession::launch(shared_ioc, std::move(spec), on_msg, std::move(on_closed));
+    }
+
+    // Live (un)subscribe on the start_async() session; see IMarketWs.
+    void send_subscription(const std::string& venue_symbol, bool subscribe)
+    {
+        if (!session) return;
+        for (auto& msg : subscription_messages(venue_symbol, subscribe)) session->send(std::move(msg));
+    }
+
     void stop() noexcept
     {
         stop_flag.store(true, std::memory_order_relaxed);
+        if (session) {
+            session->stop();
+            return;
+        }
         if (ws) {
-            net::post(ioc, [s = ws.get()] {
+            net::post(ws->get_executor(), [s = ws.get()] {
                 beast::error_code ec;
                 s->close(websocket::close_code::normal, ec);         // WS close frame
                 beast::get_lowest_layer(*s).shutdown(tcp::socket::shutdown_both, ec);
@@ -130,4 +168,41 @@ KrakenWs::KrakenWs(std::string symbol, OnMsg cb, std::string event_trigger)
 KrakenWs::~KrakenWs() { delete impl_; }
 
 void KrakenWs::start(unsigned short port) { impl_->run(port); }
+void KrakenWs::start_async(net::io_context& ioc, OnClosed on_closed, unsigned short port)
+{
+    impl_->run_async(ioc, std::move(on_closed), port);
+}
+void KrakenWs::subscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, true); }
+void KrakenWs::unsubscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, false); }
 void KrakenWs::stop() noexcept { impl_->stop(); }
+
+namespace {
+
+// REST pair names drop the separator and keep Kraken's XBT alias: "BTC/USD" -> "XBTUSD".
+std::string rest_pair(const std::string& venue_symbol)
+{
+    std::string pair;
+    for (char c : venue_symbol) {
+        if (c != '/') pair.push_back(c);
+    }
+    if (pair.rfind("BTC", 0) == 0) pair.replace(0, 3, "XBT");
+    return pair;
+}
+
+} // namespace
+
+std::optional<std::string> KrakenWs::fetch_book_snapshot(const std::string& venue_symbol)
+{
+    return venues::http_json::https_get(
+        "api.kraken.com",
+        "/0/public/Depth?pair=" + rest_pair(venue_symbol) + "&count=500",
+        "kraken-ws-connector/0.3");
+}
+
+std::optional<std::string> KrakenWs::fetch_instrument_info(const std::string& venue_symbol)
+{
+    return venues::http_json::https_get(
+        "api.kraken.com",
+        "/0/public/AssetPairs?pair=" + rest_pair(venue_symbol),
+        "kraken-ws-connector/0.3");
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include "venues/market_ws.hpp"
@@ -16,8 +17,20 @@ public:
     KrakenWs &operator=(KrakenWs &&) noexcept = default;
 
     void start(unsigned short port = 443) override;
+    void start_async(boost::asio::io_context &ioc, OnClosed on_closed,
+                     unsigned short port = 443) override;
+    void subscribe(const std::string &venue_symbol) override;
+    void unsubscribe(const std::string &venue_symbol) override;
     void stop() noexcept override;
 
+    // Blocking REST depth snapshot for in-place resyncs (body for
+    // KrakenBookParser::parse_rest_snapshot). nullopt on failure.
+    static std::optional<std::string> fetch_book_snapshot(const std::string &venue_symbol);
+
+    // Blocking REST AssetPairs query for the pair's price/qty precision (body
+    // for KrakenBookParser::parse_instrument_info). nullopt on failure.
+    static std::optional<std::string> fetch_instrument_info(const std::string &venue_symbol);
+
 private:
     struct Impl;
     Impl *impl_;
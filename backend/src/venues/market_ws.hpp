@@ -3,13 +3,40 @@
 #include <functional>
 #include <string>
 
+namespace boost::asio { class io_context; }
+
 // Interface for a market-data WebSocket connector.
-// start() spawns an internal I/O thread and returns immediately.
-// stop() requests a graceful close and joins the internal thread.
-// OnMsg(json): called for each text frame from the exchange.
+// start() runs the session on an internal io_context and returns once it ends;
+// callers give it a thread of its own.
+// start_async() instead runs the session as completion handlers on a shared
+// io_context (see WsIoPool) and returns immediately; on_closed fires once, on
+// that io_context's thread, when the session ends.
+// subscribe()/unsubscribe() add or drop an instrument on a live start_async()
+// session so one connection can carry many symbols (see md/ws_mux.hpp); the
+// blocking start() path serves only its constructor symbol and ignores them.
+// stop() requests a graceful close; it is safe to call from any thread.
+// OnMsg(frame): called for each text frame from the exchange, read straight into
+// the connector's buffer. The callee may take the frame by swapping the string
+// out (zero-copy handoff); connectors clear and reuse whatever is left.
+// Connectors may also provide a static, blocking
+//   std::optional<std::string> fetch_book_snapshot(const std::string& venue_symbol)
+// returning the venue's REST depth body; VenueFeed uses it to resync a book in
+// place after a sequence gap (connectors without it resync by reconnecting).
+// They may likewise provide
+//   std::optional<std::string> fetch_instrument_info(const std::string& venue_symbol)
+// returning instrument metadata for the parser (IBookParser::parse_instrument_info),
+// which VenueFeed fetches once per feed before verifying venue checksums.
+// Offline connectors (ReplayWs) declare `static constexpr bool kOffline = true`
+// and take the feed's venue name as a third constructor argument; VenueFeed
+// then never resets them for transport staleness.
 struct IMarketWs {
-    using OnMsg = std::function<void(const std::string &)>;
+    using OnMsg = std::function<void(std::string &)>;
+    using OnClosed = std::function<void()>;
     virtual ~IMarketWs() = default;
     virtual void start(unsigned short port = 443) = 0;
+    virtual void start_async(boost::asio::io_context &ioc, OnClosed on_closed,
+                             unsigned short port = 443) = 0;
+    virtual void subscribe(const std::string &venue_symbol) = 0;
+    virtual void unsubscribe(const std::string &venue_symbol) = 0;
     virtual void stop() = 0;
 };
@@ -10,10 +10,12 @@
 inline VenueFactory make_okx_factory() {
     VenueFactory factory;
     factory.name = "OKX";
-    factory.make_feed = [](const std::string& canonical) -> std::shared_ptr<IVenueFeed> {
+    auto mux = std::make_shared<WsMuxSlot<OkxWs, OkxBookParser>>();
+    factory.make_feed = [mux](const std::string& canonical,
+                              const FeedConfig& config) -> std::shared_ptr<IVenueFeed> {
         using Feed = VenueFeed<OkxWs, OkxBookParser>;
         return std::make_shared<Feed>(
-            "OKX", canonical, Backpressure::DropOldest);
+            "OKX", canonical, Backpressure::DropOldest, PublishPolicy{}, config, mux->get(config));
     };
     factory.make_api = []() -> std::unique_ptr<IVenueApi> {
         return std::make_unique<OkxVenueApi>();
@@ -1,14 +1,17 @@
 #pragma once
 #include "md/book_parser.hpp"
 #include "md/book_events.hpp"
+#include "md/fixed_point.hpp"
 #include "md/symbol_codec.hpp"
+#include "venues/frame_peek.hpp"
+#include "venues/json_scan.hpp"
+#include "venues/simdjson_frame.hpp"
+#include "venues/venue_time.hpp"
 
 #include <simdjson.h>
 #include <string>
-#include <vector>
 #include <chrono>
-#include <cstdlib>
-#include <cstring>
+#include <cstdint>
 #include <iostream>
 
 // Parses OKX Spot Order Book channel (books or books5).
@@ -20,15 +23,39 @@ class OkxBookParser : public IBookParser {
 public:
     OkxBookParser() = default;
 
-    bool parse(const std::string& raw, std::vector<BookEvent>& out) override {
+    // Venue symbol of a frame without parsing it (WS multiplexing); empty for
+    // connection-level frames such as pongs and errors.
+    static std::string_view peek_symbol(std::string_view raw) {
+        return venues::peek_string_field(raw, "instId");
+    }
+
+    bool parse(const std::string& raw, BookEventBatch& out) override {
+        const auto mark = out.mark();
+        const bool had_seq = have_seq_;
+        const std::int64_t last_seq = last_seq_;
+        switch (scan(raw, out)) {
+            case venues::ScanStatus::Produced: return true;
+            case venues::ScanStatus::NoEvents: return false;
+            case venues::ScanStatus::Fallback:
+                out.rewind(mark);
+                have_seq_ = had_seq; // the reparse checks the same seqIds again
+                last_seq_ = last_seq;
+                break;
+        }
+        return parse_generic(raw, out);
+    }
+
+    // Full simdjson walk: the fallback for frames scan() does not handle.
+    bool parse_generic(const std::string& raw, BookEventBatch& out) {
         if (raw.find("\"channel\":\"books") == std::string::npos &&
             raw.find("\"channel\":\"books5") == std::string::npos)
             return false;
         if (raw.find("\"data\"") == std::string::npos) return false;
 
-        simdjson::padded_string pj(raw);
+        // Parse the frame in place (pooled frames carry SIMDJSON padding).
+        const auto pj = venues::padded_frame(raw, scratch_);
         simdjson::dom::element doc;
-        if (parser_.parse(pj).get(doc)) return false;
+        if (parser_.parse(pj.data(), pj.size(), false).get(doc)) return false;
 
         // Skip non-data messages (subscribe ack has "event", not "data" as array of book data)
         simdjson::dom::object arg_obj;
@@ -36,7 +63,6 @@ public:
 
         std::string_view inst_sv;
         if (arg_obj["instId"].get_string().get(inst_sv)) return false;
-        const std::string canonical = SymbolCodec::to_canonical("okx", std::string(inst_sv));
 
         simdjson::dom::array data_arr;
         if (doc["data"].get_array().get(data_arr)) return false;
@@ -49,66 +75,230 @@ public:
         // Treat as snapshot unless explicitly action=="update" (incremental)
         const bool is_snapshot = is_books5 || !(has_action && action_sv == "update");
 
+        const md::SymbolId symbol = symbols_.get(inst_sv, [](std::string_view v) {
+            return SymbolCodec::to_canonical("okx", std::string(v));
+        });
+        const BookEventKind kind = is_snapshot ? BookEventKind::Snapshot : BookEventKind::Delta;
         const auto now_ns = monotonic_ns();
         bool produced = false;
 
+        last_symbol_ = symbol;
+
         for (simdjson::dom::element data_elem : data_arr) {
             simdjson::dom::object data_obj;
             if (data_elem.get_object().get(data_obj)) continue;
 
-            if (is_snapshot) {
-                BookEventSnapshot snap;
-                snap.venue  = "OKX";
-                snap.symbol = canonical;
-                snap.ts_ns  = now_ns;
+            const std::uint64_t seq = check_sequence(data_obj, is_snapshot, out);
+            out.begin(kind, venue_id_, symbol, now_ns, seq);
+            emit_side(data_obj, "bids", BookSide::Bid, out);
+            emit_side(data_obj, "asks", BookSide::Ask, out);
+            set_venue_ts(data_obj, out);
+            std::int64_t crc = 0;
+            if (!data_obj["checksum"].get_int64().get(crc)) {
+                out.set_checksum(static_cast<std::uint32_t>(static_cast<std::int32_t>(crc)));
+            }
+            produced |= out.commit();
+        }
+        return produced;
+    }
+
+    // GET www.okx.com/api/v5/market/books:
+    // {"code":"0","data":[{"asks":[["px","sz","0","n"]],"bids":[...],"ts":".."}]}
+    // The response has no instId; the event takes the symbol of the WS stream.
+    bool parse_rest_snapshot(const std::string& body, BookEventBatch& out) override {
+        if (last_symbol_ == md::kNoSymbol) return false;
+        const auto pj = venues::padded_frame(body, scratch_);
+        simdjson::dom::element doc;
+        if (parser_.parse(pj.data(), pj.size(), false).get(doc)) return false;
+
+        simdjson::dom::array data_arr;
+        if (doc["data"].get_array().get(data_arr)) return false;
+        for (simdjson::dom::element data_elem : data_arr) {
+            simdjson::dom::object data_obj;
+            if (data_elem.get_object().get(data_obj)) return false;
+            out.begin(BookEventKind::Snapshot, venue_id_, last_symbol_, monotonic_ns());
+            emit_side(data_obj, "bids", BookSide::Bid, out);
+            emit_side(data_obj, "asks", BookSide::Ask, out);
+            set_venue_ts(data_obj, out);
+            return out.commit();
+        }
+        return false;
+    }
+
+    void reset_sequence() override { have_seq_ = false; }
+
+    // Signed CRC32 over the top 25 bid/ask pairs in OKX's shortest strings.
+    const md::ChecksumRule* checksum_rule() const override { return &kChecksumRule; }
 
-                emit_side(data_obj, "bids", canonical, BookSide::Bid, now_ns, snap.levels);
-                emit_side(data_obj, "asks", canonical, BookSide::Ask, now_ns, snap.levels);
+private:
+    // One-pass scanner for the books/books5 schema:
+    // {"arg":{"channel":"books","instId":"BTC-USDT"},"action":"update","data":[{"asks":[["px","sz","0","n"]],
+    //   "bids":[...],"ts":"..","checksum":-855196043,"prevSeqId":123,"seqId":124}]}
+    // seqId and checksum follow the levels, so they are attached to the open event last.
+    venues::ScanStatus scan(std::string_view raw, BookEventBatch& out) {
+        using venues::ScanStatus;
+        venues::JsonScanner js(raw);
+        if (!js.begin_object()) return ScanStatus::Fallback;
 
-                if (!snap.levels.empty()) {
-                    out.emplace_back(std::move(snap));
-                    produced = true;
+        std::string_view channel, inst, action;
+        bool produced = false;
+        std::string_view key;
+        while (js.next_key(key)) {
+            if (key == "arg") {
+                if (!js.begin_object()) break;
+                while (js.next_key(key)) {
+                    bool ok = true;
+                    if (key == "channel")     ok = js.string(channel);
+                    else if (key == "instId") ok = js.string(inst);
+                    else                      ok = js.skip_value();
+                    if (!ok) break;
                 }
-            } else {
-                emit_updates(data_obj, "bids", canonical, BookSide::Bid, now_ns, out, produced);
-                emit_updates(data_obj, "asks", canonical, BookSide::Ask, now_ns, out, produced);
+                if (js.failed()) break;
+                if (channel != "books" && channel != "books5") return ScanStatus::NoEvents;
+            } else if (key == "event") {
+                return ScanStatus::NoEvents; // subscribe acks and errors
+            } else if (key == "action") {
+                if (!js.string(action)) break;
+            } else if (key == "data") {
+                const bool is_books5 = channel == "books5";
+                if (inst.empty() || (!is_books5 && action.empty()) || !js.begin_array()) {
+                    return ScanStatus::Fallback;
+                }
+                const bool is_snapshot = is_books5 || action != "update";
+                const md::SymbolId symbol = symbols_.get(inst, [](std::string_view v) {
+                    return SymbolCodec::to_canonical("okx", std::string(v));
+                });
+                last_symbol_ = symbol;
+                const auto now_ns = monotonic_ns();
+                while (js.next_element()) {
+                    out.begin(is_snapshot ? BookEventKind::Snapshot : BookEventKind::Delta,
+                              venue_id_, symbol, now_ns);
+                    if (!scan_data(js, is_snapshot, out)) return ScanStatus::Fallback;
+                    produced |= out.commit();
+                }
+            } else if (!js.skip_value()) {
+                break;
             }
         }
-        return produced;
+        if (js.failed() || channel.empty()) return ScanStatus::Fallback;
+        return produced ? ScanStatus::Produced : ScanStatus::NoEvents;
+    }
+
+    bool scan_data(venues::JsonScanner& js, bool is_snapshot, BookEventBatch& out) {
+        if (!js.begin_object()) return false;
+        std::int64_t seq = 0, prev = 0, crc = 0;
+        bool has_seq = false, has_prev = false, has_crc = false;
+        std::string_view key, ts_sv;
+        while (js.next_key(key)) {
+            bool ok = true;
+            if (key == "bids")           ok = scan_levels(js, BookSide::Bid, out);
+            else if (key == "asks")      ok = scan_levels(js, BookSide::Ask, out);
+            else if (key == "ts")        ok = js.number_token(ts_sv);
+            else if (key == "seqId")     ok = has_seq = js.int64(seq);
+            else if (key == "prevSeqId") ok = has_prev = js.int64(prev);
+            else if (key == "checksum")  ok = has_crc = js.int64(crc);
+            else                         ok = js.skip_value();
+            if (!ok) return false;
+        }
+        if (js.failed()) return false;
+        set_venue_ts(ts_sv, out);
+        if (has_seq) out.set_seq(check_sequence(seq, has_prev, prev, is_snapshot, out));
+        if (has_crc) out.set_checksum(static_cast<std::uint32_t>(static_cast<std::int32_t>(crc)));
+        return true;
+    }
+
+    static bool scan_levels(venues::JsonScanner& js, BookSide side, BookEventBatch& out) {
+        if (!js.begin_array()) return false;
+        while (js.next_element()) {
+            if (!js.begin_array()) return false;
+            std::string_view px_sv, sz_sv;
+            std::size_t idx = 0;
+            while (js.next_element()) {
+                bool ok = true;
+                if (idx == 0)      ok = js.number_token(px_sv);
+                else if (idx == 1) ok = js.number_token(sz_sv);
+                else               ok = js.skip_value();
+                if (!ok) return false;
+                ++idx;
+            }
+            if (js.failed()) return false;
+            md::PriceTicks px = 0;
+            md::SizeLots sz = 0;
+            if (idx < 2) continue;
+            if (!md::parse_price(px_sv, px) || !md::parse_size(sz_sv, sz)) {
+                out.reject_level();
+                continue;
+            }
+            if (px <= 0) continue;
+            out.add_level(side, px, sz);
+        }
+        return !js.failed();
+    }
+
+    // "ts" (epoch ms, the same clock on WS pushes and REST snapshots) onto the
+    // open event; the REST snapshot has no seqId to line deltas up against.
+    static void set_venue_ts(std::string_view ts_sv, BookEventBatch& out) {
+        std::int64_t ts_ns = 0;
+        if (venues::parse_epoch_ms(ts_sv, ts_ns)) out.set_venue_ts(ts_ns);
+    }
+
+    static void set_venue_ts(simdjson::dom::object& data_obj, BookEventBatch& out) {
+        std::string_view ts_sv;
+        if (!data_obj["ts"].get_string().get(ts_sv)) set_venue_ts(ts_sv, out);
+    }
+
+    // books: every push carries seqId and the previous push's prevSeqId (-1 on
+    // snapshots); a prevSeqId that is not our last seqId means a lost update.
+    // Returns seqId (0 if absent, e.g. books5).
+    std::uint64_t check_sequence(simdjson::dom::object& data_obj, bool is_snapshot, BookEventBatch& out) {
+        std::int64_t seq = 0, prev = 0;
+        if (data_obj["seqId"].get_int64().get(seq)) return 0;
+        const bool has_prev = !data_obj["prevSeqId"].get_int64().get(prev);
+        return check_sequence(seq, has_prev, prev, is_snapshot, out);
+    }
+
+    std::uint64_t check_sequence(std::int64_t seq, bool has_prev, std::int64_t prev,
+                                 bool is_snapshot, BookEventBatch& out) {
+        if (seq <= 0) return 0;
+        if (!is_snapshot && have_seq_ && has_prev && prev != last_seq_) out.mark_gap();
+        last_seq_ = seq;
+        have_seq_ = true;
+        return static_cast<std::uint64_t>(seq);
     }
 
-private:
     static std::int64_t monotonic_ns() {
         using namespace std::chrono;
         return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
     }
 
-    static double parse_price_or_size(simdjson::dom::element e) {
+    // OKX sends price/size as strings; parse them straight onto the fixed-point grid.
+    // Numeric elements (not expected) fall back to a double conversion.
+    static bool parse_price_or_size(simdjson::dom::element e, int decimals, std::int64_t& out) {
         switch (e.type()) {
             case simdjson::dom::element_type::STRING: {
                 std::string_view sv;
-                if (e.get_string().get(sv)) return 0.0;
-                std::string s(sv);
-                return std::strtod(s.c_str(), nullptr);
+                if (e.get_string().get(sv)) return false;
+                return decimals == md::kPriceDecimals ? md::parse_price(sv, out) : md::parse_size(sv, out);
             }
             case simdjson::dom::element_type::DOUBLE:
             case simdjson::dom::element_type::INT64:
             case simdjson::dom::element_type::UINT64: {
                 double v;
-                if (e.get_double().get(v)) return 0.0;
-                return v;
+                if (e.get_double().get(v)) return false;
+                out = decimals == md::kPriceDecimals ? md::price_from_double(v)
+                                                     : md::size_from_double(v);
+                return true;
             }
             default:
-                return 0.0;
+                return false;
         }
     }
 
+    // Append one side's levels to the open event (snapshot or update alike).
     static void emit_side(simdjson::dom::object& obj,
                           const char* key,
-                          const std::string& canonical,
                           BookSide side,
-                          std::int64_t ts_ns,
-                          std::vector<BookEventDelta>& levels) {
+                          BookEventBatch& out) {
         simdjson::dom::array arr;
         if (obj[key].get_array().get(arr)) return;
 
@@ -116,62 +306,32 @@ private:
             simdjson::dom::array level_arr;
             if (elem.get_array().get(level_arr)) continue;
 
-            double px = 0.0, sz = 0.0;
+            md::PriceTicks px = 0;
+            md::SizeLots sz = 0;
+            bool ok = true;
             std::size_t idx = 0;
             for (simdjson::dom::element e : level_arr) {
-                if (idx == 0) px = parse_price_or_size(e);
-                else if (idx == 1) sz = parse_price_or_size(e);
+                if (idx == 0) ok = parse_price_or_size(e, md::kPriceDecimals, px);
+                else if (idx == 1) ok = ok && parse_price_or_size(e, md::kSizeDecimals, sz);
                 ++idx;
             }
-            if (px <= 0.0) continue;
-
-            BookEventDelta d;
-            d.venue  = "OKX";
-            d.symbol = canonical;
-            d.side   = side;
-            d.price  = px;
-            d.size   = sz;
-            d.op     = (sz == 0.0) ? BookOp::Delete : BookOp::Upsert;
-            d.ts_ns  = ts_ns;
-            levels.emplace_back(std::move(d));
-        }
-    }
-
-    static void emit_updates(simdjson::dom::object& obj,
-                             const char* key,
-                             const std::string& canonical,
-                             BookSide side,
-                             std::int64_t ts_ns,
-                             std::vector<BookEvent>& out,
-                             bool& produced_flag) {
-        simdjson::dom::array arr;
-        if (obj[key].get_array().get(arr)) return;
-
-        for (simdjson::dom::element elem : arr) {
-            simdjson::dom::array level_arr;
-            if (elem.get_array().get(level_arr)) continue;
-
-            double px = 0.0, sz = 0.0;
-            std::size_t idx = 0;
-            for (simdjson::dom::element e : level_arr) {
-                if (idx == 0) px = parse_price_or_size(e);
-                else if (idx == 1) sz = parse_price_or_size(e);
-                ++idx;
+            if (idx < 2) continue;
+            if (!ok) {
+                out.reject_level();
+                continue;
             }
-            if (px <= 0.0) continue;
-
-            BookEventDelta d;
-            d.venue  = "OKX";
-            d.symbol = canonical;
-            d.side   = side;
-            d.price  = px;
-            d.size   = sz;
-            d.op     = (sz == 0.0) ? BookOp::Delete : BookOp::Upsert;
-            d.ts_ns  = ts_ns;
-            out.emplace_back(std::move(d));
-            produced_flag = true;
+            if (px <= 0) continue;
+            out.add_level(side, px, sz);
         }
     }
 
+    static constexpr md::ChecksumRule kChecksumRule{md::ChecksumStyle::Okx, 25, 0, 0};
+
+    const md::VenueId venue_id_ = md::venue_ids().intern("OKX");
+    md::SymbolIdCache symbols_; // instId -> canonical id, filled on first sight
+    md::SymbolId last_symbol_{md::kNoSymbol}; // stream symbol, for REST resnapshots
+    bool have_seq_{false};
+    std::int64_t last_seq_{0};
     simdjson::dom::parser parser_;
+    simdjson::padded_string scratch_; // fallback copy for unpadded frames
 };
@@ -1,4 +1,6 @@
 #include "ws.hpp"
+#include "venues/http_json.hpp"
+#include "venues/ws_session.hpp"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/ssl.hpp>
@@ -7,6 +9,7 @@
 #include <openssl/ssl.h>
 #include <atomic>
 #include <memory>
+#include <vector>
 #include <iostream>
 #include <fstream>
 #include <cstdlib>
@@ -24,10 +27,11 @@ struct OkxWs::Impl
     std::string inst_id;
     OnMsg on_msg;
 
-    net::io_context ioc{1};
+    std::unique_ptr<net::io_context> ioc; // blocking start() only
     net::ssl::context ssl_ctx{net::ssl::context::tls_client};
     std::unique_ptr<websocket::stream<beast::ssl_stream<tcp::socket>>> ws;
     std::atomic<bool> stop_flag{false};
+    std::shared_ptr<AsyncWsSession> session; // start_async() only
 
     Impl(std::string id, OnMsg cb)
         : inst_id(std::move(id)), on_msg(std::move(cb))
@@ -36,16 +40,43 @@ struct OkxWs::Impl
         ssl_ctx.set_verify_mode(net::ssl::verify_peer);
     }
 
+    static std::vector<std::string> subscription_messages(const std::string& id, bool subscribe)
+    {
+        return {std::string("{\"op\":\"") + (subscribe ? "subscribe" : "unsubscribe")
+              + "\",\"args\":[{\"channel\":\"books\",\"instId\":\"" + id + "\"}]}"};
+    }
+
+    static void debug_frame(const std::string& data)
+    {
+        static std::atomic<int> okx_msg_count{0};
+        if (std::getenv("OKX_DEBUG")) {
+            int n = okx_msg_count++;
+            if (n < 2) {
+                std::cerr << "[okx-ws] msg " << (n+1) << " len=" << data.size();
+                if (data.find("\"data\"") != std::string::npos) {
+                    std::cerr << " HAS_DATA";
+                    // Write first data msg to /tmp for inspection
+                    if (n == 1 && data.size() < 50000) {
+                        std::ofstream f("/tmp/okx_sample.json");
+                        if (f) f << data << std::endl;
+                    }
+                }
+                std::cerr << "\n";
+            }
+        }
+    }
+
     void run(unsigned short port)
     {
         try
         {
             // OKX WebSocket uses port 8443 (not 443)
             unsigned short okx_port = (port == 443) ? 8443 : port;
-            tcp::resolver resolver{ioc};
+            ioc = std::make_unique<net::io_context>(1);
+            tcp::resolver resolver{*ioc};
             auto const results = resolver.resolve(host, std::to_string(okx_port));
 
-            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(ioc, ssl_ctx);
+            ws = std::make_unique<websocket::stream<beast::ssl_stream<tcp::socket>>>(*ioc, ssl_ctx);
 
             net::connect(beast::get_lowest_layer(*ws), results);
 
@@ -65,13 +96,16 @@ struct OkxWs::Impl
             ws->handshake(host, path);
 
             // Subscribe to books channel (400-level, snapshot + incremental)
-            std::string sub = "{\"op\":\"subscribe\",\"args\":[{\"channel\":\"books\",\"instId\":\"" + inst_id + "\"}]}";
+            std::string sub = subscription_messages(inst_id, true).front();
             ws->write(net::buffer(sub));
 
-            beast::flat_buffer buffer;
+            // Frames are read straight into a string the feed can take ownership of
+            // (the callback may swap it out); the buffer is reused for the next read.
+            std::string frame;
             while (!stop_flag.load(std::memory_order_relaxed))
             {
-                buffer.clear();
+                frame.clear();
+                auto buffer = net::dynamic_buffer(frame);
                 beast::error_code ec;
                 ws->read(buffer, ec);
                 if (ec)
@@ -85,24 +119,8 @@ struct OkxWs::Impl
                     }
                     throw beast::system_error{ec};
                 }
-                std::string data = beast::buffers_to_string(buffer.cdata());
-                static std::atomic<int> okx_msg_count{0};
-                if (std::getenv("OKX_DEBUG")) {
-                    int n = okx_msg_count++;
-                    if (n < 2) {
-                        std::cerr << "[okx-ws] msg " << (n+1) << " len=" << data.size();
-                        if (data.find("\"data\"") != std::string::npos) {
-                            std::cerr << " HAS_DATA";
-                            // Write first data msg to /tmp for inspection
-                            if (n == 1 && data.size() < 50000) {
-                                std::ofstream f("/tmp/okx_sample.json");
-                                if (f) f << data << std::endl;
-                            }
-                        }
-                        std::cerr << "\n";
-                    }
-                }
-                if (on_msg) on_msg(data);
+                debug_frame(frame);
+                if (on_msg) on_msg(frame);
             }
 
             if (ws) {
@@ -116,11 +134,41 @@ struct OkxWs::Impl
         }
     }
 
+    // Same session as run(), driven by completion handlers on a shared io_context.
+    void run_async(net::io_context& shared_ioc, OnClosed on_closed, unsigned short port)
+    {
+        WsSessionSpec spec;
+        spec.tag = "okx-ws";
+        spec.host = host;
+        spec.port = std::to_string((port == 443) ? 8443 : port); // OKX WebSocket uses port 8443
+        spec.path = path;
+        spec.user_agent = "okx-ws-connector/0.1";
+        spec.subscribe = subscription_messages(inst_id, true);
+        auto cb = on_msg;
+        session = AsyncWsSession::launch(shared_ioc, std::move(spec),
+            [cb](std::string& frame) {
+                debug_frame(frame);
+                if (cb) cb(frame);
+            },
+            std::move(on_closed));
+    }
+
+    // Live (un)subscribe on the start_async() session; see IMarketWs.
+    void send_subscription(const std::string& venue_symbol, bool subscribe)
+    {
+        if (!session) return;
+        for (auto& msg : subscription_messages(venue_symbol, subscribe)) session->send(std::move(msg));
+    }
+
     void stop() noexcept
     {
         stop_flag.store(true, std::memory_order_relaxed);
+        if (session) {
+            session->stop();
+            return;
+        }
         if (ws) {
-            net::post(ioc, [s = ws.get()] {
+            net::post(ws->get_executor(), [s = ws.get()] {
                 beast::error_code ec;
                 s->close(websocket::close_code::normal, ec);
                 beast::get_lowest_layer(*s).shutdown(tcp::socket::shutdown_both, ec);
@@ -136,4 +184,18 @@ OkxWs::OkxWs(std::string inst_id, OnMsg cb)
 OkxWs::~OkxWs() { delete impl_; }
 
 void OkxWs::start(unsigned short port) { impl_->run(port); }
+void OkxWs::start_async(net::io_context& ioc, OnClosed on_closed, unsigned short port)
+{
+    impl_->run_async(ioc, std::move(on_closed), port);
+}
+void OkxWs::subscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, true); }
+void OkxWs::unsubscribe(const std::string& venue_symbol) { impl_->send_subscription(venue_symbol, false); }
 void OkxWs::stop() noexcept { impl_->stop(); }
+
+std::optional<std::string> OkxWs::fetch_book_snapshot(const std::string& venue_symbol)
+{
+    return venues::http_json::https_get(
+        "www.okx.com",
+        "/api/v5/market/books?instId=" + venue_symbol + "&sz=400",
+        "okx-ws-connector/0.1");
+}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <optional>
 #include <string>
 
 #include "venues/market_ws.hpp"
@@ -15,8 +16,16 @@ public:
     OkxWs& operator=(OkxWs&&) noexcept = default;
 
     void start(unsigned short port = 443) override;
+    void start_async(boost::asio::io_context &ioc, OnClosed on_closed,
+                     unsigned short port = 443) override;
+    void subscribe(const std::string &venue_symbol) override;
+    void unsubscribe(const std::string &venue_symbol) override;
     void stop() noexcept override;
 
+    // Blocking REST depth snapshot for in-place resyncs (body for
+    // OkxBookParser::parse_rest_snapshot). nullopt on failure.
+    static std::optional<std::string> fetch_book_snapshot(const std::string &venue_symbol);
+
 private:
     struct Impl;
     Impl* impl_;
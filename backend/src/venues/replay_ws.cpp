@@ -0,0 +1,262 @@
+#include "replay_ws.hpp"
+#include "md/capture_log.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace net = boost::asio;
+using Clock = std::chrono::steady_clock;
+
+namespace {
+
+// The loaded log plus the resume cursor of every stream that has played.
+struct ReplaySource {
+    std::shared_ptr<const md::CaptureLog> log;
+    ReplayOptions options;
+    std::int64_t first_recv_ns{0};
+    Clock::time_point epoch;
+
+    std::mutex mu;
+    std::unordered_map<std::string, std::size_t> cursors; // stream key -> next record offset
+};
+
+std::mutex g_source_mu;
+std::shared_ptr<ReplaySource> g_source;
+std::atomic<std::uint64_t> g_frames_replayed{0};
+
+std::shared_ptr<ReplaySource> current_source() {
+    std::lock_guard<std::mutex> lk(g_source_mu);
+    return g_source;
+}
+
+// Frames released per io handler at max speed before yielding the shard.
+constexpr int kAsyncBatch = 64;
+
+} // namespace
+
+struct ReplayWs::Impl : std::enable_shared_from_this<ReplayWs::Impl>
+{
+    std::string venue;
+    std::string key; // resume cursor key: venue + constructor symbol
+    OnMsg on_msg;
+    std::shared_ptr<ReplaySource> source;
+    std::size_t offset{0};
+    std::string buf; // the callback may swap it out
+
+    // Symbols: written by subscribe()/unsubscribe() on any thread, picked up by
+    // the replay thread when the version moves.
+    std::mutex symbols_mu;
+    std::vector<std::string> symbols;
+    std::atomic<std::uint64_t> symbols_version{1};
+    std::vector<std::string> active_symbols;
+    std::uint64_t active_version{0};
+
+    std::atomic<bool> stop_flag{false};
+    std::mutex wait_mu;           // start() only
+    std::condition_variable wait_cv;
+
+    net::io_context* ioc{nullptr}; // start_async() only
+    std::unique_ptr<net::steady_timer> timer;
+    OnClosed on_closed;
+    bool closed{false};
+
+    Impl(std::string sym, OnMsg cb, std::string venue_name)
+    : venue(std::move(venue_name)), on_msg(std::move(cb)), source(current_source())
+    {
+        key = venue + '\n' + sym;
+        symbols.push_back(std::move(sym));
+        if (!source) {
+            std::cerr << "[replay] no capture log loaded; " << key.substr(venue.size() + 1)
+                      << " will stay idle\n";
+            return;
+        }
+        std::lock_guard<std::mutex> lk(source->mu);
+        auto it = source->cursors.find(key);
+        offset = it != source->cursors.end() ? it->second : md::CaptureLog::first();
+    }
+
+    void refresh_symbols()
+    {
+        if (symbols_version.load(std::memory_order_acquire) == active_version) return;
+        std::lock_guard<std::mutex> lk(symbols_mu);
+        active_symbols = symbols;
+        active_version = symbols_version.load(std::memory_order_relaxed);
+    }
+
+    bool matches(const md::CapturedFrame& f) const
+    {
+        if (!venue.empty() && f.venue != venue) return false;
+        return std::find(active_symbols.begin(), active_symbols.end(), f.symbol) != active_symbols.end();
+    }
+
+    // Position on the next record of this stream; false at the end of the log.
+    bool next(md::CapturedFrame& f)
+    {
+        if (!source) return false;
+        refresh_symbols();
+        const md::CaptureLog& log = *source->log;
+        for (; log.read(offset, f); offset = log.next(offset)) {
+            if (matches(f)) return true;
+        }
+        return false;
+    }
+
+    Clock::time_point due(const md::CapturedFrame& f) const
+    {
+        const double speed = source->options.speed;
+        if (speed <= 0.0) return Clock::time_point::min();
+        const auto recorded = std::chrono::nanoseconds(f.recv_ns - source->first_recv_ns);
+        return source->epoch + std::chrono::duration_cast<Clock::duration>(recorded / speed);
+    }
+
+    void deliver(const md::CapturedFrame& f)
+    {
+        buf.assign(f.frame.data(), f.frame.size());
+        offset = source->log->next(offset);
+        g_frames_replayed.fetch_add(1, std::memory_order_relaxed);
+        on_msg(buf);
+    }
+
+    void save_cursor()
+    {
+        if (!source) return;
+        std::lock_guard<std::mutex> lk(source->mu);
+        source->cursors[key] = offset;
+    }
+
+    // Blocking playback on the caller's thread.
+    void run()
+    {
+        md::CapturedFrame f;
+        while (!stop_flag.load(std::memory_order_acquire)) {
+            if (!next(f)) {
+                // End of the recording: idle until stop() (subscribe() may add
+                // a symbol whose records lie ahead, so poll now and then).
+                std::unique_lock<std::mutex> lk(wait_mu);
+                wait_cv.wait_for(lk, std::chrono::milliseconds(100),
+                                 [this] { return stop_flag.load(std::memory_order_acquire); });
+                continue;
+            }
+            const auto when = due(f);
+            if (when > Clock::now()) {
+                std::unique_lock<std::mutex> lk(wait_mu);
+                if (wait_cv.wait_until(lk, when, [this] { return stop_flag.load(std::memory_order_acquire); })) {
+                    break;
+                }
+            }
+            deliver(f);
+        }
+        save_cursor();
+    }
+
+    // start_async(): one batch of due frames per handler, then a timer for the next.
+    void step()
+    {
+        if (closed) return;
+        md::CapturedFrame f;
+        for (int n = 0; n < kAsyncBatch; ++n) {
+            if (stop_flag.load(std::memory_order_acquire)) return close();
+            if (!next(f)) return wait_until(Clock::now() + std::chrono::milliseconds(100));
+            const auto when = due(f);
+            if (when > Clock::now()) return wait_until(when);
+            deliver(f);
+        }
+        net::post(*ioc, [self = shared_from_this()] { self->step(); });
+    }
+
+    void wait_until(Clock::time_point when)
+    {
+        timer->expires_at(when);
+        timer->async_wait([self = shared_from_this()](const boost::system::error_code&) {
+            self->step(); // cancelled by stop(): step() sees stop_flag and closes
+        });
+    }
+
+    void close()
+    {
+        if (closed) return;
+        closed = true;
+        save_cursor();
+        if (auto cb = std::move(on_closed)) cb();
+    }
+};
+
+void ReplayWs::load(std::shared_ptr<const md::CaptureLog> log, ReplayOptions options)
+{
+    auto source = std::make_shared<ReplaySource>();
+    source->log = std::move(log);
+    source->options = options;
+    md::CapturedFrame first;
+    if (source->log && source->log->read(md::CaptureLog::first(), first)) {
+        source->first_recv_ns = first.recv_ns;
+    }
+    source->epoch = Clock::now();
+    if (!source->log) source.reset();
+
+    std::lock_guard<std::mutex> lk(g_source_mu);
+    g_source = std::move(source);
+}
+
+std::uint64_t ReplayWs::frames_replayed() noexcept
+{
+    return g_frames_replayed.load(std::memory_order_relaxed);
+}
+
+ReplayWs::ReplayWs(std::string symbol, OnMsg cb, std::string venue)
+: impl_(std::make_shared<Impl>(std::move(symbol), std::move(cb), std::move(venue))) {}
+
+ReplayWs::~ReplayWs() = default;
+
+void ReplayWs::start(unsigned short)
+{
+    impl_->run();
+}
+
+void ReplayWs::start_async(net::io_context& ioc, OnClosed on_closed, unsigned short)
+{
+    impl_->ioc = &ioc;
+    impl_->timer = std::make_unique<net::steady_timer>(ioc);
+    impl_->on_closed = std::move(on_closed);
+    net::post(ioc, [self = impl_] { self->step(); });
+}
+
+void ReplayWs::subscribe(const std::string& venue_symbol)
+{
+    std::lock_guard<std::mutex> lk(impl_->symbols_mu);
+    auto& symbols = impl_->symbols;
+    if (std::find(symbols.begin(), symbols.end(), venue_symbol) != symbols.end()) return;
+    symbols.push_back(venue_symbol);
+    impl_->symbols_version.fetch_add(1, std::memory_order_release);
+}
+
+void ReplayWs::unsubscribe(const std::string& venue_symbol)
+{
+    std::lock_guard<std::mutex> lk(impl_->symbols_mu);
+    auto& symbols = impl_->symbols;
+    symbols.erase(std::remove(symbols.begin(), symbols.end(), venue_symbol), symbols.end());
+    impl_->symbols_version.fetch_add(1, std::memory_order_release);
+}
+
+void ReplayWs::stop() noexcept
+{
+    if (impl_->stop_flag.exchange(true, std::memory_order_acq_rel)) return;
+    {
+        std::lock_guard<std::mutex> lk(impl_->wait_mu);
+    }
+    impl_->wait_cv.notify_all();
+    if (impl_->ioc) {
+        net::post(*impl_->ioc, [self = impl_] {
+            if (self->timer) self->timer->cancel();
+            self->step();
+        });
+    }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+#include "venues/market_ws.hpp"
+
+namespace md { class CaptureLog; }
+
+struct ReplayOptions {
+    // Pace relative to the recording: 1 = recorded speed, N = N× faster,
+    // 0 = as fast as the consumer drains (pair with Backpressure::Block).
+    double speed{1.0};
+};
+
+// Offline connector: plays back frames from a capture log (md/capture_log.hpp)
+// instead of a socket, so VenueFeed<ReplayWs, ParserT> rebuilds the recorded
+// books without network access.
+// - load() installs the log for every ReplayWs constructed afterwards. Frames
+//   are released against one shared clock (first record = load() time), so
+//   feeds replayed side by side keep their recorded interleaving.
+// - A connector plays the records whose venue and symbol match it. A closed
+//   session leaves its cursor behind and the next connector for the same
+//   stream resumes there, so a feed reset does not restart the recording.
+// - At the end of the log the session stays open and idle until stop().
+// NOTE: PIMPL keeps Boost out of the feed headers, as with the venue connectors.
+class ReplayWs : public IMarketWs {
+public:
+    // No transport to go stale; VenueFeed skips its liveness reset and
+    // constructs the connector with its venue name (see IMarketWs).
+    static constexpr bool kOffline = true;
+
+    static void load(std::shared_ptr<const md::CaptureLog> log, ReplayOptions options = {});
+    // Frames handed to callbacks since the process started.
+    static std::uint64_t frames_replayed() noexcept;
+
+    // venue: capture venue name ("Kraken"); empty matches any venue.
+    ReplayWs(std::string symbol, OnMsg cb, std::string venue = {});
+    ~ReplayWs();
+    ReplayWs(const ReplayWs &) = delete;
+    ReplayWs &operator=(const ReplayWs &) = delete;
+
+    // port is ignored.
+    void start(unsigned short port = 443) override;
+    void start_async(boost::asio::io_context &ioc, OnClosed on_closed,
+                     unsigned short port = 443) override;
+    void subscribe(const std::string &venue_symbol) override;
+    void unsubscribe(const std::string &venue_symbol) override;
+    void stop() noexcept override;
+
+private:
+    struct Impl;
+    std::shared_ptr<Impl> impl_; // shared with pending io handlers
+};
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <simdjson.h>
+#include <string>
+
+// In-place simdjson input for raw WS frames.
+// Frames delivered through FramePool keep SIMDJSON_PADDING spare capacity, so
+// parsers can iterate them without the padded_string copy. Frames from other
+// sources (tests, replay files) fall back to a padded copy in `scratch`.
+namespace venues {
+
+inline simdjson::padded_string_view padded_frame(const std::string& raw,
+                                                 simdjson::padded_string& scratch) {
+    if (raw.capacity() - raw.size() >= simdjson::SIMDJSON_PADDING) {
+        return simdjson::padded_string_view(raw.data(), raw.size(), raw.capacity());
+    }
+    scratch = simdjson::padded_string(raw);
+    return simdjson::padded_string_view(scratch.data(), scratch.size(), scratch.size() + simdjson::SIMDJSON_PADDING);
+}
+
+} // namespace venues
@@ -4,12 +4,15 @@
 #include <memory>
 #include <string>
 
+#include "md/feed_config.hpp"
+
 struct IVenueFeed;
 class IVenueApi;
 
 struct VenueFactory {
     std::string name;
-    std::function<std::shared_ptr<IVenueFeed>(const std::string& canonical)> make_feed;
+    std::function<std::shared_ptr<IVenueFeed>(const std::string& canonical,
+                                              const FeedConfig& config)> make_feed;
     std::function<std::unique_ptr<IVenueApi>()> make_api;
     std::function<std::string(const std::string& canonical)> to_venue_symbol;
 };
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Venue event times as ns since the Unix epoch (BookEventHeader::venue_ts_ns),
+// from the two textual forms the book feeds send. Both return false on
+// anything else.
+namespace venues {
+
+namespace detail {
+
+inline bool parse_digits(std::string_view s, std::int64_t& out) {
+    if (s.empty()) return false;
+    std::int64_t v = 0;
+    for (char c : s) {
+        if (c < '0' || c > '9') return false;
+        v = v * 10 + (c - '0');
+    }
+    out = v;
+    return true;
+}
+
+} // namespace detail
+
+// "1597026383085": epoch milliseconds (OKX "ts").
+inline bool parse_epoch_ms(std::string_view s, std::int64_t& ns) {
+    std::int64_t ms = 0;
+    if (s.size() > 15 || !detail::parse_digits(s, ms)) return false;
+    ns = ms * 1'000'000;
+    return true;
+}
+
+// "2023-02-09T20:32:50.714964855Z": UTC RFC 3339 with up to nine fraction
+// digits (Coinbase "timestamp" and "time").
+inline bool parse_rfc3339_utc(std::string_view s, std::int64_t& ns) {
+    if (s.size() < 20 || s[4] != '-' || s[7] != '-' || s[10] != 'T' || s[13] != ':' || s[16] != ':' ||
+        s.back() != 'Z') {
+        return false;
+    }
+    std::int64_t y = 0, mo = 0, d = 0, h = 0, mi = 0, sec = 0, frac = 0;
+    if (!detail::parse_digits(s.substr(0, 4), y) || !detail::parse_digits(s.substr(5, 2), mo) ||
+        !detail::parse_digits(s.substr(8, 2), d) || !detail::parse_digits(s.substr(11, 2), h) ||
+        !detail::parse_digits(s.substr(14, 2), mi) || !detail::parse_digits(s.substr(17, 2), sec)) {
+        return false;
+    }
+    if (s.size() > 20) {
+        const std::string_view digits = s.substr(20, s.size() - 21);
+        if (s[19] != '.' || digits.size() > 9 || !detail::parse_digits(digits, frac)) return false;
+        for (std::size_t i = digits.size(); i < 9; ++i) frac *= 10;
+    }
+
+    using namespace std::chrono;
+    const year_month_day date{year{static_cast<int>(y)}, month{static_cast<unsigned>(mo)},
+                              day{static_cast<unsigned>(d)}};
+    if (!date.ok() || h > 23 || mi > 59 || sec > 60) return false;
+    const auto t = sys_days{date} + hours{h} + minutes{mi} + seconds{sec};
+    ns = duration_cast<nanoseconds>(t.time_since_epoch()).count() + frac;
+    return true;
+}
+
+} // namespace venues
@@ -0,0 +1,87 @@
+#include "ws_io_pool.hpp"
+
+#include <boost/asio/executor_work_guard.hpp>
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/post.hpp>
+#include <boost/asio/steady_timer.hpp>
+#include <algorithm>
+#include <exception>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+namespace net = boost::asio;
+
+struct WsIoPool::Impl
+{
+    using WorkGuard = net::executor_work_guard<net::io_context::executor_type>;
+
+    struct Shard {
+        net::io_context ioc{1};
+        WorkGuard work{net::make_work_guard(ioc)};
+        std::thread thread;
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    explicit Impl(std::size_t threads)
+    {
+        shards.reserve(threads);
+        for (std::size_t i = 0; i < threads; ++i) {
+            auto shard = std::make_unique<Shard>();
+            Shard* raw = shard.get();
+            raw->thread = std::thread([raw, i] {
+                for (;;) {
+                    try {
+                        raw->ioc.run();
+                        return;
+                    } catch (const std::exception& e) {
+                        // A throwing handler must not take down every session on the shard.
+                        std::cerr << "[ws-io] shard " << i << " handler error: " << e.what() << "\n";
+                    }
+                }
+            });
+            shards.push_back(std::move(shard));
+        }
+    }
+
+    void stop() noexcept
+    {
+        for (auto& shard : shards) {
+            shard->work.reset();
+            shard->ioc.stop();
+        }
+        for (auto& shard : shards) {
+            if (shard->thread.joinable()) shard->thread.join();
+        }
+    }
+};
+
+WsIoPool::WsIoPool(std::size_t threads) : impl_(new Impl(std::max<std::size_t>(1, threads))) {}
+
+WsIoPool::~WsIoPool()
+{
+    impl_->stop();
+    delete impl_;
+}
+
+std::size_t WsIoPool::size() const noexcept { return impl_->shards.size(); }
+
+net::io_context& WsIoPool::shard(std::size_t index)
+{
+    return impl_->shards[index % impl_->shards.size()]->ioc;
+}
+
+void WsIoPool::post_after(std::size_t index, std::chrono::milliseconds delay, std::function<void()> fn)
+{
+    net::io_context& ioc = shard(index);
+    if (delay.count() <= 0) {
+        net::post(ioc, std::move(fn));
+        return;
+    }
+    auto timer = std::make_shared<net::steady_timer>(ioc, delay);
+    timer->async_wait([timer, fn = std::move(fn)](const boost::system::error_code&) { fn(); });
+}
+
+void WsIoPool::stop() noexcept { impl_->stop(); }
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+namespace boost::asio { class io_context; }
+
+// Fixed pool of single-threaded io_contexts ("shards") shared by all market-data
+// WebSocket sessions. Each session is pinned to one shard, so its handlers never
+// run concurrently and need no strand. Thread count is a configuration value,
+// independent of how many pairs are subscribed.
+// NOTE: PIMPL keeps Boost out of the feed headers.
+class WsIoPool {
+public:
+    explicit WsIoPool(std::size_t threads);
+    ~WsIoPool();
+    WsIoPool(const WsIoPool&) = delete;
+    WsIoPool& operator=(const WsIoPool&) = delete;
+
+    std::size_t size() const noexcept;
+    boost::asio::io_context& shard(std::size_t index);
+
+    // Run fn on the shard's thread after `delay` (0 = as soon as possible).
+    void post_after(std::size_t index, std::chrono::milliseconds delay, std::function<void()> fn);
+
+    // Stop all shards and join their threads. Idempotent.
+    void stop() noexcept;
+
+private:
+    struct Impl;
+    Impl* impl_;
+};
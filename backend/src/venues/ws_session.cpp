@@ -0,0 +1,201 @@
+#include "ws_session.hpp"
+
+#include <boost/asio/connect.hpp>
+#include <boost/asio/post.hpp>
+#include <openssl/err.h>
+#include <openssl/ssl.h>
+#include <iostream>
+
+namespace beast = boost::beast;
+namespace http = beast::http;
+namespace websocket = beast::websocket;
+namespace net = boost::asio;
+using tcp = boost::asio::ip::tcp;
+
+namespace {
+
+// Expected during stop() or orderly remote shutdown
+bool is_expected_close(const beast::error_code& ec)
+{
+    return ec == websocket::error::closed ||
+           ec == net::error::operation_aborted ||
+           ec == net::error::eof ||
+           ec == net::error::not_connected ||
+           ec == beast::errc::not_connected;
+}
+
+// Recommended client settings
+net::ssl::context& verify_peer(net::ssl::context& ctx)
+{
+    ctx.set_default_verify_paths();
+    ctx.set_verify_mode(net::ssl::verify_peer);
+    return ctx;
+}
+
+} // namespace
+
+std::shared_ptr<AsyncWsSession> AsyncWsSession::launch(net::io_context& ioc,
+                                                       WsSessionSpec spec,
+                                                       IMarketWs::OnMsg on_msg,
+                                                       IMarketWs::OnClosed on_closed)
+{
+    auto session = std::make_shared<AsyncWsSession>(
+        ioc, std::move(spec), std::move(on_msg), std::move(on_closed));
+    net::post(ioc, [self = session] {
+        if (self->stopping_) {
+            self->finish(net::error::operation_aborted);
+            return;
+        }
+        self->resolver_.async_resolve(
+            self->spec_.host, self->spec_.port,
+            [self](const beast::error_code& ec, const tcp::resolver::results_type& results) {
+                self->on_resolve(ec, results);
+            });
+    });
+    return session;
+}
+
+AsyncWsSession::AsyncWsSession(net::io_context& ioc,
+                               WsSessionSpec spec,
+                               IMarketWs::OnMsg on_msg,
+                               IMarketWs::OnClosed on_closed)
+    : spec_(std::move(spec))
+    , on_msg_(std::move(on_msg))
+    , on_closed_(std::move(on_closed))
+    , resolver_(ioc)
+    , ws_(ioc, verify_peer(ssl_ctx_))
+    , outbox_(spec_.subscribe.begin(), spec_.subscribe.end())
+{}
+
+void AsyncWsSession::on_resolve(const beast::error_code& ec,
+                                const tcp::resolver::results_type& results)
+{
+    if (ec || stopping_) return finish(ec ? ec : net::error::operation_aborted);
+    net::async_connect(beast::get_lowest_layer(ws_), results,
+        [self = shared_from_this()](const beast::error_code& ec, const tcp::endpoint&) {
+            self->on_connect(ec);
+        });
+}
+
+void AsyncWsSession::on_connect(const beast::error_code& ec)
+{
+    if (ec || stopping_) return finish(ec ? ec : net::error::operation_aborted);
+
+    // SNI (Server Name Indication) for TLS
+    if (!SSL_set_tlsext_host_name(ws_.next_layer().native_handle(), spec_.host.c_str())) {
+        return finish(beast::error_code(static_cast<int>(::ERR_get_error()),
+                                        net::error::get_ssl_category()));
+    }
+
+    ws_.next_layer().async_handshake(net::ssl::stream_base::client,
+        [self = shared_from_this()](const beast::error_code& ec) {
+            self->on_tls_handshake(ec);
+        });
+}
+
+void AsyncWsSession::on_tls_handshake(const beast::error_code& ec)
+{
+    if (ec || stopping_) return finish(ec ? ec : net::error::operation_aborted);
+
+    ws_.set_option(websocket::stream_base::timeout::suggested(beast::role_type::client));
+    ws_.set_option(websocket::stream_base::decorator(
+        [ua = spec_.user_agent, origin = spec_.origin](websocket::request_type& req) {
+            req.set(http::field::user_agent, ua);
+            if (!origin.empty()) req.set(http::field::origin, origin);
+        }));
+    ws_.async_handshake(spec_.host, spec_.path,
+        [self = shared_from_this()](const beast::error_code& ec) {
+            self->on_ws_handshake(ec);
+        });
+}
+
+void AsyncWsSession::on_ws_handshake(const beast::error_code& ec)
+{
+    if (ec || stopping_) return finish(ec ? ec : net::error::operation_aborted);
+    open_ = true;
+    write_next();
+    read_next();
+}
+
+void AsyncWsSession::write_next()
+{
+    if (writing_ || outbox_.empty() || stopping_ || closed_) return;
+    writing_ = true;
+    ws_.async_write(net::buffer(outbox_.front()),
+        [self = shared_from_this()](const beast::error_code& ec, std::size_t) {
+            self->writing_ = false;
+            if (ec) return self->finish(ec);
+            if (self->stopping_) return self->begin_close(); // stop() deferred to us
+            self->outbox_.pop_front();
+            self->write_next();
+        });
+}
+
+void AsyncWsSession::send(std::string text)
+{
+    net::post(ws_.get_executor(), [self = shared_from_this(), text = std::move(text)]() mutable {
+        if (self->stopping_ || self->closed_) return;
+        self->outbox_.push_back(std::move(text));
+        if (self->open_) self->write_next();
+    });
+}
+
+void AsyncWsSession::read_next()
+{
+    frame_.clear();
+    buffer_.emplace(frame_);
+    ws_.async_read(*buffer_,
+        [self = shared_from_this()](const beast::error_code& ec, std::size_t) {
+            self->on_read(ec);
+        });
+}
+
+void AsyncWsSession::on_read(const beast::error_code& ec)
+{
+    if (ec) return finish(ec);
+    if (stopping_) return finish(net::error::operation_aborted);
+    if (on_msg_) on_msg_(frame_); // Callback with received message from websocket
+    read_next();
+}
+
+void AsyncWsSession::stop()
+{
+    net::post(ws_.get_executor(), [self = shared_from_this()] {
+        if (self->stopping_ || self->closed_) return;
+        self->stopping_ = true;
+        if (!self->writing_) self->begin_close();
+    });
+}
+
+void AsyncWsSession::begin_close()
+{
+    if (!ws_.is_open()) {
+        // Still connecting: cancelling the socket aborts the pending step.
+        resolver_.cancel();
+        close_socket();
+        return;
+    }
+    // WS close frame; the pending read then completes with websocket::error::closed.
+    ws_.async_close(websocket::close_code::normal,
+        [self = shared_from_this()](const beast::error_code&) { self->close_socket(); });
+}
+
+void AsyncWsSession::close_socket()
+{
+    beast::error_code ec;
+    beast::get_lowest_layer(ws_).shutdown(tcp::socket::shutdown_both, ec);
+    beast::get_lowest_layer(ws_).close(ec);
+}
+
+void AsyncWsSession::finish(const beast::error_code& ec)
+{
+    if (closed_) return;
+    closed_ = true;
+    if (ec && !is_expected_close(ec)) {
+        std::cerr << "[" << spec_.tag << "] error: " << ec.message() << "\n";
+    }
+    close_socket();
+    auto on_closed = std::move(on_closed_);
+    on_msg_ = nullptr;
+    if (on_closed) on_closed();
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/tcp.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/beast/core.hpp>
+#include <boost/beast/ssl.hpp>
+#include <boost/beast/websocket.hpp>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "venues/market_ws.hpp"
+
+// Connection parameters for one venue market-data stream.
+struct WsSessionSpec {
+    std::string tag;                    // log prefix, e.g. "coinbase-ws"
+    std::string host;
+    std::string port;
+    std::string path;
+    std::string user_agent;
+    std::string origin;                 // optional Origin header
+    std::vector<std::string> subscribe; // text frames written after the WS handshake
+};
+
+// Asynchronous WebSocket session for the shared WsIoPool runtime:
+// resolve -> TCP connect -> TLS -> WS handshake -> subscribe -> read loop (with
+// further subscribe/unsubscribe frames written alongside it via send()),
+// all as completion handlers on one single-threaded io_context (no strand).
+// Frames are read straight into a string handed to on_msg (which may swap it out),
+// matching the blocking connectors. on_closed fires exactly once when the session ends.
+// NOTE: Boost-heavy; include only from venue ws.cpp translation units.
+class AsyncWsSession : public std::enable_shared_from_this<AsyncWsSession> {
+public:
+    static std::shared_ptr<AsyncWsSession> launch(boost::asio::io_context& ioc,
+                                                  WsSessionSpec spec,
+                                                  IMarketWs::OnMsg on_msg,
+                                                  IMarketWs::OnClosed on_closed);
+
+    AsyncWsSession(boost::asio::io_context& ioc,
+                   WsSessionSpec spec,
+                   IMarketWs::OnMsg on_msg,
+                   IMarketWs::OnClosed on_closed);
+
+    // Thread-safe: queue a text frame (e.g. a live subscribe/unsubscribe). Frames
+    // queued before the handshake completes are written right after spec.subscribe.
+    void send(std::string text);
+
+    // Thread-safe: close the stream from its own shard.
+    void stop();
+
+private:
+    using Stream = boost::beast::websocket::stream<boost::beast::ssl_stream<boost::asio::ip::tcp::socket>>;
+    using FrameBuffer = boost::asio::dynamic_string_buffer<char, std::char_traits<char>, std::allocator<char>>;
+
+    void on_resolve(const boost::beast::error_code& ec,
+                    const boost::asio::ip::tcp::resolver::results_type& results);
+    void on_connect(const boost::beast::error_code& ec);
+    void on_tls_handshake(const boost::beast::error_code& ec);
+    void on_ws_handshake(const boost::beast::error_code& ec);
+    void write_next();
+    void read_next();
+    void on_read(const boost::beast::error_code& ec);
+    void begin_close();
+    void close_socket();
+    void finish(const boost::beast::error_code& ec);
+
+    WsSessionSpec spec_;
+    IMarketWs::OnMsg on_msg_;
+    IMarketWs::OnClosed on_closed_;
+
+    boost::asio::ssl::context ssl_ctx_{boost::asio::ssl::context::tls_client};
+    boost::asio::ip::tcp::resolver resolver_;
+    Stream ws_;
+    std::string frame_;
+    std::optional<FrameBuffer> buffer_;
+    std::deque<std::string> outbox_; // pending text frames, written one at a time
+    bool open_{false};               // WS handshake done
+    bool writing_{false};
+    bool stopping_{false};
+    bool closed_{false};
+};
@@ -72,6 +72,7 @@ mkdir -p build
 
 clang++ -std=c++20 -O3 -Wall -Wextra \
   src/venues/coinbase/ws.cpp src/venues/kraken/ws.cpp \
+  src/venues/ws_session.cpp src/venues/ws_io_pool.cpp \
   src/md/symbol_codec.cpp \
   src/ui/master_feed.cpp \
   test/test_master.cpp \
@@ -72,6 +72,7 @@ mkdir -p build
 
 clang++ -std=c++20 -O3 -Wall -Wextra \
   src/venues/coinbase/ws.cpp \
+  src/venues/ws_session.cpp src/venues/ws_io_pool.cpp \
   src/md/symbol_codec.cpp \
   test/test_pipeline_coinbase.cpp \
   -I src -I"$SIMDJSON_PREFIX/include" -I"$BOOST_PREFIX/include" -I"$OPENSSL_PREFIX/include" \
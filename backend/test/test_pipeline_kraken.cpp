@@ -68,6 +68,7 @@ SIMDJSON_PREFIX=$(brew --prefix simdjson)
 
 clang++ -std=c++20 -O3 -Wall -Wextra \
   src/venues/kraken/ws.cpp \
+  src/venues/ws_session.cpp src/venues/ws_io_pool.cpp \
   src/md/symbol_codec.cpp \
   test/test_pipeline_kraken.cpp \
   -I src -I"$SIMDJSON_PREFIX/include" -I"$BOOST_PREFIX/include" -I"$OPENSSL_PREFIX/include" \
@@ -0,0 +1,134 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "md/capture_log.hpp"
+#include "md/symbol_codec.hpp"
+#include "md/venue_feed.hpp"
+#include "venues/binance/parser.hpp"
+#include "venues/coinbase/parser.hpp"
+#include "venues/kraken/parser.hpp"
+#include "venues/okx/parser.hpp"
+#include "venues/replay_ws.hpp"
+
+// Replays a capture log (FEED_CAPTURE_PATH on the server) through one
+// VenueFeed<ReplayWs, Parser> per recorded stream and prints the final books.
+//   ./build/test_replay capture.log [speed]
+// speed: 1 = recorded pace, N = N× faster, 0 (default) = as fast as possible;
+// at 0 the feeds block instead of dropping, so the run is deterministic and
+// the reported rate is end-to-end parse + book + publish throughput.
+
+template <typename ParserT>
+static std::shared_ptr<IVenueFeed> make_feed(const std::string& venue, const std::string& canonical) {
+    return std::make_shared<VenueFeed<ReplayWs, ParserT>>(venue, canonical, Backpressure::Block);
+}
+
+static std::shared_ptr<IVenueFeed> make_replay_feed(const std::string& venue, const std::string& canonical) {
+    if (venue == "Binance")  return make_feed<BinanceBookParser>(venue, canonical);
+    if (venue == "Coinbase") return make_feed<CoinbaseBookParser>(venue, canonical);
+    if (venue == "Kraken")   return make_feed<KrakenBookParser>(venue, canonical);
+    if (venue == "OKX")      return make_feed<OkxBookParser>(venue, canonical);
+    return nullptr;
+}
+
+static void print_top(const IVenueFeed& feed) {
+    auto snap = feed.load_snapshot();
+    std::cout << std::left << std::setw(9) << feed.venue() << std::setw(10) << feed.canonical();
+    if (!snap || snap->bids.empty() || snap->asks.empty()) {
+        std::cout << "(no book)";
+    } else {
+        std::cout << std::fixed << std::setprecision(8)
+                  << snap->bids.front().price << " x " << snap->bids.front().size << "  |  "
+                  << snap->asks.front().price << " x " << snap->asks.front().size
+                  << std::defaultfloat << "  levels " << snap->bids.size() << "/" << snap->asks.size();
+    }
+    std::cout << "  gaps=" << feed.sequence_gaps() << " checksum_mismatches=" << feed.checksum_mismatches()
+              << " resyncs=" << feed.resyncs() << " rejected_levels=" << feed.rejected_levels()
+              << " dropped_frames=" << feed.dropped_frames() << "\n";
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "usage: " << argv[0] << " capture.log [speed]\n";
+        return 1;
+    }
+    const double speed = argc > 2 ? std::atof(argv[2]) : 0.0;
+
+    auto log = std::make_shared<const md::CaptureLog>(argv[1]);
+
+    // Streams in the log: (venue, venue symbol) -> frame count.
+    std::map<std::pair<std::string, std::string>, std::uint64_t> streams;
+    std::uint64_t bytes = 0;
+    md::CapturedFrame rec;
+    for (std::size_t off = log->first(); log->read(off, rec); off = log->next(off)) {
+        ++streams[{std::string(rec.venue), std::string(rec.symbol)}];
+        bytes += rec.frame.size();
+    }
+
+    ReplayWs::load(log, ReplayOptions{speed});
+
+    std::vector<std::shared_ptr<IVenueFeed>> feeds;
+    std::uint64_t expected = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (const auto& [stream, frames] : streams) {
+        const auto& [venue, venue_symbol] = stream;
+        auto feed = make_replay_feed(venue, SymbolCodec::to_canonical(venue, venue_symbol));
+        if (!feed) {
+            std::cerr << "skipping unknown venue " << venue << "\n";
+            continue;
+        }
+        feed->start_ws(venue_symbol);
+        feeds.push_back(std::move(feed));
+        expected += frames;
+    }
+
+    // Every frame handed to a feed, then the consumers caught up (no book
+    // change for a while).
+    while (ReplayWs::frames_replayed() < expected) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    for (;;) {
+        std::int64_t last = 0;
+        for (const auto& f : feeds) last = std::max(last, f->last_book_update_ns());
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        std::int64_t now = 0;
+        for (const auto& f : feeds) now = std::max(now, f->last_book_update_ns());
+        if (now == last) break;
+    }
+    const double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count() - 0.05;
+
+    std::cout << expected << " frames (" << bytes / 1024 << " KiB) over " << feeds.size()
+              << " streams in " << std::setprecision(3) << secs << " s";
+    if (speed <= 0.0) std::cout << "  ->  " << static_cast<std::uint64_t>(expected / secs) << " frames/s";
+    std::cout << "\n";
+    for (const auto& f : feeds) print_top(*f);
+
+    for (auto& f : feeds) f->stop();
+    return 0;
+}
+
+/*
+SIMDJSON_PREFIX=$(brew --prefix simdjson)
+BOOST_PREFIX=$(brew --prefix boost)
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  src/venues/replay_ws.cpp src/venues/ws_io_pool.cpp \
+  src/md/symbol_codec.cpp \
+  test/test_replay.cpp \
+  -I src -I"$SIMDJSON_PREFIX/include" -I"$BOOST_PREFIX/include" \
+  -L"$SIMDJSON_PREFIX/lib" -lsimdjson \
+  -Wl,-rpath,"$SIMDJSON_PREFIX/lib" \
+  -DBOOST_ERROR_CODE_HEADER_ONLY \
+  -o build/test_replay
+
+# capture on the server with FEED_CAPTURE_PATH=/tmp/feed.cap, then
+./build/test_replay /tmp/feed.cap      # max speed
+./build/test_replay /tmp/feed.cap 10   # 10x recorded pace
+*/
@@ -0,0 +1,131 @@
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <new>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "router/router_framework.hpp"
+#include "../bench/synthetic_books.hpp"
+
+// Checks that routing is allocation-free in steady state: every router
+// version, both sides, market and limit orders of several sizes, routed
+// through one RoutingContext into one reused RoutingDecision. The context
+// starts tiny so the first pass exercises the arena growing; the second pass
+// must not touch the heap at all (global operator new is counted) and must
+// reproduce the one-shot route_order() decisions.
+//   ./build/test_router_alloc
+
+namespace {
+
+std::atomic<std::uint64_t> g_allocs{0};
+
+} // namespace
+
+[[gnu::noinline]] void* operator new(std::size_t n) {
+    g_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+[[gnu::noinline]] void operator delete(void* p) noexcept { std::free(p); }
+[[gnu::noinline]] void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct Order {
+    std::string side;
+    double qty{0.0};
+    std::optional<double> limit_price;
+};
+
+} // namespace
+
+int main() {
+    static const char* const kNames[] = {"Coinbase", "Kraken", "OKX", "Binance"};
+    static const double kTakerFees[] = {0.006, 0.0026, 0.001, 0.004};
+
+    std::mt19937_64 rng(11);
+    md::SnapshotSet set;
+    std::unordered_map<std::string, VenueStaticInfo> static_info;
+    std::unordered_map<std::string, VenueRuntimeInfo> runtime_info;
+    double side_qty = 0.0;
+    for (std::size_t v = 0; v < 4; ++v) {
+        auto snap = std::make_shared<BookSnapshot>();
+        snap->venue = kNames[v];
+        snap->symbol = "BTC-USD";
+        snap->seq = v + 1;
+        snap->bids = bench::make_side(rng, BookSide::Bid, 2000);
+        snap->asks = bench::make_side(rng, BookSide::Ask, 2000);
+        side_qty += snap->asks.back().cum_qty;
+        const md::VenueId venue_id = snapshot_venue_id(*snap);
+        set.venues.push_back(md::SnapshotSet::Venue{venue_id, std::move(snap)});
+
+        static_info[kNames[v]].fees.tiers = {FeeTier{0.0, kTakerFees[v] / 2, kTakerFees[v]}};
+        runtime_info[kNames[v]] = VenueRuntimeInfo{0.0, 20.0 * static_cast<double>(v), 0.0005};
+    }
+
+    std::vector<Order> orders;
+    for (const char* side : {"buy", "sell"}) {
+        for (double frac : {0.0001, 0.01, 0.2, 1.5}) {
+            const double qty = side_qty * frac;
+            orders.push_back(Order{side, qty, std::nullopt});
+            const double limit = std::string(side) == "buy" ? 60'010.0 : 59'990.0;
+            orders.push_back(Order{side, qty, limit});
+        }
+    }
+
+    RoutingContext ctx(256);
+    RoutingDecision decision;
+    int failures = 0;
+
+    for (std::uint8_t id = 1; id <= router::kRouterVersionCount; ++id) {
+        const auto version = static_cast<router::RouterVersionId>(id);
+        auto route = [&](const Order& o) {
+            router::route_order(ctx, version, set, 0, o.side, o.qty, o.limit_price, static_info, runtime_info,
+                                decision);
+        };
+
+        // Warm-up: grows the arena and the decision's slice capacity.
+        for (const auto& o : orders) route(o);
+
+        const std::uint64_t before = g_allocs.load(std::memory_order_relaxed);
+        for (int pass = 0; pass < 3; ++pass) {
+            for (const auto& o : orders) route(o);
+        }
+        const std::uint64_t allocs = g_allocs.load(std::memory_order_relaxed) - before;
+
+        std::size_t mismatches = 0;
+        for (const auto& o : orders) {
+            route(o);
+            const RoutingDecision one_shot =
+                router::route_order(version, set, 0, o.side, o.qty, o.limit_price, static_info, runtime_info);
+            mismatches += bench::same_decision(decision, one_shot) ? 0 : 1;
+        }
+
+        const bool ok = allocs == 0 && mismatches == 0;
+        failures += ok ? 0 : 1;
+        std::cout << (ok ? "ok   " : "FAIL ") << router::router_version_name(version) << ": " << allocs
+                  << " allocations over " << 3 * orders.size() << " routes, " << mismatches
+                  << " decisions differ from route_order()\n";
+    }
+    std::cout << "arena grew to " << ctx.capacity_bytes() << " bytes\n";
+    return failures == 0 ? 0 : 1;
+}
+
+/*
+cd backend
+mkdir -p build
+
+clang++ -std=c++20 -O3 -Wall -Wextra \
+  test/test_router_alloc.cpp \
+  -I src \
+  -o build/test_router_alloc
+
+./build/test_router_alloc
+*/
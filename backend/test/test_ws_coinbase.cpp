@@ -24,7 +24,8 @@ OPENSSL_PREFIX=$(brew --prefix openssl)
 mkdir -p build
 
 clang++ -std=c++20 -O3 -Wall -Wextra \
-  src/venues/coinbase/ws.cpp test/test_ws_coinbase.cpp \
+  src/venues/coinbase/ws.cpp src/venues/ws_session.cpp \
+  test/test_ws_coinbase.cpp \
   -I src -I"$BOOST_PREFIX/include" -I"$OPENSSL_PREFIX/include" \
   "$OPENSSL_PREFIX/lib/libssl.dylib" \
   "$OPENSSL_PREFIX/lib/libcrypto.dylib" \
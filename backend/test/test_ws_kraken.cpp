@@ -22,7 +22,8 @@ int main(){
 
 /*
 clang++ -std=c++20 -O3 -Wall -Wextra \
-  src/venues/kraken/ws.cpp test/test_ws_kraken.cpp \
+  src/venues/kraken/ws.cpp src/venues/ws_session.cpp \
+  test/test_ws_kraken.cpp \
   -I src -I"$BOOST_PREFIX/include" -I"$OPENSSL_PREFIX/include" \
   "$OPENSSL_PREFIX/lib/libssl.dylib" \
   "$OPENSSL_PREFIX/lib/libcrypto.dylib" \
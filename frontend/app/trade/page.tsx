@@ -8,7 +8,10 @@ import {
   type BookResponse,
 } from "../../components/ConsolidatedOrderBook";
 import { OrderForm } from "../../components/OrderForm";
-import { API_BASE_URL } from "@/lib/api";
+import { API_BASE_URL, subscribeBook } from "@/lib/api";
+
+// Levels per side streamed for the ladder (backend maximum).
+const BOOK_DEPTH = 10;
 
 // Parse "BASE-QUOTE" pairs into base -> quotes map; bases and quotes sorted.
 function useBaseQuoteFromPairs(pairs: string[]) {
@@ -170,84 +173,41 @@ export default function TradePage() {
       return;
     }
 
-    let isCancelled = false;
-    let timerId: number | null = null;
-    let pollSeq = 0;
-
     // New symbol or first mount: treat as initial load, no data yet.
     invalidateBook();
 
-    const fetchBook = async () => {
-      if (isCancelled) return;
-
-      const currentSeq = ++pollSeq;
-
-      try {
-        const url = `${API_BASE_URL}/api/book?symbol=${encodeURIComponent(
-          selectedPair
-        )}&depth=24`;
-
-        const resp = await fetch(url);
-        let data: BookResponse | null = null;
+    // Server pushes a snapshot, then per-level deltas (see subscribeBook).
+    const unsubscribe = subscribeBook(selectedPair, BOOK_DEPTH, {
+      onBook: (data) => {
+        const statusCode = data.status?.code ?? 200;
 
-        try {
-          data = (await resp.json()) as BookResponse;
-        } catch {
-          data = null;
-        }
-
-        if (!resp.ok) {
-          const msg =
-            data?.status?.message ??
-            (data?.status?.code ? `HTTP ${data.status.code}` : `HTTP ${resp.status}`);
-          throw new Error(msg);
-        }
-
-        const statusCode = data?.status?.code ?? 200;
-
-        if (!isCancelled && currentSeq === pollSeq && statusCode !== 200) {
+        if (statusCode !== 200) {
           invalidateBook();
-          setError(data?.status?.message ?? "Market data unavailable");
+          setError(data.status?.message ?? "Market data unavailable");
           return;
         }
 
-        const hasLevels =
-          (data?.bids && data.bids.length > 0) ||
-          (data?.asks && data.asks.length > 0);
+        const hasLevels = data.bids.length > 0 || data.asks.length > 0;
 
-        if (!isCancelled && currentSeq === pollSeq) {
-          // Always update bookData on success so UI can show status message
-          setBookData(data);
-          setError(null);
-          if (hasLevels) {
-            setIsLoading(false);
-            lastUpdateRef.current = data?.last_updated_ms ?? null;
-          }
-          // If !hasLevels: keep loading state, UI will show "Connecting..."
+        // Always update bookData on success so UI can show status message
+        setBookData(data);
+        setError(null);
+        if (hasLevels) {
+          setIsLoading(false);
+          lastUpdateRef.current = data.last_updated_ms ?? null;
         }
-      } catch (err: any) {
-        if (!isCancelled) {
-          // Error state: we keep polling but show "Updating..." + error,
-          // and invalidate the table.
-          invalidateBook({ resetLastUpdate: false, clearError: false });
-          setError(err?.message ?? "Failed to fetch book");
-          // lastUpdateRef.current remains unchanged: tracks last success.
-        }
-      } finally {
-        if (!isCancelled) {
-          timerId = window.setTimeout(fetchBook, 1000); // Re-run after 1s
-        }
-      }
-    };
-
-    fetchBook();
-
-    return () => {
-      isCancelled = true;
-      if (timerId !== null) {
-        clearTimeout(timerId);
-      }
-    };
+        // If !hasLevels: keep loading state, UI will show "Connecting..."
+      },
+      onError: (message) => {
+        // The stream reconnects on its own; show "Updating..." + error
+        // and invalidate the table meanwhile.
+        invalidateBook({ resetLastUpdate: false, clearError: false });
+        setError(message);
+        // lastUpdateRef.current remains unchanged: tracks last success.
+      },
+    });
+
+    return unsubscribe;
   }, [selectedPair, authLoading, isAuthenticated, availablePairs]);
 
   if (authLoading || !isAuthenticated) {
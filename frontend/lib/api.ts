@@ -1 +1,223 @@
+import type { BookResponse, OrderLevel } from "@/components/ConsolidatedOrderBook";
+
 export const API_BASE_URL = process.env.NEXT_PUBLIC_API_BASE_URL ?? "";
+
+type BookStreamHandlers = {
+  // Called with the full consolidated book after every snapshot or delta.
+  onBook: (book: BookResponse) => void;
+  // Called when the stream drops; it reconnects on its own.
+  onError: (message: string) => void;
+};
+
+type SnapshotEvent = BookResponse & { seq: number };
+
+type DeltaEvent = {
+  seq: number;
+  last_updated_ms: number | null;
+  bids: OrderLevel[];
+  asks: OrderLevel[];
+};
+
+const RECONNECT_MS = 1000;
+
+const levelKey = (lvl: OrderLevel) => `${lvl.venue}|${lvl.price}`;
+
+// Same order as the backend merge: best price first, larger size first on ties.
+function sortedLevels(levels: Map<string, OrderLevel>, descending: boolean) {
+  return Array.from(levels.values()).sort((a, b) => {
+    if (a.price !== b.price) {
+      return descending ? b.price - a.price : a.price - b.price;
+    }
+    if (a.size !== b.size) return b.size - a.size;
+    return a.venue < b.venue ? -1 : a.venue > b.venue ? 1 : 0;
+  });
+}
+
+// Live consolidated book from GET /api/book/stream (server-sent events).
+// A `snapshot` event carries the whole book; each `delta` lists the levels
+// whose size changed, keyed by (venue, price), with size 0 for removed
+// levels. Deltas must arrive with consecutive seq numbers; on a gap or a
+// dropped connection the stream is reopened, which starts from a snapshot.
+// Returns a function that closes the stream.
+export function subscribeBook(
+  symbol: string,
+  depth: number,
+  { onBook, onError }: BookStreamHandlers
+): () => void {
+  const url = `${API_BASE_URL}/api/book/stream?symbol=${encodeURIComponent(
+    symbol
+  )}&depth=${depth}`;
+
+  let source: EventSource | null = null;
+  let retryId: number | null = null;
+  let closed = false;
+
+  let base: BookResponse | null = null;
+  let seq = 0;
+  const bids = new Map<string, OrderLevel>();
+  const asks = new Map<string, OrderLevel>();
+
+  const emit = () => {
+    if (!base) return;
+    onBook({
+      ...base,
+      bids: sortedLevels(bids, true),
+      asks: sortedLevels(asks, false),
+    });
+  };
+
+  const reopen = (delayMs: number) => {
+    source?.close();
+    source = null;
+    base = null;
+    if (closed || retryId !== null) return;
+    retryId = window.setTimeout(() => {
+      retryId = null;
+      open();
+    }, delayMs);
+  };
+
+  const open = () => {
+    if (closed) return;
+    const es = new EventSource(url);
+    source = es;
+
+    es.addEventListener("snapshot", (ev) => {
+      const data = JSON.parse((ev as MessageEvent<string>).data) as SnapshotEvent;
+      const { seq: snapshotSeq, ...book } = data;
+      seq = snapshotSeq;
+      base = book;
+      bids.clear();
+      asks.clear();
+      for (const lvl of book.bids ?? []) bids.set(levelKey(lvl), lvl);
+      for (const lvl of book.asks ?? []) asks.set(levelKey(lvl), lvl);
+      emit();
+    });
+
+    es.addEventListener("delta", (ev) => {
+      const data = JSON.parse((ev as MessageEvent<string>).data) as DeltaEvent;
+      if (!base || data.seq !== seq + 1) {
+        reopen(0);
+        return;
+      }
+      seq = data.seq;
+      base = { ...base, last_updated_ms: data.last_updated_ms };
+      const apply = (side: Map<string, OrderLevel>, levels: OrderLevel[]) => {
+        for (const lvl of levels) {
+          if (lvl.size === 0) side.delete(levelKey(lvl));
+          else side.set(levelKey(lvl), lvl);
+        }
+      };
+      apply(bids, data.bids);
+      apply(asks, data.asks);
+      emit();
+    });
+
+    es.onerror = () => {
+      onError("Book stream disconnected");
+      reopen(RECONNECT_MS);
+    };
+  };
+
+  open();
+
+  return () => {
+    closed = true;
+    if (retryId !== null) clearTimeout(retryId);
+    source?.close();
+    source = null;
+  };
+}
+
+export const BOOK_WIRE_TYPE = "application/x-book-wire";
+
+// Decodes the binary /api/book body (layout in backend/src/ui/book_wire.hpp).
+export function decodeBook(buffer: ArrayBuffer): BookResponse {
+  const bytes = new Uint8Array(buffer);
+  const text = new TextDecoder();
+  let pos = 0;
+
+  const byte = () => {
+    if (pos >= bytes.length) throw new Error("Truncated book payload");
+    return bytes[pos++];
+  };
+  // LEB128; multiplies instead of shifting so values above 2^31 stay exact.
+  const varint = () => {
+    let value = 0;
+    let scale = 1;
+    for (;;) {
+      const b = byte();
+      value += (b & 0x7f) * scale;
+      if (b < 0x80) return value;
+      scale *= 128;
+    }
+  };
+  const zigzag = () => {
+    const v = varint();
+    return v % 2 === 0 ? v / 2 : -(v + 1) / 2;
+  };
+  const string = () => {
+    const len = varint();
+    if (pos + len > bytes.length) throw new Error("Truncated book payload");
+    const s = text.decode(bytes.subarray(pos, pos + len));
+    pos += len;
+    return s;
+  };
+
+  const version = byte();
+  if (version !== 1) throw new Error(`Unsupported book payload version ${version}`);
+  const code = varint();
+  const message = string();
+  const lastUpdated = varint();
+  const symbol = string();
+  const dictSize = varint();
+  const listed = varint();
+  const dict: string[] = [];
+  for (let i = 0; i < dictSize; i++) dict.push(string());
+  const priceScale = 10 ** byte();
+  const sizeScale = 10 ** byte();
+
+  const side = () => {
+    const count = varint();
+    const levels: OrderLevel[] = [];
+    let price = 0;
+    for (let i = 0; i < count; i++) {
+      const venue = dict[varint()];
+      price += zigzag();
+      const size = varint();
+      levels.push({ price: price / priceScale, size: size / sizeScale, venue });
+    }
+    return levels;
+  };
+  const bids = side();
+  const asks = side();
+
+  return {
+    status: { code, message },
+    last_updated_ms: lastUpdated > 0 ? lastUpdated : null,
+    symbol,
+    venues: dict.slice(0, listed),
+    bids,
+    asks,
+  };
+}
+
+// One-off consolidated book in the binary encoding (cold books arrive with
+// status.code 503 and are returned as-is).
+export async function fetchBook(
+  symbol: string,
+  depth: number,
+  init?: RequestInit
+): Promise<BookResponse> {
+  const headers = new Headers(init?.headers);
+  headers.set("Accept", BOOK_WIRE_TYPE);
+  const res = await fetch(
+    `${API_BASE_URL}/api/book?symbol=${encodeURIComponent(symbol)}&depth=${depth}`,
+    { ...init, headers }
+  );
+  if (!res.headers.get("content-type")?.startsWith(BOOK_WIRE_TYPE)) {
+    const body = await res.json().catch(() => null);
+    throw new Error(body?.error ?? `Book request failed (${res.status})`);
+  }
+  return decodeBook(await res.arrayBuffer());
+}